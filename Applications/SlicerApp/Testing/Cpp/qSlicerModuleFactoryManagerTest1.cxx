@@ -42,6 +42,8 @@ int qSlicerModuleFactoryManagerTest1(int argc, char * argv[])
   // Register factories
   moduleFactoryManager.registerFactory(new qSlicerCoreModuleFactory());
 
+  moduleFactoryManager.setProfileModuleStartup(true);
+
   // Register core modules
   moduleFactoryManager.registerModules();
 
@@ -68,6 +70,16 @@ int qSlicerModuleFactoryManagerTest1(int argc, char * argv[])
     return EXIT_FAILURE;
   }
 
+  // Startup times are recorded when profiling is enabled
+  if (moduleFactoryManager.moduleStartupTime(moduleName, "instantiate") < 0
+    || moduleFactoryManager.moduleStartupTime(moduleName, "load") < 0
+    || !moduleFactoryManager.moduleStartupTimeReport().contains(moduleName))
+  {
+    std::cerr << __LINE__ << " - Error in moduleStartupTime() or moduleStartupTimeReport()" << std::endl
+              << qPrintable(moduleFactoryManager.moduleStartupTimeReport()) << std::endl;
+    return EXIT_FAILURE;
+  }
+
   moduleFactoryManager.unloadModules();
 
   // Instantiate again
@@ -0,0 +1,211 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Slicer includes
+#include "vtkSlicerApplicationLogic.h"
+#include "vtkSlicerTask.h"
+
+// MRML includes
+#include <vtkMRMLAbstractLogic.h>
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+
+// STD includes
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+class vtkTestTaskLogic : public vtkMRMLAbstractLogic
+{
+public:
+  static vtkTestTaskLogic* New();
+  vtkTypeMacro(vtkTestTaskLogic, vtkMRMLAbstractLogic);
+
+  void RunTask(void* clientData)
+  {
+    int taskId = *static_cast<int*>(clientData);
+    int running = ++this->NumberOfRunningTasks;
+    int maximumRunning = this->MaximumNumberOfRunningTasks;
+    while (running > maximumRunning && !this->MaximumNumberOfRunningTasks.compare_exchange_weak(maximumRunning, running))
+    {
+    }
+    while (taskId < 0 && this->Blocked)
+    {
+      // blocking task, waits until it is released
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    if (taskId >= 0)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(this->TaskDuration));
+    }
+    {
+      std::lock_guard<std::mutex> lock(this->ExecutedTasksLock);
+      this->ExecutedTasks.push_back(taskId);
+    }
+    --this->NumberOfRunningTasks;
+  }
+
+  std::vector<int> GetExecutedTasks()
+  {
+    std::lock_guard<std::mutex> lock(this->ExecutedTasksLock);
+    return this->ExecutedTasks;
+  }
+
+  std::atomic<bool> Blocked{true};
+  std::atomic<int> NumberOfRunningTasks{0};
+  std::atomic<int> MaximumNumberOfRunningTasks{0};
+  int TaskDuration{0};
+
+protected:
+  vtkTestTaskLogic() = default;
+  ~vtkTestTaskLogic() override = default;
+
+  std::mutex ExecutedTasksLock;
+  std::vector<int> ExecutedTasks;
+};
+
+vtkStandardNewMacro(vtkTestTaskLogic);
+
+//-----------------------------------------------------------------------------
+bool ScheduleTestTask(vtkSlicerApplicationLogic* appLogic, vtkTestTaskLogic* logic, int* taskId, int priority)
+{
+  vtkNew<vtkSlicerTask> task;
+  task->SetTypeToProcessing();
+  task->SetPriority(priority);
+  task->SetTaskFunction(logic, (vtkSlicerTask::TaskFunctionPointer)&vtkTestTaskLogic::RunTask, taskId);
+  return appLogic->ScheduleTask(task);
+}
+
+//-----------------------------------------------------------------------------
+bool WaitForExecutedTasks(vtkTestTaskLogic* logic, size_t numberOfTasks)
+{
+  for (int i = 0; i < 1000; ++i)
+  {
+    if (logic->GetExecutedTasks().size() >= numberOfTasks)
+    {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  std::cerr << "Timeout while waiting for " << numberOfTasks << " tasks to complete" << std::endl;
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+int TestTaskPriority()
+{
+  vtkNew<vtkSlicerApplicationLogic> appLogic;
+  if (appLogic->GetNumberOfProcessingThreads() != 1)
+  {
+    std::cerr << __LINE__ << ": Expected a single processing thread by default" << std::endl;
+    return EXIT_FAILURE;
+  }
+  vtkNew<vtkTestTaskLogic> logic;
+  int taskIds[4] = { -1, 0, 1, 2 };
+  if (ScheduleTestTask(appLogic, logic, &taskIds[0], 0))
+  {
+    std::cerr << __LINE__ << ": Tasks must not be scheduled before processing thread is created" << std::endl;
+    return EXIT_FAILURE;
+  }
+  appLogic->CreateProcessingThread();
+
+  // Occupy the processing thread then queue tasks with different priorities
+  ScheduleTestTask(appLogic, logic, &taskIds[0], 0);
+  for (int i = 0; i < 1000 && appLogic->GetNumberOfStartedTasks() < 1; ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ScheduleTestTask(appLogic, logic, &taskIds[1], 0);
+  ScheduleTestTask(appLogic, logic, &taskIds[2], 0);
+  ScheduleTestTask(appLogic, logic, &taskIds[3], 10);
+  if (appLogic->GetProcessingTaskQueueSize() != 3)
+  {
+    std::cerr << __LINE__ << ": Expected 3 tasks in the queue, found " << appLogic->GetProcessingTaskQueueSize() << std::endl;
+    return EXIT_FAILURE;
+  }
+  logic->Blocked = false;
+  if (!WaitForExecutedTasks(logic, 4))
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::vector<int> expectedOrder = { -1, 2, 0, 1 };
+  if (logic->GetExecutedTasks() != expectedOrder)
+  {
+    std::cerr << __LINE__ << ": Tasks are not executed in order of priority" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (appLogic->GetNumberOfStartedTasks() != 4 || appLogic->GetProcessingTaskQueueSize() != 0
+    || appLogic->GetMaximumTaskLatency() <= 0.0)
+  {
+    std::cerr << __LINE__ << ": Invalid task statistics: started tasks = " << appLogic->GetNumberOfStartedTasks()
+      << ", maximum latency = " << appLogic->GetMaximumTaskLatency() << std::endl;
+    return EXIT_FAILURE;
+  }
+  appLogic->TerminateProcessingThread();
+  return EXIT_SUCCESS;
+}
+
+//-----------------------------------------------------------------------------
+int TestParallelTasks()
+{
+  const int numberOfThreads = 4;
+  vtkNew<vtkSlicerApplicationLogic> appLogic;
+  appLogic->SetNumberOfProcessingThreads(numberOfThreads);
+  appLogic->CreateProcessingThread();
+
+  vtkNew<vtkTestTaskLogic> logic;
+  logic->TaskDuration = 200;
+  int taskIds[numberOfThreads] = { 0, 1, 2, 3 };
+  for (int i = 0; i < numberOfThreads; ++i)
+  {
+    ScheduleTestTask(appLogic, logic, &taskIds[i], 0);
+  }
+  if (!WaitForExecutedTasks(logic, numberOfThreads))
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Maximum number of concurrently running tasks: " << logic->MaximumNumberOfRunningTasks << std::endl;
+  if (logic->MaximumNumberOfRunningTasks < 2)
+  {
+    std::cerr << __LINE__ << ": Tasks are not executed in parallel" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Threads are terminated when the logic is destroyed
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int vtkSlicerApplicationLogicTest2(int , char * [])
+{
+  if (TestTaskPriority() != EXIT_SUCCESS
+    || TestParallelTasks() != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Processing thread pool test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -34,12 +34,14 @@
 // VTK includes
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkTimerLog.h>
 
 // ITKSYS includes
 #include <itksys/SystemTools.hxx>
 
 // STD includes
 #include <algorithm>
+#include <condition_variable>
 
 #ifdef ITK_USE_PTHREADS
 # include <unistd.h>
@@ -52,7 +54,51 @@
 #include "vtkSlicerApplicationLogicRequests.h"
 
 //----------------------------------------------------------------------------
-class ProcessingTaskQueue : public std::queue<vtkSmartPointer<vtkSlicerTask> > {};
+struct ScheduledTask
+{
+  vtkSmartPointer<vtkSlicerTask> Task;
+  int Priority{0};
+  vtkTypeUInt64 SequenceNumber{0};
+  double ScheduledTime{0.0};
+};
+
+//----------------------------------------------------------------------------
+struct ScheduledTaskCompare
+{
+  // Tasks with higher priority first, then the earliest scheduled task first
+  bool operator()(const ScheduledTask& first, const ScheduledTask& second) const
+  {
+    if (first.Priority != second.Priority)
+    {
+      return first.Priority < second.Priority;
+    }
+    return first.SequenceNumber > second.SequenceNumber;
+  }
+};
+
+//----------------------------------------------------------------------------
+class ScheduledTaskQueue
+  : public std::priority_queue<ScheduledTask, std::vector<ScheduledTask>, ScheduledTaskCompare> {};
+
+//----------------------------------------------------------------------------
+class ProcessingTaskQueue
+{
+public:
+  ScheduledTaskQueue& GetQueue(int taskType)
+  {
+    return (taskType == vtkSlicerTask::Networking ? this->NetworkingTasks : this->ProcessingTasks);
+  }
+  std::condition_variable& GetTaskAvailableCondition(int taskType)
+  {
+    return (taskType == vtkSlicerTask::Networking ? this->NetworkingTaskAvailable : this->ProcessingTaskAvailable);
+  }
+
+  ScheduledTaskQueue ProcessingTasks;
+  ScheduledTaskQueue NetworkingTasks;
+  std::condition_variable ProcessingTaskAvailable;
+  std::condition_variable NetworkingTaskAvailable;
+  vtkTypeUInt64 NextSequenceNumber{0};
+};
 class ModifiedQueue : public std::queue<vtkSmartPointer<vtkObject> > {};
 class ReadDataQueue : public std::queue<DataRequest*> {};
 class WriteDataQueue : public std::queue<DataRequest*> {};
@@ -64,7 +110,7 @@ vtkStandardNewMacro(vtkSlicerApplicationLogic);
 vtkSlicerApplicationLogic::vtkSlicerApplicationLogic()
 {
   this->ProcessingThreader = itk::PlatformMultiThreader::New();
-  this->ProcessingThreadId = -1;
+  this->NumberOfProcessingThreads = 1;
   this->ProcessingThreadActive = false;
 
   this->ModifiedQueueActive = false;
@@ -80,26 +126,16 @@ vtkSlicerApplicationLogic::vtkSlicerApplicationLogic()
   this->InternalWriteDataQueue = new WriteDataQueue;
 
   this->UserInformation = vtkPersonInformation::New();
+
+  this->ResetStatistics();
 }
 
 //----------------------------------------------------------------------------
 vtkSlicerApplicationLogic::~vtkSlicerApplicationLogic()
 {
-  // Note that TerminateThread does not kill a thread, it only waits
-  // for the thread to finish.  We need to signal the thread that we
-  // want to terminate
-  if (this->ProcessingThreadId != -1 && this->ProcessingThreader)
-  {
-    // Signal the processingThread that we are terminating.
-    this->ProcessingThreadActiveLock.lock();
-    this->ProcessingThreadActive = false;
-    this->ProcessingThreadActiveLock.unlock();
-
-    // Wait for the thread to finish and clean up the state of the threader
-    this->ProcessingThreader->TerminateThread( this->ProcessingThreadId );
-
-    this->ProcessingThreadId = -1;
-  }
+  // Signal the processing and networking threads that we are terminating
+  // and wait for them to finish.
+  this->TerminateProcessingThread();
 
   delete this->InternalTaskQueue;
 
@@ -121,9 +157,98 @@ vtkSlicerApplicationLogic::~vtkSlicerApplicationLogic()
 //----------------------------------------------------------------------------
 unsigned int vtkSlicerApplicationLogic::GetReadDataQueueSize()
 {
+  std::lock_guard<std::mutex> lock(this->ReadDataQueueLock);
   return static_cast<unsigned int>( (*this->InternalReadDataQueue).size() );
 }
 
+//----------------------------------------------------------------------------
+unsigned int vtkSlicerApplicationLogic::GetWriteDataQueueSize()
+{
+  std::lock_guard<std::mutex> lock(this->WriteDataQueueLock);
+  return static_cast<unsigned int>( (*this->InternalWriteDataQueue).size() );
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkSlicerApplicationLogic::GetProcessingTaskQueueSize()
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  return static_cast<unsigned int>( this->InternalTaskQueue->ProcessingTasks.size()
+    + this->InternalTaskQueue->NetworkingTasks.size() );
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkSlicerApplicationLogic::GetNumberOfStartedTasks()
+{
+  std::lock_guard<std::mutex> lock(this->StatisticsLock);
+  return this->NumberOfStartedTasks;
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerApplicationLogic::GetAverageTaskLatency()
+{
+  std::lock_guard<std::mutex> lock(this->StatisticsLock);
+  return (this->NumberOfStartedTasks > 0 ? this->TotalTaskLatency / this->NumberOfStartedTasks : 0.0);
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerApplicationLogic::GetMaximumTaskLatency()
+{
+  std::lock_guard<std::mutex> lock(this->StatisticsLock);
+  return this->MaximumTaskLatency;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkSlicerApplicationLogic::GetNumberOfProcessedDataRequests()
+{
+  std::lock_guard<std::mutex> lock(this->StatisticsLock);
+  return this->NumberOfProcessedDataRequests;
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerApplicationLogic::GetAverageDataRequestLatency()
+{
+  std::lock_guard<std::mutex> lock(this->StatisticsLock);
+  return (this->NumberOfProcessedDataRequests > 0 ?
+    this->TotalDataRequestLatency / this->NumberOfProcessedDataRequests : 0.0);
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerApplicationLogic::GetMaximumDataRequestLatency()
+{
+  std::lock_guard<std::mutex> lock(this->StatisticsLock);
+  return this->MaximumDataRequestLatency;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::ResetStatistics()
+{
+  std::lock_guard<std::mutex> lock(this->StatisticsLock);
+  this->NumberOfStartedTasks = 0;
+  this->TotalTaskLatency = 0.0;
+  this->MaximumTaskLatency = 0.0;
+  this->NumberOfProcessedDataRequests = 0;
+  this->TotalDataRequestLatency = 0.0;
+  this->MaximumDataRequestLatency = 0.0;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::AddLatencyStatistics(bool task, double latency)
+{
+  std::lock_guard<std::mutex> lock(this->StatisticsLock);
+  if (task)
+  {
+    this->NumberOfStartedTasks++;
+    this->TotalTaskLatency += latency;
+    this->MaximumTaskLatency = std::max(this->MaximumTaskLatency, latency);
+  }
+  else
+  {
+    this->NumberOfProcessedDataRequests++;
+    this->TotalDataRequestLatency += latency;
+    this->MaximumDataRequestLatency = std::max(this->MaximumDataRequestLatency, latency);
+  }
+}
+
 //-----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::SetMRMLSceneDataIO(vtkMRMLScene* newMRMLScene,
                                                    vtkMRMLRemoteIOLogic *remoteIOLogic,
@@ -164,23 +289,33 @@ void vtkSlicerApplicationLogic::PrintSelf(ostream& os, vtkIndent indent)
   this->vtkObject::PrintSelf(os, indent);
 
   os << indent << "SlicerApplicationLogic:             " << this->GetClassName() << "\n";
+  os << indent << "NumberOfProcessingThreads:          " << this->NumberOfProcessingThreads << "\n";
+  os << indent << "ProcessingTaskQueueSize:            " << this->GetProcessingTaskQueueSize() << "\n";
+  os << indent << "NumberOfStartedTasks:               " << this->GetNumberOfStartedTasks() << "\n";
+  os << indent << "AverageTaskLatency:                 " << this->GetAverageTaskLatency() << "\n";
+  os << indent << "NumberOfProcessedDataRequests:      " << this->GetNumberOfProcessedDataRequests() << "\n";
+  os << indent << "AverageDataRequestLatency:          " << this->GetAverageDataRequestLatency() << "\n";
 }
 
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::CreateProcessingThread()
 {
-  if (this->ProcessingThreadId == -1)
+  if (this->ProcessingThreadIDs.empty())
   {
     this->ProcessingThreadActiveLock.lock();
     this->ProcessingThreadActive = true;
     this->ProcessingThreadActiveLock.unlock();
 
-    this->ProcessingThreadId
-      = this->ProcessingThreader
-      ->SpawnThread(vtkSlicerApplicationLogic::ProcessingThreaderCallback,
-                    this);
+    this->ResetStatistics();
+
+    for (int threadIndex = 0; threadIndex < this->NumberOfProcessingThreads; ++threadIndex)
+    {
+      this->ProcessingThreadIDs.push_back( this->ProcessingThreader
+        ->SpawnThread(vtkSlicerApplicationLogic::ProcessingThreaderCallback,
+                      this) );
+    }
 
-    // Start four network threads (TODO: make the number of threads a setting)
+    // Start a single network thread
     this->NetworkingThreadIDs.push_back ( this->ProcessingThreader
           ->SpawnThread(vtkSlicerApplicationLogic::NetworkingThreaderCallback,
                     this) );
@@ -221,7 +356,7 @@ void vtkSlicerApplicationLogic::CreateProcessingThread()
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::TerminateProcessingThread()
 {
-  if (this->ProcessingThreadId != -1)
+  if (!this->ProcessingThreadIDs.empty() && this->ProcessingThreader)
   {
     this->ModifiedQueueActiveLock.lock();
     this->ModifiedQueueActive = false;
@@ -239,10 +374,25 @@ void vtkSlicerApplicationLogic::TerminateProcessingThread()
     this->ProcessingThreadActive = false;
     this->ProcessingThreadActiveLock.unlock();
 
-    this->ProcessingThreader->TerminateThread( this->ProcessingThreadId );
-    this->ProcessingThreadId = -1;
+    // Wake up all idle threads so that they notice that they have to terminate.
+    // The queue lock ensures that no thread is between checking the active flag
+    // and starting to wait.
+    this->ProcessingTaskQueueLock.lock();
+    this->ProcessingTaskQueueLock.unlock();
+    this->InternalTaskQueue->ProcessingTaskAvailable.notify_all();
+    this->InternalTaskQueue->NetworkingTaskAvailable.notify_all();
 
+    // Note that TerminateThread does not kill a thread, it only waits
+    // for the thread to finish.
     std::vector<int>::const_iterator idIterator;
+    idIterator = this->ProcessingThreadIDs.begin();
+    while (idIterator != this->ProcessingThreadIDs.end())
+    {
+      this->ProcessingThreader->TerminateThread( *idIterator );
+      ++idIterator;
+    }
+    this->ProcessingThreadIDs.clear();
+
     idIterator = this->NetworkingThreadIDs.begin();
     while (idIterator != this->NetworkingThreadIDs.end())
     {
@@ -276,48 +426,7 @@ vtkSlicerApplicationLogic::ProcessingThreaderCallback(void* arg)
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::ProcessProcessingTasks()
 {
-  int active = true;
-  vtkSmartPointer<vtkSlicerTask> task = nullptr;
-
-  while (active)
-  {
-    // Check to see if we should be shutting down
-    this->ProcessingThreadActiveLock.lock();
-    active = this->ProcessingThreadActive;
-    this->ProcessingThreadActiveLock.unlock();
-
-    if (active)
-    {
-      // pull a task off the queue
-      this->ProcessingTaskQueueLock.lock();
-      if ((*this->InternalTaskQueue).size() > 0)
-      {
-        // std::cout << "Number of queued tasks: " << (*this->InternalTaskQueue).size() << std::endl;
-
-        // only handle processing tasks in this thread
-        task = (*this->InternalTaskQueue).front();
-        if ( task->GetType() == vtkSlicerTask::Processing )
-        {
-          (*this->InternalTaskQueue).pop();
-        }
-        else
-        {
-          task = nullptr;
-        }
-      }
-      this->ProcessingTaskQueueLock.unlock();
-
-      // process the task (should this be in a separate thread?)
-      if (task)
-      {
-        task->Execute();
-        task = nullptr;
-      }
-    }
-
-    // busy wait
-    itksys::SystemTools::Delay(100);
-  }
+  this->ProcessTasks(vtkSlicerTask::Processing);
 }
 
 itk::ITK_THREAD_RETURN_TYPE
@@ -341,45 +450,38 @@ vtkSlicerApplicationLogic::NetworkingThreaderCallback(void* arg)
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::ProcessNetworkingTasks()
 {
-  int active = true;
-  vtkSmartPointer<vtkSlicerTask> task = nullptr;
+  this->ProcessTasks(vtkSlicerTask::Networking);
+}
 
-  while (active)
-  {
-    // Check to see if we should be shutting down
-    this->ProcessingThreadActiveLock.lock();
-    active = this->ProcessingThreadActive;
-    this->ProcessingThreadActiveLock.unlock();
+//----------------------------------------------------------------------------
+bool vtkSlicerApplicationLogic::IsProcessingThreadActive()
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingThreadActiveLock);
+  return this->ProcessingThreadActive;
+}
 
-    if (active)
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::ProcessTasks(int taskType)
+{
+  ScheduledTaskQueue& queue = this->InternalTaskQueue->GetQueue(taskType);
+  std::condition_variable& taskAvailable = this->InternalTaskQueue->GetTaskAvailableCondition(taskType);
+  while (true)
+  {
+    // Wait (without using CPU) until a task is scheduled or the thread has to terminate
+    ScheduledTask scheduledTask;
     {
-      // pull a task off the queue
-      this->ProcessingTaskQueueLock.lock();
-      if ((*this->InternalTaskQueue).size() > 0)
+      std::unique_lock<std::mutex> lock(this->ProcessingTaskQueueLock);
+      taskAvailable.wait(lock, [&] { return !queue.empty() || !this->IsProcessingThreadActive(); });
+      if (!this->IsProcessingThreadActive())
       {
-        // std::cout << "Number of queued tasks: " << (*this->InternalTaskQueue).size() << std::endl;
-        task = (*this->InternalTaskQueue).front();
-        if ( task->GetType() == vtkSlicerTask::Networking )
-        {
-          (*this->InternalTaskQueue).pop();
-        }
-        else
-        {
-          task = nullptr;
-        }
-      }
-      this->ProcessingTaskQueueLock.unlock();
-
-      // process the task (should this be in a separate thread?)
-      if (task)
-      {
-        task->Execute();
-        task = nullptr;
+        break;
       }
+      scheduledTask = queue.top();
+      queue.pop();
     }
 
-    // busy wait
-    itksys::SystemTools::Delay(100);
+    this->AddLatencyStatistics(true, vtkTimerLog::GetUniversalTime() - scheduledTask.ScheduledTime);
+    scheduledTask.Task->Execute();
   }
 }
 
@@ -395,9 +497,16 @@ int vtkSlicerApplicationLogic::ScheduleTask( vtkSlicerTask *task )
     return false;
   }
 
+  // Undefined tasks are executed by the processing threads
+  ScheduledTask scheduledTask;
+  scheduledTask.Task = task;
+  scheduledTask.Priority = task->GetPriority();
+  scheduledTask.ScheduledTime = vtkTimerLog::GetUniversalTime();
   this->ProcessingTaskQueueLock.lock();
-  (*this->InternalTaskQueue).push( task );
+  scheduledTask.SequenceNumber = this->InternalTaskQueue->NextSequenceNumber++;
+  this->InternalTaskQueue->GetQueue(task->GetType()).push(scheduledTask);
   this->ProcessingTaskQueueLock.unlock();
+  this->InternalTaskQueue->GetTaskAvailableCondition(task->GetType()).notify_one();
   return true;
 }
 
@@ -445,6 +554,29 @@ vtkMTimeType vtkSlicerApplicationLogic::RequestReadFile(const char *refNode, con
   return uid;
 }
 
+//----------------------------------------------------------------------------
+vtkMTimeType vtkSlicerApplicationLogic::RequestSetVolumeImageData(const std::string& volumeNodeID,
+  vtkImageData* imageData, vtkMatrix4x4* ijkToRAS, int displayData)
+{
+  // only request to read a file if the ReadData queue is up
+  this->ReadDataQueueActiveLock.lock();
+  int active = this->ReadDataQueueActive;
+  this->ReadDataQueueActiveLock.unlock();
+  if (!active)
+  {
+    // could not request the record be added to the queue
+    return 0;
+  }
+
+  this->ReadDataQueueLock.lock();
+  this->RequestTimeStamp.Modified();
+  vtkMTimeType uid = this->RequestTimeStamp.GetMTime();
+  (*this->InternalReadDataQueue).push(
+    new ReadDataRequestVolumeImage(volumeNodeID, imageData, ijkToRAS, displayData, uid));
+  this->ReadDataQueueLock.unlock();
+  return uid;
+}
+
 //----------------------------------------------------------------------------
 vtkMTimeType vtkSlicerApplicationLogic::RequestUpdateParentTransform(const std::string &refNode, const std::string& parentTransformNode)
 {
@@ -639,6 +771,7 @@ void vtkSlicerApplicationLogic::ProcessReadData()
   if (req)
   {
     uid = req->GetUID();
+    this->AddLatencyStatistics(false, vtkTimerLog::GetUniversalTime() - req->GetRequestTime());
     req->Execute(this);
     delete req;
   }
@@ -679,6 +812,7 @@ void vtkSlicerApplicationLogic::ProcessWriteData()
   if (req)
   {
     vtkMTimeType uid = req->GetUID();
+    this->AddLatencyStatistics(false, vtkTimerLog::GetUniversalTime() - req->GetRequestTime());
     req->Execute(this);
     delete req;
 
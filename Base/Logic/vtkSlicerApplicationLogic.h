@@ -37,6 +37,8 @@ class vtkMRMLSelectionNode;
 class vtkMRMLInteractionNode;
 class vtkMRMLRemoteIOLogic;
 class vtkDataIOManagerLogic;
+class vtkImageData;
+class vtkMatrix4x4;
 class vtkPersonInformation;
 class vtkSlicerTask;
 class ModifiedQueue;
@@ -68,11 +70,18 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerApplicationLogic
                           vtkDataIOManagerLogic *dataIOManagerLogic);
 
 
-  /// Create a thread for processing
+  /// Create the threads for processing and networking tasks
   void CreateProcessingThread();
 
-  /// Shutdown the processing thread
+  /// Shutdown the processing and networking threads
   void TerminateProcessingThread();
+
+  /// Number of threads that execute processing tasks (for example, CLI modules).
+  /// Tasks wait for a free thread in order of their priority.
+  /// Must be set before CreateProcessingThread() is called. Default is 1.
+  /// \sa vtkSlicerTask::SetPriority()
+  vtkSetClampMacro(NumberOfProcessingThreads, int, 1, 32);
+  vtkGetMacro(NumberOfProcessingThreads, int);
   /// List of events potentially fired by the application logic
   enum RequestEvents
   {
@@ -89,6 +98,8 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerApplicationLogic
   /// Schedule a task to run in the processing thread. Returns true if
   /// task was successfully scheduled. ScheduleTask() is called from the
   /// main thread to run something in the processing thread.
+  /// Tasks with higher priority are started first, tasks with the same
+  /// priority are started in the order they were scheduled.
   int ScheduleTask( vtkSlicerTask* );
 
   /// Request a Modified call on an object.  This method allows a
@@ -113,6 +124,17 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerApplicationLogic
   vtkMTimeType RequestReadFile(const char *refNode, const char *filename,
     int displayData = false, int deleteFile = false);
 
+  /// Request that an image and its geometry be set on the referenced volume
+  /// node. This allows a processing thread to read the image data and have it
+  /// set on the node in the main thread, which also updates the display.
+  /// \a ijkToRAS may be nullptr to keep the current volume geometry.
+  /// Return the request UID (monotonically increasing) of the request or 0 if
+  /// the request failed to be registered. When the request is processed,
+  /// RequestProcessedEvent is invoked with the request UID as calldata.
+  /// \sa RequestReadFile()
+  vtkMTimeType RequestSetVolumeImageData(const std::string& volumeNodeID, vtkImageData* imageData,
+    vtkMatrix4x4* ijkToRAS, int displayData = false);
+
   /// Request setting of parent transform.
   /// The request will executed on the main thread.
   /// Return the request UID (monotonically increasing) of the request or 0 if
@@ -142,6 +164,23 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerApplicationLogic
   /// multiple items are being returned and have all been returned).
   unsigned int GetReadDataQueueSize();
 
+  /// Return the number of data write requests waiting to be processed.
+  unsigned int GetWriteDataQueueSize();
+
+  /// Return the number of scheduled tasks that have not been started yet.
+  unsigned int GetProcessingTaskQueueSize();
+
+  /// Queue statistics, collected since the processing threads were created
+  /// or ResetStatistics() was called.
+  /// Latency is the time in seconds from scheduling a task (or submitting
+  /// a read/write data request) until its execution is started.
+  vtkTypeInt64 GetNumberOfStartedTasks();
+  double GetAverageTaskLatency();
+  double GetMaximumTaskLatency();
+  vtkTypeInt64 GetNumberOfProcessedDataRequests();
+  double GetAverageDataRequestLatency();
+  double GetMaximumDataRequestLatency();
+  void ResetStatistics();
 
   /// Request that data be written from a file to a remote destination.
   /// Return the request UID (monotonically increasing) of the request or 0 if
@@ -239,6 +278,10 @@ protected:
   /// Networking Task processing loop that is run in a networking thread
   void ProcessNetworkingTasks();
 
+  /// Execute tasks of the specified type (vtkSlicerTask::Processing or Networking)
+  /// as they are scheduled, until the processing threads are terminated.
+  void ProcessTasks(int taskType);
+
   /// Process a request to read data into a scene.  This method is
   /// called by ProcessReadData() in the application main thread
   /// because calls to load data will cause a Modified() on a node
@@ -256,6 +299,9 @@ private:
   vtkSlicerApplicationLogic(const vtkSlicerApplicationLogic&);
   void operator=(const vtkSlicerApplicationLogic&);
 
+  bool IsProcessingThreadActive();
+  void AddLatencyStatistics(bool task, double latency);
+
   itk::PlatformMultiThreader::Pointer ProcessingThreader;
   std::mutex ProcessingThreadActiveLock;
   std::mutex ProcessingTaskQueueLock;
@@ -265,8 +311,10 @@ private:
   std::mutex ReadDataQueueLock;
   std::mutex WriteDataQueueActiveLock;
   std::mutex WriteDataQueueLock;
+  std::mutex StatisticsLock;
   vtkTimeStamp RequestTimeStamp;
-  int ProcessingThreadId;
+  int NumberOfProcessingThreads;
+  std::vector<int> ProcessingThreadIDs;
   std::vector<int> NetworkingThreadIDs;
   int ProcessingThreadActive;
   int ModifiedQueueActive;
@@ -278,6 +326,13 @@ private:
   ReadDataQueue*       InternalReadDataQueue;
   WriteDataQueue*      InternalWriteDataQueue;
 
+  vtkTypeInt64 NumberOfStartedTasks;
+  double TotalTaskLatency;
+  double MaximumTaskLatency;
+  vtkTypeInt64 NumberOfProcessedDataRequests;
+  double TotalDataRequestLatency;
+  double MaximumDataRequestLatency;
+
   vtkPersonInformation* UserInformation;
 
   /// For use with external tracing tool (such as AQTime)
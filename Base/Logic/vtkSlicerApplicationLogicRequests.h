@@ -19,6 +19,11 @@
 #include <vtkMRMLSubjectHierarchyNode.h>
 #include <vtkMRMLTableNode.h>
 
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
 //----------------------------------------------------------------------------
 class DataRequest
 {
@@ -26,11 +31,13 @@ public:
   DataRequest()
   {
     m_UID = 0;
+    m_RequestTime = vtkTimerLog::GetUniversalTime();
   }
 
   DataRequest(int uid)
   {
     m_UID = uid;
+    m_RequestTime = vtkTimerLog::GetUniversalTime();
   }
 
   virtual ~DataRequest()  = default;
@@ -39,8 +46,12 @@ public:
 
   int GetUID()const{return m_UID;}
 
+  /// Time when the request was submitted (in seconds)
+  double GetRequestTime()const{return m_RequestTime;}
+
 protected:
   vtkMTimeType m_UID;
+  double m_RequestTime;
 };
 
 //----------------------------------------------------------------------------
@@ -188,7 +199,14 @@ public:
       }
     }
 
+    this->UpdateDisplay(appLogic, nd);
+  }
 
+protected:
+  /// Create default display nodes, notify observers and make the node
+  /// active in the selection node if display is requested.
+  void UpdateDisplay(vtkSlicerApplicationLogic* appLogic, vtkMRMLNode* nd)
+  {
     // Get the right type of display node. Only create a display node
     // if one does not exist already
     //
@@ -237,13 +255,48 @@ public:
     }
   }
 
-protected:
   std::string m_TargetNode;
   std::string m_Filename;
   int m_DisplayData;
   int m_DeleteFile;
 };
 
+//----------------------------------------------------------------------------
+class ReadDataRequestVolumeImage : public ReadDataRequestFile
+{
+public:
+  ReadDataRequestVolumeImage(const std::string& node, vtkImageData* imageData,
+    vtkMatrix4x4* ijkToRAS, int displayData, int uid = 0)
+    : ReadDataRequestFile(node, std::string(), displayData, false, uid)
+  {
+    m_ImageData = imageData;
+    m_IJKToRAS = ijkToRAS;
+  }
+
+  void Execute(vtkSlicerApplicationLogic* appLogic) override
+  {
+    vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(
+      appLogic->GetMRMLScene()->GetNodeByID(m_TargetNode.c_str()));
+    if (!volumeNode)
+    {
+      vtkErrorWithObjectMacro(appLogic, "ReadDataRequestVolumeImage: volume node " << m_TargetNode << " not found");
+      return;
+    }
+    int wasModified = volumeNode->StartModify();
+    if (m_IJKToRAS)
+    {
+      volumeNode->SetIJKToRASMatrix(m_IJKToRAS);
+    }
+    volumeNode->SetAndObserveImageData(m_ImageData);
+    volumeNode->EndModify(wasModified);
+    this->UpdateDisplay(appLogic, volumeNode);
+  }
+
+protected:
+  vtkSmartPointer<vtkImageData> m_ImageData;
+  vtkSmartPointer<vtkMatrix4x4> m_IJKToRAS;
+};
+
 //----------------------------------------------------------------------------
 class ReadDataRequestScene : public DataRequest
 {
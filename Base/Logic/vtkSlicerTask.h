@@ -38,6 +38,12 @@ public:
   void SetTypeToProcessing() {this->SetType(vtkSlicerTask::Processing);};
   void SetTypeToNetworking() {this->SetType(vtkSlicerTask::Networking);};
 
+  ///
+  /// Tasks with higher priority are started before tasks with lower
+  /// priority when multiple tasks are waiting for a thread. Default is 0.
+  vtkSetMacro(Priority, int);
+  vtkGetMacro(Priority, int);
+
   const char* GetTypeAsString( ) {
     switch (this->Type)
     {
@@ -60,6 +66,7 @@ private:
   void *TaskClientData;
 
   int Type;
+  int Priority;
 
 };
 #endif
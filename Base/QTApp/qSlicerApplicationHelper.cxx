@@ -21,6 +21,7 @@
 #include "qSlicerApplicationHelper.h"
 
 // Qt includes
+#include <QFileInfo>
 #include <QFont>
 #include <QLabel>
 #include <QSettings>
@@ -184,6 +185,8 @@ void qSlicerApplicationHelper::setupModuleFactoryManager(qSlicerModuleFactoryMan
 
     qSlicerCLIExecutableModuleFactory* cliExecutableFactory = new qSlicerCLIExecutableModuleFactory();
     cliExecutableFactory->setTempDirectory(tempDirectory);
+    cliExecutableFactory->setXmlDescriptionCacheFilePath(
+      QFileInfo(app->cachePath(), "CLIModuleCache/CLIModuleXmlDescriptions.json").absoluteFilePath());
     moduleFactoryManager->registerFactory(cliExecutableFactory, preferExecutableCLIs ? 1 : 0);
 
     if (!options->disableBuiltInModules() &&
@@ -217,6 +220,7 @@ void qSlicerApplicationHelper::setupModuleFactoryManager(qSlicerModuleFactoryMan
   moduleFactoryManager->setModulesToIgnore(modulesToIgnore);
 
   moduleFactoryManager->setVerboseModuleDiscovery(app->commandOptions()->verboseModuleDiscovery());
+  moduleFactoryManager->setProfileModuleStartup(app->commandOptions()->profileModuleStartup());
 }
 
 //----------------------------------------------------------------------------
@@ -306,6 +306,10 @@ int qSlicerApplicationHelper::postInitializeApplication(
   {
     qDebug() << "Number of loaded modules:" << moduleManager->modulesNames().count();
   }
+  if (app.commandOptions()->profileModuleStartup())
+  {
+    qDebug().noquote() << moduleFactoryManager->moduleStartupTimeReport();
+  }
 
   splashMessage(splashScreen, QString());
 
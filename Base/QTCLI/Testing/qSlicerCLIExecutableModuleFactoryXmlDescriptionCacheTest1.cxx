@@ -0,0 +1,156 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+// Slicer includes
+#include <qSlicerAbstractCoreModule.h>
+#include <qSlicerCLIExecutableModuleFactory.h>
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+/// Create an executable that prints its XML description and counts how many times it was run.
+bool writeExecutable(const QString& executablePath, const QString& runLogFilePath)
+{
+  QFile executable(executablePath);
+  if (!executable.open(QIODevice::WriteOnly | QIODevice::Text))
+  {
+    return false;
+  }
+  QTextStream stream(&executable);
+  stream << "#!/bin/sh\n"
+    << "echo run >> \"" << runLogFilePath << "\"\n"
+    << "cat << 'EOF'\n"
+    << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    << "<executable>\n"
+    << "  <category>Testing</category>\n"
+    << "  <title>XML Description Cache Test</title>\n"
+    << "  <description>Command line module used to test the XML description cache.</description>\n"
+    << "  <version>0.0.1</version>\n"
+    << "  <parameters>\n"
+    << "    <label>Test Settings</label>\n"
+    << "    <integer>\n"
+    << "      <name>InputValue</name>\n"
+    << "      <label>Input Value</label>\n"
+    << "      <longflag>--inputvalue</longflag>\n"
+    << "      <description>Input value</description>\n"
+    << "      <default>1</default>\n"
+    << "    </integer>\n"
+    << "  </parameters>\n"
+    << "</executable>\n"
+    << "EOF\n";
+  stream.flush();
+  executable.close();
+  return executable.setPermissions(executable.permissions()
+    | QFileDevice::ExeOwner | QFileDevice::ExeUser | QFileDevice::ReadOwner | QFileDevice::ReadUser);
+}
+
+//-----------------------------------------------------------------------------
+int numberOfRuns(const QString& runLogFilePath)
+{
+  QFile runLog(runLogFilePath);
+  if (!runLog.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    return 0;
+  }
+  return QString(runLog.readAll()).split('\n', Qt::SkipEmptyParts).size();
+}
+
+//-----------------------------------------------------------------------------
+/// Register and instantiate the module in a new factory, as it is done at each application startup.
+bool registerAndInstantiateModule(const QString& executablePath, const QString& cacheFilePath)
+{
+  qSlicerCLIExecutableModuleFactory factory;
+  factory.setXmlDescriptionCacheFilePath(cacheFilePath);
+  QString moduleName = factory.registerFileItem(QFileInfo(executablePath));
+  if (moduleName.isEmpty())
+  {
+    std::cerr << "Failed to register " << qPrintable(executablePath) << std::endl;
+    return false;
+  }
+  qSlicerAbstractCoreModule* module = factory.instantiate(moduleName);
+  if (!module)
+  {
+    std::cerr << "Failed to instantiate " << qPrintable(moduleName) << std::endl;
+    return false;
+  }
+  bool success = (module->title() == "XML Description Cache Test");
+  factory.uninstantiate(moduleName);
+  return success;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int qSlicerCLIExecutableModuleFactoryXmlDescriptionCacheTest1(int argc, char* argv[])
+{
+#ifdef Q_OS_WIN
+  Q_UNUSED(argc);
+  Q_UNUSED(argv);
+  std::cout << "Test requires a shell script executable, skip test." << std::endl;
+  return EXIT_SUCCESS;
+#else
+  QCoreApplication app(argc, argv);
+
+  QTemporaryDir tempDir;
+  CHECK_BOOL(tempDir.isValid(), true);
+  // There is no XML file next to the executable
+  QString executablePath = QDir(tempDir.path()).filePath("XmlDescriptionCacheTest");
+  QString runLogFilePath = QDir(tempDir.path()).filePath("XmlDescriptionCacheTestRuns.txt");
+  QString cacheFilePath = QDir(tempDir.path()).filePath("CLIModuleCache/CLIModuleXmlDescriptions.json");
+  CHECK_BOOL(writeExecutable(executablePath, runLogFilePath), true);
+
+  // First registration runs the executable and stores the description
+  CHECK_BOOL(registerAndInstantiateModule(executablePath, cacheFilePath), true);
+  CHECK_INT(numberOfRuns(runLogFilePath), 1);
+  CHECK_BOOL(QFileInfo::exists(cacheFilePath), true);
+
+  // Second registration uses the cached description, without running the executable
+  CHECK_BOOL(registerAndInstantiateModule(executablePath, cacheFilePath), true);
+  CHECK_INT(numberOfRuns(runLogFilePath), 1);
+
+  // Touching the executable invalidates the cached description
+  {
+    QFile executable(executablePath);
+    CHECK_BOOL(executable.open(QIODevice::ReadWrite), true);
+    QDateTime lastModified = QFileInfo(executablePath).lastModified();
+    CHECK_BOOL(executable.setFileTime(lastModified.addSecs(10), QFileDevice::FileModificationTime), true);
+  }
+  CHECK_BOOL(registerAndInstantiateModule(executablePath, cacheFilePath), true);
+  CHECK_INT(numberOfRuns(runLogFilePath), 2);
+
+  // The updated description is used from the cache again
+  CHECK_BOOL(registerAndInstantiateModule(executablePath, cacheFilePath), true);
+  CHECK_INT(numberOfRuns(runLogFilePath), 2);
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+#endif
+}
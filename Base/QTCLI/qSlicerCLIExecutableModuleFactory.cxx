@@ -19,8 +19,15 @@
 ==============================================================================*/
 
 // Qt includes
+#include <QDateTime>
+#include <QDebug>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QProcess>
+#include <QSaveFile>
 #include <QStandardPaths>
+#include <QThread>
 
 // Slicer includes
 #include "qSlicerCLIExecutableModuleFactory.h"
@@ -47,17 +54,397 @@ QString findPython()
 
 }
 
+//-----------------------------------------------------------------------------
+// qSlicerCLIExecutableModuleXmlDescriptionCache
+
+//-----------------------------------------------------------------------------
+/// \brief Retrieve XML descriptions of CLI executables.
+///
+/// Executables are run with "--xml" in the background, several at a time,
+/// as soon as they are registered, so that their output is ready (or
+/// almost ready) by the time the modules are instantiated.
+/// Descriptions are stored in a file, keyed by the executable path, and
+/// reused as long as the size and modification time of the executable are
+/// unchanged.
+class qSlicerCLIExecutableModuleXmlDescriptionCache
+{
+public:
+  struct Result
+  {
+    QString XmlDescription;
+    QStringList ErrorStrings;
+    QStringList WarningStrings;
+  };
+
+  qSlicerCLIExecutableModuleXmlDescriptionCache();
+  ~qSlicerCLIExecutableModuleXmlDescriptionCache();
+
+  void setCacheFilePath(const QString& filePath);
+  QString cacheFilePath()const;
+
+  /// Start running the executable in the background, unless its
+  /// description is already cached or requested.
+  void requestDescription(const QString& executablePath);
+
+  /// Return the description of the executable. Waits for the process to
+  /// finish (it is started first if needed).
+  Result description(const QString& executablePath);
+
+protected:
+  struct RunningProcess
+  {
+    QString ExecutablePath;
+    QProcess* Process;
+  };
+
+  QJsonObject cacheEntry(const QString& executablePath);
+  bool hasCachedDescription(const QString& executablePath);
+  void loadCache();
+  void saveCache();
+
+  void startProcesses();
+  void finishProcess(int runningProcessIndex);
+  int runningProcessIndex(const QString& executablePath)const;
+
+  QString CacheFilePath;
+  bool CacheLoaded{false};
+  bool CacheModified{false};
+  QJsonObject Cache;
+
+  int MaximumNumberOfRunningProcesses;
+  int ProcessTimeoutInMs{5000};
+  QStringList QueuedExecutablePaths;
+  QList<RunningProcess> RunningProcesses;
+  QHash<QString, Result> Results;
+};
+
+//-----------------------------------------------------------------------------
+qSlicerCLIExecutableModuleXmlDescriptionCache::qSlicerCLIExecutableModuleXmlDescriptionCache()
+{
+  this->MaximumNumberOfRunningProcesses = qMax(1, QThread::idealThreadCount());
+}
+
+//-----------------------------------------------------------------------------
+qSlicerCLIExecutableModuleXmlDescriptionCache::~qSlicerCLIExecutableModuleXmlDescriptionCache()
+{
+  foreach(const RunningProcess& runningProcess, this->RunningProcesses)
+  {
+    runningProcess.Process->kill();
+    runningProcess.Process->waitForFinished(1000);
+    delete runningProcess.Process;
+  }
+  this->RunningProcesses.clear();
+  if (this->CacheModified)
+  {
+    this->saveCache();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleXmlDescriptionCache::setCacheFilePath(const QString& filePath)
+{
+  if (this->CacheFilePath == filePath)
+  {
+    return;
+  }
+  this->CacheFilePath = filePath;
+  this->CacheLoaded = false;
+  this->CacheModified = false;
+  this->Cache = QJsonObject();
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIExecutableModuleXmlDescriptionCache::cacheFilePath()const
+{
+  return this->CacheFilePath;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleXmlDescriptionCache::loadCache()
+{
+  if (this->CacheLoaded)
+  {
+    return;
+  }
+  this->CacheLoaded = true;
+  if (this->CacheFilePath.isEmpty())
+  {
+    return;
+  }
+  QFile cacheFile(this->CacheFilePath);
+  if (!cacheFile.open(QIODevice::ReadOnly))
+  {
+    return;
+  }
+  QJsonDocument document = QJsonDocument::fromJson(cacheFile.readAll());
+  if (document.isObject())
+  {
+    this->Cache = document.object();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleXmlDescriptionCache::saveCache()
+{
+  if (this->CacheFilePath.isEmpty())
+  {
+    return;
+  }
+  // Forget executables that have been removed
+  foreach(const QString& executablePath, this->Cache.keys())
+  {
+    if (!QFileInfo::exists(executablePath))
+    {
+      this->Cache.remove(executablePath);
+    }
+  }
+  QDir().mkpath(QFileInfo(this->CacheFilePath).absolutePath());
+  QSaveFile cacheFile(this->CacheFilePath);
+  if (!cacheFile.open(QIODevice::WriteOnly))
+  {
+    qWarning() << "Failed to write CLI module description cache file" << this->CacheFilePath;
+    return;
+  }
+  cacheFile.write(QJsonDocument(this->Cache).toJson(QJsonDocument::Compact));
+  if (!cacheFile.commit())
+  {
+    qWarning() << "Failed to write CLI module description cache file" << this->CacheFilePath;
+    return;
+  }
+  this->CacheModified = false;
+}
+
+//-----------------------------------------------------------------------------
+QJsonObject qSlicerCLIExecutableModuleXmlDescriptionCache::cacheEntry(const QString& executablePath)
+{
+  this->loadCache();
+  QJsonObject entry = this->Cache.value(executablePath).toObject();
+  if (entry.isEmpty())
+  {
+    return QJsonObject();
+  }
+  QFileInfo executableInfo(executablePath);
+  if (entry.value("lastModified").toDouble() != executableInfo.lastModified().toMSecsSinceEpoch()
+    || entry.value("size").toDouble() != executableInfo.size())
+  {
+    return QJsonObject();
+  }
+  return entry;
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerCLIExecutableModuleXmlDescriptionCache::hasCachedDescription(const QString& executablePath)
+{
+  return !this->cacheEntry(executablePath).isEmpty();
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerCLIExecutableModuleXmlDescriptionCache::runningProcessIndex(const QString& executablePath)const
+{
+  for (int index = 0; index < this->RunningProcesses.size(); ++index)
+  {
+    if (this->RunningProcesses[index].ExecutablePath == executablePath)
+    {
+      return index;
+    }
+  }
+  return -1;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleXmlDescriptionCache::requestDescription(const QString& executablePath)
+{
+  if (this->hasCachedDescription(executablePath)
+    || this->Results.contains(executablePath)
+    || this->QueuedExecutablePaths.contains(executablePath)
+    || this->runningProcessIndex(executablePath) >= 0)
+  {
+    return;
+  }
+  this->QueuedExecutablePaths << executablePath;
+
+  // Collect processes that already completed to free their slot
+  for (int index = this->RunningProcesses.size() - 1; index >= 0; --index)
+  {
+    if (this->RunningProcesses[index].Process->waitForFinished(0))
+    {
+      this->finishProcess(index);
+    }
+  }
+  this->startProcesses();
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleXmlDescriptionCache::startProcesses()
+{
+  while (!this->QueuedExecutablePaths.isEmpty()
+    && this->RunningProcesses.size() < this->MaximumNumberOfRunningProcesses)
+  {
+    QString executablePath = this->QueuedExecutablePaths.takeFirst();
+    QProcess* process = new QProcess;
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert("ITK_AUTOLOAD_PATH", "");
+    process->setProcessEnvironment(env);
+    process->setWorkingDirectory(QFileInfo(executablePath).path());
+    process->start(executablePath, QStringList(QString("--xml")));
+    RunningProcess runningProcess = { executablePath, process };
+    this->RunningProcesses << runningProcess;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleXmlDescriptionCache::finishProcess(int runningProcessIndex)
+{
+  RunningProcess runningProcess = this->RunningProcesses.takeAt(runningProcessIndex);
+  QScopedPointer<QProcess> cli(runningProcess.Process);
+  const QString& executablePath = runningProcess.ExecutablePath;
+  Result& result = this->Results[executablePath];
+
+  bool res = cli->waitForFinished(this->ProcessTimeoutInMs);
+  if (!res)
+  {
+    result.ErrorStrings << qSlicerCLIModule::tr("CLI executable: %1").arg(executablePath);
+    QString errorString;
+    switch(cli->error())
+    {
+      case QProcess::FailedToStart:
+        errorString = qSlicerCLIModule::tr(
+              "The process failed to start. Either the invoked program is missing, or "
+              "you may have insufficient permissions to invoke the program.");
+        break;
+      case QProcess::Crashed:
+        errorString = qSlicerCLIModule::tr(
+              "The process crashed some time after starting successfully.");
+        break;
+      case QProcess::Timedout:
+        errorString = qSlicerCLIModule::tr(
+              "The process timed out after %1 msecs.").arg(this->ProcessTimeoutInMs);
+        break;
+      case QProcess::WriteError:
+        errorString = qSlicerCLIModule::tr(
+              "An error occurred when attempting to read from the process. "
+              "For example, the process may not be running.");
+        break;
+      case QProcess::ReadError:
+        errorString = qSlicerCLIModule::tr(
+              "An error occurred when attempting to read from the process. "
+              "For example, the process may not be running.");
+        break;
+      case QProcess::UnknownError:
+        errorString = qSlicerCLIModule::tr(
+              "Failed to execute process. An unknown error occurred.");
+        break;
+    }
+    result.ErrorStrings << errorString;
+    if (cli->state() != QProcess::NotRunning)
+    {
+      cli->kill();
+      cli->waitForFinished(1000);
+    }
+    return;
+  }
+  QString errors = cli->readAllStandardError();
+  if (!errors.isEmpty())
+  {
+    result.ErrorStrings << qSlicerCLIModule::tr("CLI executable: %1").arg(executablePath);
+    result.ErrorStrings << errors;
+    // TODO: More investigation for the following behavior:
+    // on my machine (Ubuntu 10.04 with ITKv4), having standard error trims the
+    // standard output results. The following readAllStandardOutput() is then
+    // missing chars and makes the XML invalid. I'm not sure if it's just on my
+    // machine so there is a chance it succeeds to parse the XML description
+    // on other machines.
+  }
+  QString xmlDescription = cli->readAllStandardOutput();
+  if (xmlDescription.isEmpty())
+  {
+    result.ErrorStrings << qSlicerCLIModule::tr("CLI executable: %1").arg(executablePath);
+    result.ErrorStrings << qSlicerCLIModule::tr("Failed to retrieve XML Description");
+    return;
+  }
+  if (!xmlDescription.startsWith("<?xml"))
+  {
+    result.WarningStrings << qSlicerCLIModule::tr("CLI executable: %1").arg(executablePath);
+    result.WarningStrings << qSlicerCLIModule::tr("XML description doesn't start right away.");
+    result.WarningStrings << qSlicerCLIModule::tr("Output before '<?xml' is [%1]").arg(
+                               xmlDescription.mid(0, xmlDescription.indexOf("<?xml")));
+    xmlDescription.remove(0, xmlDescription.indexOf("<?xml"));
+  }
+  result.XmlDescription = xmlDescription;
+
+  // Only clean descriptions are cached, so that errors and warnings are
+  // reported again in the next session.
+  if (result.ErrorStrings.isEmpty() && result.WarningStrings.isEmpty())
+  {
+    this->loadCache();
+    QFileInfo executableInfo(executablePath);
+    QJsonObject entry;
+    entry["lastModified"] = static_cast<double>(executableInfo.lastModified().toMSecsSinceEpoch());
+    entry["size"] = static_cast<double>(executableInfo.size());
+    entry["xml"] = xmlDescription;
+    this->Cache[executablePath] = entry;
+    this->CacheModified = true;
+  }
+}
+
+//-----------------------------------------------------------------------------
+qSlicerCLIExecutableModuleXmlDescriptionCache::Result
+qSlicerCLIExecutableModuleXmlDescriptionCache::description(const QString& executablePath)
+{
+  if (!this->Results.contains(executablePath))
+  {
+    QJsonObject entry = this->cacheEntry(executablePath);
+    if (!entry.isEmpty())
+    {
+      Result result;
+      result.XmlDescription = entry.value("xml").toString();
+      return result;
+    }
+
+    int index = this->runningProcessIndex(executablePath);
+    if (index < 0)
+    {
+      // Start the process right away, ahead of the other queued executables
+      this->QueuedExecutablePaths.removeAll(executablePath);
+      this->QueuedExecutablePaths.prepend(executablePath);
+      while (this->RunningProcesses.size() >= this->MaximumNumberOfRunningProcesses)
+      {
+        this->finishProcess(0);
+      }
+      this->startProcesses();
+      index = this->runningProcessIndex(executablePath);
+    }
+    this->finishProcess(index);
+    this->startProcesses();
+  }
+
+  if (this->CacheModified && this->QueuedExecutablePaths.isEmpty() && this->RunningProcesses.isEmpty())
+  {
+    this->saveCache();
+  }
+  return this->Results.take(executablePath);
+}
+
+//-----------------------------------------------------------------------------
+// qSlicerCLIExecutableModuleFactoryItem
+
 //-----------------------------------------------------------------------------
 qSlicerCLIExecutableModuleFactoryItem::qSlicerCLIExecutableModuleFactoryItem(
-  const QString& newTempDirectory)
+  const QString& newTempDirectory,
+  const QSharedPointer<qSlicerCLIExecutableModuleXmlDescriptionCache>& xmlDescriptionCache)
   : TempDirectory(newTempDirectory)
   , CLIModule(nullptr)
+  , XmlDescriptionCache(xmlDescriptionCache)
 {
 }
 
 //-----------------------------------------------------------------------------
 bool qSlicerCLIExecutableModuleFactoryItem::load()
 {
+  if (!this->XmlDescriptionCache.isNull() && !QFile::exists(this->xmlModuleDescriptionFilePath()))
+  {
+    this->XmlDescriptionCache->requestDescription(this->path());
+  }
   return true;
 }
 
@@ -137,86 +524,30 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
 //-----------------------------------------------------------------------------
 QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
 {
-  ctkScopedCurrentDir scopedCurrentDir(QFileInfo(this->path()).path());
-
-  int cliProcessTimeoutInMs = 5000;
-  QProcess cli;
-  QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-  env.insert("ITK_AUTOLOAD_PATH", "");
-  cli.setProcessEnvironment(env);
-  cli.start(this->path(), QStringList(QString("--xml")));
-  bool res = cli.waitForFinished(cliProcessTimeoutInMs);
-  if (!res)
-  {
-    this->appendInstantiateErrorString(qSlicerCLIModule::tr("CLI executable: %1").arg(this->path()));
-    QString errorString;
-    switch(cli.error())
-    {
-      case QProcess::FailedToStart:
-        errorString = qSlicerCLIModule::tr(
-              "The process failed to start. Either the invoked program is missing, or "
-              "you may have insufficient permissions to invoke the program.");
-        break;
-      case QProcess::Crashed:
-        errorString = qSlicerCLIModule::tr(
-              "The process crashed some time after starting successfully.");
-        break;
-      case QProcess::Timedout:
-        errorString = qSlicerCLIModule::tr(
-              "The process timed out after %1 msecs.").arg(cliProcessTimeoutInMs);
-        break;
-      case QProcess::WriteError:
-        errorString = qSlicerCLIModule::tr(
-              "An error occurred when attempting to read from the process. "
-              "For example, the process may not be running.");
-        break;
-      case QProcess::ReadError:
-        errorString = qSlicerCLIModule::tr(
-              "An error occurred when attempting to read from the process. "
-              "For example, the process may not be running.");
-        break;
-      case QProcess::UnknownError:
-        errorString = qSlicerCLIModule::tr(
-              "Failed to execute process. An unknown error occurred.");
-        break;
-    }
-    this->appendInstantiateErrorString(errorString);
-    return nullptr;
-  }
-  QString errors = cli.readAllStandardError();
-  if (!errors.isEmpty())
+  QSharedPointer<qSlicerCLIExecutableModuleXmlDescriptionCache> xmlDescriptionCache = this->XmlDescriptionCache;
+  if (xmlDescriptionCache.isNull())
   {
-    this->appendInstantiateErrorString(qSlicerCLIModule::tr("CLI executable: %1").arg(this->path()));
-    this->appendInstantiateErrorString(errors);
-    // TODO: More investigation for the following behavior:
-    // on my machine (Ubuntu 10.04 with ITKv4), having standard error trims the
-    // standard output results. The following readAllStandardOutput() is then
-    // missing chars and makes the XML invalid. I'm not sure if it's just on my
-    // machine so there is a chance it succeeds to parse the XML description
-    // on other machines.
+    xmlDescriptionCache.reset(new qSlicerCLIExecutableModuleXmlDescriptionCache);
   }
-  QString xmlDescription = cli.readAllStandardOutput();
-  if (xmlDescription.isEmpty())
+  qSlicerCLIExecutableModuleXmlDescriptionCache::Result result = xmlDescriptionCache->description(this->path());
+  foreach(const QString& errorString, result.ErrorStrings)
   {
-    this->appendInstantiateErrorString(qSlicerCLIModule::tr("CLI executable: %1").arg(this->path()));
-    this->appendInstantiateErrorString(qSlicerCLIModule::tr("Failed to retrieve XML Description"));
-    return QString();
+    this->appendInstantiateErrorString(errorString);
   }
-  if (!xmlDescription.startsWith("<?xml"))
+  foreach(const QString& warningString, result.WarningStrings)
   {
-    this->appendInstantiateWarningString(qSlicerCLIModule::tr("CLI executable: %1").arg(this->path()));
-    this->appendInstantiateWarningString(qSlicerCLIModule::tr("XML description doesn't start right away."));
-    this->appendInstantiateWarningString(qSlicerCLIModule::tr("Output before '<?xml' is [%1]").arg(
-                                           xmlDescription.mid(0, xmlDescription.indexOf("<?xml"))));
-    xmlDescription.remove(0, xmlDescription.indexOf("<?xml"));
+    this->appendInstantiateWarningString(warningString);
   }
-  return xmlDescription;
+  return result.XmlDescription;
 }
 
 //-----------------------------------------------------------------------------
 void qSlicerCLIExecutableModuleFactoryItem::uninstantiate()
 {
-  this->CLIModule->cliModuleLogic()->KillProcesses();
+  if (this->CLIModule && this->CLIModule->cliModuleLogic())
+  {
+    this->CLIModule->cliModuleLogic()->KillProcesses();
+  }
   this->ctkAbstractFactoryFileBasedItem<qSlicerAbstractCoreModule>::uninstantiate();
 }
 
@@ -235,6 +566,7 @@ public:
 
 private:
   QString TempDirectory;
+  QSharedPointer<qSlicerCLIExecutableModuleXmlDescriptionCache> XmlDescriptionCache;
 };
 
 //-----------------------------------------------------------------------------
@@ -242,6 +574,7 @@ qSlicerCLIExecutableModuleFactoryPrivate::qSlicerCLIExecutableModuleFactoryPriva
 :q_ptr(&object)
 {
   this->TempDirectory = QDir::tempPath();
+  this->XmlDescriptionCache.reset(new qSlicerCLIExecutableModuleXmlDescriptionCache);
 }
 
 //-----------------------------------------------------------------------------
@@ -285,7 +618,7 @@ ctkAbstractFactoryItem<qSlicerAbstractCoreModule>* qSlicerCLIExecutableModuleFac
 ::createFactoryFileBasedItem()
 {
   Q_D(qSlicerCLIExecutableModuleFactory);
-  return new qSlicerCLIExecutableModuleFactoryItem(d->TempDirectory);
+  return new qSlicerCLIExecutableModuleFactoryItem(d->TempDirectory, d->XmlDescriptionCache);
 }
 
 //-----------------------------------------------------------------------------
@@ -300,3 +633,17 @@ void qSlicerCLIExecutableModuleFactory::setTempDirectory(const QString& newTempD
   Q_D(qSlicerCLIExecutableModuleFactory);
   d->TempDirectory = newTempDirectory;
 }
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactory::setXmlDescriptionCacheFilePath(const QString& filePath)
+{
+  Q_D(qSlicerCLIExecutableModuleFactory);
+  d->XmlDescriptionCache->setCacheFilePath(filePath);
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIExecutableModuleFactory::xmlDescriptionCacheFilePath()const
+{
+  Q_D(const qSlicerCLIExecutableModuleFactory);
+  return d->XmlDescriptionCache->cacheFilePath();
+}
@@ -21,10 +21,14 @@
 #ifndef __qSlicerCLIExecutableModuleFactory_h
 #define __qSlicerCLIExecutableModuleFactory_h
 
+// Qt includes
+#include <QSharedPointer>
+
 // Slicer includes
 #include "qSlicerAbstractCoreModule.h"
 #include "qSlicerBaseQTCLIExport.h"
 class qSlicerCLIModule;
+class qSlicerCLIExecutableModuleXmlDescriptionCache;
 
 // CTK includes
 #include <ctkPimpl.h>
@@ -35,7 +39,11 @@ class qSlicerCLIExecutableModuleFactoryItem
   : public ctkAbstractFactoryFileBasedItem<qSlicerAbstractCoreModule>
 {
 public:
-  qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory);
+  qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory,
+    const QSharedPointer<qSlicerCLIExecutableModuleXmlDescriptionCache>& xmlDescriptionCache =
+      QSharedPointer<qSlicerCLIExecutableModuleXmlDescriptionCache>());
+  /// Start retrieving the XML description of the executable in the background
+  /// if there is no XML file next to the executable.
   bool load() override;
   void uninstantiate() override;
 protected:
@@ -43,10 +51,14 @@ protected:
   QString xmlModuleDescriptionFilePath();
 
   qSlicerAbstractCoreModule* instanciator() override;
+  /// Return the XML description printed by the executable when it is run with "--xml".
+  /// The description is retrieved from the cache if the executable has not been modified
+  /// since it was last run.
   QString runCLIWithXmlArgument();
 private:
   QString TempDirectory;
   qSlicerCLIModule* CLIModule;
+  QSharedPointer<qSlicerCLIExecutableModuleXmlDescriptionCache> XmlDescriptionCache;
 };
 
 class qSlicerCLIExecutableModuleFactoryPrivate;
@@ -71,6 +83,13 @@ public:
 
   void setTempDirectory(const QString& newTempDirectory);
 
+  /// Set the file where XML descriptions retrieved by running the executables
+  /// with "--xml" are stored between application sessions. Descriptions are
+  /// invalidated when the size or modification time of the executable changes.
+  /// If empty (default) then descriptions are not stored.
+  void setXmlDescriptionCacheFilePath(const QString& filePath);
+  QString xmlDescriptionCacheFilePath()const;
+
 protected:
   bool isValidFile(const QFileInfo& file)const override;
 
@@ -104,6 +104,11 @@ vtkMRMLAbstractLogic* qSlicerCLIModule::createLogic()
     logic->SetAllowInMemoryTransfer(0);
   }
 
+  if (d->Desc.GetParameterValue("AllowSharedMemoryTransfer") == "true")
+  {
+    logic->SetAllowSharedMemoryTransfer(1);
+  }
+
   return logic;
 }
 
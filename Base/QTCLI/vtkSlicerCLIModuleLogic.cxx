@@ -29,13 +29,20 @@
 #include <vtkMRMLStorageNode.h>
 #include <vtkMRMLModelStorageNode.h>
 #include <vtkMRMLTransformNode.h>
+#include <vtkMRMLVolumeNode.h>
+
+// MRMLIDImageIO includes
+#include <itkMRMLSharedMemoryImageIO.h>
 
 // VTK includes
 #include <vtkCallbackCommand.h>
+#include <vtkImageData.h>
 #include <vtkIntArray.h>
+#include <vtkMatrix4x4.h>
 #include <vtkMultiThreader.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkPointData.h>
 #include <vtkStringArray.h>
 #include <vtksys/SystemTools.hxx>
 
@@ -46,11 +53,14 @@
 
 // STL includes
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <ctime>
+#include <iomanip>
 #include <mutex>
 #include <random>
 #include <set>
+#include <sstream>
 
 #ifdef _WIN32
 #else
@@ -75,6 +85,70 @@ struct DigitsToCharacters
 typedef std::pair<vtkSlicerCLIModuleLogic *, vtkMRMLCommandLineModuleNode *> LogicNodePair;
 class MRMLIDMap : public std::map<std::string, std::string> {};
 
+//----------------------------------------------------------------------------
+/// Removes the shared memory segments used by a CLI execution when going
+/// out of scope. Segments are always removed (even if temporary files are
+/// kept) because they would use memory until the system is restarted.
+struct SharedMemorySegmentRemover
+{
+  ~SharedMemorySegmentRemover()
+  {
+    for (const std::string& fileName : this->FileNames)
+    {
+      itk::MRMLSharedMemoryImageIO::RemoveSegment(fileName);
+    }
+  }
+  std::set<std::string> FileNames;
+};
+
+//----------------------------------------------------------------------------
+/// Serializes access to the ITK_AUTOLOAD_PATH environment variable of the application,
+/// which is temporarily modified while CLI processes are started from concurrent tasks.
+static std::mutex ITKAutoLoadPathLock;
+
+//----------------------------------------------------------------------------
+itk::ImageIOBase::IOComponentType VTKScalarTypeToITKComponentType(int scalarType)
+{
+  switch (scalarType)
+  {
+    case VTK_FLOAT: return itk::ImageIOBase::FLOAT;
+    case VTK_DOUBLE: return itk::ImageIOBase::DOUBLE;
+    case VTK_INT: return itk::ImageIOBase::INT;
+    case VTK_UNSIGNED_INT: return itk::ImageIOBase::UINT;
+    case VTK_SHORT: return itk::ImageIOBase::SHORT;
+    case VTK_UNSIGNED_SHORT: return itk::ImageIOBase::USHORT;
+    case VTK_LONG: return itk::ImageIOBase::LONG;
+    case VTK_UNSIGNED_LONG: return itk::ImageIOBase::ULONG;
+    case VTK_LONG_LONG: return itk::ImageIOBase::LONGLONG;
+    case VTK_UNSIGNED_LONG_LONG: return itk::ImageIOBase::ULONGLONG;
+    case VTK_CHAR: return itk::ImageIOBase::CHAR;
+    case VTK_SIGNED_CHAR: return itk::ImageIOBase::CHAR;
+    case VTK_UNSIGNED_CHAR: return itk::ImageIOBase::UCHAR;
+    default: return itk::ImageIOBase::UNKNOWNCOMPONENTTYPE;
+  }
+}
+
+//----------------------------------------------------------------------------
+int ITKComponentTypeToVTKScalarType(itk::ImageIOBase::IOComponentType componentType)
+{
+  switch (componentType)
+  {
+    case itk::ImageIOBase::FLOAT: return VTK_FLOAT;
+    case itk::ImageIOBase::DOUBLE: return VTK_DOUBLE;
+    case itk::ImageIOBase::INT: return VTK_INT;
+    case itk::ImageIOBase::UINT: return VTK_UNSIGNED_INT;
+    case itk::ImageIOBase::SHORT: return VTK_SHORT;
+    case itk::ImageIOBase::USHORT: return VTK_UNSIGNED_SHORT;
+    case itk::ImageIOBase::LONG: return VTK_LONG;
+    case itk::ImageIOBase::ULONG: return VTK_UNSIGNED_LONG;
+    case itk::ImageIOBase::LONGLONG: return VTK_LONG_LONG;
+    case itk::ImageIOBase::ULONGLONG: return VTK_UNSIGNED_LONG_LONG;
+    case itk::ImageIOBase::CHAR: return VTK_SIGNED_CHAR;
+    case itk::ImageIOBase::UCHAR: return VTK_UNSIGNED_CHAR;
+    default: return VTK_VOID;
+  }
+}
+
 //---------------------------------------------------------------------------
 class vtkSlicerCLIRescheduleCallback : public vtkCallbackCommand
 {
@@ -192,6 +266,10 @@ public:
   ModuleDescription DefaultModuleDescription;
   int DeleteTemporaryFiles;
   int AllowInMemoryTransfer;
+  int AllowSharedMemoryTransfer;
+
+  /// Used for making shared memory segment names unique across executions
+  std::atomic<unsigned int> SharedMemorySegmentCounter{0};
 
   int RedirectModuleStreams;
 
@@ -305,6 +383,7 @@ vtkSlicerCLIModuleLogic::vtkSlicerCLIModuleLogic()
 
   this->Internal->DeleteTemporaryFiles = 1;
   this->Internal->AllowInMemoryTransfer = 1;
+  this->Internal->AllowSharedMemoryTransfer = 0;
   this->Internal->RedirectModuleStreams = 1;
   this->Internal->RescheduleCallback =
     vtkSmartPointer<vtkSlicerCLIRescheduleCallback>::New();
@@ -408,6 +487,64 @@ int vtkSlicerCLIModuleLogic::GetAllowInMemoryTransfer() const
   return this->Internal->AllowInMemoryTransfer;
 }
 
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetAllowSharedMemoryTransfer(int value)
+{
+  vtkDebugMacro(<< this->GetClassName() << " (" << this << "): setting AllowSharedMemoryTransfer to " << value);
+  if (this->Internal->AllowSharedMemoryTransfer != value)
+  {
+    this->Internal->AllowSharedMemoryTransfer = value;
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetAllowSharedMemoryTransfer() const
+{
+  return this->Internal->AllowSharedMemoryTransfer;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerCLIModuleLogic::IsSharedMemoryTransferAvailable() const
+{
+  return this->GetAllowInMemoryTransfer()
+    && this->GetAllowSharedMemoryTransfer()
+    && itk::MRMLSharedMemoryImageIO::IsSupported()
+    && !vtkSlicerCLIModuleLogic::GetSharedMemoryPluginDirectory().empty();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkSlicerCLIModuleLogic::GetSharedMemoryPluginDirectory()
+{
+  std::string autoLoadPath;
+  {
+    std::lock_guard<std::mutex> lock(ITKAutoLoadPathLock);
+    if (!itksys::SystemTools::GetEnv("ITK_AUTOLOAD_PATH", autoLoadPath))
+    {
+      return std::string();
+    }
+  }
+#ifdef _WIN32
+  const char pathSeparator = ';';
+#else
+  const char pathSeparator = ':';
+#endif
+  std::vector<std::string> directories;
+  itksys::SystemTools::Split(autoLoadPath, directories, pathSeparator);
+  for (const std::string& directory : directories)
+  {
+    if (directory.empty())
+    {
+      continue;
+    }
+    std::string pluginDirectory = directory + "/SharedMemory";
+    if (itksys::SystemTools::FileIsDirectory(pluginDirectory))
+    {
+      return pluginDirectory;
+    }
+  }
+  return std::string();
+}
+
 //----------------------------------------------------------------------------
 void vtkSlicerCLIModuleLogic::RedirectModuleStreamsOn()
 {
@@ -484,6 +621,152 @@ vtkSlicerCLIModuleLogic
   return fname;
 }
 
+//----------------------------------------------------------------------------
+std::string vtkSlicerCLIModuleLogic::ConstructSharedMemoryFileName()
+{
+  // Segment names must be unique in the system: include the process id
+  // and a counter (a node may be used by CLIs running at the same time).
+  // Names are kept short (20 characters), as macOS limits them to 31 characters.
+  std::ostringstream segmentName;
+#ifdef _WIN32
+  unsigned long pid = GetCurrentProcessId();
+#else
+  unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+  segmentName << "/slc" << std::hex << std::setfill('0')
+    << std::setw(8) << (pid & 0xffffffffUL)
+    << std::setw(8) << (this->Internal->SharedMemorySegmentCounter++ & 0xffffffffU);
+  return itk::MRMLSharedMemoryImageIO::GetFileNamePrefix() + segmentName.str();
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerCLIModuleLogic::IsSharedMemoryTransferPossible(const std::string& type, vtkMRMLNode* node) const
+{
+  if (!node || type == "dynamic-contrast-enhanced" || type == "diffusion-weighted" || type == "tensor")
+  {
+    return false;
+  }
+  // Only plain image data is transferred, diffusion and other specialized
+  // volumes require additional metadata that is stored in files.
+  std::string className = node->GetClassName();
+  return className == "vtkMRMLScalarVolumeNode"
+    || className == "vtkMRMLLabelMapVolumeNode"
+    || className == "vtkMRMLVectorVolumeNode";
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerCLIModuleLogic::WriteVolumeToSharedMemory(vtkMRMLVolumeNode* volumeNode, const std::string& fileName)
+{
+  vtkImageData* imageData = volumeNode ? volumeNode->GetImageData() : nullptr;
+  if (!imageData || !imageData->GetPointData() || !imageData->GetPointData()->GetScalars())
+  {
+    vtkErrorMacro("WriteVolumeToSharedMemory: volume has no image data");
+    return false;
+  }
+  itk::ImageIOBase::IOComponentType componentType = VTKScalarTypeToITKComponentType(imageData->GetScalarType());
+  if (componentType == itk::ImageIOBase::UNKNOWNCOMPONENTTYPE)
+  {
+    vtkErrorMacro("WriteVolumeToSharedMemory: unsupported scalar type " << imageData->GetScalarTypeAsString());
+    return false;
+  }
+
+  itk::MRMLSharedMemoryImageIO::Pointer imageIO = itk::MRMLSharedMemoryImageIO::New();
+  imageIO->SetFileName(fileName);
+  imageIO->SetNumberOfDimensions(3);
+
+  // The node stores the geometry in RAS, ITK needs it in LPS
+  int* dimensions = imageData->GetDimensions();
+  double* spacing = volumeNode->GetSpacing();
+  double directions[3][3];
+  volumeNode->GetIJKToRASDirections(directions);
+  // The segment starts at the first voxel of the extent, which is not
+  // at the volume origin if the extent does not start at 0.
+  int* extent = imageData->GetExtent();
+  vtkNew<vtkMatrix4x4> ijkToRAS;
+  volumeNode->GetIJKToRASMatrix(ijkToRAS);
+  double extentStartIJK[4] = { static_cast<double>(extent[0]), static_cast<double>(extent[2]),
+    static_cast<double>(extent[4]), 1.0 };
+  double origin[4] = { 0.0, 0.0, 0.0, 1.0 };
+  ijkToRAS->MultiplyPoint(extentStartIJK, origin);
+  for (unsigned int axis = 0; axis < 3; ++axis)
+  {
+    imageIO->SetDimensions(axis, dimensions[axis]);
+    imageIO->SetSpacing(axis, spacing[axis]);
+    imageIO->SetOrigin(axis, axis < 2 ? -origin[axis] : origin[axis]);
+    std::vector<double> direction(3);
+    for (unsigned int row = 0; row < 3; ++row)
+    {
+      direction[row] = row < 2 ? -directions[row][axis] : directions[row][axis];
+    }
+    imageIO->SetDirection(axis, direction);
+  }
+  int numberOfComponents = imageData->GetNumberOfScalarComponents();
+  imageIO->SetNumberOfComponents(numberOfComponents);
+  imageIO->SetPixelType(numberOfComponents == 1 ? itk::ImageIOBase::SCALAR : itk::ImageIOBase::VECTOR);
+  imageIO->SetComponentType(componentType);
+
+  try
+  {
+    imageIO->WriteImageInformation();
+    imageIO->Write(imageData->GetScalarPointer());
+  }
+  catch (itk::ExceptionObject& exc)
+  {
+    vtkErrorMacro("WriteVolumeToSharedMemory: failed to write " << fileName << ": " << exc);
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerCLIModuleLogic::ReadVolumeFromSharedMemory(const std::string& fileName,
+  vtkImageData* imageData, vtkMatrix4x4* ijkToRAS)
+{
+  if (!imageData || !ijkToRAS)
+  {
+    vtkErrorMacro("ReadVolumeFromSharedMemory: invalid output");
+    return false;
+  }
+  itk::MRMLSharedMemoryImageIO::Pointer imageIO = itk::MRMLSharedMemoryImageIO::New();
+  imageIO->SetFileName(fileName);
+  try
+  {
+    imageIO->ReadImageInformation();
+    int scalarType = ITKComponentTypeToVTKScalarType(imageIO->GetComponentType());
+    if (scalarType == VTK_VOID)
+    {
+      vtkErrorMacro("ReadVolumeFromSharedMemory: unsupported component type in " << fileName);
+      return false;
+    }
+
+    // The segment stores the geometry in LPS, the node needs it in RAS
+    int dimensions[3] = { 1, 1, 1 };
+    ijkToRAS->Identity();
+    unsigned int numberOfDimensions = std::min(imageIO->GetNumberOfDimensions(), 3u);
+    for (unsigned int axis = 0; axis < numberOfDimensions; ++axis)
+    {
+      dimensions[axis] = static_cast<int>(imageIO->GetDimensions(axis));
+      std::vector<double> direction = imageIO->GetDirection(axis);
+      for (unsigned int row = 0; row < numberOfDimensions; ++row)
+      {
+        double value = direction[row] * imageIO->GetSpacing(axis);
+        ijkToRAS->SetElement(row, axis, row < 2 ? -value : value);
+      }
+      ijkToRAS->SetElement(axis, 3, axis < 2 ? -imageIO->GetOrigin(axis) : imageIO->GetOrigin(axis));
+    }
+
+    imageData->SetDimensions(dimensions);
+    imageData->AllocateScalars(scalarType, imageIO->GetNumberOfComponents());
+    imageIO->Read(imageData->GetScalarPointer());
+  }
+  catch (itk::ExceptionObject& exc)
+  {
+    vtkErrorMacro("ReadVolumeFromSharedMemory: failed to read " << fileName << ": " << exc);
+    return false;
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 std::string
 vtkSlicerCLIModuleLogic
@@ -907,6 +1190,14 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
   // vector of files to delete
   std::set<std::string> filesToDelete;
 
+  // Images are transferred to/from executables through shared memory
+  // segments if enabled. Segments are removed when leaving this method.
+  bool sharedMemoryTransferAvailable =
+    (commandType == CommandLineModule && this->IsSharedMemoryTransferAvailable());
+  SharedMemorySegmentRemover sharedMemorySegmentRemover;
+  // Temporary file used for an input image if its shared memory segment cannot be written
+  std::map<std::string, std::string> sharedMemoryFallbackFileNames;
+
   // iterators for parameter groups
   std::vector<ModuleParameterGroup>::iterator pgbeginit
     = node0->GetModuleDescription().GetParameterGroups().begin();
@@ -949,12 +1240,26 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
           continue;
         }
 
-        std::string fname
-          = this->ConstructTemporaryFileName((*pit).GetTag(),
-                                             (*pit).GetType(),
-                                             id,
-                                             (*pit).GetFileExtensions(),
-                                             commandType);
+        std::string fname;
+        if ((*pit).GetTag() == "image" && sharedMemoryTransferAvailable
+          && this->IsSharedMemoryTransferPossible((*pit).GetType(), this->GetMRMLScene()->GetNodeByID(id)))
+        {
+          fname = this->ConstructSharedMemoryFileName();
+          sharedMemorySegmentRemover.FileNames.insert(fname);
+          if ((*pit).GetChannel() == "input")
+          {
+            sharedMemoryFallbackFileNames[fname] = this->ConstructTemporaryFileName((*pit).GetTag(),
+              (*pit).GetType(), id, (*pit).GetFileExtensions(), commandType);
+          }
+        }
+        else
+        {
+          fname = this->ConstructTemporaryFileName((*pit).GetTag(),
+                                                   (*pit).GetType(),
+                                                   id,
+                                                   (*pit).GetFileExtensions(),
+                                                   commandType);
+        }
 
         filesToDelete.insert(fname);
         if ((*pit).GetChannel() == "input")
@@ -1005,7 +1310,7 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
   MemoryTransferPossible.insert("vtkMRMLDiffusionWeightedVolumeNode");
   MemoryTransferPossible.insert("vtkMRMLDiffusionTensorVolumeNode");
 
-  MRMLIDToFileNameMap::const_iterator id2fn0;
+  MRMLIDToFileNameMap::iterator id2fn0;
 
   for (id2fn0 = nodesToWrite.begin();
        id2fn0 != nodesToWrite.end();
@@ -1110,6 +1415,27 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
       this->AddCompleteModelHierarchyToMiniScene(miniscene.GetPointer(), mhnd, &sceneToMiniSceneMap, filesToDelete);
     }
 
+    // Images transferred through shared memory are published in a segment
+    // instead of being written to a file
+    if (itk::MRMLSharedMemoryImageIO::IsSharedMemoryFileName((*id2fn0).second))
+    {
+      if (this->WriteVolumeToSharedMemory(vtkMRMLVolumeNode::SafeDownCast(nd), (*id2fn0).second))
+      {
+        out = nullptr;
+      }
+      else
+      {
+        // The segment could not be created (for example, shared memory is full),
+        // pass the volume in a temporary file instead. The command line is built
+        // from nodesToWrite, so it refers to the file.
+        std::string fallbackFileName = sharedMemoryFallbackFileNames[(*id2fn0).second];
+        vtkWarningMacro("Failed to write shared memory segment " << (*id2fn0).second
+          << ", using temporary file " << fallbackFileName << " instead");
+        (*id2fn0).second = fallbackFileName;
+        filesToDelete.insert(fallbackFileName);
+      }
+    }
+
     // if the file is to be written, then write it
     if (out)
     {
@@ -1774,9 +2100,18 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
     // statically linked to the executable.
     // Historically, there was an nvidia driver bug that causes the module
     // to fail on exit with undefined symbol.
+    // If images are transferred through shared memory segments then only
+    // the MRMLSharedMemoryIOPlugin plugin is loaded, which only depends on ITK.
+    // The environment is shared by all tasks, so it is modified and restored
+    // while holding a lock until the process is started.
+     std::string emptyString("ITK_AUTOLOAD_PATH=");
+     if (!sharedMemorySegmentRemover.FileNames.empty())
+     {
+       emptyString += vtkSlicerCLIModuleLogic::GetSharedMemoryPluginDirectory();
+     }
+     std::unique_lock<std::mutex> autoLoadPathLock(ITKAutoLoadPathLock);
      std::string saveITKAutoLoadPath;
      itksys::SystemTools::GetEnv("ITK_AUTOLOAD_PATH", saveITKAutoLoadPath);
-     std::string emptyString("ITK_AUTOLOAD_PATH=");
      int putSuccess =
        itksys::SystemTools::PutEnv(const_cast <char *> (emptyString.c_str()));
      if (!putSuccess)
@@ -1788,7 +2123,9 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
     //
     itksysProcess *process = itksysProcess_New();
 
+    this->Internal->ProcessesKillLock.lock();
     this->Internal->Processes.push_back(process);
+    this->Internal->ProcessesKillLock.unlock();
 
     // setup the command
     itksysProcess_SetCommand(process, command);
@@ -1810,6 +2147,7 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
     {
       vtkErrorMacro( "Unable to restore ITK_AUTOLOAD_PATH. ");
     }
+    autoLoadPathLock.unlock();
 
     // Wait for the command to finish
     char *tbuffer;
@@ -1838,8 +2176,10 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
       if (node0->GetModuleDescription().GetProcessInformation()->Abort)
       {
         itksysProcess_Kill(process);
+        this->Internal->ProcessesKillLock.lock();
         this->Internal->Processes.erase(
               std::find(this->Internal->Processes.begin(), this->Internal->Processes.end(), process));
+        this->Internal->ProcessesKillLock.unlock();
         node0->GetModuleDescription().GetProcessInformation()->Progress = 0;
         node0->GetModuleDescription().GetProcessInformation()->StageProgress =0;
         this->GetApplicationLogic()->RequestModified( node0 );
@@ -2174,16 +2514,36 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
           displayData=false;
         }
 
-        bool deleteFile = this->GetDeleteTemporaryFiles();
-        vtkMTimeType requestUID = this->GetApplicationLogic()
-          ->RequestReadFile((*id2fn0).first.c_str(), (*id2fn0).second.c_str(),
-                            displayData, deleteFile);
-        this->Internal->SetLastRequest(node0, requestUID);
-
-        // If we are reloading a file, then we know that it is a file
-        // that needs to be removed.  It wouldn't make sense for two
-        // outputs of a module to produce the same file to be reloaded.
-        filesToDelete.erase( (*id2fn0).second );
+        if (itk::MRMLSharedMemoryImageIO::IsSharedMemoryFileName((*id2fn0).second))
+        {
+          // Read the segment in this thread, only setting the image on the
+          // node is done in the main thread. The segment is removed on exit.
+          vtkNew<vtkImageData> imageData;
+          vtkNew<vtkMatrix4x4> ijkToRAS;
+          if (this->ReadVolumeFromSharedMemory((*id2fn0).second, imageData, ijkToRAS))
+          {
+            vtkMTimeType requestUID = this->GetApplicationLogic()
+              ->RequestSetVolumeImageData((*id2fn0).first, imageData, ijkToRAS, displayData);
+            this->Internal->SetLastRequest(node0, requestUID);
+          }
+          else
+          {
+            vtkErrorMacro("ERROR reading shared memory segment " << (*id2fn0).second);
+          }
+        }
+        else
+        {
+          bool deleteFile = this->GetDeleteTemporaryFiles();
+          vtkMTimeType requestUID = this->GetApplicationLogic()
+            ->RequestReadFile((*id2fn0).first.c_str(), (*id2fn0).second.c_str(),
+                              displayData, deleteFile);
+          this->Internal->SetLastRequest(node0, requestUID);
+
+          // If we are reloading a file, then we know that it is a file
+          // that needs to be removed.  It wouldn't make sense for two
+          // outputs of a module to produce the same file to be reloaded.
+          filesToDelete.erase( (*id2fn0).second );
+        }
 
         if (commandType == SharedObjectModule)
         {
@@ -24,8 +24,13 @@ class ModuleParameter;
 // MRML include
 #include "vtkMRMLScene.h"
 class vtkMRMLModelHierarchyNode;
+class vtkMRMLVolumeNode;
 class MRMLIDMap;
 
+// VTK includes
+class vtkImageData;
+class vtkMatrix4x4;
+
 // STL includes
 #include <string>
 
@@ -96,6 +101,23 @@ public:
   void SetAllowInMemoryTransfer(int value);
   int GetAllowInMemoryTransfer() const;
 
+  /// Control use of shared memory segments for transferring scalar, label map
+  /// and vector volumes to and from CLI executables (instead of temporary files).
+  /// Only used if AllowInMemoryTransfer is enabled. Disabled by default.
+  /// \sa IsSharedMemoryTransferAvailable()
+  void SetAllowSharedMemoryTransfer(int value);
+  int GetAllowSharedMemoryTransfer() const;
+
+  /// Return true if AllowInMemoryTransfer and AllowSharedMemoryTransfer are
+  /// enabled, the platform supports shared memory and the ITK plugin that CLI
+  /// executables use to read and write shared memory segments is found.
+  bool IsSharedMemoryTransferAvailable() const;
+
+  /// Return the directory that contains the ITK shared memory image IO
+  /// plugin or an empty string if not found. The plugin is looked up in the
+  /// "SharedMemory" subdirectory of the directories in ITK_AUTOLOAD_PATH.
+  static std::string GetSharedMemoryPluginDirectory();
+
   /// For debugging, control redirection of cout and cerr
   virtual void RedirectModuleStreamsOn();
   virtual void RedirectModuleStreamsOff();
@@ -145,6 +167,16 @@ protected:
                                      const std::vector<std::string>& extensions,
                                      CommandLineModuleType commandType);
   std::string ConstructTemporarySceneFileName(vtkMRMLScene *scene);
+  /// Construct a unique, short "slicershm:" file name for transferring an image
+  /// through shared memory. The name does not depend on the node, as segment
+  /// name length is limited on some platforms.
+  std::string ConstructSharedMemoryFileName();
+  /// Return true if the node can be transferred through shared memory.
+  bool IsSharedMemoryTransferPossible(const std::string& type, vtkMRMLNode* node) const;
+  /// Publish the volume in the shared memory segment referred to by the file name.
+  bool WriteVolumeToSharedMemory(vtkMRMLVolumeNode* volumeNode, const std::string& fileName);
+  /// Read image and geometry from the shared memory segment referred to by the file name.
+  bool ReadVolumeFromSharedMemory(const std::string& fileName, vtkImageData* imageData, vtkMatrix4x4* ijkToRAS);
   std::string FindHiddenNodeID(const ModuleDescription& d,
                                const ModuleParameter& p);
 
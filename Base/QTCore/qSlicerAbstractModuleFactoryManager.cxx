@@ -20,6 +20,7 @@
 
 // Qt includes
 #include <QDir>
+#include <QElapsedTimer>
 
 // Slicer includes
 #include "qSlicerCoreApplication.h"
@@ -27,6 +28,7 @@
 #include "qSlicerAbstractCoreModule.h"
 
 // STD includes
+#include <algorithm>
 #include <csignal>
 #include <typeinfo>
 
@@ -61,6 +63,10 @@ public:
   QMap<QString, QStringList> ModuleDependees;
 
   bool Verbose;
+
+  bool ProfileModuleStartup;
+  /// Module name -> startup step -> time in milliseconds
+  QMap<QString, QMap<QString, double> > ModuleStartupTimes;
 };
 
 //-----------------------------------------------------------------------------
@@ -69,6 +75,7 @@ qSlicerAbstractModuleFactoryManagerPrivate::qSlicerAbstractModuleFactoryManagerP
   : q_ptr(&object)
 {
   this->Verbose = false;
+  this->ProfileModuleStartup = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -293,6 +300,8 @@ void qSlicerAbstractModuleFactoryManager::registerModules(const QString& path)
 void qSlicerAbstractModuleFactoryManager::registerModule(const QFileInfo& file)
 {
   Q_D(qSlicerAbstractModuleFactoryManager);
+  QElapsedTimer timer;
+  timer.start();
 
   qSlicerFileBasedModuleFactory* moduleFactory = nullptr;
   foreach(qSlicerFileBasedModuleFactory* factory, d->fileBasedFactories())
@@ -361,6 +370,7 @@ void qSlicerAbstractModuleFactoryManager::registerModule(const QFileInfo& file)
     return;
   }
   d->RegisteredModules[moduleName] = moduleFactory;
+  this->addModuleStartupTime(moduleName, "register", timer.nsecsElapsed() * 1e-6);
   if (!dontEmitSignal)
   {
     emit moduleRegistered(moduleName);
@@ -401,6 +411,8 @@ qSlicerAbstractCoreModule* qSlicerAbstractModuleFactoryManager
     qCritical() << "Fail to instantiate module " << moduleName << " (not registered)";
     return nullptr;
   }
+  QElapsedTimer timer;
+  timer.start();
   qSlicerAbstractCoreModule* module = factory->instantiate(moduleName);
   if (!module)
   {
@@ -421,6 +433,7 @@ qSlicerAbstractCoreModule* qSlicerAbstractModuleFactoryManager
       d->ModuleDependees.insert(dependency, dependees << moduleName);
     }
   }
+  this->addModuleStartupTime(moduleName, "instantiate", timer.nsecsElapsed() * 1e-6);
   emit moduleInstantiated(moduleName);
   return module;
 }
@@ -554,3 +567,85 @@ void qSlicerAbstractModuleFactoryManager::setIsVerbose(bool flag)
   Q_D(qSlicerAbstractModuleFactoryManager);
   d->Verbose = flag;
 }
+
+//---------------------------------------------------------------------------
+void qSlicerAbstractModuleFactoryManager::setProfileModuleStartup(bool enable)
+{
+  Q_D(qSlicerAbstractModuleFactoryManager);
+  d->ProfileModuleStartup = enable;
+}
+
+//---------------------------------------------------------------------------
+bool qSlicerAbstractModuleFactoryManager::profileModuleStartup()const
+{
+  Q_D(const qSlicerAbstractModuleFactoryManager);
+  return d->ProfileModuleStartup;
+}
+
+//---------------------------------------------------------------------------
+void qSlicerAbstractModuleFactoryManager::addModuleStartupTime(
+  const QString& moduleName, const QString& step, double milliseconds)
+{
+  Q_D(qSlicerAbstractModuleFactoryManager);
+  if (!d->ProfileModuleStartup)
+  {
+    return;
+  }
+  d->ModuleStartupTimes[moduleName][step] += milliseconds;
+}
+
+//---------------------------------------------------------------------------
+double qSlicerAbstractModuleFactoryManager::moduleStartupTime(const QString& moduleName, const QString& step)const
+{
+  Q_D(const qSlicerAbstractModuleFactoryManager);
+  return d->ModuleStartupTimes.value(moduleName).value(step, -1.0);
+}
+
+//---------------------------------------------------------------------------
+QString qSlicerAbstractModuleFactoryManager::moduleStartupTimeReport()const
+{
+  Q_D(const qSlicerAbstractModuleFactoryManager);
+  const QStringList steps = QStringList() << "register" << "instantiate" << "load";
+  auto formatTime = [](double milliseconds)
+  {
+    return milliseconds < 0 ? QString("%1").arg("-", 12) : QString("%1").arg(milliseconds, 12, 'f', 1);
+  };
+
+  QList<QPair<double, QString> > modulesByTotalTime;
+  QMap<QString, double> stepTotalTimes;
+  double totalTime = 0.0;
+  for (QMap<QString, QMap<QString, double> >::const_iterator moduleIt = d->ModuleStartupTimes.constBegin();
+    moduleIt != d->ModuleStartupTimes.constEnd(); ++moduleIt)
+  {
+    double moduleTotalTime = 0.0;
+    foreach(const QString& step, steps)
+    {
+      double stepTime = moduleIt.value().value(step, 0.0);
+      moduleTotalTime += stepTime;
+      stepTotalTimes[step] += stepTime;
+    }
+    totalTime += moduleTotalTime;
+    modulesByTotalTime << qMakePair(moduleTotalTime, moduleIt.key());
+  }
+  std::stable_sort(modulesByTotalTime.begin(), modulesByTotalTime.end(),
+    [](const QPair<double, QString>& a, const QPair<double, QString>& b) { return a.first > b.first; });
+
+  QString report = QString("Module startup times (ms):\n  %1%2%3%4%5\n")
+    .arg("Module", -40).arg("Register", 12).arg("Instantiate", 12).arg("Load", 12).arg("Total", 12);
+  for (const QPair<double, QString>& moduleTime : modulesByTotalTime)
+  {
+    report += QString("  %1").arg(moduleTime.second, -40);
+    foreach(const QString& step, steps)
+    {
+      report += formatTime(this->moduleStartupTime(moduleTime.second, step));
+    }
+    report += formatTime(moduleTime.first) + "\n";
+  }
+  report += QString("  %1").arg(QString("Total (%1 modules)").arg(modulesByTotalTime.count()), -40);
+  foreach(const QString& step, steps)
+  {
+    report += formatTime(stepTotalTimes.value(step, 0.0));
+  }
+  report += formatTime(totalTime) + "\n";
+  return report;
+}
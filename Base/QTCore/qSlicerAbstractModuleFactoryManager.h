@@ -186,6 +186,23 @@ public:
   /// Enable/Disable verbose output during module discovery process
   void setVerboseModuleDiscovery(bool value);
 
+  /// Enable/Disable recording of the time spent registering, instantiating
+  /// and loading each module. Disabled by default.
+  /// \sa moduleStartupTime(), moduleStartupTimeReport()
+  void setProfileModuleStartup(bool enable);
+  bool profileModuleStartup()const;
+
+  /// Return the time in milliseconds spent in the startup \a step
+  /// ("register", "instantiate" or "load") of module \a moduleName.
+  /// Returns -1 if the time was not recorded.
+  /// \sa setProfileModuleStartup()
+  Q_INVOKABLE double moduleStartupTime(const QString& moduleName, const QString& step)const;
+
+  /// Return a table of the recorded startup times of all modules,
+  /// the slowest module first.
+  /// \sa setProfileModuleStartup()
+  Q_INVOKABLE QString moduleStartupTimeReport()const;
+
   /// Return the list of modules that have \a module as a dependency.
   /// Note that the list can contain unloaded modules.
   /// \sa qSlicerAbstractCoreModule::dependencies(), moduleDependees()
@@ -234,6 +251,11 @@ protected:
   /// Uninstantiate a module given its \a moduleName
   virtual void uninstantiateModule(const QString& moduleName);
 
+  /// Add \a milliseconds to the recorded time of the startup \a step of
+  /// module \a moduleName. Does nothing if profiling is disabled.
+  /// \sa setProfileModuleStartup()
+  void addModuleStartupTime(const QString& moduleName, const QString& step, double milliseconds);
+
 private:
   Q_DECLARE_PRIVATE(qSlicerAbstractModuleFactoryManager);
   Q_DISABLE_COPY(qSlicerAbstractModuleFactoryManager);
@@ -334,6 +334,13 @@ bool qSlicerCoreCommandOptions::verboseModuleDiscovery() const
   return d->ParsedArgs.value("verbose-module-discovery").toBool();
 }
 
+//-----------------------------------------------------------------------------
+bool qSlicerCoreCommandOptions::profileModuleStartup() const
+{
+  Q_D(const qSlicerCoreCommandOptions);
+  return d->ParsedArgs.value("profile-module-startup").toBool();
+}
+
 //-----------------------------------------------------------------------------
 bool qSlicerCoreCommandOptions::verbose()const
 {
@@ -483,6 +490,9 @@ void qSlicerCoreCommandOptions::addArguments()
   this->addArgument("verbose-module-discovery", "", QVariant::Bool,
                     /*no tr*/"Enable verbose output during module discovery process.");
 
+  this->addArgument("profile-module-startup", "", QVariant::Bool,
+                    /*no tr*/"Display the time spent registering, instantiating and loading each module.");
+
   this->addArgument("disable-settings", "", QVariant::Bool,
                     /*no tr*/"Start application ignoring user settings and using new temporary settings.");
 
@@ -18,6 +18,9 @@
 
 ==============================================================================*/
 
+// Qt includes
+#include <QElapsedTimer>
+
 // Slicer includes
 #include "qSlicerModuleFactoryManager.h"
 #include "qSlicerAbstractCoreModule.h"
@@ -173,6 +176,10 @@ bool qSlicerModuleFactoryManager::loadModule(const QString& name, const QString&
     }
   }
 
+  // Time spent loading the dependencies is recorded for the dependencies
+  QElapsedTimer timer;
+  timer.start();
+
   // Update internal Map
   d->LoadedModules << name;
 
@@ -201,6 +208,8 @@ bool qSlicerModuleFactoryManager::loadModule(const QString& name, const QString&
   // Handle post-load initialization
   emit this->moduleLoaded(name);
 
+  this->addModuleStartupTime(name, "load", timer.nsecsElapsed() * 1e-6);
+
   return true;
 }
 
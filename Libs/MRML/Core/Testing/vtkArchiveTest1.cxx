@@ -14,6 +14,7 @@
 #include "vtkArchive.h"
 
 // VTK includes
+#include <vtkNew.h>
 
 // VTKSYS includes
 #include <vtksys/SystemTools.hxx>
@@ -166,6 +167,44 @@ int vtkArchiveTest1(int argc, char * argv[] )
     std::cerr << "failed to extract archive : " << "extractedArchiveTest" << std::endl;
     return EXIT_FAILURE;
   }
+  vtksys::SystemTools::ChangeDirectory("..");
+
+  //
+  // Create a zip file incrementally
+  //
+  std::cout << "creating archiveTestIncremental.zip" << std::endl;
+  std::string incrementalZipFilePath = vtksys::SystemTools::GetCurrentWorkingDirectory() +
+                                                    std::string("/archiveTestIncremental.zip");
+  vtkNew<vtkArchive> archive;
+  CHECK_BOOL(archive->OpenZip(incrementalZipFilePath.c_str(), zipDirPath.c_str()), true);
+  CHECK_BOOL(archive->IsZipOpen(), true);
+  CHECK_BOOL(archive->AddFileToZip((zipDirPath + "/vol.mrml").c_str()), true);
+  // files that are already added are ignored
+  CHECK_BOOL(archive->AddFileToZip((zipDirPath + "/vol.mrml").c_str()), true);
+  // files outside of the zipped directory are rejected
+  CHECK_BOOL(archive->AddFileToZip(zipFilePath.c_str()), false);
+  CHECK_BOOL(archive->AddRemainingFilesToZip(), true);
+  // closing reports the earlier error
+  CHECK_BOOL(archive->CloseZip(), false);
+  CHECK_BOOL(archive->IsZipOpen(), false);
+
+  CHECK_BOOL(archive->OpenZip(incrementalZipFilePath.c_str(), zipDirPath.c_str()), true);
+  CHECK_BOOL(archive->AddFileToZip((zipDirPath + "/vol_and_cube.mrml").c_str()), true);
+  CHECK_BOOL(archive->AddRemainingFilesToZip(), true);
+  CHECK_BOOL(archive->CloseZip(), true);
+
+  files.clear();
+  CHECK_BOOL(vtkArchive::ListArchive(incrementalZipFilePath.c_str(), files), true);
+  int numberOfZippedFiles = 0;
+  for (const std::string& file : files)
+  {
+    std::cout << "Zipped file: " << file << std::endl;
+    if (file == "archiveTest/vol.mrml" || file == "archiveTest/vol_and_cube.mrml")
+    {
+      numberOfZippedFiles++;
+    }
+  }
+  CHECK_INT(numberOfZippedFiles, 2);
 
   return EXIT_SUCCESS;
 }
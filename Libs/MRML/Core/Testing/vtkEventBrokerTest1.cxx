@@ -0,0 +1,105 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkEventBroker.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkObservation.h"
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkNew.h>
+
+namespace
+{
+
+int CallbackCount = 0;
+
+//---------------------------------------------------------------------------
+void CountingCallback(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid),
+                      void* vtkNotUsed(clientData), void* vtkNotUsed(callData))
+{
+  CallbackCount++;
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkEventBrokerTest1(int , char * [] )
+{
+  vtkEventBroker* broker = vtkEventBroker::GetInstance();
+  CHECK_INT(broker->GetEventCoalescing(), 0);
+  CHECK_BOOL(broker->IsEventCoalesced(vtkCommand::ModifiedEvent), true);
+
+  vtkNew<vtkObject> subject;
+  vtkNew<vtkObject> observer;
+  vtkNew<vtkCallbackCommand> callback;
+  callback->SetCallback(CountingCallback);
+  vtkObservation* observation = broker->AddObservation(subject, vtkCommand::ModifiedEvent, observer, callback);
+  CHECK_NOT_NULL(observation);
+
+  // Without coalescing, each event is delivered
+  CallbackCount = 0;
+  broker->StartEventBatch();
+  subject->Modified();
+  subject->Modified();
+  CHECK_INT(CallbackCount, 2);
+  broker->EndEventBatch();
+  CHECK_INT(CallbackCount, 2);
+  CHECK_INT(static_cast<int>(observation->GetInvocationCount()), 2);
+  CHECK_INT(static_cast<int>(observation->GetCoalescedCount()), 0);
+
+  // With coalescing, repeated events in a batch are delivered once when the batch ends
+  broker->EventCoalescingOn();
+  broker->ResetObservationStatistics();
+  CallbackCount = 0;
+  broker->StartEventBatch();
+  broker->StartEventBatch();
+  for (int i = 0; i < 100; ++i)
+  {
+    subject->Modified();
+  }
+  broker->EndEventBatch();
+  CHECK_INT(CallbackCount, 0);
+  CHECK_INT(broker->GetNumberOfQueuedObservations(), 1);
+  broker->EndEventBatch();
+  CHECK_INT(CallbackCount, 1);
+  CHECK_INT(broker->GetNumberOfQueuedObservations(), 0);
+  CHECK_INT(static_cast<int>(observation->GetInvocationCount()), 1);
+  CHECK_INT(static_cast<int>(observation->GetCoalescedCount()), 99);
+
+  // Outside of a batch, events are delivered immediately
+  CallbackCount = 0;
+  subject->Modified();
+  CHECK_INT(CallbackCount, 1);
+
+  // Events that are not in the coalesced event list are delivered immediately
+  broker->RemoveCoalescedEvent(vtkCommand::ModifiedEvent);
+  CallbackCount = 0;
+  broker->StartEventBatch();
+  subject->Modified();
+  CHECK_INT(CallbackCount, 1);
+  broker->EndEventBatch();
+  CHECK_INT(CallbackCount, 1);
+
+  // Removing an observation removes it from the queue
+  broker->AddCoalescedEvent(vtkCommand::ModifiedEvent);
+  CallbackCount = 0;
+  broker->StartEventBatch();
+  subject->Modified();
+  broker->RemoveObservation(observation);
+  broker->EndEventBatch();
+  CHECK_INT(CallbackCount, 0);
+
+  broker->EventCoalescingOff();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkImageHistogramCache.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeDisplayNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+//----------------------------------------------------------------------------
+int vtkImageHistogramCacheTest1(int , char * [] )
+{
+  // Image with values 0..999, each value is present 10 times
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(100, 10, 10);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(imageData->GetScalarPointer());
+  for (int i = 0; i < 10000; ++i)
+  {
+    voxels[i] = static_cast<short>(i % 1000);
+  }
+
+  vtkNew<vtkImageHistogramCache> histogramCache;
+  EXERCISE_BASIC_OBJECT_METHODS(histogramCache.GetPointer());
+
+  // Integer image is binned by value
+  vtkNew<vtkIdTypeArray> histogram;
+  double binOrigin = 0.0;
+  double binSpacing = 0.0;
+  CHECK_BOOL(histogramCache->GetHistogram(imageData, histogram, binOrigin, binSpacing), true);
+  CHECK_INT(histogram->GetNumberOfTuples(), 1000);
+  CHECK_DOUBLE(binOrigin, 0.0);
+  CHECK_DOUBLE(binSpacing, 1.0);
+  CHECK_INT(histogram->GetValue(0), 10);
+  CHECK_INT(histogram->GetValue(999), 10);
+  CHECK_INT(histogramCache->GetNumberOfComputedHistograms(), 1);
+
+  double range[2] = { 0.0, 0.0 };
+  CHECK_BOOL(histogramCache->GetPercentileRange(imageData, 0.0, 100.0, range), true);
+  CHECK_DOUBLE(range[0], 0.0);
+  CHECK_DOUBLE(range[1], 999.0);
+  CHECK_BOOL(histogramCache->GetPercentileRange(imageData, 10.0, 90.0, range), true);
+  CHECK_DOUBLE(range[0], 100.0);
+  CHECK_DOUBLE(range[1], 899.0);
+  // Histogram is reused
+  CHECK_INT(histogramCache->GetNumberOfComputedHistograms(), 1);
+
+  // Strided sampling is cached separately
+  CHECK_BOOL(histogramCache->GetHistogram(imageData, histogram, binOrigin, binSpacing, 2), true);
+  vtkIdType numberOfSamples = 0;
+  for (vtkIdType i = 0; i < histogram->GetNumberOfTuples(); ++i)
+  {
+    numberOfSamples += histogram->GetValue(i);
+  }
+  CHECK_INT(numberOfSamples, 50 * 5 * 5);
+  CHECK_INT(histogramCache->GetNumberOfComputedHistograms(), 2);
+  CHECK_INT(histogramCache->GetNumberOfCachedHistograms(), 2);
+
+  // Modified image is recomputed
+  voxels[0] = 2000;
+  imageData->GetPointData()->GetScalars()->Modified();
+  CHECK_BOOL(histogramCache->GetPercentileRange(imageData, 0.0, 100.0, range), true);
+  CHECK_DOUBLE(range[0], 0.0);
+  CHECK_DOUBLE(range[1], 2000.0);
+  CHECK_INT(histogramCache->GetNumberOfComputedHistograms(), 3);
+
+  // Floating-point image is binned into the maximum number of bins
+  vtkNew<vtkImageData> floatImageData;
+  floatImageData->SetDimensions(101, 1, 1);
+  floatImageData->AllocateScalars(VTK_FLOAT, 1);
+  float* floatVoxels = static_cast<float*>(floatImageData->GetScalarPointer());
+  for (int i = 0; i <= 100; ++i)
+  {
+    floatVoxels[i] = 0.01f * i;
+  }
+  histogramCache->SetMaximumNumberOfBins(101);
+  CHECK_BOOL(histogramCache->GetHistogram(floatImageData, histogram, binOrigin, binSpacing), true);
+  CHECK_INT(histogram->GetNumberOfTuples(), 101);
+  CHECK_DOUBLE_TOLERANCE(binSpacing, 0.01, 1e-6);
+  CHECK_BOOL(histogramCache->GetPercentileRange(floatImageData, 0.0, 100.0, range), true);
+  CHECK_DOUBLE_TOLERANCE(range[0], 0.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(range[1], 1.0, 1e-6);
+
+  // Number of cached histograms is limited
+  histogramCache->SetMaximumNumberOfCachedHistograms(1);
+  CHECK_BOOL(histogramCache->GetPercentileRange(imageData, 0.0, 100.0, range), true);
+  CHECK_INT(histogramCache->GetNumberOfCachedHistograms(), 1);
+  histogramCache->ClearCache();
+  CHECK_INT(histogramCache->GetNumberOfCachedHistograms(), 0);
+
+  // Image without scalars
+  vtkNew<vtkImageData> emptyImageData;
+  CHECK_BOOL(histogramCache->GetPercentileRange(emptyImageData, 0.0, 100.0, range), false);
+  CHECK_BOOL(histogramCache->GetPercentileRange(nullptr, 0.0, 100.0, range), false);
+
+  // Display nodes of a volume share the histogram of the volume node
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  scene->AddNode(volumeNode);
+  volumeNode->SetAndObserveImageData(imageData);
+  for (int i = 0; i < 3; ++i)
+  {
+    vtkNew<vtkMRMLScalarVolumeDisplayNode> displayNode;
+    scene->AddNode(displayNode);
+    volumeNode->AddAndObserveDisplayNodeID(displayNode->GetID());
+    displayNode->SetAutoWindowLevel(1);
+    displayNode->CalculateAutoLevels();
+    CHECK_DOUBLE(displayNode->GetWindowLevelMin(), 1.0);
+  }
+  CHECK_INT(volumeNode->GetImageHistogramCache()->GetNumberOfComputedHistograms(), 1);
+  CHECK_BOOL(volumeNode->GetImageDataPercentileRange(0.0, 100.0, range), true);
+  CHECK_DOUBLE(range[1], 2000.0);
+  CHECK_INT(volumeNode->GetImageHistogramCache()->GetNumberOfComputedHistograms(), 1);
+
+  return EXIT_SUCCESS;
+}
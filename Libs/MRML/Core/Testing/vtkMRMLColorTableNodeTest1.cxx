@@ -106,5 +106,51 @@ int vtkMRMLColorTableNodeTest1(int argc, char * argv[])
     CHECK_STRING(colorNode->GetColorName(2), "two")
   }
 
+  // check that content of deferred color tables is created on first access
+  {
+    vtkNew<vtkMRMLColorTableNode> colorNode;
+    colorNode->SetTypeDeferred(vtkMRMLColorTableNode::Labels);
+    CHECK_BOOL(colorNode->GetContentDeferred(), true);
+    CHECK_INT(colorNode->GetType(), vtkMRMLColorTableNode::Labels);
+    CHECK_INT(colorNode->GetNumberOfColors(), 257);
+    CHECK_BOOL(colorNode->GetContentDeferred(), false);
+    CHECK_STRING(colorNode->GetColorName(1), "jake");
+
+    // copy of a deferred node is deferred as well
+    vtkNew<vtkMRMLColorTableNode> deferredNode;
+    deferredNode->SetTypeDeferred(vtkMRMLColorTableNode::Grey);
+    vtkNew<vtkMRMLColorTableNode> copiedNode;
+    copiedNode->Copy(deferredNode.GetPointer());
+    CHECK_BOOL(deferredNode->GetContentDeferred(), true);
+    CHECK_BOOL(copiedNode->GetContentDeferred(), true);
+    CHECK_NOT_NULL(copiedNode->GetLookupTable());
+    CHECK_INT(copiedNode->GetNumberOfColors(), 256);
+    CHECK_BOOL(copiedNode->GetContentDeferred(), false);
+  }
+
+  // check color index lookup by name
+  {
+    vtkNew<vtkMRMLColorTableNode> colorNode;
+    colorNode->SetTypeToUser();
+    colorNode->SetNumberOfColors(4);
+    colorNode->SetColor(0, "zero", 0.0, 0.0, 0.0, 1.0);
+    colorNode->SetColor(1, "one", 1.0, 0.0, 0.0, 1.0);
+    colorNode->SetColor(2, "one", 0.0, 1.0, 0.0, 1.0);
+    colorNode->NamesInitialisedOn();
+    CHECK_INT(colorNode->GetColorIndexByName("zero"), 0);
+    CHECK_INT(colorNode->GetColorIndexByName("one"), 1);
+    CHECK_INT(colorNode->GetColorIndexByName("two"), -1);
+    CHECK_INT(colorNode->GetColorIndexByName(colorNode->GetNoName()), 3);
+
+    // renamed colors are found
+    colorNode->SetColorName(1, "two");
+    CHECK_INT(colorNode->GetColorIndexByName("two"), 1);
+    CHECK_INT(colorNode->GetColorIndexByName("one"), 2);
+
+    colorNode->SetColors(0, 3, "all", 0.0, 0.0, 0.0, 1.0);
+    CHECK_INT(colorNode->GetColorIndexByName("all"), 0);
+    CHECK_INT(colorNode->GetColorIndexByName("zero"), -1);
+  }
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,187 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLLabelMapVolumeNode.h"
+#include "vtkMRMLModelDisplayNode.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLTextNode.h"
+
+// VTK includes
+#include <vtkCollection.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+int TestNodeClassIndexConsistency()
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  // Index is created before nodes are added
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLVolumeNode"), 0);
+
+  vtkNew<vtkMRMLScalarVolumeNode> scalarVolumeNode;
+  scene->AddNode(scalarVolumeNode);
+  vtkNew<vtkMRMLModelNode> modelNode;
+  scene->AddNode(modelNode);
+  vtkNew<vtkMRMLLabelMapVolumeNode> labelMapVolumeNode;
+  scene->AddNode(labelMapVolumeNode);
+
+  // Superclass queries are kept up-to-date
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLVolumeNode"), 2);
+  CHECK_POINTER(scene->GetNthNodeByClass(0, "vtkMRMLVolumeNode"), scalarVolumeNode.GetPointer());
+  CHECK_POINTER(scene->GetNthNodeByClass(1, "vtkMRMLVolumeNode"), labelMapVolumeNode.GetPointer());
+  CHECK_NULL(scene->GetNthNodeByClass(2, "vtkMRMLVolumeNode"));
+
+  // Index is created after nodes are added (vtkMRMLLabelMapVolumeNode is a vtkMRMLScalarVolumeNode)
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLScalarVolumeNode"), 2);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLDisplayableNode"), 3);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLNonExistingNode"), 0);
+
+  // Adding a node updates all indexed classes
+  vtkNew<vtkMRMLScalarVolumeNode> scalarVolumeNode2;
+  scene->AddNode(scalarVolumeNode2);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLVolumeNode"), 3);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLScalarVolumeNode"), 3);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLDisplayableNode"), 4);
+  CHECK_POINTER(scene->GetNthNodeByClass(2, "vtkMRMLVolumeNode"), scalarVolumeNode2.GetPointer());
+
+  // Removing a node
+  scene->RemoveNode(scalarVolumeNode);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLVolumeNode"), 2);
+  CHECK_POINTER(scene->GetFirstNodeByClass("vtkMRMLVolumeNode"), labelMapVolumeNode.GetPointer());
+  CHECK_POINTER(scene->GetNthNodeByClass(1, "vtkMRMLVolumeNode"), scalarVolumeNode2.GetPointer());
+  std::vector<vtkMRMLNode*> displayableNodes;
+  CHECK_INT(scene->GetNodesByClass("vtkMRMLDisplayableNode", displayableNodes), 3);
+  CHECK_POINTER(displayableNodes[0], modelNode.GetPointer());
+
+  // Re-adding a removed node puts it at the end
+  scene->AddNode(scalarVolumeNode);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLVolumeNode"), 3);
+  CHECK_POINTER(scene->GetNthNodeByClass(2, "vtkMRMLVolumeNode"), scalarVolumeNode.GetPointer());
+
+  // Inserting a node changes the order
+  vtkNew<vtkMRMLScalarVolumeNode> insertedVolumeNode;
+  scene->InsertBeforeNode(labelMapVolumeNode, insertedVolumeNode);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLVolumeNode"), 4);
+  CHECK_POINTER(scene->GetFirstNodeByClass("vtkMRMLVolumeNode"), insertedVolumeNode.GetPointer());
+
+  // Collection returned by GetNodesByClass
+  vtkSmartPointer<vtkCollection> volumeNodes = vtkSmartPointer<vtkCollection>::Take(scene->GetNodesByClass("vtkMRMLVolumeNode"));
+  CHECK_INT(volumeNodes->GetNumberOfItems(), 4);
+  CHECK_POINTER(volumeNodes->GetItemAsObject(0), labelMapVolumeNode.GetPointer());
+
+  // Closing the scene
+  scene->Clear(0);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLVolumeNode"), 0);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLDisplayableNode"), 0);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLNode"), scene->GetNumberOfNodes());
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestNodeClassQueryPerformance(int numberOfNodes)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkTimerLog> timer;
+
+  // Synthetic scene with a mix of node classes
+  timer->StartTimer();
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  for (int i = 0; i < numberOfNodes; ++i)
+  {
+    vtkSmartPointer<vtkMRMLNode> node;
+    switch (i % 4)
+    {
+      case 0: node = vtkSmartPointer<vtkMRMLModelNode>::New(); break;
+      case 1: node = vtkSmartPointer<vtkMRMLModelDisplayNode>::New(); break;
+      case 2: node = vtkSmartPointer<vtkMRMLTextNode>::New(); break;
+      default: node = vtkSmartPointer<vtkMRMLScalarVolumeNode>::New(); break;
+    }
+    scene->AddNode(node);
+    // Simulate observers querying the scene on NodeAdded
+    if (i % 100 == 0)
+    {
+      scene->GetFirstNodeByClass("vtkMRMLVolumeNode");
+    }
+  }
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  timer->StopTimer();
+  std::cout << "Add " << numberOfNodes << " nodes: " << timer->GetElapsedTime() << "s" << std::endl;
+
+  const char* classNames[] = { "vtkMRMLModelNode", "vtkMRMLDisplayNode", "vtkMRMLVolumeNode", "vtkMRMLNode" };
+  const int numberOfQueries = 1000;
+  for (const char* className : classNames)
+  {
+    timer->StartTimer();
+    int numberOfFoundNodes = 0;
+    for (int i = 0; i < numberOfQueries; ++i)
+    {
+      numberOfFoundNodes = scene->GetNumberOfNodesByClass(className);
+      scene->GetNthNodeByClass(numberOfFoundNodes / 2, className);
+    }
+    timer->StopTimer();
+    std::cout << "Query " << className << " (" << numberOfFoundNodes << " nodes): "
+      << timer->GetElapsedTime() / numberOfQueries * 1e6 << "us" << std::endl;
+  }
+
+  timer->StartTimer();
+  std::vector<vtkMRMLNode*> nodes;
+  for (int i = 0; i < numberOfQueries; ++i)
+  {
+    scene->GetNodesByClass("vtkMRMLDisplayableNode", nodes);
+  }
+  timer->StopTimer();
+  std::cout << "GetNodesByClass vtkMRMLDisplayableNode (" << nodes.size() << " nodes): "
+    << timer->GetElapsedTime() / numberOfQueries * 1e6 << "us" << std::endl;
+
+  timer->StartTimer();
+  scene->Clear(0);
+  timer->StopTimer();
+  std::cout << "Clear scene: " << timer->GetElapsedTime() << "s" << std::endl;
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLModelNode"), 0);
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneNodeClassIndexTest(int argc, char* argv[])
+{
+  // A small scene by default so that the test runs quickly, correctness is checked in TestNodeClassIndexConsistency.
+  // Execution times are only reported, pass a large number of nodes (e.g., 50000) as argument to measure performance.
+  int numberOfNodes = 400;
+  if (argc > 1)
+  {
+    numberOfNodes = atoi(argv[1]);
+  }
+  CHECK_EXIT_SUCCESS(TestNodeClassIndexConsistency());
+  CHECK_EXIT_SUCCESS(TestNodeClassQueryPerformance(numberOfNodes));
+  return EXIT_SUCCESS;
+}
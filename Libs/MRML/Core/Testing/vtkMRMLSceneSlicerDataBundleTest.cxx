@@ -0,0 +1,169 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkCacheManager.h"
+#include "vtkDataIOManager.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtksys/Directory.hxx>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// Node names that result in file names with the same prefix before the first dot
+const std::vector<std::string> VolumeNames = { "CT 1.25mm", "CT 1.5mm", "CT 1.75mm", "CT", "Vol", "Vol.nii", "Vol.nii.gz" };
+
+//---------------------------------------------------------------------------
+void AddVolumes(vtkMRMLScene* scene)
+{
+  for (size_t i = 0; i < VolumeNames.size(); ++i)
+  {
+    vtkNew<vtkImageData> imageData;
+    imageData->SetDimensions(32, 32, 16);
+    imageData->AllocateScalars(VTK_SHORT, 1);
+    imageData->GetPointData()->GetScalars()->Fill(static_cast<double>(100 + i));
+    vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(
+      scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode", VolumeNames[i]));
+    volumeNode->SetAndObserveImageData(imageData);
+  }
+}
+
+//---------------------------------------------------------------------------
+int CheckVolumes(vtkMRMLScene* scene)
+{
+  for (size_t i = 0; i < VolumeNames.size(); ++i)
+  {
+    vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(
+      scene->GetFirstNodeByName(VolumeNames[i].c_str()));
+    CHECK_NOT_NULL(volumeNode);
+    CHECK_NOT_NULL(volumeNode->GetImageData());
+    int* dimensions = volumeNode->GetImageData()->GetDimensions();
+    CHECK_INT(dimensions[0], 32);
+    CHECK_INT(dimensions[1], 32);
+    CHECK_INT(dimensions[2], 16);
+    double range[2] = { 0.0, 0.0 };
+    volumeNode->GetImageData()->GetScalarRange(range);
+    CHECK_DOUBLE(range[0], 100 + i);
+    CHECK_DOUBLE(range[1], 100 + i);
+  }
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int CheckNoTemporaryWriteDirectory(const std::string& dataDir)
+{
+  vtksys::Directory dir;
+  dir.Load(dataDir);
+  for (unsigned long fileIndex = 0; fileIndex < dir.GetNumberOfFiles(); ++fileIndex)
+  {
+    std::string fileName = dir.GetFile(fileIndex);
+    if (fileName.find("TempWrite") != std::string::npos)
+    {
+      std::cerr << "Temporary write directory left behind: " << fileName << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestSaveSceneToSlicerDataBundleDirectory(const std::string& tempDir)
+{
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetNumberOfStorableNodeWriterThreads(8);
+  AddVolumes(scene);
+
+  std::string bundleDir = tempDir + "/vtkMRMLSceneSlicerDataBundleTest";
+  vtksys::SystemTools::RemoveADirectory(bundleDir);
+  CHECK_BOOL(scene->SaveSceneToSlicerDataBundleDirectory(bundleDir.c_str()), true);
+  CHECK_EXIT_SUCCESS(CheckNoTemporaryWriteDirectory(bundleDir + "/Data"));
+
+  // Each volume is written into its own file
+  vtksys::Directory dataDir;
+  dataDir.Load(bundleDir + "/Data");
+  size_t numberOfVolumeFiles = 0;
+  for (unsigned long fileIndex = 0; fileIndex < dataDir.GetNumberOfFiles(); ++fileIndex)
+  {
+    std::string fileName = dataDir.GetFile(fileIndex);
+    if (fileName.size() > 5 && fileName.substr(fileName.size() - 5) == ".nrrd")
+    {
+      ++numberOfVolumeFiles;
+    }
+  }
+  CHECK_INT(static_cast<int>(numberOfVolumeFiles), static_cast<int>(VolumeNames.size()));
+
+  vtkNew<vtkMRMLScene> readScene;
+  readScene->SetURL((bundleDir + "/vtkMRMLSceneSlicerDataBundleTest.mrml").c_str());
+  CHECK_INT(readScene->Connect(), 1);
+  CHECK_EXIT_SUCCESS(CheckVolumes(readScene));
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestWriteToMRB(const std::string& tempDir)
+{
+  vtkNew<vtkCacheManager> cacheManager;
+  cacheManager->SetRemoteCacheDirectory(tempDir.c_str());
+  vtkNew<vtkDataIOManager> dataIOManager;
+  dataIOManager->SetCacheManager(cacheManager);
+
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetDataIOManager(dataIOManager);
+  scene->SetNumberOfStorableNodeWriterThreads(8);
+  AddVolumes(scene);
+
+  std::string mrbFileName = tempDir + "/vtkMRMLSceneSlicerDataBundleTest.mrb";
+  vtksys::SystemTools::RemoveFile(mrbFileName);
+  CHECK_BOOL(scene->WriteToMRB(mrbFileName.c_str()), true);
+
+  vtkNew<vtkMRMLScene> readScene;
+  readScene->SetDataIOManager(dataIOManager);
+  CHECK_BOOL(readScene->ReadFromMRB(mrbFileName.c_str()), true);
+  CHECK_EXIT_SUCCESS(CheckVolumes(readScene));
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneSlicerDataBundleTest(int argc, char* argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string tempDir = argv[1];
+
+  CHECK_EXIT_SUCCESS(TestSaveSceneToSlicerDataBundleDirectory(tempDir));
+  CHECK_EXIT_SUCCESS(TestWriteToMRB(tempDir));
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
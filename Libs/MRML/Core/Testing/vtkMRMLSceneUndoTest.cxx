@@ -0,0 +1,266 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelDisplayNode.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLTextNode.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+vtkMRMLTextNode* AddTextNode(vtkMRMLScene* scene, const std::string& text)
+{
+  vtkNew<vtkMRMLTextNode> textNode;
+  textNode->SetUndoEnabled(true);
+  textNode->SetText(text);
+  scene->AddNode(textNode);
+  return textNode;
+}
+
+//---------------------------------------------------------------------------
+int TestUndoRedo()
+{
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetUndoOn();
+
+  vtkMRMLTextNode* textNode1 = AddTextNode(scene, "first");
+  vtkMRMLTextNode* textNode2 = AddTextNode(scene, "second");
+  std::string textNode2ID = textNode2->GetID();
+
+  // Modified node is restored
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 1);
+  textNode1->SetText("first modified");
+  scene->Undo();
+  CHECK_STD_STRING(textNode1->GetText(), "first");
+  CHECK_INT(scene->GetNumberOfRedoLevels(), 1);
+  scene->Redo();
+  CHECK_STD_STRING(textNode1->GetText(), "first modified");
+
+  // Removed node is added back
+  scene->SaveStateForUndo();
+  scene->RemoveNode(textNode2);
+  CHECK_NULL(scene->GetNodeByID(textNode2ID));
+  scene->Undo();
+  vtkMRMLTextNode* restoredTextNode2 = vtkMRMLTextNode::SafeDownCast(scene->GetNodeByID(textNode2ID));
+  CHECK_NOT_NULL(restoredTextNode2);
+  CHECK_STD_STRING(restoredTextNode2->GetText(), "second");
+
+  // Added node is removed
+  scene->SaveStateForUndo();
+  vtkMRMLTextNode* textNode3 = AddTextNode(scene, "third");
+  std::string textNode3ID = textNode3->GetID();
+  scene->Undo();
+  CHECK_NULL(scene->GetNodeByID(textNode3ID));
+  scene->Redo();
+  CHECK_NOT_NULL(scene->GetNodeByID(textNode3ID));
+
+  // Node that is removed after its state is shared by several undo levels
+  // can be restored multiple times
+  scene->ClearUndoStack();
+  scene->ClearRedoStack();
+  scene->SaveStateForUndo();
+  scene->SaveStateForUndo();
+  scene->RemoveNode(restoredTextNode2);
+  scene->Undo();
+  restoredTextNode2 = vtkMRMLTextNode::SafeDownCast(scene->GetNodeByID(textNode2ID));
+  CHECK_NOT_NULL(restoredTextNode2);
+  restoredTextNode2->SetText("second modified");
+  scene->RemoveNode(restoredTextNode2);
+  scene->Undo();
+  restoredTextNode2 = vtkMRMLTextNode::SafeDownCast(scene->GetNodeByID(textNode2ID));
+  CHECK_NOT_NULL(restoredTextNode2);
+  CHECK_STD_STRING(restoredTextNode2->GetText(), "second");
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestSharedSnapshots()
+{
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetUndoOn();
+
+  const int numberOfTextNodes = 20;
+  std::vector<vtkMRMLTextNode*> textNodes;
+  for (int i = 0; i < numberOfTextNodes; ++i)
+  {
+    textNodes.push_back(AddTextNode(scene, "text"));
+  }
+  vtkNew<vtkPolyData> mesh;
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(0.0, 0.0, 0.0);
+  mesh->SetPoints(points);
+  vtkNew<vtkMRMLModelNode> modelNode;
+  modelNode->SetUndoEnabled(true);
+  modelNode->SetAndObserveMesh(mesh);
+  scene->AddNode(modelNode);
+  const int numberOfNodes = numberOfTextNodes + 1;
+
+  // All nodes are copied when first saved
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoNodeCopies(), numberOfNodes);
+
+  // Unchanged nodes are not copied again
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoNodeCopies(), numberOfNodes);
+
+  // Only modified node is copied
+  textNodes[3]->SetText("modified");
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoNodeCopies(), numberOfNodes + 1);
+
+  // Modification of the mesh is detected
+  points->SetPoint(0, 1.0, 2.0, 3.0);
+  points->Modified();
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoNodeCopies(), numberOfNodes + 2);
+
+  // Modification of node references is detected
+  textNodes[5]->SetNodeReferenceID("testReference", modelNode->GetID());
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoNodeCopies(), numberOfNodes + 3);
+
+  // Undo restores the content of each saved level
+  textNodes[3]->SetText("modified again");
+  scene->Undo();
+  CHECK_STD_STRING(textNodes[3]->GetText(), "modified");
+  CHECK_NOT_NULL(textNodes[5]->GetNodeReference("testReference"));
+  scene->Undo();
+  CHECK_NULL(textNodes[5]->GetNodeReference("testReference"));
+  CHECK_DOUBLE(modelNode->GetMesh()->GetPoint(0)[0], 1.0);
+  scene->Undo();
+  CHECK_DOUBLE(modelNode->GetMesh()->GetPoint(0)[0], 0.0);
+  CHECK_STD_STRING(textNodes[3]->GetText(), "modified");
+  scene->Undo();
+  CHECK_STD_STRING(textNodes[3]->GetText(), "text");
+  scene->Redo();
+  CHECK_STD_STRING(textNodes[3]->GetText(), "modified");
+  CHECK_DOUBLE(modelNode->GetMesh()->GetPoint(0)[0], 0.0);
+  scene->Redo();
+  CHECK_DOUBLE(modelNode->GetMesh()->GetPoint(0)[0], 1.0);
+
+  // Snapshots are released along with the states
+  scene->ClearUndoStack();
+  scene->ClearRedoStack();
+  int numberOfCopies = scene->GetNumberOfUndoNodeCopies();
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoNodeCopies(), numberOfCopies + numberOfNodes);
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestUndoPerformance(int numberOfNodes)
+{
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetUndoOn();
+  vtkNew<vtkTimerLog> timer;
+
+  // Scene with a mix of undo-enabled nodes
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  std::vector<vtkMRMLNode*> nodes;
+  for (int i = 0; i < numberOfNodes; ++i)
+  {
+    vtkSmartPointer<vtkMRMLNode> node;
+    switch (i % 3)
+    {
+      case 0: node = vtkSmartPointer<vtkMRMLModelNode>::New(); break;
+      case 1: node = vtkSmartPointer<vtkMRMLModelDisplayNode>::New(); break;
+      default: node = vtkSmartPointer<vtkMRMLTextNode>::New(); break;
+    }
+    node->SetUndoEnabled(true);
+    scene->AddNode(node);
+    nodes.push_back(node);
+  }
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+
+  timer->StartTimer();
+  scene->SaveStateForUndo();
+  timer->StopTimer();
+  std::cout << "Save first undo state of " << numberOfNodes << " nodes: " << timer->GetElapsedTime() << "s" << std::endl;
+
+  // Interaction that modifies a single node between saved states
+  const int numberOfStates = 20;
+  timer->StartTimer();
+  for (int i = 0; i < numberOfStates; ++i)
+  {
+    nodes[(i * 7919) % numberOfNodes]->SetName(("Modified" + std::to_string(i)).c_str());
+    scene->SaveStateForUndo();
+  }
+  timer->StopTimer();
+  std::cout << "Save undo state with one modified node: "
+    << timer->GetElapsedTime() / numberOfStates * 1e3 << "ms" << std::endl;
+  CHECK_INT(scene->GetNumberOfUndoNodeCopies(), numberOfNodes + numberOfStates);
+
+  timer->StartTimer();
+  for (int i = 0; i < numberOfStates; ++i)
+  {
+    scene->Undo();
+  }
+  timer->StopTimer();
+  std::cout << "Undo: " << timer->GetElapsedTime() / numberOfStates * 1e3 << "ms" << std::endl;
+
+  timer->StartTimer();
+  for (int i = 0; i < numberOfStates; ++i)
+  {
+    scene->Redo();
+  }
+  timer->StopTimer();
+  std::cout << "Redo: " << timer->GetElapsedTime() / numberOfStates * 1e3 << "ms" << std::endl;
+
+  timer->StartTimer();
+  scene->ClearUndoStack();
+  scene->ClearRedoStack();
+  timer->StopTimer();
+  std::cout << "Clear undo stack: " << timer->GetElapsedTime() << "s" << std::endl;
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneUndoTest(int argc, char* argv[])
+{
+  // A small scene by default so that the test runs quickly. Execution times are only reported,
+  // pass a large number of nodes (e.g., 20000) as argument to measure undo performance.
+  int numberOfNodes = 200;
+  if (argc > 1)
+  {
+    numberOfNodes = atoi(argv[1]);
+  }
+  CHECK_EXIT_SUCCESS(TestUndoRedo());
+  CHECK_EXIT_SUCCESS(TestSharedSnapshots());
+  CHECK_EXIT_SUCCESS(TestUndoPerformance(numberOfNodes));
+  return EXIT_SUCCESS;
+}
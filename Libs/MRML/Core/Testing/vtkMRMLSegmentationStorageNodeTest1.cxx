@@ -33,6 +33,57 @@ Care Ontario.
 #include "vtkFractionalLabelmapToClosedSurfaceConversionRule.h"
 #include "vtkClosedSurfaceToFractionalLabelmapConversionRule.h"
 
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkPointData.h>
+#include <vtkTeemNRRDReader.h>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+vtkSmartPointer<vtkOrientedImageData> CreateBoxLabelmap(int dimensions[3], int boxExtent[6])
+{
+  vtkSmartPointer<vtkOrientedImageData> labelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+  labelmap->SetDimensions(dimensions);
+  labelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  labelmap->GetPointData()->GetScalars()->Fill(0);
+  for (int k = boxExtent[4]; k <= boxExtent[5]; ++k)
+  {
+    for (int j = boxExtent[2]; j <= boxExtent[3]; ++j)
+    {
+      for (int i = boxExtent[0]; i <= boxExtent[1]; ++i)
+      {
+        *static_cast<unsigned char*>(labelmap->GetScalarPointer(i, j, k)) = 1;
+      }
+    }
+  }
+  return labelmap;
+}
+
+//---------------------------------------------------------------------------
+vtkIdType GetNumberOfSegmentVoxels(vtkSegment* segment)
+{
+  vtkOrientedImageData* labelmap = vtkOrientedImageData::SafeDownCast(
+    segment->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+  if (!labelmap || !labelmap->GetPointData()->GetScalars())
+  {
+    return 0;
+  }
+  vtkDataArray* scalars = labelmap->GetPointData()->GetScalars();
+  vtkIdType numberOfSegmentVoxels = 0;
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i)
+  {
+    if (scalars->GetTuple1(i) == segment->GetLabelValue())
+    {
+      ++numberOfSegmentVoxels;
+    }
+  }
+  return numberOfSegmentVoxels;
+}
+
+} // end of anonymous namespace
+
 int vtkMRMLSegmentationStorageNodeTest1(int argc, char* argv[])
 {
   vtkNew<vtkMRMLSegmentationStorageNode> node1;
@@ -155,5 +206,51 @@ int vtkMRMLSegmentationStorageNodeTest1(int argc, char* argv[])
     vtksys::SystemTools::RemoveFile(emptySegmentationFilename);
   }
 
+  std::cout << "Testing segmentation with parallel compression" << std::endl;
+  {
+    // Two overlapping segments, stored in two layers. The image is larger than
+    // the compression block size so that it is stored in multiple gzip members.
+    int dimensions[3] = { 128, 128, 160 };
+    int boxExtentA[6] = { 0, 127, 0, 127, 0, 99 };
+    int boxExtentB[6] = { 10, 99, 20, 109, 60, 159 };
+    vtkNew<vtkMRMLSegmentationNode> segmentationNode;
+    scene->AddNode(segmentationNode);
+    segmentationNode->GetSegmentation()->SetSourceRepresentationName(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName());
+    vtkNew<vtkSegment> segmentA;
+    segmentA->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), CreateBoxLabelmap(dimensions, boxExtentA));
+    CHECK_BOOL(segmentationNode->GetSegmentation()->AddSegment(segmentA, "A"), true);
+    vtkNew<vtkSegment> segmentB;
+    segmentB->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), CreateBoxLabelmap(dimensions, boxExtentB));
+    CHECK_BOOL(segmentationNode->GetSegmentation()->AddSegment(segmentB, "B"), true);
+    CHECK_INT(segmentationNode->GetSegmentation()->GetNumberOfLayers(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()), 2);
+
+    // Write to file
+    vtkNew<vtkMRMLSegmentationStorageNode> segmentationStorageNode;
+    scene->AddNode(segmentationStorageNode);
+    std::string segmentationFilename = std::string(tempDir) + "/ParallelCompressedSegmentation.seg.nrrd";
+    segmentationStorageNode->SetFileName(segmentationFilename.c_str());
+    segmentationStorageNode->SetUseCompression(1);
+    CHECK_INT(segmentationStorageNode->WriteData(segmentationNode), 1);
+    vtkTeemNRRDReader::DataLayout layout;
+    CHECK_BOOL(vtkTeemNRRDReader::GetDataLayout(segmentationFilename.c_str(), layout), true);
+    CHECK_BOOL(layout.Blocks.size() > 1, true);
+
+    // Read from file
+    vtkNew<vtkMRMLSegmentationNode> segmentationNodeFromFile;
+    scene->AddNode(segmentationNodeFromFile);
+    CHECK_INT(segmentationStorageNode->ReadData(segmentationNodeFromFile), 1);
+    vtkSegmentation* segmentation = segmentationNodeFromFile->GetSegmentation();
+    CHECK_NOT_NULL(segmentation);
+    CHECK_INT(segmentation->GetNumberOfSegments(), 2);
+    CHECK_INT(segmentation->GetNumberOfLayers(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()), 2);
+    CHECK_NOT_NULL(segmentation->GetSegment("A"));
+    CHECK_NOT_NULL(segmentation->GetSegment("B"));
+    CHECK_INT(GetNumberOfSegmentVoxels(segmentation->GetSegment("A")), 128 * 128 * 100);
+    CHECK_INT(GetNumberOfSegmentVoxels(segmentation->GetSegment("B")), 90 * 90 * 100);
+
+    // Clean up
+    vtksys::SystemTools::RemoveFile(segmentationFilename);
+  }
+
   return EXIT_SUCCESS;
 }
@@ -19,6 +19,10 @@
 #include "vtkMRMLScene.h"
 #include "vtkMRMLSubjectHierarchyNode.h"
 
+// VTK includes
+#include <vtkCollection.h>
+#include <vtkIdList.h>
+
 int vtkMRMLSubjectHierarchyNodeTest1(int , char * [])
 {
   // Add a scene with 3 text nodes
@@ -75,6 +79,58 @@ int vtkMRMLSubjectHierarchyNodeTest1(int , char * [])
   CHECK_BOOL(std::find(ids.begin(), ids.end(), "defffff") != ids.end(), true);
   CHECK_BOOL(std::find(ids.begin(), ids.end(), "ggggg") != ids.end(), true);
 
+  // Test finding items by UID
+
+  CHECK_INT(shNode->GetItemByUID("abc", "3"), itemId1);
+  CHECK_INT(shNode->GetItemByUID("abc", "4"), vtkMRMLSubjectHierarchyNode::GetInvalidItemID());
+  shNode->SetItemUID(itemId1, "abc", "4");
+  CHECK_INT(shNode->GetItemByUID("abc", "3"), vtkMRMLSubjectHierarchyNode::GetInvalidItemID());
+  CHECK_INT(shNode->GetItemByUID("abc", "4"), itemId1);
+  shNode->RemoveItemUID(itemId1, "abc");
+  CHECK_INT(shNode->GetItemByUID("abc", "4"), vtkMRMLSubjectHierarchyNode::GetInvalidItemID());
+  shNode->SetItemUID(itemId1, "abc", "3");
+
+  // If multiple items have the same UID then the first one is found
+  vtkIdType folderItemId = shNode->CreateFolderItem(shNode->GetSceneItemID(), "Folder");
+  vtkIdType folderChildItemId = shNode->CreateFolderItem(folderItemId, "FolderChild");
+  shNode->SetItemUID(folderChildItemId, "abc", "3");
+  CHECK_INT(shNode->GetItemByUID("abc", "3"), itemId1);
+  shNode->RemoveItem(itemId1, false);
+  CHECK_INT(shNode->GetItemByUID("abc", "3"), folderChildItemId);
+  shNode->RemoveItem(folderItemId, false, true);
+  CHECK_INT(shNode->GetItemByUID("abc", "3"), vtkMRMLSubjectHierarchyNode::GetInvalidItemID());
+
+  // Test bulk item creation and reparenting
+  /////////////////////////
+
+  vtkNew<vtkCollection> dataNodes;
+  dataNodes->AddItem(dataNode1);
+  for (int i = 0; i < 5; ++i)
+  {
+    vtkNew<vtkMRMLModelNode> dataNode;
+    scene->AddNode(dataNode);
+    dataNodes->AddItem(dataNode);
+  }
+  vtkNew<vtkIdList> createdItemIds;
+  shNode->CreateItems(shNode->GetSceneItemID(), dataNodes, createdItemIds);
+  CHECK_INT(createdItemIds->GetNumberOfIds(), 6);
+  for (vtkIdType i = 0; i < createdItemIds->GetNumberOfIds(); ++i)
+  {
+    CHECK_INT(shNode->GetItemByDataNode(vtkMRMLNode::SafeDownCast(dataNodes->GetItemAsObject(i))), createdItemIds->GetId(i));
+  }
+  itemId1 = createdItemIds->GetId(0);
+
+  vtkIdType newParentItemId = shNode->CreateFolderItem(shNode->GetSceneItemID(), "NewParent");
+  shNode->SetItemsParent(createdItemIds, newParentItemId);
+  CHECK_BOOL(scene->IsBatchProcessing(), false);
+  for (vtkIdType i = 0; i < createdItemIds->GetNumberOfIds(); ++i)
+  {
+    CHECK_INT(shNode->GetItemParent(createdItemIds->GetId(i)), newParentItemId);
+  }
+  vtkNew<vtkIdList> childItemIds;
+  shNode->GetItemChildren(newParentItemId, childItemIds);
+  CHECK_INT(childItemIds->GetNumberOfIds(), 6);
+
   // Test attributes
   /////////////////////////
 
@@ -115,5 +171,43 @@ int vtkMRMLSubjectHierarchyNodeTest1(int , char * [])
   CHECK_BOOL(std::find(atts.begin(), atts.end(), "zxcv") != atts.end(), true);
   CHECK_BOOL(std::find(atts.begin(), atts.end(), "qwer") != atts.end(), true);
 
+  // Test finding items by attribute
+
+  vtkIdType itemId2 = createdItemIds->GetId(1);
+  shNode->SetItemAttribute(itemId2, "asd", "sss");
+  vtkNew<vtkIdList> foundItemIds;
+  shNode->GetItemsByAttribute("asd", foundItemIds);
+  CHECK_INT(foundItemIds->GetNumberOfIds(), 2);
+  CHECK_INT(foundItemIds->GetId(0), itemId1);
+  CHECK_INT(foundItemIds->GetId(1), itemId2);
+  shNode->GetItemsByAttributeValue("asd", "sss", foundItemIds);
+  CHECK_INT(foundItemIds->GetNumberOfIds(), 1);
+  CHECK_INT(foundItemIds->GetId(0), itemId2);
+  shNode->SetItemAttribute(itemId2, "asd", "rrr");
+  shNode->GetItemsByAttributeValue("asd", "sss", foundItemIds);
+  CHECK_INT(foundItemIds->GetNumberOfIds(), 0);
+  shNode->GetItemsByAttributeValue("asd", "rrr", foundItemIds);
+  CHECK_INT(foundItemIds->GetNumberOfIds(), 2);
+  shNode->RemoveItemAttribute(itemId1, "asd");
+  shNode->GetItemsByAttribute("asd", foundItemIds);
+  CHECK_INT(foundItemIds->GetNumberOfIds(), 1);
+  CHECK_INT(foundItemIds->GetId(0), itemId2);
+
+  // Items of a copied hierarchy are not found in the original hierarchy
+  shNode->SetItemUID(itemId2, "copied", "1");
+  vtkNew<vtkMRMLSubjectHierarchyNode> copiedShNode;
+  copiedShNode->Copy(shNode);
+  copiedShNode->Copy(shNode);
+  shNode->GetItemsByAttribute("asd", foundItemIds);
+  CHECK_INT(foundItemIds->GetNumberOfIds(), 1);
+  CHECK_INT(foundItemIds->GetId(0), itemId2);
+  CHECK_INT(shNode->GetItemByUID("copied", "1"), itemId2);
+
+  // Removed items are not found
+  shNode->RemoveItem(itemId2, false);
+  shNode->GetItemsByAttribute("asd", foundItemIds);
+  CHECK_INT(foundItemIds->GetNumberOfIds(), 0);
+  CHECK_INT(shNode->GetItemByUID("copied", "1"), vtkMRMLSubjectHierarchyNode::GetInvalidItemID());
+
   return EXIT_SUCCESS;
 }
@@ -25,14 +25,23 @@
 #include "vtkMRMLTableNode.h"
 #include "vtkMRMLTableStorageNode.h"
 #include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIntArray.h"
 #include "vtkStringArray.h"
 #include "vtkTable.h"
 
 #include <vtksys/SystemTools.hxx>
 
+// STD includes
+#include <cstring>
+#include <fstream>
+
 //---------------------------------------------------------------------------
 int TestReadWriteWithoutSchema(vtkMRMLScene* scene);
 int TestReadWriteWithSchema(vtkMRMLScene* scene);
+int TestReadWriteLargeTable(vtkMRMLScene* scene);
+int TestReadWriteFloatingPointPrecision(vtkMRMLScene* scene);
+int TestReadSpecialValues(vtkMRMLScene* scene);
 int TestReadWriteData(vtkMRMLScene* scene, const char *extension, vtkTable* table, bool schemaExpected);
 
 int vtkMRMLTableStorageNodeTest1(int argc, char * argv[])
@@ -52,6 +61,9 @@ int vtkMRMLTableStorageNodeTest1(int argc, char * argv[])
 
   CHECK_EXIT_SUCCESS(TestReadWriteWithoutSchema(scene.GetPointer()));
   CHECK_EXIT_SUCCESS(TestReadWriteWithSchema(scene.GetPointer()));
+  CHECK_EXIT_SUCCESS(TestReadWriteLargeTable(scene.GetPointer()));
+  CHECK_EXIT_SUCCESS(TestReadWriteFloatingPointPrecision(scene.GetPointer()));
+  CHECK_EXIT_SUCCESS(TestReadSpecialValues(scene.GetPointer()));
 
   std::cout << "Test passed." << std::endl;
   return EXIT_SUCCESS;
@@ -113,6 +125,152 @@ int TestReadWriteWithSchema(vtkMRMLScene* scene)
   return EXIT_SUCCESS;
 }
 
+//---------------------------------------------------------------------------
+int TestReadWriteLargeTable(vtkMRMLScene* scene)
+{
+  // Table that is large enough to be parsed in multiple chunks
+  const int numberOfRows = 200000;
+  vtkNew<vtkStringArray> col1;
+  col1->SetName("col1");
+  vtkNew<vtkDoubleArray> col2;
+  col2->SetName("col2");
+  vtkNew<vtkIntArray> col3;
+  col3->SetName("col3");
+  col3->SetNumberOfComponents(2);
+  col3->SetComponentName(0, "X");
+  col3->SetComponentName(1, "Y");
+  for (int row = 0; row < numberOfRows; ++row)
+  {
+    // string values contain the field delimiter of csv files
+    col1->InsertNextValue("item, " + std::to_string(row));
+    col2->InsertNextValue(row * 0.25 - 1000.0);
+    col3->InsertNextTuple2(row, -row);
+  }
+  vtkNew<vtkTable> table;
+  table->AddColumn(col1.GetPointer());
+  table->AddColumn(col2.GetPointer());
+  table->AddColumn(col3.GetPointer());
+
+  CHECK_EXIT_SUCCESS(TestReadWriteData(scene, ".csv", table.GetPointer(), true));
+  CHECK_EXIT_SUCCESS(TestReadWriteData(scene, ".tsv", table.GetPointer(), true));
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestReadWriteFloatingPointPrecision(vtkMRMLScene* scene)
+{
+  // Values that cannot be written exactly with digits10 significant digits
+  const double doubleValues[] = { 0.1 + 0.2, 0.1, 1.0 / 3.0, 2.0 / 3.0 * 1e-300, -1.0 / 7.0 * 1e300 };
+  const float floatValues[] = { 0.1f + 0.2f, 0.1f, 1.0f / 3.0f, 2.0f / 3.0f * 1e-30f, -1.0f / 7.0f * 1e30f };
+  const int numberOfRows = sizeof(doubleValues) / sizeof(doubleValues[0]);
+  vtkNew<vtkDoubleArray> doubleColumn;
+  doubleColumn->SetName("double");
+  vtkNew<vtkFloatArray> floatColumn;
+  floatColumn->SetName("float");
+  for (int row = 0; row < numberOfRows; ++row)
+  {
+    doubleColumn->InsertNextValue(doubleValues[row]);
+    floatColumn->InsertNextValue(floatValues[row]);
+  }
+  vtkNew<vtkTable> table;
+  table->AddColumn(doubleColumn.GetPointer());
+  table->AddColumn(floatColumn.GetPointer());
+
+  std::string fileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1Precision.csv";
+  vtkNew<vtkMRMLTableNode> tableNode;
+  tableNode->SetAndObserveTable(table);
+  CHECK_NOT_NULL(scene->AddNode(tableNode.GetPointer()));
+  tableNode->AddDefaultStorageNode();
+  vtkMRMLStorageNode* storageNode = tableNode->GetStorageNode();
+  CHECK_NOT_NULL(storageNode);
+  storageNode->SetFileName(fileName.c_str());
+  CHECK_BOOL(storageNode->WriteData(tableNode.GetPointer()), true);
+  tableNode->SetAndObserveTable(nullptr);
+  CHECK_BOOL(storageNode->ReadData(tableNode.GetPointer()), true);
+
+  // Values must be bit-exact after reading them back
+  vtkTable* table2 = tableNode->GetTable();
+  CHECK_NOT_NULL(table2);
+  vtkDoubleArray* doubleColumn2 = vtkDoubleArray::SafeDownCast(table2->GetColumnByName("double"));
+  CHECK_NOT_NULL(doubleColumn2);
+  vtkFloatArray* floatColumn2 = vtkFloatArray::SafeDownCast(table2->GetColumnByName("float"));
+  CHECK_NOT_NULL(floatColumn2);
+  CHECK_INT(doubleColumn2->GetNumberOfValues(), numberOfRows);
+  CHECK_INT(floatColumn2->GetNumberOfValues(), numberOfRows);
+  for (int row = 0; row < numberOfRows; ++row)
+  {
+    double doubleValue = doubleColumn2->GetValue(row);
+    CHECK_INT(memcmp(&doubleValue, &doubleValues[row], sizeof(double)), 0);
+    float floatValue = floatColumn2->GetValue(row);
+    CHECK_INT(memcmp(&floatValue, &floatValues[row], sizeof(float)), 0);
+  }
+
+  scene->RemoveNode(tableNode);
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestReadSpecialValues(vtkMRMLScene* scene)
+{
+  std::string fileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1Special.csv";
+  std::string schemaFileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1Special.schema.csv";
+
+  // Byte order mark, quoted values with delimiters and line breaks, empty records, empty and missing values
+  {
+    std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+    file << "\xEF\xBB\xBF" "name,value,count\r\n"
+      << "\"Smith, John\",1.5,3\r\n"
+      << "\r\n"
+      << "\"multi\nline\",,7\r\n"
+      << "short\r\n"
+      << "invalid,abc,1.5";
+  }
+  {
+    std::ofstream file(schemaFileName.c_str(), std::ios::out | std::ios::binary);
+    file << "columnName,type,nullValue,componentNames\n"
+      << "value,double,-1,\n"
+      << "count,int,,\n";
+  }
+
+  vtkNew<vtkMRMLTableNode> tableNode;
+  CHECK_NOT_NULL(scene->AddNode(tableNode.GetPointer()));
+  tableNode->AddDefaultStorageNode();
+  vtkMRMLStorageNode* storageNode = tableNode->GetStorageNode();
+  CHECK_NOT_NULL(storageNode);
+  storageNode->SetFileName(fileName.c_str());
+  CHECK_BOOL(storageNode->ReadData(tableNode.GetPointer()), true);
+
+  vtkTable* table = tableNode->GetTable();
+  CHECK_NOT_NULL(table);
+  CHECK_INT(table->GetNumberOfColumns(), 3);
+  CHECK_INT(table->GetNumberOfRows(), 4);
+
+  vtkStringArray* nameColumn = vtkStringArray::SafeDownCast(table->GetColumnByName("name"));
+  CHECK_NOT_NULL(nameColumn);
+  CHECK_STD_STRING(nameColumn->GetValue(0), "Smith, John");
+  CHECK_STD_STRING(nameColumn->GetValue(1), "multi\nline");
+  CHECK_STD_STRING(nameColumn->GetValue(2), "short");
+
+  // Empty and invalid values are set to the null value
+  vtkDoubleArray* valueColumn = vtkDoubleArray::SafeDownCast(table->GetColumnByName("value"));
+  CHECK_NOT_NULL(valueColumn);
+  CHECK_DOUBLE(valueColumn->GetValue(0), 1.5);
+  CHECK_DOUBLE(valueColumn->GetValue(1), -1.0);
+  CHECK_DOUBLE(valueColumn->GetValue(2), -1.0);
+  CHECK_DOUBLE(valueColumn->GetValue(3), -1.0);
+
+  vtkIntArray* countColumn = vtkIntArray::SafeDownCast(table->GetColumnByName("count"));
+  CHECK_NOT_NULL(countColumn);
+  CHECK_INT(countColumn->GetValue(0), 3);
+  CHECK_INT(countColumn->GetValue(1), 7);
+  CHECK_INT(countColumn->GetValue(2), 0);
+  CHECK_INT(countColumn->GetValue(3), 0);
+
+  scene->RemoveNode(tableNode);
+  return EXIT_SUCCESS;
+}
+
 //---------------------------------------------------------------------------
 int TestReadWriteData(vtkMRMLScene* scene, const char *extension, vtkTable* table, bool schemaExpected)
 {
@@ -167,6 +325,7 @@ int TestReadWriteData(vtkMRMLScene* scene, const char *extension, vtkTable* tabl
     vtkAbstractArray* column2 = table2->GetColumn(columnId);
     CHECK_NOT_NULL(column2);
 
+    CHECK_INT(column->GetDataType(), column2->GetDataType());
     CHECK_INT(column->GetNumberOfTuples(), column2->GetNumberOfTuples());
     CHECK_INT(column->GetNumberOfComponents(), column2->GetNumberOfComponents());
     for (vtkIdType valueId = 0; valueId < column->GetNumberOfValues(); ++valueId)
@@ -22,6 +22,7 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include <iostream>
 
 // VTK include
+#include <vtkNew.h>
 #include <vtkObjectFactory.h>
 
 vtkStandardNewMacro(vtkArchive);
@@ -225,7 +226,10 @@ long copy_data(struct archive *ar, struct archive *aw)
 vtkArchive::vtkArchive() = default;
 
 //----------------------------------------------------------------------------
-vtkArchive::~vtkArchive() = default;
+vtkArchive::~vtkArchive()
+{
+  this->CloseZip();
+}
 
 //----------------------------------------------------------------------------
 void vtkArchive::PrintSelf(ostream& os, vtkIndent indent)
@@ -363,16 +367,28 @@ bool vtkArchive::ExtractTar(const char* tarFileName, bool verbose, bool extract,
 // creates a zip file with the full contents of the directory (recurses)
 // zip entries will include relative path of including tail of directoryToZip
 bool vtkArchive::Zip(const char* zipFileName, const char* directoryToZip)
+{
+  vtkNew<vtkArchive> zipArchive;
+  if (!zipArchive->OpenZip(zipFileName, directoryToZip))
+  {
+    return false;
+  }
+  bool success = zipArchive->AddRemainingFilesToZip();
+  success = zipArchive->CloseZip() && success;
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::OpenZip(const char* zipFileName, const char* directoryToZip)
 {
 
   //
   // to make a zip file:
   // - check that libarchive supports zip writing
   // - check arguments
-  // - get a list of files using vtksys Glob
   // - create the archive
-  // -- go file-by-file and add chunks of data to the archive
-  // - close up and return success
+  // - add files file-by-file (AddFileToZip, AddRemainingFilesToZip)
+  // - close up and return success (CloseZip)
   //
 
 // only support the libarchive version 3.0 +
@@ -385,22 +401,16 @@ bool vtkArchive::Zip(const char* zipFileName, const char* directoryToZip)
     vtkArchiveTools::Error("Zip:", "Invalid zipfile or directory");
     return false;
   }
+  if (this->ZipArchive)
+  {
+    vtkArchiveTools::Error("Zip:", "A zip file is already open");
+    return false;
+  }
 
   std::vector<std::string> directoryParts;
   directoryParts = vtksys::SystemTools::SplitString(directoryToZip, '/', true);
   std::string directoryName = directoryParts.back();
 
-  vtksys::Glob glob;
-  glob.RecurseOn();
-  glob.RecurseThroughSymlinksOff();
-  std::string globPattern(directoryToZip);
-  if (!glob.FindFiles(globPattern + "/*"))
-  {
-    vtkArchiveTools::Error("Zip:", "Could not find files in directory");
-    return false;
-  }
-  std::vector<std::string> files = glob.GetFiles();
-
   // now zip it up using LibArchive
   struct archive* zipArchive = archive_write_new();
 
@@ -436,81 +446,155 @@ bool vtkArchive::Zip(const char* zipFileName, const char* directoryToZip)
   if (archive_write_header(zipArchive, dirEntry) != ARCHIVE_OK)
   {
     vtkArchiveTools::Error("Zip: write file header:", archive_error_string(zipArchive));
+    archive_entry_free(dirEntry);
     archive_write_free(zipArchive);
     return false;
   }
   archive_entry_free(dirEntry);
 
-  // add the files
+  this->ZipArchive = zipArchive;
+  this->ZipDirectory = vtksys::SystemTools::CollapseFullPath(directoryToZip);
+  this->ZippedFiles.clear();
+  this->ZipError = false;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::AddFileToZip(const char* fileName)
+{
+  if (!this->ZipArchive)
+  {
+    vtkArchiveTools::Error("Zip:", "Zip file is not open");
+    return false;
+  }
+  if (!fileName)
+  {
+    vtkArchiveTools::Error("Zip:", "Invalid file name");
+    return false;
+  }
+  std::string filePath = vtksys::SystemTools::CollapseFullPath(fileName);
+  if (!this->ZippedFiles.insert(filePath).second)
+  {
+    // already added
+    return true;
+  }
+  if (!vtksys::SystemTools::IsSubDirectory(filePath, this->ZipDirectory))
+  {
+    vtkArchiveTools::Error("Zip: file is not in the zipped directory:", filePath.c_str());
+    this->ZipError = true;
+    return false;
+  }
+  vtkArchiveTools::Message("Zip: adding:", filePath.c_str());
+
+  //
+  // add an entry for this file
+  //
+  // use a relative path for the entry file name, including the top
+  // directory so it unzips into a directory of it's own
+  std::string relFileName = vtksys::SystemTools::RelativePath(
+            vtksys::SystemTools::GetParentDirectory(this->ZipDirectory).c_str(),
+            filePath.c_str());
+  vtkArchiveTools::Message("Zip: adding rel:", relFileName.c_str());
+
+  FILE *fd = fopen(filePath.c_str(), "rb");
+  if (!fd)
+  {
+    vtkArchiveTools::Error("Zip: cannot open input file:", filePath.c_str());
+    this->ZipError = true;
+    return false;
+  }
+
+  struct archive_entry* entry = archive_entry_new();
+  archive_entry_set_pathname(entry, relFileName.c_str());
+  // size is required, for now use the vtksys call though it uses struct stat
+  // and may not be portable
+  unsigned long fileLength = vtksys::SystemTools::FileLength(filePath);
+  archive_entry_set_size(entry, fileLength);
+  archive_entry_set_filetype(entry, AE_IFREG);
+  archive_entry_set_perm(entry, 0644);
+  if (archive_write_header(this->ZipArchive, entry) != ARCHIVE_OK)
+  {
+    vtkArchiveTools::Error("Zip: write file header:", archive_error_string(this->ZipArchive));
+    archive_entry_free(entry);
+    fclose(fd);
+    this->ZipError = true;
+    return false;
+  }
+
+  //
+  // add the data for this entry
+  //
   bool success = true;
   char buff[BUFSIZ];
-  std::vector<std::string>::const_iterator sit;
-  sit = files.begin();
-  while (sit != files.end() && success)
-  {
-    vtkArchiveTools::Message("Zip: adding:", sit->c_str());
-    const char *fileName = sit->c_str();
-    ++sit;
-
-    //
-    // add an entry for this file
-    //
-    struct archive_entry* entry = archive_entry_new();
-    // use a relative path for the entry file name, including the top
-    // directory so it unzips into a directory of it's own
-    std::string relFileName = vtksys::SystemTools::RelativePath(
-              vtksys::SystemTools::GetParentDirectory(directoryToZip).c_str(),
-              fileName);
-    vtkArchiveTools::Message("Zip: adding rel:", relFileName.c_str());
-    archive_entry_set_pathname(entry, relFileName.c_str());
-    // size is required, for now use the vtksys call though it uses struct stat
-    // and may not be portable
-    unsigned long fileLength = vtksys::SystemTools::FileLength(fileName);
-    archive_entry_set_size(entry, fileLength);
-    archive_entry_set_filetype(entry, AE_IFREG);
-    archive_entry_set_perm(entry, 0644);
-    if (archive_write_header(zipArchive, entry) != ARCHIVE_OK)
-    {
-      vtkArchiveTools::Error("Zip: write file header:", archive_error_string(zipArchive));
-      return false;
-    }
-
-    //
-    // add the data for this entry
-    //
-    FILE *fd = fopen(fileName, "rb");
-    if (!fd)
+  size_t len = fread(buff, sizeof(char), sizeof(buff), fd);
+  while (len > 0 && success)
+  {
+    if (archive_write_data(this->ZipArchive, buff, len) < 0)
     {
-      vtkArchiveTools::Error("Zip: cannot open input file:", sit->c_str());
+      vtkArchiveTools::Error("Zip: cannot write data:", archive_error_string(this->ZipArchive));
       success = false;
     }
-    else
-    {
-      size_t len = fread(buff, sizeof(char), sizeof(buff), fd);
-      while ( len > 0 )
-      {
-        if (archive_write_data(zipArchive, buff, len) < 0)
-        {
-          vtkArchiveTools::Error("Zip: cannot write data:", archive_error_string(zipArchive));
-          success = false;
-        }
-        len = fread(buff, sizeof(char), sizeof(buff), fd);
-      }
-      fclose(fd);
-    }
-    archive_entry_free(entry);
+    len = fread(buff, sizeof(char), sizeof(buff), fd);
+  }
+  fclose(fd);
+  archive_entry_free(entry);
+  if (!success)
+  {
+    this->ZipError = true;
   }
+  return success;
+}
 
-  if (archive_write_close(zipArchive) != ARCHIVE_OK)
+//-----------------------------------------------------------------------------
+bool vtkArchive::AddRemainingFilesToZip()
+{
+  if (!this->ZipArchive)
+  {
+    vtkArchiveTools::Error("Zip:", "Zip file is not open");
+    return false;
+  }
+
+  vtksys::Glob glob;
+  glob.RecurseOn();
+  glob.RecurseThroughSymlinksOff();
+  if (!glob.FindFiles(this->ZipDirectory + "/*"))
+  {
+    vtkArchiveTools::Error("Zip:", "Could not find files in directory");
+    return false;
+  }
+  std::vector<std::string> files = glob.GetFiles();
+
+  // add the files
+  bool success = true;
+  for (std::vector<std::string>::const_iterator sit = files.begin(); sit != files.end() && success; ++sit)
+  {
+    success = this->AddFileToZip(sit->c_str());
+  }
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::CloseZip()
+{
+  if (!this->ZipArchive)
+  {
+    return true;
+  }
+  bool success = !this->ZipError;
+  if (archive_write_close(this->ZipArchive) != ARCHIVE_OK)
   {
-    vtkArchiveTools::Error("Zip: close archive", archive_error_string(zipArchive));
+    vtkArchiveTools::Error("Zip: close archive", archive_error_string(this->ZipArchive));
     success = false;
   }
-  if (archive_write_free(zipArchive) != ARCHIVE_OK)
+  if (archive_write_free(this->ZipArchive) != ARCHIVE_OK)
   {
-    vtkArchiveTools::Error("Zip: cleanup", archive_error_string(zipArchive));
+    vtkArchiveTools::Error("Zip: cleanup", archive_error_string(this->ZipArchive));
     success = false;
   }
+  this->ZipArchive = nullptr;
+  this->ZipDirectory.clear();
+  this->ZippedFiles.clear();
+  this->ZipError = false;
   return success;
 }
 
@@ -17,9 +17,12 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include <vtkObject.h>
 
 // STD includes
+#include <set>
 #include <string>
 #include <vector>
 
+struct archive;
+
 /// \brief Simple class for manipulating archive files
 ///
 class VTK_MRML_EXPORT vtkArchive : public vtkObject
@@ -39,6 +42,23 @@ public:
   // zip entries will include relative path of including tail of directoryToZip
   static bool Zip(const char* zipFileName, const char* directoryToZip);
 
+  // Incremental zip file creation, for adding files to the archive as soon as
+  // they are available (for example, while other files of the directory are still
+  // being written) instead of zipping the complete directory at the end.
+  // Zip entries include relative path of including tail of directoryToZip, same as in Zip().
+  // Returns false if the zip file could not be created.
+  bool OpenZip(const char* zipFileName, const char* directoryToZip);
+  // Add a file to the zip file opened by OpenZip. The file must be within directoryToZip.
+  // Files that have been already added are ignored.
+  bool AddFileToZip(const char* fileName);
+  // Add all files in directoryToZip (recursively) that have not been added yet.
+  bool AddRemainingFilesToZip();
+  // Finish writing of the zip file opened by OpenZip.
+  // Returns false if adding of any file failed.
+  bool CloseZip();
+  // Returns true if a zip file has been opened by OpenZip and not closed yet.
+  bool IsZipOpen() { return this->ZipArchive != nullptr; }
+
   // unzips zip file into specified directory
   // (internally this supports many formats of archive, not just zip)
   static bool UnZip(const char* zipFileName, const char *destinationDirectory);
@@ -48,6 +68,11 @@ protected:
   ~vtkArchive() override;
   vtkArchive(const vtkArchive&);
   void operator=(const vtkArchive&);
+
+  struct archive* ZipArchive{ nullptr };
+  std::string ZipDirectory;
+  std::set<std::string> ZippedFiles;
+  bool ZipError{ false };
 };
 
 #endif
@@ -96,6 +96,9 @@ vtkEventBroker::vtkEventBroker()
   this->EventNestingLevel = 0;
   this->TimerLog = vtkTimerLog::New();
   this->CompressCallData = 0;
+  this->EventCoalescing = 0;
+  this->EventBatchLevel = 0;
+  this->CoalescedEvents.insert(vtkCommand::ModifiedEvent);
   this->LogFileName = nullptr;
   this->ScriptHandler = nullptr;
   this->ScriptHandlerClientData = nullptr;
@@ -557,8 +560,7 @@ int vtkEventBroker::GenerateGraphFile ( const char *graphFile )
           << " -> "
           << observation->GetSubject()->GetClassName()
           << " [ label = \""
-          << vtkCommand::GetStringFromEventId( observation->GetEvent() )
-          << "\" ];\n" ;
+          << vtkCommand::GetStringFromEventId( observation->GetEvent() );
     }
     else
     {
@@ -567,9 +569,15 @@ int vtkEventBroker::GenerateGraphFile ( const char *graphFile )
           << " -> "
           << observation->GetSubject()->GetClassName()
           << " [ label = \""
-          << vtkCommand::GetStringFromEventId( observation->GetEvent() )
-          << "\" ];\n" ;
+          << vtkCommand::GetStringFromEventId( observation->GetEvent() );
+    }
+    if ( observation->GetInvocationCount() > 0 || observation->GetCoalescedCount() > 0 )
+    {
+      file << "\\ninvoked: " << observation->GetInvocationCount()
+          << " coalesced: " << observation->GetCoalescedCount()
+          << " time: " << observation->GetTotalElapsedTime() << "s";
     }
+    file << "\" ];\n" ;
     file.flush();
   }
 
@@ -669,7 +677,10 @@ void vtkEventBroker::LogEvent ( vtkObservation *observation )
     {
       this->LogFile << " ";
     }
-    this->LogFile << " # " << observation->GetLastElapsedTime() << " seconds \n";
+    this->LogFile << " # " << observation->GetLastElapsedTime() << " seconds"
+      << " (invoked: " << observation->GetInvocationCount()
+      << " coalesced: " << observation->GetCoalescedCount()
+      << " total: " << observation->GetTotalElapsedTime() << " seconds) \n";
 
     this->LogFile.flush();
   }
@@ -685,14 +696,19 @@ void vtkEventBroker::ProcessEvent ( vtkObservation *observation, vtkObject *call
   //   be a delete event that the event broker asked for)
   // - if the observer did ask to observe delete events, pass them through
   //   right away even in async mode - this way things can clean up
+  // - in a coalescing batch, coalesced events are queued as in asynchronous
+  //   mode and invoked when the batch ends
   //
   if ( eid == observation->GetEvent() || observation->GetEvent() == vtkCommand::AnyEvent )
   {
-    if ( this->EventMode == vtkEventBroker::Synchronous || eid == vtkCommand::DeleteEvent )
+    bool coalesce = ( this->EventCoalescing && this->EventBatchLevel > 0
+      && eid != vtkCommand::DeleteEvent && this->IsEventCoalesced( eid ) );
+    if ( eid == vtkCommand::DeleteEvent
+      || ( this->EventMode == vtkEventBroker::Synchronous && !coalesce ) )
     {
       this->InvokeObservation( observation, eid, callData );
     }
-    else if ( this->EventMode == vtkEventBroker::Asynchronous )
+    else if ( this->EventMode == vtkEventBroker::Asynchronous || coalesce )
     {
       this->QueueObservation( observation, eid, callData );
     }
@@ -761,6 +777,10 @@ void vtkEventBroker::QueueObservation ( vtkObservation *observation,
   if ( this->GetCompressCallData() &&
        observation->GetEvent() != vtkCommand::AnyEvent)
   {
+    if ( !observation->GetCallDataList()->empty() )
+    {
+      observation->SetCoalescedCount( observation->GetCoalescedCount() + 1 );
+    }
     observation->GetCallDataList()->clear();
     observation->GetCallDataList()->push_back( call );
   }
@@ -779,6 +799,10 @@ void vtkEventBroker::QueueObservation ( vtkObservation *observation,
     {
       observation->GetCallDataList()->push_back( call );
     }
+    else
+    {
+      observation->SetCoalescedCount( observation->GetCoalescedCount() + 1 );
+    }
   }
 
   if ( !observation->GetInEventQueue() )
@@ -848,6 +872,7 @@ void vtkEventBroker::InvokeObservation ( vtkObservation *observation,
   double elapsedTime = this->TimerLog->GetUniversalTime() - startTime;
   observation->SetTotalElapsedTime (observation->GetTotalElapsedTime() + elapsedTime);
   observation->SetLastElapsedTime (elapsedTime);
+  observation->SetInvocationCount (observation->GetInvocationCount() + 1);
   this->LogEvent (observation);
 
   // clear reference to observation (may cause delete)
@@ -889,6 +914,74 @@ void vtkEventBroker::ProcessEventQueue ()
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkEventBroker::AddCoalescedEvent ( unsigned long event )
+{
+  if ( event == vtkCommand::DeleteEvent )
+  {
+    vtkWarningMacro( "AddCoalescedEvent: DeleteEvent cannot be coalesced" );
+    return;
+  }
+  this->CoalescedEvents.insert( event );
+}
+
+//----------------------------------------------------------------------------
+void vtkEventBroker::RemoveCoalescedEvent ( unsigned long event )
+{
+  this->CoalescedEvents.erase( event );
+}
+
+//----------------------------------------------------------------------------
+void vtkEventBroker::RemoveAllCoalescedEvents ()
+{
+  this->CoalescedEvents.clear();
+}
+
+//----------------------------------------------------------------------------
+bool vtkEventBroker::IsEventCoalesced ( unsigned long event )
+{
+  return ( this->CoalescedEvents.find( event ) != this->CoalescedEvents.end() );
+}
+
+//----------------------------------------------------------------------------
+void vtkEventBroker::StartEventBatch ()
+{
+  this->EventBatchLevel++;
+}
+
+//----------------------------------------------------------------------------
+void vtkEventBroker::EndEventBatch ()
+{
+  if ( this->EventBatchLevel <= 0 )
+  {
+    vtkErrorMacro( "EndEventBatch: no event batch was started" );
+    return;
+  }
+  this->EventBatchLevel--;
+  if ( this->EventBatchLevel == 0 && this->EventMode == vtkEventBroker::Synchronous )
+  {
+    // deliver the events that were coalesced during the batch
+    this->ProcessEventQueue();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkEventBroker::ResetObservationStatistics ()
+{
+  ObjectToObservationVectorMap::iterator mapiter;
+  ObservationVector::iterator oiter;
+  for (mapiter = this->SubjectMap.begin(); mapiter != this->SubjectMap.end(); mapiter++)
+  {
+    for(oiter=(mapiter->second).begin(); oiter != (mapiter->second).end(); oiter++)
+    {
+      (*oiter)->SetInvocationCount( 0 );
+      (*oiter)->SetCoalescedCount( 0 );
+      (*oiter)->SetLastElapsedTime( 0.0 );
+      (*oiter)->SetTotalElapsedTime( 0.0 );
+    }
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkEventBroker::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -899,6 +992,8 @@ void vtkEventBroker::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "EventMode: " << this->GetEventModeAsString() << "\n";
   os << indent << "EventLogging: " << this->EventLogging << "\n";
   os << indent << "EventNestingLevel: " << this->EventNestingLevel << "\n";
+  os << indent << "EventCoalescing: " << this->EventCoalescing << "\n";
+  os << indent << "EventBatchLevel: " << this->EventBatchLevel << "\n";
   os << indent << "LogFileName: " <<
     (this->LogFileName ? this->LogFileName : "(none)") << "\n";
 }
@@ -233,6 +233,39 @@ public:
   vtkGetMacro (CompressCallData, int);
   vtkSetMacro (CompressCallData, int);
 
+  /// Event coalescing
+  ///
+  /// When coalescing is enabled, coalesced events (only ModifiedEvent by
+  /// default) that are received between StartEventBatch() and EndEventBatch()
+  /// are queued instead of being invoked immediately. Repeated events of
+  /// the same observation (subject, event, observer) are collapsed into a
+  /// single invocation when the outermost batch ends. Number of invocations,
+  /// number of coalesced events and total elapsed time are recorded in each
+  /// observation and are written to the event log and graph file.
+  /// Coalescing is OFF by default.
+  vtkBooleanMacro (EventCoalescing, int);
+  vtkGetMacro (EventCoalescing, int);
+  vtkSetMacro (EventCoalescing, int);
+
+  ///
+  /// Set events that are coalesced within a batch.
+  /// DeleteEvent is never coalesced.
+  void AddCoalescedEvent (unsigned long event);
+  void RemoveCoalescedEvent (unsigned long event);
+  void RemoveAllCoalescedEvents ();
+  bool IsEventCoalesced (unsigned long event);
+
+  ///
+  /// Start and end a batch window. Batches can be nested, queued events
+  /// are processed when the outermost batch ends.
+  void StartEventBatch ();
+  void EndEventBatch ();
+  vtkGetMacro (EventBatchLevel, int);
+
+  ///
+  /// Reset invocation count, coalesced count, and elapsed time of all observations
+  void ResetObservationStatistics ();
+
   ///
   /// Sets the method pointer to be used for processing script observations
   void SetScriptHandler ( void (*scriptHandler) (const char* script, void *clientData), void *clientData )
@@ -297,6 +330,10 @@ protected:
   int EventMode;
   int CompressCallData;
 
+  int EventCoalescing;
+  int EventBatchLevel;
+  std::set< unsigned long > CoalescedEvents;
+
   std::ofstream LogFile;
 
   vtkCallbackCommand* RequestModifiedCallback;
@@ -0,0 +1,343 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkImageHistogramCache.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <vector>
+
+vtkStandardNewMacro(vtkImageHistogramCache);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+struct HistogramEntry
+{
+  vtkWeakPointer<vtkDataArray> Scalars;
+  vtkMTimeType ScalarsMTime{ 0 };
+  int Dimensions[3] = { 0, 0, 0 };
+  int SampleStride{ 1 };
+  int MaximumNumberOfBins{ 0 };
+  double BinOrigin{ 0.0 };
+  double BinSpacing{ 1.0 };
+  std::vector<vtkIdType> Counts;
+};
+
+//----------------------------------------------------------------------------
+/// Accumulates the histogram of a range of sampled rows in thread-local bins.
+template <class T>
+class HistogramFunctor
+{
+public:
+  HistogramFunctor(const T* scalars, int numberOfComponents, const int dimensions[3], int sampleStride,
+    double binOrigin, double binSpacing, size_t numberOfBins)
+    : Scalars(scalars)
+    , NumberOfComponents(numberOfComponents)
+    , SampleStride(sampleStride)
+    , BinOrigin(binOrigin)
+    , BinSpacing(binSpacing)
+    , NumberOfBins(numberOfBins)
+  {
+    std::copy(dimensions, dimensions + 3, this->Dimensions);
+    this->NumberOfSampledRowsInSlice = (this->Dimensions[1] + sampleStride - 1) / sampleStride;
+  }
+
+  void Initialize()
+  {
+    this->LocalCounts.Local().assign(this->NumberOfBins, 0);
+  }
+
+  void operator()(vtkIdType firstRow, vtkIdType lastRow)
+  {
+    std::vector<vtkIdType>& counts = this->LocalCounts.Local();
+    const vtkIdType maximumBinIndex = static_cast<vtkIdType>(this->NumberOfBins) - 1;
+    const vtkIdType pixelIncrement = static_cast<vtkIdType>(this->SampleStride) * this->NumberOfComponents;
+    for (vtkIdType row = firstRow; row < lastRow; ++row)
+    {
+      vtkIdType j = (row % this->NumberOfSampledRowsInSlice) * this->SampleStride;
+      vtkIdType k = (row / this->NumberOfSampledRowsInSlice) * this->SampleStride;
+      const T* scalarPtr = this->Scalars
+        + (k * this->Dimensions[1] + j) * this->Dimensions[0] * this->NumberOfComponents;
+      for (int i = 0; i < this->Dimensions[0]; i += this->SampleStride, scalarPtr += pixelIncrement)
+      {
+        double binIndex = std::floor((static_cast<double>(*scalarPtr) - this->BinOrigin) / this->BinSpacing + 0.5);
+        if (std::isnan(binIndex))
+        {
+          continue;
+        }
+        vtkIdType clampedBinIndex = (binIndex <= 0.0 ? 0
+          : (binIndex >= maximumBinIndex ? maximumBinIndex : static_cast<vtkIdType>(binIndex)));
+        ++counts[clampedBinIndex];
+      }
+    }
+  }
+
+  void Reduce()
+  {
+    this->Counts.assign(this->NumberOfBins, 0);
+    for (const std::vector<vtkIdType>& localCounts : this->LocalCounts)
+    {
+      for (size_t binIndex = 0; binIndex < this->NumberOfBins; ++binIndex)
+      {
+        this->Counts[binIndex] += localCounts[binIndex];
+      }
+    }
+  }
+
+  vtkIdType GetNumberOfSampledRows() const
+  {
+    return static_cast<vtkIdType>(this->NumberOfSampledRowsInSlice)
+      * ((this->Dimensions[2] + this->SampleStride - 1) / this->SampleStride);
+  }
+
+  std::vector<vtkIdType> Counts;
+
+private:
+  const T* Scalars;
+  int NumberOfComponents;
+  int Dimensions[3];
+  int SampleStride;
+  int NumberOfSampledRowsInSlice;
+  double BinOrigin;
+  double BinSpacing;
+  size_t NumberOfBins;
+  vtkSMPThreadLocal<std::vector<vtkIdType>> LocalCounts;
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+void ComputeHistogram(const T* scalars, int numberOfComponents, const int dimensions[3], int sampleStride,
+  HistogramEntry& entry)
+{
+  HistogramFunctor<T> functor(scalars, numberOfComponents, dimensions, sampleStride,
+    entry.BinOrigin, entry.BinSpacing, entry.Counts.size());
+  vtkSMPTools::For(0, functor.GetNumberOfSampledRows(), functor);
+  entry.Counts.swap(functor.Counts);
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+class vtkImageHistogramCache::vtkInternal
+{
+public:
+  /// Most recently used entry is at the front.
+  std::list<HistogramEntry> Entries;
+};
+
+//----------------------------------------------------------------------------
+vtkImageHistogramCache::vtkImageHistogramCache()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkImageHistogramCache::~vtkImageHistogramCache()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageHistogramCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumNumberOfBins: " << this->MaximumNumberOfBins << "\n";
+  os << indent << "MaximumNumberOfCachedHistograms: " << this->MaximumNumberOfCachedHistograms << "\n";
+  os << indent << "NumberOfCachedHistograms: " << this->GetNumberOfCachedHistograms() << "\n";
+  os << indent << "NumberOfComputedHistograms: " << this->NumberOfComputedHistograms << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkImageHistogramCache::ClearCache()
+{
+  this->Internal->Entries.clear();
+}
+
+//----------------------------------------------------------------------------
+int vtkImageHistogramCache::GetNumberOfCachedHistograms()
+{
+  return static_cast<int>(this->Internal->Entries.size());
+}
+
+//----------------------------------------------------------------------------
+bool vtkImageHistogramCache::GetHistogram(vtkImageData* imageData, vtkIdTypeArray* histogram,
+  double& binOrigin, double& binSpacing, int sampleStride/*=1*/)
+{
+  if (!histogram)
+  {
+    vtkErrorMacro("GetHistogram: invalid histogram array");
+    return false;
+  }
+  vtkDataArray* scalars = (imageData && imageData->GetPointData()) ? imageData->GetPointData()->GetScalars() : nullptr;
+  if (!scalars || scalars->GetNumberOfTuples() < 1)
+  {
+    return false;
+  }
+  sampleStride = std::max(sampleStride, 1);
+  int dimensions[3] = { 0, 0, 0 };
+  imageData->GetDimensions(dimensions);
+  if (static_cast<vtkIdType>(dimensions[0]) * dimensions[1] * dimensions[2] != scalars->GetNumberOfTuples())
+  {
+    vtkErrorMacro("GetHistogram: number of scalars does not match the image dimensions");
+    return false;
+  }
+
+  // Remove entries of deleted arrays and look up the requested histogram
+  std::list<HistogramEntry>& entries = this->Internal->Entries;
+  entries.remove_if([](const HistogramEntry& entry) { return entry.Scalars == nullptr; });
+  auto entryIt = std::find_if(entries.begin(), entries.end(), [&](const HistogramEntry& entry)
+  {
+    return entry.Scalars == scalars && entry.ScalarsMTime == scalars->GetMTime()
+      && std::equal(dimensions, dimensions + 3, entry.Dimensions)
+      && entry.SampleStride == sampleStride && entry.MaximumNumberOfBins == this->MaximumNumberOfBins;
+  });
+
+  if (entryIt != entries.end())
+  {
+    entries.splice(entries.begin(), entries, entryIt);
+  }
+  else
+  {
+    HistogramEntry entry;
+    entry.Scalars = scalars;
+    entry.ScalarsMTime = scalars->GetMTime();
+    std::copy(dimensions, dimensions + 3, entry.Dimensions);
+    entry.SampleStride = sampleStride;
+    entry.MaximumNumberOfBins = this->MaximumNumberOfBins;
+
+    // The range is cached in the array, therefore it is only computed once
+    double scalarRange[2] = { 0.0, 0.0 };
+    scalars->GetRange(scalarRange, 0);
+    size_t numberOfBins = 1;
+    entry.BinOrigin = scalarRange[0];
+    entry.BinSpacing = 1.0;
+    if (scalarRange[1] > scalarRange[0])
+    {
+      int dataType = scalars->GetDataType();
+      bool integerType = (dataType != VTK_FLOAT && dataType != VTK_DOUBLE);
+      double integerNumberOfBins = std::floor(scalarRange[1]) - std::floor(scalarRange[0]) + 1.0;
+      if (integerType && integerNumberOfBins <= this->MaximumNumberOfBins)
+      {
+        numberOfBins = static_cast<size_t>(integerNumberOfBins);
+      }
+      else
+      {
+        numberOfBins = static_cast<size_t>(this->MaximumNumberOfBins);
+        entry.BinSpacing = (scalarRange[1] - scalarRange[0]) / (numberOfBins - 1);
+      }
+    }
+    entry.Counts.resize(numberOfBins);
+
+    const int numberOfComponents = scalars->GetNumberOfComponents();
+    switch (scalars->GetDataType())
+    {
+      vtkTemplateMacro(ComputeHistogram<VTK_TT>(static_cast<const VTK_TT*>(scalars->GetVoidPointer(0)),
+        numberOfComponents, dimensions, sampleStride, entry));
+      default:
+        vtkErrorMacro("GetHistogram: unsupported scalar type " << scalars->GetDataTypeAsString());
+        return false;
+    }
+    this->NumberOfComputedHistograms++;
+
+    entries.push_front(std::move(entry));
+    while (static_cast<int>(entries.size()) > this->MaximumNumberOfCachedHistograms)
+    {
+      entries.pop_back();
+    }
+  }
+
+  const HistogramEntry& entry = entries.front();
+  binOrigin = entry.BinOrigin;
+  binSpacing = entry.BinSpacing;
+  histogram->SetNumberOfComponents(1);
+  histogram->SetNumberOfTuples(static_cast<vtkIdType>(entry.Counts.size()));
+  std::copy(entry.Counts.begin(), entry.Counts.end(), histogram->GetPointer(0));
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkImageHistogramCache::GetPercentileRange(vtkImageData* imageData, double lowerPercentile, double upperPercentile,
+  double range[2], int sampleStride/*=1*/)
+{
+  vtkNew<vtkIdTypeArray> histogram;
+  double binOrigin = 0.0;
+  double binSpacing = 1.0;
+  if (!this->GetHistogram(imageData, histogram, binOrigin, binSpacing, sampleStride))
+  {
+    return false;
+  }
+
+  const vtkIdType numberOfBins = histogram->GetNumberOfTuples();
+  const vtkIdType* counts = histogram->GetPointer(0);
+  double total = 0.0;
+  for (vtkIdType binIndex = 0; binIndex < numberOfBins; ++binIndex)
+  {
+    total += counts[binIndex];
+  }
+  if (total <= 0.0)
+  {
+    return false;
+  }
+
+  // Lower bound is the first bin that is above the lower percentile,
+  // upper bound is the first bin that reaches the upper percentile.
+  const double lowerCount = total * std::min(std::max(lowerPercentile, 0.0), 100.0) * 0.01;
+  const double upperCount = total * std::min(std::max(upperPercentile, 0.0), 100.0) * 0.01;
+  vtkIdType lowerBinIndex = -1;
+  vtkIdType upperBinIndex = -1;
+  double sum = 0.0;
+  for (vtkIdType binIndex = 0; binIndex < numberOfBins && upperBinIndex < 0; ++binIndex)
+  {
+    if (counts[binIndex] == 0)
+    {
+      continue;
+    }
+    sum += counts[binIndex];
+    if (lowerBinIndex < 0 && sum > lowerCount)
+    {
+      lowerBinIndex = binIndex;
+    }
+    if (sum >= upperCount)
+    {
+      upperBinIndex = binIndex;
+    }
+  }
+  if (lowerBinIndex < 0)
+  {
+    lowerBinIndex = numberOfBins - 1;
+  }
+  if (upperBinIndex < lowerBinIndex)
+  {
+    upperBinIndex = lowerBinIndex;
+  }
+  range[0] = binOrigin + lowerBinIndex * binSpacing;
+  range[1] = binOrigin + upperBinIndex * binSpacing;
+  return true;
+}
@@ -0,0 +1,103 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef vtkImageHistogramCache_h
+#define vtkImageHistogramCache_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+class vtkImageData;
+class vtkIdTypeArray;
+
+/// \brief Compute and cache intensity histograms of images.
+///
+/// Histograms are computed in parallel, from the first scalar component of the image.
+/// Results are kept until the scalar array of the image is modified, so that
+/// all the display nodes of a volume, and modules that need percentiles of the
+/// intensity distribution (automatic window/level, volume rendering presets,
+/// thresholding) can share a single computation.
+///
+/// Histograms are cached for the most recently used scalar arrays. This allows
+/// reusing the results when the same image data is displayed again (for example,
+/// when browsing the frames of a volume sequence).
+///
+/// A strided sample of the voxels may be used to quickly get an estimate for large images.
+/// Histograms of different sampling strides are cached separately.
+///
+/// Integer images with a range that fits into the maximum number of bins are
+/// binned by integer value, other images are binned into the maximum number
+/// of bins, evenly distributed over the scalar range.
+class VTK_MRML_EXPORT vtkImageHistogramCache : public vtkObject
+{
+public:
+  static vtkImageHistogramCache *New();
+  vtkTypeMacro(vtkImageHistogramCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Get the intensity range that contains all the voxels, except the lowest and highest
+  /// percentiles. Percentiles are specified as percentage (between 0 and 100).
+  /// If sampleStride is larger than 1 then only every sampleStride-th voxel along each axis
+  /// is taken into account.
+  /// Returns false if the image has no scalars.
+  bool GetPercentileRange(vtkImageData* imageData, double lowerPercentile, double upperPercentile,
+    double range[2], int sampleStride = 1);
+
+  /// Get the histogram of the image. Value of bin i is the number of voxels with intensity
+  /// between binOrigin + (i - 0.5) * binSpacing and binOrigin + (i + 0.5) * binSpacing.
+  /// If sampleStride is larger than 1 then only every sampleStride-th voxel along each axis
+  /// is taken into account.
+  /// Returns false if the image has no scalars.
+  bool GetHistogram(vtkImageData* imageData, vtkIdTypeArray* histogram,
+    double& binOrigin, double& binSpacing, int sampleStride = 1);
+
+  /// Maximum number of bins of a histogram. Default is 65536.
+  vtkSetClampMacro(MaximumNumberOfBins, int, 2, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfBins, int);
+
+  /// Maximum number of histograms kept in the cache. Default is 8.
+  vtkSetClampMacro(MaximumNumberOfCachedHistograms, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfCachedHistograms, int);
+
+  /// Remove all cached histograms.
+  void ClearCache();
+
+  /// Number of histograms currently in the cache.
+  int GetNumberOfCachedHistograms();
+
+  /// Number of histogram computations performed so far.
+  /// Used for testing that results are reused.
+  vtkGetMacro(NumberOfComputedHistograms, int);
+
+protected:
+  vtkImageHistogramCache();
+  ~vtkImageHistogramCache() override;
+
+  int MaximumNumberOfBins{ 65536 };
+  int MaximumNumberOfCachedHistograms{ 8 };
+  int NumberOfComputedHistograms{ 0 };
+
+private:
+  vtkImageHistogramCache(const vtkImageHistogramCache&) = delete;
+  void operator=(const vtkImageHistogramCache&) = delete;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
@@ -42,6 +42,11 @@ vtkMRMLColorNode::vtkMRMLColorNode()
   this->SetNoName("(none)");
 
   this->NamesInitialised = 0;
+
+  this->ContentDeferred = false;
+  this->ColorNameIndexValid = false;
+  this->ColorNameIndexNumberOfColors = 0;
+  this->ColorNameIndexTime = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -149,9 +154,13 @@ void vtkMRMLColorNode::Copy(vtkMRMLNode *anode)
 
   // copy names
   this->Names = node->Names;
+  this->ColorNamesModified();
 
   this->NamesInitialised = node->NamesInitialised;
 
+  // content of a deferred node is created when it is accessed
+  this->ContentDeferred = node->ContentDeferred;
+
   this->EndModify(disabledModify);
 
 }
@@ -172,6 +181,7 @@ void vtkMRMLColorNode::PrintSelf(ostream& os, vtkIndent indent)
     (this->NoName ? this->NoName : "(not set)") <<  "\n";
 
   os << indent << "Names array initialised: " << (this->GetNamesInitialised() ? "true" : "false") << "\n";
+  os << indent << "Content deferred: " << (this->ContentDeferred ? "true" : "false") << "\n";
 
   if (this->Names.size() > 0)
   {
@@ -270,6 +280,7 @@ void vtkMRMLColorNode::SetType(int type)
 //---------------------------------------------------------------------------
 void vtkMRMLColorNode::SetNamesFromColors()
 {
+  this->UpdateDeferredContent();
   const int numPoints = this->GetNumberOfColors();
   // reset the names
   this->Names.resize(numPoints);
@@ -284,6 +295,7 @@ void vtkMRMLColorNode::SetNamesFromColors()
     // the array size.
     assert(res);
   }
+  this->ColorNamesModified();
   this->NamesInitialisedOn();
 }
 
@@ -349,6 +361,7 @@ bool vtkMRMLColorNode::HasNameFromColor(int index)
 //---------------------------------------------------------------------------
 const char *vtkMRMLColorNode::GetColorName(int ind)
 {
+  this->UpdateDeferredContent();
   if (!this->GetNamesInitialised())
   {
     this->SetNamesFromColors();
@@ -374,22 +387,79 @@ int vtkMRMLColorNode::GetColorIndexByName(const char *name)
     return -1;
   }
 
+  this->UpdateDeferredContent();
   if (!this->GetNamesInitialised())
   {
     this->SetNamesFromColors();
   }
 
   std::string strName = name;
-  for (int i = 0; i < this->GetNumberOfColors(); ++i)
+  if (this->NoName && strName == this->NoName)
   {
-    if (strName == this->GetColorName(i))
+    // Unnamed colors are not indexed, search them one by one
+    for (int i = 0; i < this->GetNumberOfColors(); ++i)
     {
-      return i;
+      if (strName == this->GetColorName(i))
+      {
+        return i;
+      }
     }
+    return -1;
+  }
+
+  if (!this->ColorNameIndexValid
+    || this->ColorNameIndexNumberOfColors != this->GetNumberOfColors()
+    || this->ColorNameIndexTime < this->GetMTime())
+  {
+    this->UpdateColorNameIndex();
+  }
+  std::unordered_map<std::string, int>::iterator it = this->ColorNameIndex.find(strName);
+  if (it != this->ColorNameIndex.end() && strName == this->GetColorName(it->second))
+  {
+    return it->second;
   }
   return -1;
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLColorNode::ColorNamesModified()
+{
+  this->ColorNameIndexValid = false;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLColorNode::UpdateColorNameIndex()
+{
+  this->ColorNameIndex.clear();
+  int numberOfColors = this->GetNumberOfColors();
+  int numberOfNames = std::min(numberOfColors, static_cast<int>(this->Names.size()));
+  this->ColorNameIndex.reserve(numberOfNames);
+  for (int i = 0; i < numberOfNames; ++i)
+  {
+    if (this->Names[i].empty())
+    {
+      continue;
+    }
+    // emplace does not replace existing element, so the lowest index is kept
+    this->ColorNameIndex.emplace(this->Names[i], i);
+  }
+  this->ColorNameIndexNumberOfColors = numberOfColors;
+  this->ColorNameIndexTime = this->GetMTime();
+  this->ColorNameIndexValid = true;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLColorNode::UpdateDeferredContent()
+{
+  if (!this->ContentDeferred)
+  {
+    return;
+  }
+  // Clear the flag first, as content creation accesses colors and names
+  this->ContentDeferred = false;
+  this->CreateDeferredContent();
+}
+
 //---------------------------------------------------------------------------
 std::string vtkMRMLColorNode::GetColorNameWithoutSpaces(int ind, const char *subst)
 {
@@ -433,6 +503,7 @@ std::string vtkMRMLColorNode::GetColorNameAsFileName(int colorIndex, const char
 //---------------------------------------------------------------------------
 int vtkMRMLColorNode::SetColorName(int ind, const char *name)
 {
+  this->UpdateDeferredContent();
   if (ind >= static_cast<int>(this->Names.size()) || ind < 0)
   {
     vtkErrorMacro("ERROR: SetColorName, index was out of bounds: "<< ind << ", current size is " << this->Names.size() << ", table name = " << (this->GetName() == nullptr ? "null" : this->GetName()));
@@ -442,6 +513,7 @@ int vtkMRMLColorNode::SetColorName(int ind, const char *name)
   if (this->Names[ind] != newName)
   {
     this->Names[ind] = newName;
+    this->ColorNamesModified();
     this->StorableModifiedTime.Modified();
     this->Modified();
   }
@@ -470,6 +542,7 @@ int vtkMRMLColorNode::SetColorNameWithSpaces(int ind, const char *name, const ch
 //---------------------------------------------------------------------------
 int vtkMRMLColorNode::GetNumberOfColors()
 {
+  this->UpdateDeferredContent();
   return static_cast<int>(this->Names.size());
 }
 
@@ -490,11 +563,27 @@ void vtkMRMLColorNode::Reset(vtkMRMLNode* vtkNotUsed(defaultNode))
 //---------------------------------------------------------------------------
 bool vtkMRMLColorNode::GetModifiedSinceRead()
 {
+  if (this->ContentDeferred)
+  {
+    // content has not been created (or read) yet, so it cannot be modified
+    return false;
+  }
   return this->Superclass::GetModifiedSinceRead() ||
     (this->GetScalarsToColors() &&
      this->GetScalarsToColors()->GetMTime() > this->GetStoredTime());
 }
 
+//---------------------------------------------------------------------------
+vtkMTimeType vtkMRMLColorNode::GetContentMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetContentMTime();
+  if (this->GetScalarsToColors())
+  {
+    mTime = std::max(mTime, this->GetScalarsToColors()->GetMTime());
+  }
+  return mTime;
+}
+
 //---------------------------------------------------------------------------
 vtkLookupTable* vtkMRMLColorNode::CreateLookupTableCopy()
 {
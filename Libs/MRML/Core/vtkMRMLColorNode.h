@@ -24,6 +24,7 @@ class vtkScalarsToColors;
 
 // Std includes
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 /// \brief Abstract MRML node to represent color information.
@@ -43,6 +44,10 @@ class vtkScalarsToColors;
 /// something would be there rather than the default \a NoName which is used
 /// to determine that it's a unnamed and probably uninitialized color.
 ///
+/// Color nodes that are created by default in every scene may defer building
+/// their content (colors and names) until it is first accessed, see
+/// GetContentDeferred().
+///
 /// Subclasses must reimplement GetColor() and GetNumberOfColors().
 class VTK_MRML_EXPORT vtkMRMLColorNode : public vtkMRMLStorableNode
 {
@@ -116,6 +121,9 @@ public:
 
   /// Return the index associated with this color name, which can then be used
   /// to get the color. Returns -1 on failure.
+  /// If multiple colors have the same name then the lowest index is returned.
+  /// Names are looked up in a hash table that is rebuilt when color names
+  /// are changed, so calling this method repeatedly is inexpensive.
   /// \sa GetColorName()
   int GetColorIndexByName(const char *name);
 
@@ -188,6 +196,15 @@ public:
   /// \sa vtkMRMLStorableNode::GetModifiedSinceRead()
   bool GetModifiedSinceRead() override;
 
+  /// Reimplemented to take into account the modified time of the lookup table.
+  vtkMTimeType GetContentMTime() override;
+
+  /// Returns true if the colors and names of the node have not been created yet.
+  /// Default color nodes are added to the scene as lightweight placeholders
+  /// that only store their type. Content is created automatically when colors,
+  /// names, or the lookup table are first accessed.
+  vtkGetMacro(ContentDeferred, bool);
+
   /// The list of valid color node types, added to in subclasses
   /// For backward compatibility, User and File keep the numbers that
   /// were in the ColorTable node
@@ -221,6 +238,24 @@ protected:
   /// \sa GetNoName()
   virtual bool HasNameFromColor(int index);
 
+  /// Create the content of the node if its creation was deferred.
+  /// Must be called by subclasses before accessing colors or names.
+  /// \sa GetContentDeferred()
+  void UpdateDeferredContent();
+
+  /// Create colors and names of the node, called once when the content of a
+  /// deferred node is first accessed. The default implementation does nothing.
+  /// \sa UpdateDeferredContent()
+  virtual void CreateDeferredContent() {};
+
+  /// Mark the color name lookup table outdated.
+  /// Must be called by subclasses that modify the Names vector directly.
+  /// \sa GetColorIndexByName()
+  void ColorNamesModified();
+
+  /// Rebuild the color name lookup table used by GetColorIndexByName().
+  void UpdateColorNameIndex();
+
   /// Which type of color information does this node hold?
   /// Valid values are in the enumerated list
   int Type;
@@ -240,6 +275,18 @@ protected:
   ///
   /// Have the color names been set? Used to do lazy copy of the Names array.
   int NamesInitialised;
+
+  ///
+  /// Colors and names have not been created yet, see GetContentDeferred().
+  bool ContentDeferred;
+
+  ///
+  /// Map from color name to the lowest color index that has that name.
+  /// Unnamed colors are not stored.
+  std::unordered_map<std::string, int> ColorNameIndex;
+  bool ColorNameIndexValid;
+  int ColorNameIndexNumberOfColors;
+  vtkMTimeType ColorNameIndexTime;
 };
 
 #endif
@@ -54,7 +54,7 @@ void vtkMRMLColorTableNode::WriteXML(ostream& of, int nIndent)
 
   // only print out the look up table size so that the table can be
   // initialized properly
-  if (this->LookupTable != nullptr)
+  if (this->GetLookupTable() != nullptr)
   {
     of << " numcolors=\"" << this->LookupTable->GetNumberOfTableValues() << "\"";
   }
@@ -176,7 +176,12 @@ void vtkMRMLColorTableNode::Copy(vtkMRMLNode *anode)
   vtkMRMLColorTableNode *node = (vtkMRMLColorTableNode *) anode;
 
   // Deep copy LookupTable
-  if (node->GetLookupTable() != nullptr)
+  if (node->GetContentDeferred())
+  {
+    // content will be created from the type when accessed,
+    // no need to build it in the source node just to copy it
+  }
+  else if (node->GetLookupTable() != nullptr)
   {
     if (this->LookupTable == nullptr)
     {
@@ -595,17 +600,68 @@ void vtkMRMLColorTableNode::ProcessMRMLEvents ( vtkObject *caller,
 //---------------------------------------------------------------------------
 void vtkMRMLColorTableNode::SetType(int type)
 {
-  if (this->GetLookupTable() != nullptr &&
+  if (this->LookupTable != nullptr &&
+      !this->ContentDeferred &&
       this->Type == type)
   {
     vtkDebugMacro("SetType: type is already set to " << type <<  " = " << this->GetTypeAsString());
     return;
   }
 
-    this->Type = type;
+  this->Type = type;
+  this->ContentDeferred = false;
+
+  vtkDebugMacro(<< this->GetClassName() << " (" << this << "): setting Type to " << type << " = " << this->GetTypeAsString());
+
+  if (!this->UpdateLookupTableFromType())
+  {
+    return;
+  }
+
+  // invoke a modified event
+  this->Modified();
+
+  // invoke a type  modified event
+  this->InvokeEvent(vtkMRMLColorTableNode::TypeModifiedEvent);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLColorTableNode::SetTypeDeferred(int type)
+{
+  if (this->Type == type && (this->LookupTable != nullptr || this->ContentDeferred))
+  {
+    vtkDebugMacro("SetTypeDeferred: type is already set to " << type <<  " = " << this->GetTypeAsString());
+    return;
+  }
+  this->Type = type;
+  this->ContentDeferred = true;
+  this->Modified();
+  this->InvokeEvent(vtkMRMLColorTableNode::TypeModifiedEvent);
+}
 
-    vtkDebugMacro(<< this->GetClassName() << " (" << this << "): setting Type to " << type << " = " << this->GetTypeAsString());
+//---------------------------------------------------------------------------
+void vtkMRMLColorTableNode::CreateDeferredContent()
+{
+  MRMLNodeModifyBlocker blocker(this);
+  if (!this->UpdateLookupTableFromType())
+  {
+    return;
+  }
+  if (this->Type == this->File)
+  {
+    vtkMRMLStorageNode* storageNode = this->GetStorageNode();
+    if (!storageNode || !storageNode->ReadData(this))
+    {
+      vtkErrorMacro("CreateDeferredContent: failed to read color table "
+        << (this->GetName() ? this->GetName() : "(none)") << " from file "
+        << (storageNode && storageNode->GetFileName() ? storageNode->GetFileName() : "(none)"));
+    }
+  }
+}
 
+//---------------------------------------------------------------------------
+bool vtkMRMLColorTableNode::UpdateLookupTableFromType()
+{
     //this->LookupTable->Delete();
     if (this->GetLookupTable() == nullptr)
     {
@@ -1092,6 +1148,7 @@ void vtkMRMLColorTableNode::SetType(int type)
       this->GetLookupTable()->SetTableRange(0,255);
       this->Names.clear();
       this->Names.resize(this->GetLookupTable()->GetNumberOfTableValues());
+      this->ColorNamesModified();
 
       if (this->SetColorName(0, "Black") != 0)
       {
@@ -1233,14 +1290,10 @@ void vtkMRMLColorTableNode::SetType(int type)
 
     else
     {
-      vtkErrorMacro("vtkMRMLColorTableNode: SetType ERROR, unknown type " << type << endl);
-      return;
+      vtkErrorMacro("vtkMRMLColorTableNode: SetType ERROR, unknown type " << this->Type << endl);
+      return false;
     }
-    // invoke a modified event
-    this->Modified();
-
-    // invoke a type  modified event
-    this->InvokeEvent(vtkMRMLColorTableNode::TypeModifiedEvent);
+    return true;
 }
 
 //---------------------------------------------------------------------------
@@ -1273,6 +1326,7 @@ void vtkMRMLColorTableNode::SetNumberOfColors(int n)
     // elements is set). We initialize the color names to have one for each lookup table item.
     std::string noNameStr = this->GetNoName() ? this->GetNoName() : "";
     this->Names.resize(n, noNameStr);
+    this->ColorNamesModified();
   }
 }
 
@@ -1380,6 +1434,7 @@ int vtkMRMLColorTableNode::SetColors(int firstEntry, int lastEntry, const char *
   {
     std::string noNameStr = this->GetNoName() ? this->GetNoName() : "";
     this->Names.resize(numberOfValues, noNameStr);
+    this->ColorNamesModified();
   }
   if (firstEntry < 0 || firstEntry >= numberOfValues)
   {
@@ -1409,6 +1464,7 @@ int vtkMRMLColorTableNode::SetColors(int firstEntry, int lastEntry, const char *
     *(rgba++) = static_cast<unsigned char>(a * 255.0 + 0.5);
     this->Names[indx] = nameStr;
   }
+  this->ColorNamesModified();
   lut->BuildSpecialColors();
   lut->Modified();
 
@@ -1458,6 +1514,7 @@ bool vtkMRMLColorTableNode::GetColor(int entry, double color[4])
 void vtkMRMLColorTableNode::ClearNames()
 {
   this->Names.clear();
+  this->ColorNamesModified();
   this->NamesInitialisedOff();
 }
 
@@ -1492,6 +1549,7 @@ vtkMRMLStorageNode* vtkMRMLColorTableNode::CreateDefaultStorageNode()
 //----------------------------------------------------------------------------
 vtkLookupTable* vtkMRMLColorTableNode::GetLookupTable()
 {
+  this->UpdateDeferredContent();
   return this->LookupTable;
 }
 
@@ -1502,6 +1560,8 @@ void vtkMRMLColorTableNode::SetAndObserveLookupTable(vtkLookupTable *lut)
   {
     return;
   }
+  // explicitly set content replaces the deferred one
+  this->ContentDeferred = false;
   vtkSetAndObserveMRMLObjectMacro(this->LookupTable, lut);
   this->Modified();
 }
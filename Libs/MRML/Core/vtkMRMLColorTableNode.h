@@ -53,7 +53,8 @@ public:
   const char* GetNodeTagName() override {return "ColorTable";}
 
   /// Access lookup table object that stores table values.
-  /// \sa SetAndObserveLookupTable()
+  /// If creation of the content was deferred then the lookup table is created now.
+  /// \sa SetAndObserveLookupTable(), SetTypeDeferred()
   vtkLookupTable* GetLookupTable() override;
 
   /// Set lookup table object that this object will use.
@@ -72,6 +73,14 @@ public:
   /// Get/Set for Type
   void SetType(int type) override;
   //GetType is defined in ColorTableNode class via macro.
+
+  /// Set the type without building the lookup table and names.
+  /// The content is created from the type (or read by the storage node,
+  /// if type is File) when the colors, names, or lookup table are first accessed.
+  /// This allows adding many color nodes to the scene quickly, only paying the
+  /// cost of building the tables that are actually used.
+  /// \sa SetType(), GetContentDeferred()
+  void SetTypeDeferred(int type);
   void SetTypeToFullRainbow();
   void SetTypeToGrey();
   void SetTypeToIron();
@@ -243,6 +252,14 @@ protected:
   vtkMRMLColorTableNode(const vtkMRMLColorTableNode&);
   void operator=(const vtkMRMLColorTableNode&);
 
+  /// Build colors and names of the lookup table according to the Type.
+  /// Returns false if the type is unknown.
+  bool UpdateLookupTableFromType();
+
+  /// Build the lookup table from the type or read it from file.
+  /// \sa SetTypeDeferred()
+  void CreateDeferredContent() override;
+
   ///
   /// The look up table, constructed according to the Type
   vtkLookupTable *LookupTable;
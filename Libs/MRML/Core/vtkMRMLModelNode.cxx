@@ -43,6 +43,7 @@ Version:   $Revision: 1.3 $
 #include <vtkVersion.h>
 
 // STD includes
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 
@@ -1034,6 +1035,17 @@ bool vtkMRMLModelNode::GetModifiedSinceRead()
     (this->GetMesh() && this->GetMesh()->GetMTime() > this->GetStoredTime());
 }
 
+//---------------------------------------------------------------------------
+vtkMTimeType vtkMRMLModelNode::GetContentMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetContentMTime();
+  if (this->GetMesh())
+  {
+    mTime = std::max(mTime, this->GetMesh()->GetMTime());
+  }
+  return mTime;
+}
+
 //---------------------------------------------------------------------------
 vtkImplicitFunction* vtkMRMLModelNode::GetImplicitFunctionWorld()
 {
@@ -253,6 +253,9 @@ public:
   /// \sa vtkMRMLStorableNode::GetModifiedSinceRead()
   bool GetModifiedSinceRead() override;
 
+  /// Reimplemented to take into account the modified time of the mesh.
+  vtkMTimeType GetContentMTime() override;
+
   /// Determine if the mesh stores scalar data data that the user may want to see and if
   /// such data is found then display it.
   /// Currently, it displays single-component scalar array (with a colormap),
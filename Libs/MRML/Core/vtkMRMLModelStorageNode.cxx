@@ -154,6 +154,24 @@ bool vtkMRMLModelStorageNode::CanReadInReferenceNode(vtkMRMLNode *refNode)
   return refNode->IsA("vtkMRMLModelNode");
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLModelStorageNode::CanWriteDataInBackground(vtkMRMLNode* refNode)
+{
+  vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(refNode);
+  if (!modelNode)
+  {
+    return false;
+  }
+  std::string extension = vtkMRMLStorageNode::GetLowercaseExtensionFromFileName(this->GetFullNameFromFileName());
+  if (extension == ".obj")
+  {
+    return false;
+  }
+  // Execute the mesh pipeline now, the background thread only reads the output mesh
+  modelNode->GetMesh();
+  return true;
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLModelStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
 {
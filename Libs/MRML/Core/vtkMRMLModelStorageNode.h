@@ -45,6 +45,10 @@ public:
   /// Return true if the reference node can be read in
   bool CanReadInReferenceNode(vtkMRMLNode *refNode) override;
 
+  /// Models can be written in a background thread, except in OBJ format
+  /// (the OBJ exporter requires a render window).
+  bool CanWriteDataInBackground(vtkMRMLNode* refNode) override;
+
   /// Get/Set flag that controls if points are to be written in various coordinate systems
   vtkSetClampMacro(CoordinateSystem, int, 0, vtkMRMLStorageNode::CoordinateSystemType_Last-1);
   vtkGetMacro(CoordinateSystem, int);
@@ -128,6 +128,12 @@ void vtkMRMLNode::Copy(vtkMRMLNode *node)
   this->CopyReferences(node);
 }
 
+//----------------------------------------------------------------------------
+vtkMTimeType vtkMRMLNode::GetContentMTime()
+{
+  return this->GetMTime();
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLNode::CopyContent(vtkMRMLNode* node, bool vtkNotUsed(deepCopy)/*=true*/)
 {
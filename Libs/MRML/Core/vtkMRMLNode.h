@@ -254,6 +254,16 @@ public:
   /// in all parent classes by adding vtkMRMLCopyContentMacro(ClassName) to the class headers.
   virtual void CopyContent(vtkMRMLNode* node, bool deepCopy=true);
 
+  /// \brief Get the last time when the node or its content was modified.
+  ///
+  /// In addition to the node modification time, it takes into account
+  /// modification of content that may be modified without calling Modified() on the node,
+  /// such as bulk data of storable nodes.
+  /// The scene uses this to detect nodes that have not changed since their last undo snapshot.
+  /// \note
+  /// Subclasses that store content in separate objects should override this method.
+  virtual vtkMTimeType GetContentMTime();
+
   /// \brief Copy the references of the node into this.
   ///
   /// Existing references will be replaced if found in node, or removed if not
@@ -14,6 +14,7 @@ Version:   $Revision: 1.2 $
 
 // MRML includes
 #include "vtkEventBroker.h"
+#include "vtkImageHistogramCache.h"
 #include "vtkMRMLScalarVolumeDisplayNode.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLProceduralColorNode.h"
@@ -27,7 +28,6 @@ Version:   $Revision: 1.2 $
 #include <vtkImageCast.h>
 #include <vtkImageData.h>
 #include <vtkImageExtractComponents.h>
-#include <vtkImageHistogramStatistics.h>
 #include <vtkImageLogic.h>
 #include <vtkImageMapToWindowLevelColors.h>
 #include <vtkImageStencil.h>
@@ -102,7 +102,7 @@ vtkMRMLScalarVolumeDisplayNode::vtkMRMLScalarVolumeDisplayNode()
   this->AppendComponents->AddInputConnection(0, this->ExtractRGB->GetOutputPort() );
   this->AppendComponents->AddInputConnection(0, this->AlphaLogic->GetOutputPort() );
 
-  this->HistogramStatistics = nullptr;
+  this->HistogramCache = nullptr;
   this->IsInCalculateAutoLevels = false;
 
   vtkEventBroker::GetInstance()->AddObservation(
@@ -123,10 +123,10 @@ vtkMRMLScalarVolumeDisplayNode::~vtkMRMLScalarVolumeDisplayNode()
   this->ExtractAlpha->Delete();
   this->MultiplyAlpha->Delete();
 
-  if (this->HistogramStatistics)
+  if (this->HistogramCache)
   {
-    this->HistogramStatistics->Delete();
-    this->HistogramStatistics = nullptr;
+    this->HistogramCache->Delete();
+    this->HistogramCache = nullptr;
   }
 }
 
@@ -746,32 +746,47 @@ void vtkMRMLScalarVolumeDisplayNode::CalculateAutoLevels()
     return;
   }
 
-  if (this->HistogramStatistics == nullptr)
+  // Set automatic window/level to include the entire intensity range
+  // (except top/bottom 0.1%, to not let a very thin tail of the intensity
+  // distribution to decrease the image contrast too much).
+  // While in CT and sometimes in MRI, there may be a large empty area
+  // outside the reconstructed image, which could be suppressed
+  // by a larger lower percentile value, it would make the method
+  // too specific to particular imaging modalities and could lead to
+  // suboptimal results for other types of images.
+  // Therefore, we choose small, symmetric percentile values here
+  // and maybe add modality-specific methods later (e.g., for CT
+  // images we could set lower value to -1000HU).
+  // Percentiles are very low (0.1%), so there is no need for
+  // range expansion.
+  const double lowerPercentile = 0.1;
+  const double upperPercentile = 99.9;
+
+  // The histogram is cached in the volume node, therefore it is not recomputed
+  // when the display node is modified or when there are multiple display nodes.
+  vtkImageHistogramCache* histogramCache = nullptr;
+  vtkMRMLVolumeNode* volumeNode = this->GetVolumeNode();
+  if (volumeNode && volumeNode->GetImageData() == imageDataScalar)
+  {
+    histogramCache = volumeNode->GetImageHistogramCache();
+  }
+  else
   {
-    this->HistogramStatistics = vtkImageHistogramStatistics::New();
-
-    // Set automatic window/level to include the entire intensity range
-    // (except top/bottom 0.1%, to not let a very thin tail of the intensity
-    // distribution to decrease the image contrast too much).
-    // While in CT and sometimes in MRI, there may be a large empty area
-    // outside the reconstructed image, which could be suppressed
-    // by a larger lower percentile value, it would make the method
-    // too specific to particular imaging modalities and could lead to
-    // suboptimal results for other types of images.
-    // Therefore, we choose small, symmetric percentile values here
-    // and maybe add modality-specific methods later (e.g., for CT
-    // images we could set lower value to -1000HU).
-    this->HistogramStatistics->SetAutoRangePercentiles(0.1, 99.9);
+    if (this->HistogramCache == nullptr)
+    {
+      this->HistogramCache = vtkImageHistogramCache::New();
+    }
+    histogramCache = this->HistogramCache;
+  }
 
-    // Percentiles are very low (0.1%), so there is no need for
-    // range expansion.
-    this->HistogramStatistics->SetAutoRangeExpansionFactors(0.0, 0.0);
+  double intensityRange[2] = { 0.0, 0.0 };
+  if (!histogramCache->GetPercentileRange(imageDataScalar, lowerPercentile, upperPercentile, intensityRange))
+  {
+    vtkDebugMacro("CalculateScalarAutoLevels: failed to compute image histogram");
+    return;
   }
 
   this->IsInCalculateAutoLevels = true;
-  this->HistogramStatistics->SetInputData(imageDataScalar);
-  this->HistogramStatistics->Update();
-  double* intensityRange = this->HistogramStatistics->GetAutoRange();
   vtkDebugMacro("CalculateScalarAutoLevels:"
                 << " lower: " << intensityRange[0] << " upper: " << intensityRange[1]);
 
@@ -21,7 +21,7 @@
 // VTK includes
 class vtkImageAlgorithm;
 class vtkImageAppendComponents;
-class vtkImageHistogramStatistics;
+class vtkImageHistogramCache;
 class vtkImageCast;
 class vtkImageLogic;
 class vtkImageMapToColors;
@@ -248,8 +248,9 @@ protected:
   std::vector<WindowLevelPreset> WindowLevelPresets;
 
   ///
-  /// Used internally in CalculateScalarAutoLevels and CalculateStatisticsAutoLevels
-  vtkImageHistogramStatistics *HistogramStatistics;
+  /// Used internally in CalculateAutoLevels if the input image data is not the
+  /// image data of the volume node (the histogram cache of the volume node is used otherwise).
+  vtkImageHistogramCache *HistogramCache;
   bool IsInCalculateAutoLevels;
 };
 
@@ -88,6 +88,7 @@ Version:   $Revision: 1.18 $
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
 #include <vtkDebugLeaks.h>
+#include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPNGWriter.h>
 #include <vtkSmartPointer.h>
@@ -99,7 +100,12 @@ Version:   $Revision: 1.18 $
 
 // STD includes
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <numeric>
+#include <thread>
 
 //#define MRMLSCENE_VERBOSE
 
@@ -123,6 +129,9 @@ vtkMRMLScene::vtkMRMLScene()
   this->MaximumNumberOfSavedUndoStates = 20;
   this->UndoFlag = false;
 
+  // Writing is often limited by disk throughput, therefore more threads would not help much
+  this->NumberOfStorableNodeWriterThreads = std::max(1, std::min(8, static_cast<int>(std::thread::hardware_concurrency())));
+
   this->CacheManager = nullptr;
   this->DataIOManager = nullptr;
   this->URIHandlerCollection = nullptr;
@@ -1311,6 +1320,7 @@ vtkMRMLNode* vtkMRMLScene::AddNodeNoNotify(vtkMRMLNode *n)
 
   // cache the node so the whole scene cache stays up-to date
   this->AddNodeID(n);
+  this->AddNodeToClassIndex(n);
 
   // Keep the SH up-to-date
   if (vtkMRMLSubjectHierarchyNode::SafeDownCast(n) != nullptr &&
@@ -1525,6 +1535,7 @@ void vtkMRMLScene::RemoveNode(vtkMRMLNode *n)
 
   std::string nid = (n->GetID() ? n->GetID() : "");
   this->RemoveNodeID(n->GetID());
+  this->RemoveNodeFromClassIndex(n);
 
   this->InvokeEvent(vtkMRMLScene::NodeRemovedEvent, n);
 
@@ -1705,18 +1716,7 @@ int vtkMRMLScene::GetNumberOfNodesByClass(const char *className)
     vtkErrorMacro("GetNumberOfNodesByClass: class name is null.");
     return 0;
   }
-  int num=0;
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
-  {
-    if (node->IsA(className))
-    {
-      num++;
-    }
-  }
-  return num;
+  return static_cast<int>(this->GetNodesByClassFromIndex(className).size());
 }
 
 //------------------------------------------------------------------------------
@@ -1728,16 +1728,7 @@ int vtkMRMLScene::GetNodesByClass(const char *className, std::vector<vtkMRMLNode
     vtkErrorMacro("GetNodesByClass: class name is null.");
     return 0;
   }
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
-  {
-    if (node->IsA(className))
-    {
-      nodes.push_back(node);
-    }
-  }
+  nodes = this->GetNodesByClassFromIndex(className);
   return static_cast<int>(nodes.size());
 }
 
@@ -1750,15 +1741,9 @@ vtkCollection* vtkMRMLScene::GetNodesByClass(const char *className)
     return nullptr;
   }
   vtkCollection* nodes = vtkCollection::New();
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  for (vtkMRMLNode* node : this->GetNodesByClassFromIndex(className))
   {
-    if (node->IsA(className))
-    {
-      nodes->AddItem(node);
-    }
+    nodes->AddItem(node);
   }
   return nodes;
 }
@@ -1819,13 +1804,9 @@ vtkMRMLNode* vtkMRMLScene::GetSingletonNode(const char* singletonTag, const char
     return nullptr;
   }
 
-  vtkCollectionSimpleIterator it;
-  vtkMRMLNode* node = nullptr;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  for (vtkMRMLNode* node : this->GetNodesByClassFromIndex(className))
   {
-    if (node->IsA(className) &&
-        node->GetSingletonTag() != nullptr &&
+    if (node->GetSingletonTag() != nullptr &&
         strcmp(node->GetSingletonTag(), singletonTag) == 0)
     {
       return node;
@@ -1895,22 +1876,12 @@ vtkMRMLNode* vtkMRMLScene::GetNthNodeByClass(int n, const char *className)
     return nullptr;
   }
 
-  int num=0;
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  const std::vector<vtkMRMLNode*>& nodes = this->GetNodesByClassFromIndex(className);
+  if (n >= static_cast<int>(nodes.size()))
   {
-    if (node->IsA(className))
-    {
-      if (num == n)
-      {
-        return node;
-      }
-      num++;
-    }
+    return nullptr;
   }
-  return nullptr;
+  return nodes[n];
 }
 
 //------------------------------------------------------------------------------
@@ -2057,11 +2028,9 @@ vtkCollection* vtkMRMLScene::GetNodesByClassByName(const char* className, const
     return nodes;
   }
 
-  vtkMRMLNode *node;
-  for (int n=0; n < this->Nodes->GetNumberOfItems(); n++)
+  for (vtkMRMLNode* node : this->GetNodesByClassFromIndex(className))
   {
-    node = (vtkMRMLNode*)this->Nodes->GetItemAsObject(n);
-    if (node->GetName() != nullptr && !strcmp(node->GetName(), name) && node->IsA(className))
+    if (node->GetName() != nullptr && !strcmp(node->GetName(), name))
     {
       nodes->AddItem(node);
     }
@@ -2156,6 +2125,8 @@ vtkMRMLNode* vtkMRMLScene::InsertAfterNode(vtkMRMLNode *item, vtkMRMLNode *n)
   }
   // cache the node so the whole scene cache stays up-to-date
   this->AddNodeID(n);
+  // node order has changed, the class index will be rebuilt when needed
+  this->ClearNodeClassIndex();
 
   n->SetDisableModifiedEvent(modifyStatus);
 
@@ -2254,6 +2225,8 @@ vtkMRMLNode* vtkMRMLScene::InsertBeforeNode(vtkMRMLNode *item, vtkMRMLNode *n)
   }
   // cache the node so the whole scene cache stays up-todate
   this->AddNodeID(n);
+  // node order has changed, the class index will be rebuilt when needed
+  this->ClearNodeClassIndex();
 
   n->SetDisableModifiedEvent(modifyStatus);
 
@@ -2275,6 +2248,7 @@ void vtkMRMLScene::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "LastLoadedExtensions= " << (this->GetLastLoadedExtensions() ? this->GetLastLoadedExtensions() : "NULL") << "\n";
   os << indent << "URL = " << this->GetURL() << "\n";
   os << indent << "Root Directory = " << this->GetRootDirectory() << "\n";
+  os << indent << "NumberOfStorableNodeWriterThreads = " << this->NumberOfStorableNodeWriterThreads << "\n";
 
   this->Nodes->vtkCollection::PrintSelf(os,indent);
   std::list<std::string> classes = this->GetNodeClassesList();
@@ -2492,13 +2466,11 @@ void vtkMRMLScene::GetNodeReferenceIDsFromUndoStack(std::set<std::string>& refer
 {
   referenceIDs.clear();
 
-  std::list<vtkCollection*>::const_iterator undoStackIt;
+  std::list<UndoSceneState*>::const_iterator undoStackIt;
   for (undoStackIt = this->UndoStack.begin(); undoStackIt != this->UndoStack.end(); ++undoStackIt)
   {
-    vtkCollection* nodes = *undoStackIt;
-    for (int i = 0; i < nodes->GetNumberOfItems(); ++i)
+    for (vtkMRMLNode* node : (*undoStackIt)->Nodes)
     {
-      vtkMRMLNode* node = vtkMRMLNode::SafeDownCast(nodes->GetItemAsObject(i));
       if (!node)
       {
         continue;
@@ -2724,11 +2696,11 @@ void vtkMRMLScene::SaveStateForUndo (vtkCollection* nodes)
   //this->SetUndoOn();
   this->PushIntoUndoStack();
 
-  int nnodes = nodes->GetNumberOfItems();
-
-  for (int n=0; n<nnodes; n++)
+  vtkObject* object = nullptr;
+  vtkCollectionSimpleIterator it;
+  for (nodes->InitTraversal(it); (object = nodes->GetNextItemAsObject(it));)
   {
-    vtkMRMLNode *node  = vtkMRMLNode::SafeDownCast(nodes->GetItemAsObject(n));
+    vtkMRMLNode *node  = vtkMRMLNode::SafeDownCast(object);
     if (node && node->GetUndoEnabled())
     {
       this->CopyNodeInUndoStack(node);
@@ -2755,7 +2727,25 @@ void vtkMRMLScene::SaveStateForUndo ()
 }
 
 //------------------------------------------------------------------------------
-// Make a new collection that has pointers to all the nodes in the current scene
+// Make a new state that has pointers to all the undo-enabled nodes in the current scene
+vtkMRMLScene::UndoSceneState* vtkMRMLScene::CreateUndoSceneState()
+{
+  UndoSceneState* state = new UndoSceneState;
+  state->Nodes.reserve(this->Nodes->GetNumberOfItems());
+  vtkMRMLNode* node = nullptr;
+  vtkCollectionSimpleIterator it;
+  for (this->Nodes->InitTraversal(it);
+    (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it));)
+  {
+    if (node->GetUndoEnabled())
+    {
+      state->Nodes.emplace_back(node);
+    }
+  }
+  return state;
+}
+
+//------------------------------------------------------------------------------
 void vtkMRMLScene::PushIntoUndoStack()
 {
   if (this->Nodes == nullptr)
@@ -2763,50 +2753,155 @@ void vtkMRMLScene::PushIntoUndoStack()
     return;
   }
 
-  vtkCollection* newScene = vtkCollection::New();
+  this->UndoStack.push_back(this->CreateUndoSceneState());
+  this->TrimUndoStack();
+}
 
-  vtkCollection* currentScene = this->Nodes;
+//------------------------------------------------------------------------------
+void vtkMRMLScene::PushIntoRedoStack()
+{
+  if (this->Nodes == nullptr)
+  {
+    return;
+  }
 
-  int nnodes = currentScene->GetNumberOfItems();
+  this->RedoStack.push_back(this->CreateUndoSceneState());
+}
 
-  for (int n=0; n<nnodes; n++)
+//------------------------------------------------------------------------------
+namespace
+{
+void GetNodeReferences(vtkMRMLNode* node, std::map<std::string, std::vector<std::string> >& references)
+{
+  std::vector<std::string> roles;
+  node->GetNodeReferenceRoles(roles);
+  for (const std::string& role : roles)
   {
-    vtkMRMLNode *node  = vtkMRMLNode::SafeDownCast(currentScene->GetItemAsObject(n));
-    if (node && node->GetUndoEnabled())
+    std::vector<const char*> referenceIDs;
+    node->GetNodeReferenceIDs(role.c_str(), referenceIDs);
+    if (referenceIDs.empty())
     {
-      newScene->AddItem(node);
+      continue;
+    }
+    std::vector<std::string>& roleReferences = references[role];
+    for (const char* referenceID : referenceIDs)
+    {
+      roleReferences.emplace_back(referenceID ? referenceID : "");
     }
   }
+}
 
-  this->UndoStack.push_back(newScene);
-  this->TrimUndoStack();
+//------------------------------------------------------------------------------
+bool HaveSameNodeReferences(vtkMRMLNode* node1, vtkMRMLNode* node2)
+{
+  // Modification of node references does not change the node modification time,
+  // therefore they are compared explicitly.
+  std::map<std::string, std::vector<std::string> > references1;
+  std::map<std::string, std::vector<std::string> > references2;
+  GetNodeReferences(node1, references1);
+  GetNodeReferences(node2, references2);
+  return references1 == references2;
+}
 }
 
 //------------------------------------------------------------------------------
-// Make a new collection that has pointers to the current scene nodes
-void vtkMRMLScene::PushIntoRedoStack()
+vtkMRMLNode* vtkMRMLScene::GetUpToDateUndoNodeSnapshot(vtkMRMLNode* node)
 {
-  if (this->Nodes == nullptr)
+  std::map<vtkMRMLNode*, UndoNodeSnapshot>::iterator snapshotIt = this->UndoNodeSnapshots.find(node);
+  if (snapshotIt == this->UndoNodeSnapshots.end())
+  {
+    return nullptr;
+  }
+  UndoNodeSnapshot& snapshot = snapshotIt->second;
+  if (snapshot.Node != node || !snapshot.Snapshot)
+  {
+    // node or all states that used the snapshot have been deleted
+    return nullptr;
+  }
+  if (node->GetDisableModifiedEvent() && node->GetModifiedEventPending() > 0)
+  {
+    // node is being modified, its modification time is not updated yet
+    return nullptr;
+  }
+  if (snapshot.ContentMTime != node->GetContentMTime()
+    || !HaveSameNodeReferences(node, snapshot.Snapshot))
+  {
+    return nullptr;
+  }
+  return snapshot.Snapshot;
+}
+
+//------------------------------------------------------------------------------
+// Put a replacement node into the saved state so that the node can be edited
+void vtkMRMLScene::CopyNodeInUndoSceneState(UndoSceneState* state, vtkMRMLNode* copyNode)
+{
+  if (state->NodeIndices.empty() && state->Snapshots.empty())
   {
+    for (size_t index = 0; index < state->Nodes.size(); ++index)
+    {
+      state->NodeIndices[state->Nodes[index]] = index;
+    }
+  }
+  std::map<vtkMRMLNode*, size_t>::iterator indexIt = state->NodeIndices.find(copyNode);
+  if (indexIt == state->NodeIndices.end())
+  {
+    // node was not undo-enabled when the state was saved or it has been replaced already
     return;
   }
 
-  vtkCollection* newScene = vtkCollection::New();
+  // Reuse the last snapshot of the node if the node has not changed since then
+  vtkSmartPointer<vtkMRMLNode> snapshot = this->GetUpToDateUndoNodeSnapshot(copyNode);
+  if (!snapshot)
+  {
+    vtkMTimeType contentMTime = copyNode->GetContentMTime();
+    snapshot = vtkSmartPointer<vtkMRMLNode>::Take(copyNode->CreateNodeInstance());
+    if (!snapshot)
+    {
+      vtkErrorMacro("CopyNodeInUndoSceneState: failed to create instance of " << copyNode->GetClassName());
+      return;
+    }
+    snapshot->CopyWithScene(copyNode);
+    ++this->NumberOfUndoNodeCopies;
+    UndoNodeSnapshot& cachedSnapshot = this->UndoNodeSnapshots[copyNode];
+    cachedSnapshot.Node = copyNode;
+    cachedSnapshot.ContentMTime = contentMTime;
+    cachedSnapshot.Snapshot = snapshot.GetPointer();
+  }
 
-  vtkCollection* currentScene = this->Nodes;
+  state->Nodes[indexIt->second] = snapshot;
+  state->Snapshots.insert(snapshot.GetPointer());
+  state->NodeIndices.erase(indexIt);
+}
 
-  int nnodes = currentScene->GetNumberOfItems();
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMRMLNode> vtkMRMLScene::GetUndoSceneStateNodeToAdd(UndoSceneState* state, vtkMRMLNode* node)
+{
+  if (state->Snapshots.find(node) == state->Snapshots.end() || node->GetReferenceCount() <= 1)
+  {
+    // scene node or snapshot that is only used by this state
+    return node;
+  }
+  // snapshot is shared with other states, it must not be modified
+  vtkSmartPointer<vtkMRMLNode> nodeToAdd = vtkSmartPointer<vtkMRMLNode>::Take(node->CreateNodeInstance());
+  nodeToAdd->CopyWithScene(node);
+  return nodeToAdd;
+}
 
-  for (int n=0; n<nnodes; n++)
+//------------------------------------------------------------------------------
+void vtkMRMLScene::RemoveUnusedUndoNodeSnapshots()
+{
+  for (std::map<vtkMRMLNode*, UndoNodeSnapshot>::iterator snapshotIt = this->UndoNodeSnapshots.begin();
+    snapshotIt != this->UndoNodeSnapshots.end();)
   {
-    vtkMRMLNode *node  = vtkMRMLNode::SafeDownCast(currentScene->GetItemAsObject(n));
-    if (node && node->GetUndoEnabled())
+    if (!snapshotIt->second.Node || !snapshotIt->second.Snapshot)
     {
-      newScene->AddItem(node);
+      snapshotIt = this->UndoNodeSnapshots.erase(snapshotIt);
+    }
+    else
+    {
+      ++snapshotIt;
     }
   }
-
-  this->RedoStack.push_back(newScene);
 }
 
 //------------------------------------------------------------------------------
@@ -2819,25 +2914,11 @@ void vtkMRMLScene::CopyNodeInUndoStack(vtkMRMLNode *copyNode)
     vtkErrorMacro("CopyNodeInUndoStack: node is null");
     return;
   }
-
-  vtkMRMLNode *snode = copyNode->CreateNodeInstance();
-  if (snode != nullptr)
+  if (this->UndoStack.empty())
   {
-    snode->CopyWithScene(copyNode);
-  }
-
-  vtkCollection* undoScene = this->UndoStack.back();
-  int nnodes = undoScene->GetNumberOfItems();
-  for (int n=0; n<nnodes; n++)
-  {
-    vtkMRMLNode *node  = vtkMRMLNode::SafeDownCast(undoScene->GetItemAsObject(n));
-    if (node == copyNode)
-    {
-      undoScene->ReplaceItem (n, snode);
-      break;
-    }
+    return;
   }
-  snode->Delete();
+  this->CopyNodeInUndoSceneState(this->UndoStack.back(), copyNode);
 }
 
 //------------------------------------------------------------------------------
@@ -2850,23 +2931,11 @@ void vtkMRMLScene::CopyNodeInRedoStack(vtkMRMLNode *copyNode)
     vtkErrorMacro("CopyNodeInRedoStack: node is null");
     return;
   }
-  vtkMRMLNode *snode = copyNode->CreateNodeInstance();
-  if (snode != nullptr)
-  {
-    snode->CopyWithScene(copyNode);
-  }
-  vtkCollection* undoScene = this->RedoStack.back();
-  int nnodes = undoScene->GetNumberOfItems();
-  for (int n=0; n<nnodes; n++)
+  if (this->RedoStack.empty())
   {
-    vtkMRMLNode *node  = vtkMRMLNode::SafeDownCast(undoScene->GetItemAsObject(n));
-    if (node == copyNode)
-    {
-      undoScene->ReplaceItem (n, snode);
-      break;
-    }
+    return;
   }
-  snode->Delete();
+  this->CopyNodeInUndoSceneState(this->RedoStack.back(), copyNode);
 }
 
 //------------------------------------------------------------------------------
@@ -2887,93 +2956,74 @@ void vtkMRMLScene::Undo()
   this->StartState(vtkMRMLScene::UndoState);
   this->RemoveUnusedNodeReferences();
 
-  int nnodes;
-  int n;
-  unsigned int nn;
-
   this->PushIntoRedoStack();
 
-  vtkCollection* currentScene = this->Nodes;
-  // We use 2 vectors instead of a map in order to keep the ordering of the
+  // We use a vector in addition to the map in order to keep the ordering of the
   // nodes.
-  std::vector<std::string> currentIDs;
   std::vector<vtkMRMLNode*> currentNodes;
-  nnodes = currentScene->GetNumberOfItems();
-  for (n=0; n<nnodes; n++)
+  std::map<std::string, vtkMRMLNode*> currentNodesByID;
+  vtkMRMLNode* node = nullptr;
+  vtkCollectionSimpleIterator it;
+  for (this->Nodes->InitTraversal(it);
+    (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it));)
   {
-    vtkMRMLNode *node  = vtkMRMLNode::SafeDownCast(currentScene->GetItemAsObject(n));
-    if (node && node->GetUndoEnabled())
+    if (node->GetUndoEnabled())
     {
-      currentIDs.emplace_back(node->GetID());
       currentNodes.push_back(node);
+      currentNodesByID[node->GetID()] = node;
     }
   }
 
-  vtkCollection* undoScene = nullptr;
-  std::vector<std::string> undoIDs;
+  UndoSceneState* undoScene = this->UndoStack.back();
   std::vector<vtkMRMLNode*> undoNodes;
-
-  if (!this->UndoStack.empty())
+  std::set<std::string> undoIDs;
+  for (vtkMRMLNode* undoNode : undoScene->Nodes)
   {
-    undoScene = this->UndoStack.back();
-    nnodes = undoScene->GetNumberOfItems();
-    for (n=0; n<nnodes; n++)
+    if (undoNode && undoNode->GetUndoEnabled())
     {
-      vtkMRMLNode *node  = vtkMRMLNode::SafeDownCast(undoScene->GetItemAsObject(n));
-      if (node && node->GetUndoEnabled())
-      {
-        undoIDs.emplace_back(node->GetID());
-        undoNodes.push_back(node);
-      }
+      undoNodes.push_back(undoNode);
+      undoIDs.insert(undoNode->GetID());
     }
   }
 
-  std::vector<std::string>::iterator iterID;
-  std::vector<vtkMRMLNode*>::iterator iterNode;
-  std::vector<std::string>::iterator curIterID;
-  std::vector<vtkMRMLNode*>::iterator curIterNode;
-
   // copy back changes and add deleted nodes to the current scene
-  std::vector<vtkMRMLNode*> addNodes;
-
-  for(iterID=undoIDs.begin(), iterNode = undoNodes.begin(); iterID != undoIDs.end(); iterID++, iterNode++)
+  std::vector<vtkSmartPointer<vtkMRMLNode> > addNodes;
+  for (vtkMRMLNode* undoNode : undoNodes)
   {
-    curIterID = std::find(currentIDs.begin(), currentIDs.end(), *iterID);
-    curIterNode = currentNodes.begin() + std::distance(currentIDs.begin(), curIterID);
-    if ( curIterID == currentIDs.end() )
+    std::map<std::string, vtkMRMLNode*>::iterator currentNodeIt = currentNodesByID.find(undoNode->GetID());
+    if (currentNodeIt == currentNodesByID.end())
     {
       // the node was deleted, add Node back to the current scene
-      addNodes.push_back(*iterNode);
+      addNodes.push_back(this->GetUndoSceneStateNodeToAdd(undoScene, undoNode));
     }
-    else if (*iterNode != *curIterNode)
+    else if (undoNode != currentNodeIt->second
+      && undoNode != this->GetUpToDateUndoNodeSnapshot(currentNodeIt->second))
     {
       // nodes differ, copy from undo to current scene
       // but before create a copy in redo stack from current
-      this->CopyNodeInRedoStack(*curIterNode);
-      (*curIterNode)->CopyWithScene(*iterNode);
+      this->CopyNodeInRedoStack(currentNodeIt->second);
+      currentNodeIt->second->CopyWithScene(undoNode);
     }
   }
 
   // remove new nodes created before Undo
   std::vector<vtkMRMLNode*> removeNodes;
-  for(curIterID=currentIDs.begin(), curIterNode = currentNodes.begin(); curIterID != currentIDs.end(); curIterID++, curIterNode++)
+  for (vtkMRMLNode* currentNode : currentNodes)
   {
-    iterID = std::find(undoIDs.begin(),undoIDs.end(), *curIterID);
     // Remove only if the node is not present in the previous state.
-    if ( iterID == undoIDs.end() )
+    if (undoIDs.find(currentNode->GetID()) == undoIDs.end())
     {
-      removeNodes.push_back(*curIterNode);
+      removeNodes.push_back(currentNode);
     }
   }
 
-  for (nn=0; nn<addNodes.size(); nn++)
+  for (vtkMRMLNode* addNode : addNodes)
   {
-    this->AddNode(addNodes[nn]);
-    addNodes[nn]->SetSceneReferences();
+    this->AddNode(addNode);
+    addNode->SetSceneReferences();
   }
-  for (nn=0; nn<removeNodes.size(); nn++)
+  for (vtkMRMLNode* nodeToRemove : removeNodes)
   {
-    vtkMRMLNode* nodeToRemove = removeNodes[nn];
     // Maybe the node has been removed already by a side effect of a previous
     // node removal.
     if (this->IsNodePresent(nodeToRemove))
@@ -2982,16 +3032,9 @@ void vtkMRMLScene::Undo()
     }
   }
 
-  if (undoScene)
-  {
-    undoScene->RemoveAllItems();
-    undoScene->Delete();
-  }
-
-  if (!this->UndoStack.empty())
-  {
-   this->UndoStack.pop_back();
-  }
+  this->UndoStack.pop_back();
+  delete undoScene;
+  this->RemoveUnusedUndoNodeSnapshots();
   this->Modified();
 
   this->EndState(vtkMRMLScene::UndoState);
@@ -3014,49 +3057,31 @@ void vtkMRMLScene::Redo()
     return;
   }
 
-  int nnodes;
-  int n;
-  unsigned int nn;
-
   this->StartState(vtkMRMLScene::RedoState);
 
   this->RemoveUnusedNodeReferences();
 
   this->PushIntoUndoStack();
 
-
-  vtkCollection* currentScene = this->Nodes;
-  //std::hash_map<std::string, vtkMRMLNode*> currentMap;
   std::map<std::string, vtkWeakPointer<vtkMRMLNode> > currentMap;
-  nnodes = currentScene->GetNumberOfItems();
-  for (n=0; n<nnodes; n++)
+  vtkMRMLNode* node = nullptr;
+  vtkCollectionSimpleIterator it;
+  for (this->Nodes->InitTraversal(it);
+    (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it));)
   {
-    vtkMRMLNode *node  = vtkMRMLNode::SafeDownCast(currentScene->GetItemAsObject(n));
-    if (node && node->GetUndoEnabled())
+    if (node->GetUndoEnabled())
     {
       currentMap[node->GetID()] = node;
     }
   }
 
-  //std::hash_map<std::string, vtkMRMLNode*> undoMap;
   std::map<std::string, vtkWeakPointer<vtkMRMLNode> > undoMap;
-
-  vtkCollection* undoScene = nullptr;
-
-  if (!this->RedoStack.empty())
+  UndoSceneState* undoScene = this->RedoStack.back();
+  for (vtkMRMLNode* undoNode : undoScene->Nodes)
   {
-    undoScene = this->RedoStack.back();
-    if (undoScene)
+    if (undoNode && undoNode->GetUndoEnabled())
     {
-      nnodes = undoScene->GetNumberOfItems();
-      for (n=0; n<nnodes; n++)
-      {
-        vtkMRMLNode *node = vtkMRMLNode::SafeDownCast(undoScene->GetItemAsObject(n));
-        if (node && node->GetUndoEnabled())
-        {
-          undoMap[node->GetID()] = node;
-        }
-      }
+      undoMap[undoNode->GetID()] = undoNode;
     }
   }
 
@@ -3064,20 +3089,21 @@ void vtkMRMLScene::Redo()
   std::map<std::string, vtkWeakPointer<vtkMRMLNode> >::iterator curIter;
 
   // copy back changes and add deleted nodes to the current scene
-  std::vector<vtkWeakPointer<vtkMRMLNode> > addNodes;
+  std::vector<vtkSmartPointer<vtkMRMLNode> > addNodes;
   for(iter=undoMap.begin(); iter != undoMap.end(); iter++)
   {
     curIter = currentMap.find(iter->first);
     if ( curIter == currentMap.end() )
     {
       // the node was deleted, add Node back to the current scene
-      addNodes.push_back(iter->second);
+      addNodes.push_back(this->GetUndoSceneStateNodeToAdd(undoScene, iter->second));
     }
     else if (!curIter->second || !iter->second)
     {
       continue;
     }
-    else if (iter->second != curIter->second)
+    else if (iter->second != curIter->second
+      && iter->second != this->GetUpToDateUndoNodeSnapshot(curIter->second))
     {
       // nodes differ, copy from redo to current scene
       // but before create a copy in undo stack from current
@@ -3103,21 +3129,18 @@ void vtkMRMLScene::Redo()
     }
   }
 
-  for (nn=0; nn<addNodes.size(); nn++)
+  for (vtkMRMLNode* addNode : addNodes)
   {
-    this->AddNode(addNodes[nn]);
+    this->AddNode(addNode);
   }
-  for (nn=0; nn<removeNodes.size(); nn++)
+  for (vtkMRMLNode* nodeToRemove : removeNodes)
   {
-    this->RemoveNode(removeNodes[nn]);
+    this->RemoveNode(nodeToRemove);
   }
 
-  if (undoScene)
-  {
-    undoScene->RemoveAllItems();
-    undoScene->Delete();
-  }
   this->RedoStack.pop_back();
+  delete undoScene;
+  this->RemoveUnusedUndoNodeSnapshots();
   this->Modified();
 
   this->EndState(vtkMRMLScene::RedoState);
@@ -3126,25 +3149,23 @@ void vtkMRMLScene::Redo()
 //------------------------------------------------------------------------------
 void vtkMRMLScene::ClearUndoStack()
 {
-  std::list< vtkCollection* >::iterator iter;
-  for(iter=this->UndoStack.begin(); iter != this->UndoStack.end(); iter++)
+  for (UndoSceneState* state : this->UndoStack)
   {
-    (*iter)->RemoveAllItems();
-    (*iter)->Delete();
+    delete state;
   }
   this->UndoStack.clear();
+  this->RemoveUnusedUndoNodeSnapshots();
 }
 
 //------------------------------------------------------------------------------
 void vtkMRMLScene::ClearRedoStack()
 {
-  std::list< vtkCollection* >::iterator iter;
-  for(iter=this->RedoStack.begin(); iter != this->RedoStack.end(); iter++)
+  for (UndoSceneState* state : this->RedoStack)
   {
-    (*iter)->RemoveAllItems();
-    (*iter)->Delete();
+    delete state;
   }
   this->RedoStack.clear();
+  this->RemoveUnusedUndoNodeSnapshots();
 }
 
 //------------------------------------------------------------------------------
@@ -3488,6 +3509,156 @@ void vtkMRMLScene::ClearNodeIDs()
   }
 }
 
+//-----------------------------------------------------------------------------
+const std::vector<vtkMRMLNode*>& vtkMRMLScene::GetNodesByClassFromIndex(const char* className)
+{
+  static const std::vector<vtkMRMLNode*> emptyNodeList;
+  if (!this->Nodes || !className)
+  {
+    return emptyNodeList;
+  }
+  if (this->Nodes->GetMTime() > this->NodeClassIndexMTime)
+  {
+    // The collection was modified without AddNode/RemoveNode (e.g., by accessing
+    // the collection directly), therefore the index cannot be trusted anymore.
+    this->ClearNodeClassIndex();
+  }
+
+  std::map< std::string, NodeClassIndexEntry >::iterator entryIt = this->NodeClassIndex.find(className);
+  if (entryIt != this->NodeClassIndex.end())
+  {
+    NodeClassIndexEntry& entry = entryIt->second;
+    if (entry.NumberOfRemovedNodes > 0)
+    {
+      // Compact the lists now (nodes were only marked as removed)
+      size_t validNodeCount = 0;
+      for (size_t i = 0; i < entry.Nodes.size(); ++i)
+      {
+        if (entry.Nodes[i])
+        {
+          entry.Nodes[validNodeCount] = entry.Nodes[i];
+          entry.NodeSequenceNumbers[validNodeCount] = entry.NodeSequenceNumbers[i];
+          ++validNodeCount;
+        }
+      }
+      entry.Nodes.resize(validNodeCount);
+      entry.NodeSequenceNumbers.resize(validNodeCount);
+      entry.NumberOfRemovedNodes = 0;
+    }
+    return entry.Nodes;
+  }
+
+  // This class name has not been requested before, add it to the index
+  if (this->NodeClassIndex.empty())
+  {
+    // Sequence numbers are only maintained while there are indexed classes
+    this->NodeClassIndexSequenceNumbers.clear();
+    this->NodeClassIndexNextSequenceNumber = 0;
+    vtkMRMLNode* node = nullptr;
+    vtkCollectionSimpleIterator it;
+    for (this->Nodes->InitTraversal(it);
+      (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it));)
+    {
+      this->NodeClassIndexSequenceNumbers[node] = this->NodeClassIndexNextSequenceNumber++;
+    }
+  }
+  NodeClassIndexEntry& entry = this->NodeClassIndex[className];
+  vtkMRMLNode* node = nullptr;
+  vtkCollectionSimpleIterator it;
+  for (this->Nodes->InitTraversal(it);
+    (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it));)
+  {
+    if (node->IsA(className))
+    {
+      entry.Nodes.push_back(node);
+      entry.NodeSequenceNumbers.push_back(this->NodeClassIndexSequenceNumbers[node]);
+    }
+  }
+  // Lists of indexed classes that each node class belongs to have to be updated
+  this->NodeClassIndexVersion++;
+  this->NodeClassIndexMTime = this->Nodes->GetMTime();
+  return entry.Nodes;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<vtkMRMLScene::NodeClassIndexEntry*>& vtkMRMLScene::GetNodeClassIndexEntries(vtkMRMLNode* node)
+{
+  std::pair< int, std::vector<NodeClassIndexEntry*> >& entries = this->NodeClassIndexEntriesByClassName[node->GetClassName()];
+  if (entries.first != this->NodeClassIndexVersion)
+  {
+    // New class names have been indexed since this list was computed
+    entries.second.clear();
+    for (std::map< std::string, NodeClassIndexEntry >::iterator entryIt = this->NodeClassIndex.begin();
+      entryIt != this->NodeClassIndex.end(); ++entryIt)
+    {
+      if (node->IsA(entryIt->first.c_str()))
+      {
+        entries.second.push_back(&(entryIt->second));
+      }
+    }
+    entries.first = this->NodeClassIndexVersion;
+  }
+  return entries.second;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::AddNodeToClassIndex(vtkMRMLNode* node)
+{
+  if (!this->Nodes || !node)
+  {
+    return;
+  }
+  if (!this->NodeClassIndex.empty())
+  {
+    vtkIdType sequenceNumber = this->NodeClassIndexNextSequenceNumber++;
+    this->NodeClassIndexSequenceNumbers[node] = sequenceNumber;
+    for (NodeClassIndexEntry* entry : this->GetNodeClassIndexEntries(node))
+    {
+      entry->Nodes.push_back(node);
+      entry->NodeSequenceNumbers.push_back(sequenceNumber);
+    }
+  }
+  this->NodeClassIndexMTime = this->Nodes->GetMTime();
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::RemoveNodeFromClassIndex(vtkMRMLNode* node)
+{
+  if (!this->Nodes || !node)
+  {
+    return;
+  }
+  std::map< vtkMRMLNode*, vtkIdType >::iterator sequenceNumberIt = this->NodeClassIndexSequenceNumbers.find(node);
+  if (sequenceNumberIt != this->NodeClassIndexSequenceNumbers.end())
+  {
+    vtkIdType sequenceNumber = sequenceNumberIt->second;
+    this->NodeClassIndexSequenceNumbers.erase(sequenceNumberIt);
+    for (NodeClassIndexEntry* entry : this->GetNodeClassIndexEntries(node))
+    {
+      // Sequence numbers are increasing, so binary search can be used.
+      // The node is only marked as removed, the list is compacted on next request.
+      std::vector<vtkIdType>::iterator it = std::lower_bound(
+        entry->NodeSequenceNumbers.begin(), entry->NodeSequenceNumbers.end(), sequenceNumber);
+      if (it != entry->NodeSequenceNumbers.end() && *it == sequenceNumber)
+      {
+        entry->Nodes[it - entry->NodeSequenceNumbers.begin()] = nullptr;
+        entry->NumberOfRemovedNodes++;
+      }
+    }
+  }
+  this->NodeClassIndexMTime = this->Nodes->GetMTime();
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::ClearNodeClassIndex()
+{
+  this->NodeClassIndex.clear();
+  this->NodeClassIndexEntriesByClassName.clear();
+  this->NodeClassIndexSequenceNumbers.clear();
+  this->NodeClassIndexNextSequenceNumber = 0;
+  this->NodeClassIndexMTime = (this->Nodes ? this->Nodes->GetMTime() : 0);
+}
+
 //------------------------------------------------------------------------------
 void vtkMRMLScene::AddURIHandler(vtkURIHandler *handler)
 {
@@ -3854,12 +4025,22 @@ void vtkMRMLScene::SetMaximumNumberOfSavedUndoStates(int stackSize)
 //-----------------------------------------------------------------------------
 void vtkMRMLScene::TrimUndoStack()
 {
-  std::list<vtkSmartPointer<vtkCollection> > removedStacks;
+  std::list<UndoSceneState*> removedStates;
   while(static_cast<int>(this->UndoStack.size()) > this->MaximumNumberOfSavedUndoStates)
   {
-    removedStacks.emplace_back(this->UndoStack.front());
+    removedStates.push_back(this->UndoStack.front());
     this->UndoStack.pop_front();
   }
+  if (removedStates.empty())
+  {
+    return;
+  }
+  // Nodes of removed states are released after the stack is updated
+  for (UndoSceneState* state : removedStates)
+  {
+    delete state;
+  }
+  this->RemoveUnusedUndoNodeSnapshots();
 }
 
 //----------------------------------------------------------------------------
@@ -3933,25 +4114,51 @@ bool vtkMRMLScene::WriteToMRB(const char* filename, vtkImageData* thumbnail/*=nu
   }
 
   //
-  // Now save the scene into the bundle directory and then make a zip (mrb) file
-  // in the user's selected file location
+  // Now save the scene into the bundle directory and make a zip (mrb) file.
+  // Data files are added to the zip file as soon as they are written.
+  // The zip file is created next to the user's selected file location
+  // and only replaces that file if the scene is saved successfully.
   //
-  bool retval = this->SaveSceneToSlicerDataBundleDirectory(bundleDir.c_str(), thumbnail, userMessages);
+  std::string mrbTempFilePath = mrbDir + "/" + this->GetTemporaryBundleDirectory() + ".mrb";
+  vtkDebugMacro("Zipping to " << mrbTempFilePath);
+  vtkNew<vtkArchive> archive;
+  if (!archive->OpenZip(mrbTempFilePath.c_str(), bundleDir.c_str()))
+  {
+    vtkErrorToMessageCollectionMacro(userMessages, "vtkMRMLScene::WriteToMRB",
+      "Failed to save '" << filename << "': Could not create file '" << mrbTempFilePath << "'");
+    return false;
+  }
+
+  bool retval = this->SaveSceneToSlicerDataBundleDirectory(bundleDir.c_str(), thumbnail, userMessages, archive);
   if (!retval)
   {
+    archive->CloseZip();
+    vtksys::SystemTools::RemoveFile(mrbTempFilePath);
     vtkErrorToMessageCollectionMacro(userMessages, "vtkMRMLScene::WriteToMRB",
       "Failed to save '" << filename << "': Failed to save scene to data bundle directory '" << bundleDir << "'");
     return false;
   }
 
-  vtkDebugMacro("Zipping to " << mrbFilePath);
-  if (!vtkArchive::Zip(mrbFilePath.c_str(), bundleDir.c_str()))
+  // Add the scene file, thumbnail, and all other files that have not been added yet
+  bool zipped = archive->AddRemainingFilesToZip();
+  zipped = archive->CloseZip() && zipped;
+  if (!zipped)
   {
+    vtksys::SystemTools::RemoveFile(mrbTempFilePath);
     vtkErrorToMessageCollectionMacro(userMessages, "vtkMRMLScene::WriteToMRB",
       "Failed to save '" << filename << "': Could not compress bundle in directory '" << bundleDir << "'");
     return false;
   }
 
+  vtkDebugMacro("Moving " << mrbTempFilePath << " to " << mrbFilePath);
+  if (!vtksys::SystemTools::RenameFile(mrbTempFilePath, mrbFilePath))
+  {
+    vtksys::SystemTools::RemoveFile(mrbTempFilePath);
+    vtkErrorToMessageCollectionMacro(userMessages, "vtkMRMLScene::WriteToMRB",
+      "Failed to save '" << filename << "': Could not write file '" << mrbFilePath << "'");
+    return false;
+  }
+
   //
   // Now clean up the temp directory
   //
@@ -4139,7 +4346,14 @@ std::string vtkMRMLScene::UnpackSlicerDataBundle(const char* sdbFilePath, const
 
 //----------------------------------------------------------------------------
 bool vtkMRMLScene::SaveSceneToSlicerDataBundleDirectory(const char* sdbDir,
-  vtkImageData* screenShot/*=nullptr*/, vtkMRMLMessageCollection* userMessagesInput/*=nullptr*/)
+  vtkImageData* screenShot/*=nullptr*/, vtkMRMLMessageCollection* userMessages/*=nullptr*/)
+{
+  return this->SaveSceneToSlicerDataBundleDirectory(sdbDir, screenShot, userMessages, nullptr);
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLScene::SaveSceneToSlicerDataBundleDirectory(const char* sdbDir,
+  vtkImageData* screenShot, vtkMRMLMessageCollection* userMessagesInput, vtkArchive* archive)
 {
   // Overview:
   // - confirm the arguments are valid and create directories if needed
@@ -4254,7 +4468,7 @@ bool vtkMRMLScene::SaveSceneToSlicerDataBundleDirectory(const char* sdbDir,
 
 
   // Change all storage nodes and file names to be unique in the new directory.
-  // Write the new data as we go; save old values.
+  // Save old values, then write the new data (independent nodes are written concurrently).
   // Use a map to store the file names from a storage node, the 0th one is by
   // definition the GetFileName returned value, then the rest are at index n+1
   // from GetNthFileName(n).
@@ -4262,6 +4476,10 @@ bool vtkMRMLScene::SaveSceneToSlicerDataBundleDirectory(const char* sdbDir,
 
   bool success = true;
   std::map<std::string, vtkMRMLNode *> storableNodes;
+  // File names of nodesToWrite, which are not written to disk yet
+  std::set<std::string> reservedFileNames;
+  std::vector< std::pair<vtkMRMLStorableNode*, vtkMRMLStorageNode*> > nodesToWrite;
+  std::set<vtkMRMLStorageNode*> storageNodesToWrite;
   int numNodes = this->GetNumberOfNodes();
   for (int i = 0; i < numNodes; ++i)
   {
@@ -4277,13 +4495,32 @@ bool vtkMRMLScene::SaveSceneToSlicerDataBundleDirectory(const char* sdbDir,
       // get all storable nodes in the main scene
       // and store them in the map by ID to avoid duplicates for the scene views
       vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(mrmlNode);
-      if (!this->SaveStorableNodeToSlicerDataBundleDirectory(storableNode, dataDir, originalStorageNodeFileNames, userMessages))
+      if (storableNode->GetStorageNode() && storageNodesToWrite.count(storableNode->GetStorageNode()))
       {
-        success = false;
+        // Storage node is shared with a node that is not written yet, write pending nodes
+        // before the file name is changed.
+        if (!this->WriteStorableNodesToSlicerDataBundleDirectory(nodesToWrite, userMessages, archive))
+        {
+          success = false;
+        }
+        nodesToWrite.clear();
+        storageNodesToWrite.clear();
+        reservedFileNames.clear();
+      }
+      vtkMRMLStorageNode* storageNode = this->PrepareStorableNodeForSlicerDataBundleDirectory(
+        storableNode, dataDir, originalStorageNodeFileNames, reservedFileNames);
+      if (storageNode)
+      {
+        nodesToWrite.emplace_back(storableNode, storageNode);
+        storageNodesToWrite.insert(storageNode);
       }
       storableNodes[std::string(storableNode->GetID())] = storableNode;
     }
   }
+  if (!this->WriteStorableNodesToSlicerDataBundleDirectory(nodesToWrite, userMessages, archive))
+  {
+    success = false;
+  }
   // Update all storage nodes in all scene views.
   // Nodes that are not present in the main scene are actually saved to file, others just have their paths updated.
   for (int i = 0; i < numNodes; ++i)
@@ -4466,7 +4703,15 @@ void vtkMRMLScene::SaveSceneScreenshot(vtkImageData* screenshot)
 //----------------------------------------------------------------------------
 std::string vtkMRMLScene::CreateUniqueFileName(const std::string& filename, const std::string& knownExtension)
 {
-  if (!vtksys::SystemTools::FileExists(filename.c_str()))
+  return vtkMRMLScene::CreateUniqueFileName(filename, knownExtension, std::set<std::string>());
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLScene::CreateUniqueFileName(const std::string& filename, const std::string& knownExtension,
+  const std::set<std::string>& reservedFileNames)
+{
+  if (!vtksys::SystemTools::FileExists(filename.c_str())
+    && !reservedFileNames.count(vtksys::SystemTools::LowerCase(filename)))
   {
     // filename is unique already
     return filename;
@@ -4518,7 +4763,8 @@ std::string vtkMRMLScene::CreateUniqueFileName(const std::string& filename, cons
     std::stringstream ss;
     ss << baseName << "_" << suffix << extension;
     uniqueFilename = ss.str();
-    if (!vtksys::SystemTools::FileExists(uniqueFilename))
+    if (!vtksys::SystemTools::FileExists(uniqueFilename)
+      && !reservedFileNames.count(vtksys::SystemTools::LowerCase(uniqueFilename)))
     {
       // found unique filename
       break;
@@ -4531,10 +4777,28 @@ std::string vtkMRMLScene::CreateUniqueFileName(const std::string& filename, cons
 bool vtkMRMLScene::SaveStorableNodeToSlicerDataBundleDirectory(vtkMRMLStorableNode* storableNode, std::string &dataDir,
   std::map<vtkMRMLStorageNode*, std::vector<std::string> > &originalStorageNodeFileNames, vtkMRMLMessageCollection* userMessages)
 {
-  if (!storableNode || !storableNode->GetSaveWithScene())
+  std::set<std::string> reservedFileNames;
+  vtkMRMLStorageNode* storageNode = this->PrepareStorableNodeForSlicerDataBundleDirectory(
+    storableNode, dataDir, originalStorageNodeFileNames, reservedFileNames);
+  if (!storageNode)
   {
+    // no need to write this node
     return true;
   }
+  std::vector< std::pair<vtkMRMLStorableNode*, vtkMRMLStorageNode*> > nodesToWrite;
+  nodesToWrite.emplace_back(storableNode, storageNode);
+  return this->WriteStorableNodesToSlicerDataBundleDirectory(nodesToWrite, userMessages, nullptr);
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLStorageNode* vtkMRMLScene::PrepareStorableNodeForSlicerDataBundleDirectory(vtkMRMLStorableNode* storableNode,
+  std::string &dataDir, std::map<vtkMRMLStorageNode*, std::vector<std::string> > &originalStorageNodeFileNames,
+  std::set<std::string>& reservedFileNames)
+{
+  if (!storableNode || !storableNode->GetSaveWithScene())
+  {
+    return nullptr;
+  }
   // adjust the file paths for storable nodes
   vtkMRMLStorageNode* storageNode = storableNode->GetStorageNode();
   if (!storageNode)
@@ -4545,7 +4809,7 @@ bool vtkMRMLScene::SaveStorableNodeToSlicerDataBundleDirectory(vtkMRMLStorableNo
     if (!storageNode)
     {
       // no need for storage node to store this node
-      return true;
+      return nullptr;
     }
   }
 
@@ -4594,22 +4858,166 @@ bool vtkMRMLScene::SaveStorableNodeToSlicerDataBundleDirectory(vtkMRMLStorableNo
 
   // Make sure the filename is unique (default filenames may be the same if for example there are multiple
   // nodes with the same name).
+  // Files of other nodes in reservedFileNames are not written yet, so they are checked separately
+  // (case-insensitively, as the file system may be case-insensitive).
   std::string existingFileName = (storageNode->GetFileName() ? storageNode->GetFileName() : "");
-  if (vtksys::SystemTools::FileExists(existingFileName, true))
+  if (vtksys::SystemTools::FileExists(existingFileName, true)
+    || reservedFileNames.count(vtksys::SystemTools::LowerCase(existingFileName)))
   {
     std::string currentExtension = storageNode->GetSupportedFileExtension(existingFileName.c_str());
-    std::string uniqueFileName = this->CreateUniqueFileName(existingFileName, currentExtension);
+    std::string uniqueFileName = vtkMRMLScene::CreateUniqueFileName(existingFileName, currentExtension, reservedFileNames);
     vtkDebugMacro("file " << existingFileName << " already exists, use " << uniqueFileName << " filename instead");
     storageNode->SetFileName(uniqueFileName.c_str());
   }
+  reservedFileNames.insert(vtksys::SystemTools::LowerCase(storageNode->GetFileName() ? storageNode->GetFileName() : ""));
+
+  return storageNode;
+}
+
+//----------------------------------------------------------------------------
+namespace
+{
+/// Add all files written by the storage node to the archive
+void AddStorageNodeFilesToArchive(vtkMRMLStorageNode* storageNode, vtkArchive* archive)
+{
+  if (!archive)
+  {
+    return;
+  }
+  std::vector<std::string> fileNames;
+  fileNames.push_back(storageNode->GetFullNameFromFileName());
+  for (int i = 0; i < storageNode->GetNumberOfFileNames(); ++i)
+  {
+    fileNames.push_back(storageNode->GetFullNameFromNthFileName(i));
+  }
+  for (const std::string& fileName : fileNames)
+  {
+    if (!fileName.empty() && vtksys::SystemTools::FileExists(fileName, true))
+    {
+      // Errors are reported when the archive is closed
+      archive->AddFileToZip(fileName.c_str());
+    }
+  }
+}
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLScene::WriteStorableNodesToSlicerDataBundleDirectory(
+  const std::vector< std::pair<vtkMRMLStorableNode*, vtkMRMLStorageNode*> >& nodesToWrite,
+  vtkMRMLMessageCollection* userMessages, vtkArchive* archive)
+{
+  size_t numberOfNodesToWrite = nodesToWrite.size();
+  std::vector<int> results(numberOfNodesToWrite, 0);
+
+  // Decide which nodes can be written in background threads. This is done right before
+  // writing, as storage nodes may update the data of the storable node at this point.
+  std::vector<size_t> backgroundWriteIndices;
+  for (size_t i = 0; i < numberOfNodesToWrite; ++i)
+  {
+    vtkMRMLStorageNode* storageNode = nodesToWrite[i].second;
+    storageNode->GetUserMessages()->ClearMessages();
+    if (this->NumberOfStorableNodeWriterThreads > 1 && numberOfNodesToWrite > 1
+      && storageNode->CanWriteDataInBackground(nodesToWrite[i].first))
+    {
+      backgroundWriteIndices.push_back(i);
+    }
+  }
+
+  // Write nodes that must be written on the main thread, before any background thread is started
+  // (they may invoke events that background threads must not be exposed to).
+  for (size_t i = 0, backgroundIndex = 0; i < numberOfNodesToWrite; ++i)
+  {
+    if (backgroundIndex < backgroundWriteIndices.size() && backgroundWriteIndices[backgroundIndex] == i)
+    {
+      ++backgroundIndex;
+      continue;
+    }
+    results[i] = nodesToWrite[i].second->WriteData(nodesToWrite[i].first);
+    AddStorageNodeFilesToArchive(nodesToWrite[i].second, archive);
+  }
 
-  storageNode->GetUserMessages()->ClearMessages();
-  int success = storageNode->WriteData(storableNode);
-  if (userMessages)
+  if (!backgroundWriteIndices.empty())
   {
-    std::string messagePrefix = std::string(storableNode->GetName() ? storableNode->GetName() : "unknown") + " ("
-      + (storableNode->GetID() ? storableNode->GetID() : "none") + "): ";
-    userMessages->AddMessages(storageNode->GetUserMessages(), messagePrefix);
+    // Modified events of nodes being written are invoked on the main thread, when all writing is completed
+    std::vector<int> storableNodeWasModifying(numberOfNodesToWrite, 0);
+    std::vector<int> storageNodeWasModifying(numberOfNodesToWrite, 0);
+    for (size_t i : backgroundWriteIndices)
+    {
+      storableNodeWasModifying[i] = nodesToWrite[i].first->StartModify();
+      storageNodeWasModifying[i] = nodesToWrite[i].second->StartModify();
+    }
+
+    std::atomic<size_t> nextBackgroundIndex(0);
+    std::mutex completedMutex;
+    std::condition_variable completedCondition;
+    std::deque<size_t> completedIndices;
+    auto writeNodes = [&]()
+    {
+      for (size_t backgroundIndex = nextBackgroundIndex++; backgroundIndex < backgroundWriteIndices.size();
+        backgroundIndex = nextBackgroundIndex++)
+      {
+        size_t i = backgroundWriteIndices[backgroundIndex];
+        int result = 0;
+        try
+        {
+          result = nodesToWrite[i].second->WriteDataFile(nodesToWrite[i].first);
+        }
+        catch (...)
+        {
+          result = 0;
+        }
+        std::lock_guard<std::mutex> lock(completedMutex);
+        results[i] = result;
+        completedIndices.push_back(i);
+        completedCondition.notify_one();
+      }
+    };
+    int numberOfThreads = std::min(this->NumberOfStorableNodeWriterThreads, static_cast<int>(backgroundWriteIndices.size()));
+    std::vector<std::thread> threads;
+    for (int threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex)
+    {
+      threads.emplace_back(writeNodes);
+    }
+
+    // Add files to the archive as soon as they are written, while other nodes are still being written
+    for (size_t numberOfCompletedNodes = 0; numberOfCompletedNodes < backgroundWriteIndices.size(); ++numberOfCompletedNodes)
+    {
+      size_t i = 0;
+      {
+        std::unique_lock<std::mutex> lock(completedMutex);
+        completedCondition.wait(lock, [&completedIndices] { return !completedIndices.empty(); });
+        i = completedIndices.front();
+        completedIndices.pop_front();
+      }
+      AddStorageNodeFilesToArchive(nodesToWrite[i].second, archive);
+    }
+    for (std::thread& thread : threads)
+    {
+      thread.join();
+    }
+
+    for (size_t i : backgroundWriteIndices)
+    {
+      results[i] = nodesToWrite[i].second->CompleteWriteData(nodesToWrite[i].first, results[i]);
+      nodesToWrite[i].second->EndModify(storageNodeWasModifying[i]);
+      nodesToWrite[i].first->EndModify(storableNodeWasModifying[i]);
+    }
+  }
+
+  bool success = true;
+  for (size_t i = 0; i < numberOfNodesToWrite; ++i)
+  {
+    vtkMRMLStorableNode* storableNode = nodesToWrite[i].first;
+    if (userMessages)
+    {
+      std::string messagePrefix = std::string(storableNode->GetName() ? storableNode->GetName() : "unknown") + " ("
+        + (storableNode->GetID() ? storableNode->GetID() : "none") + "): ";
+      userMessages->AddMessages(nodesToWrite[i].second->GetUserMessages(), messagePrefix);
+    }
+    if (!results[i])
+    {
+      success = false;
+    }
   }
   return success;
 }
@@ -29,8 +29,10 @@ Version:   $Revision: 1.18 $
 #include <random>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
+class vtkArchive;
 class vtkCacheManager;
 class vtkDataIOManager;
 class vtkTagTable;
@@ -783,6 +785,13 @@ public:
   void SetMaximumNumberOfSavedUndoStates(int stackSize);
   vtkGetMacro(MaximumNumberOfSavedUndoStates, int);
 
+  /// \brief Number of node copies made so far for saving undo/redo states.
+  ///
+  /// Copies of nodes that have not changed since their last copy are shared between
+  /// states, therefore this only increases when a modified node is saved.
+  /// Used for testing and benchmarking.
+  vtkGetMacro(NumberOfUndoNodeCopies, int);
+
   /// \brief Returns a string for the temporary directory to use for saving/reading scene files.
   /// The directory is created from the current date/time as well as a random number 0-999.
   std::string GetTemporaryBundleDirectory();
@@ -834,6 +843,16 @@ public:
   /// could be gz, nii.gz, or file.nii.gz and only one of them is correct).
   static std::string CreateUniqueFileName(const std::string& filename, const std::string& knownExtension = "");
 
+  /// \brief Maximum number of threads used for writing storable nodes when saving
+  /// the scene into a data bundle directory or MRML scene bundle file.
+  ///
+  /// Nodes whose storage node supports writing in a background thread
+  /// (see vtkMRMLStorageNode::CanWriteDataInBackground) are written concurrently.
+  /// Set to 1 to write all nodes on the main thread.
+  /// Default is the number of CPU cores, at most 8.
+  vtkSetClampMacro(NumberOfStorableNodeWriterThreads, int, 1, 256);
+  vtkGetMacro(NumberOfStorableNodeWriterThreads, int);
+
 protected:
 
   typedef std::map< std::string, std::set<std::string> > NodeReferencesType;
@@ -847,6 +866,21 @@ protected:
   void CopyNodeInUndoStack(vtkMRMLNode *node);
   void CopyNodeInRedoStack(vtkMRMLNode *node);
 
+  struct UndoSceneState;
+  /// Create a state that refers to all the undo-enabled nodes of the scene.
+  UndoSceneState* CreateUndoSceneState();
+  /// Get the last snapshot of the node if the node has not changed since it was taken.
+  /// Returns nullptr if there is no up-to-date snapshot of the node.
+  vtkMRMLNode* GetUpToDateUndoNodeSnapshot(vtkMRMLNode* node);
+  /// Replace the node in the state by a snapshot of its current content.
+  /// The snapshot is shared with other states if the node has not changed since it was taken.
+  void CopyNodeInUndoSceneState(UndoSceneState* state, vtkMRMLNode* node);
+  /// Get a node that can be added to the scene to restore a node stored in the state.
+  /// Snapshots may be shared between states, therefore a copy is returned for them.
+  vtkSmartPointer<vtkMRMLNode> GetUndoSceneStateNodeToAdd(UndoSceneState* state, vtkMRMLNode* node);
+  /// Remove snapshots that are no longer used by any state from the snapshot cache.
+  void RemoveUnusedUndoNodeSnapshots();
+
   /// Add a node to the scene without invoking a vtkMRMLScene::NodeAddedEvent event.
   ///
   /// \warning Use with extreme caution as it might unsynchronize observer.
@@ -894,6 +928,29 @@ protected:
   /// Clear NodeIDs map used to speedup GetByID() method.
   void ClearNodeIDs();
 
+  /// \brief Return nodes of class \a className (or derived from it) in the
+  /// order of the \a Nodes collection.
+  ///
+  /// The per-class index is created on the first request for a class name
+  /// and then kept up-to-date incrementally as nodes are added and removed.
+  /// The index is rebuilt if the \a Nodes collection was modified directly.
+  /// \sa GetNodesByClass(), GetNthNodeByClass(), GetNumberOfNodesByClass()
+  const std::vector<vtkMRMLNode*>& GetNodesByClassFromIndex(const char* className);
+
+  /// Add node to the per-class index used to speedup GetNodesByClass() methods.
+  void AddNodeToClassIndex(vtkMRMLNode* node);
+
+  /// Remove node from the per-class index used to speedup GetNodesByClass() methods.
+  void RemoveNodeFromClassIndex(vtkMRMLNode* node);
+
+  /// Clear the per-class index used to speedup GetNodesByClass() methods.
+  /// Indexed class names are recomputed when they are requested again.
+  void ClearNodeClassIndex();
+
+  struct NodeClassIndexEntry;
+  /// Get all the class index entries that nodes of the same class as \a node belong to.
+  std::vector<NodeClassIndexEntry*>& GetNodeClassIndexEntries(vtkMRMLNode* node);
+
   /// Get a NodeReferences iterator for a node reference.
   NodeReferencesType::iterator FindNodeReference(const char* referencedId, vtkMRMLNode* referencingNode);
 
@@ -918,6 +975,32 @@ protected:
   bool SaveStorableNodeToSlicerDataBundleDirectory(vtkMRMLStorableNode* storableNode, std::string& dataDir,
     std::map<vtkMRMLStorageNode*, std::vector<std::string> > &originalStorageNodeFileNames, vtkMRMLMessageCollection* userMessages);
 
+  /// Save the scene into a self contained directory, sdbDir.
+  /// If archive is not nullptr then files of storable nodes are added to the archive
+  /// (opened by vtkArchive::OpenZip) as soon as they are written.
+  bool SaveSceneToSlicerDataBundleDirectory(const char* sdbDir, vtkImageData* thumbnail,
+    vtkMRMLMessageCollection* userMessages, vtkArchive* archive);
+
+  /// Set up the storage node of a storable node for writing into the data directory
+  /// while storing original filenames. File names in reservedFileNames (lowercase) are considered
+  /// as existing files when choosing a unique file name, and the chosen file name is
+  /// added to the set.
+  /// Returns the storage node that has to write the data, nullptr if the node does not need to be written.
+  vtkMRMLStorageNode* PrepareStorableNodeForSlicerDataBundleDirectory(vtkMRMLStorableNode* storableNode, std::string& dataDir,
+    std::map<vtkMRMLStorageNode*, std::vector<std::string> > &originalStorageNodeFileNames, std::set<std::string>& reservedFileNames);
+
+  /// Write storable nodes using the storage nodes prepared by PrepareStorableNodeForSlicerDataBundleDirectory.
+  /// Nodes that support it are written concurrently, by up to NumberOfStorableNodeWriterThreads threads.
+  /// If archive is not nullptr then the written files are added to it as soon as they are written.
+  /// Returns true if all nodes were written successfully.
+  bool WriteStorableNodesToSlicerDataBundleDirectory(
+    const std::vector< std::pair<vtkMRMLStorableNode*, vtkMRMLStorageNode*> >& nodesToWrite,
+    vtkMRMLMessageCollection* userMessages, vtkArchive* archive);
+
+  /// Same as CreateUniqueFileName but file names in reservedFileNames (lowercase) are considered as existing files.
+  static std::string CreateUniqueFileName(const std::string& filename, const std::string& knownExtension,
+    const std::set<std::string>& reservedFileNames);
+
   vtkCollection*  Nodes;
 
   /// subject hierarchy node
@@ -934,8 +1017,36 @@ protected:
   int  MaximumNumberOfSavedUndoStates;
   bool UndoFlag;
 
-  std::list< vtkCollection* >  UndoStack;
-  std::list< vtkCollection* >  RedoStack;
+  /// Saved state of the undo-enabled nodes of the scene.
+  /// Nodes that have not been modified since the state was saved are stored as is,
+  /// modified nodes are replaced by a snapshot (copy) of their content at the time
+  /// the state was saved.
+  struct UndoSceneState
+  {
+    /// Nodes and node snapshots, in scene order.
+    std::vector< vtkSmartPointer<vtkMRMLNode> > Nodes;
+    /// Position of each scene node in Nodes. Built when the first node is replaced.
+    std::map< vtkMRMLNode*, size_t > NodeIndices;
+    /// Items of Nodes that are snapshots and not scene nodes.
+    std::set< vtkMRMLNode* > Snapshots;
+  };
+  std::list< UndoSceneState* >  UndoStack;
+  std::list< UndoSceneState* >  RedoStack;
+
+  /// Most recent snapshot of a node, along with the content modification time
+  /// of the node when the snapshot was taken.
+  struct UndoNodeSnapshot
+  {
+    vtkWeakPointer<vtkMRMLNode> Node;
+    vtkMTimeType ContentMTime{0};
+    vtkWeakPointer<vtkMRMLNode> Snapshot;
+  };
+  /// Snapshots are shared between undo/redo states until the node is modified.
+  /// Weak pointers are stored so that snapshots are deleted along with the last state that uses them.
+  std::map< vtkMRMLNode*, UndoNodeSnapshot > UndoNodeSnapshots;
+  int NumberOfUndoNodeCopies{0};
+
+  int NumberOfStorableNodeWriterThreads;
 
   std::string                 URL;
   std::string                 RootDirectory;
@@ -967,6 +1078,27 @@ protected:
 
   vtkMTimeType  NodeIDsMTime;
 
+  /// Nodes that are of a requested class (or derived from it), in scene order.
+  /// Removed nodes are only marked as nullptr and the list is compacted
+  /// lazily to make removal of many nodes (e.g., when closing the scene) fast.
+  struct NodeClassIndexEntry
+  {
+    std::vector<vtkMRMLNode*> Nodes;
+    std::vector<vtkIdType> NodeSequenceNumbers;
+    int NumberOfRemovedNodes{0};
+  };
+  /// Index of nodes by requested class name (key is the class name passed to GetNodesByClass, etc.)
+  std::map< std::string, NodeClassIndexEntry > NodeClassIndex;
+  /// For each concrete node class in the scene, list of indexed class names that it is a subclass of.
+  /// NodeClassIndexVersion is stored along with the list to detect when it needs to be updated.
+  std::map< std::string, std::pair< int, std::vector<NodeClassIndexEntry*> > > NodeClassIndexEntriesByClassName;
+  /// Order of the node in the scene. Used for finding the node in the NodeClassIndex entries.
+  std::map< vtkMRMLNode*, vtkIdType > NodeClassIndexSequenceNumbers;
+  vtkIdType NodeClassIndexNextSequenceNumber{0};
+  /// Incremented each time a new class name is added to the index.
+  int NodeClassIndexVersion{0};
+  vtkMTimeType NodeClassIndexMTime{0};
+
   void RemoveAllNodes(bool removeSingletons);
 
   char* Version;
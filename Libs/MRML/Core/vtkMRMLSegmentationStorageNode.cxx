@@ -38,6 +38,7 @@
 #include <vtkDoubleArray.h>
 #include <vtkErrorCode.h>
 #include <vtkFieldData.h>
+#include <vtkImageData.h>
 #include <vtkImageAccumulate.h>
 #include <vtkImageAppendComponents.h>
 #include <vtkImageCast.h>
@@ -53,10 +54,14 @@
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
+#include <vtkSMPTools.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkStringArray.h>
+#include <vtkTeemNRRDReader.h>
 #include <vtkTransform.h>
 #include <vtkXMLMultiBlockDataWriter.h>
 #include <vtkXMLMultiBlockDataReader.h>
+#include <vtksys/FStream.hxx>
 #include <vtksys/SystemTools.hxx>
 
 #ifdef SUPPORT_4D_SPATIAL_NRRD
@@ -70,8 +75,10 @@
 #endif
 
 // STL & C++ includes
+#include <atomic>
 #include <iterator>
 #include <sstream>
+#include <vector>
 
 //----------------------------------------------------------------------------
 static const char LIST_SEPARATOR = '|';
@@ -91,6 +98,69 @@ static const std::string KEY_SEGMENTATION_REFERENCE_IMAGE_EXTENT_OFFSET = "Refer
 static const std::string KEY_SEGMENTATION_CONTAINED_REPRESENTATION_NAMES = "ContainedRepresentationNames";
 
 static const int SINGLE_SEGMENT_INDEX = -1; // used as segment index when there is only a single segment
+
+//----------------------------------------------------------------------------
+/// Read voxels of a file that was written by vtkTeemNRRDWriter with parallel compression
+/// by decompressing the gzip members on multiple threads.
+/// Image geometry and metadata must be already read by the reader (UpdateInformation).
+/// Returns nullptr if the file cannot be read this way, in this case the reader must be used.
+static vtkSmartPointer<vtkImageData> ReadBlockCompressedImageData(const std::string& path, vtkITKArchetypeImageSeriesReader* reader)
+{
+  // The archetype reader returns voxels in file order, with the list of layers stored in the first axis
+  vtkTeemNRRDReader::DataLayout layout;
+  if (!vtkTeemNRRDReader::GetDataLayout(path.c_str(), layout)
+    || layout.Blocks.empty() || !layout.NativeByteOrder || layout.RangeAxis > 0)
+  {
+    return nullptr;
+  }
+
+  vtkInformation* outInfo = reader->GetOutputInformation(0);
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent);
+  vtkSmartPointer<vtkImageData> imageData = vtkSmartPointer<vtkImageData>::New();
+  imageData->SetExtent(extent);
+  imageData->SetSpacing(outInfo->Get(vtkDataObject::SPACING()));
+  imageData->SetOrigin(outInfo->Get(vtkDataObject::ORIGIN()));
+  imageData->AllocateScalars(outInfo);
+  vtkDataArray* scalars = imageData->GetPointData()->GetScalars();
+  if (!scalars
+    || static_cast<size_t>(scalars->GetNumberOfValues()) * scalars->GetDataTypeSize() != layout.DataSize)
+  {
+    return nullptr;
+  }
+
+  vtksys::ifstream inputStream(path.c_str(), std::ios::in | std::ios::binary);
+  const vtkTeemNRRDReader::CompressedBlockInfo& lastBlock = layout.Blocks.back();
+  std::vector<unsigned char> compressedData(lastBlock.MemberOffset + lastBlock.MemberSize - layout.DataOffset);
+  inputStream.seekg(static_cast<std::streamoff>(layout.DataOffset), std::ios::beg);
+  inputStream.read(reinterpret_cast<char*>(compressedData.data()), compressedData.size());
+  if (static_cast<size_t>(inputStream.gcount()) != compressedData.size())
+  {
+    return nullptr;
+  }
+  inputStream.close();
+
+  unsigned char* data = static_cast<unsigned char*>(scalars->GetVoidPointer(0));
+  std::atomic<bool> success(true);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(layout.Blocks.size()), 1, [&](vtkIdType firstBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType blockIndex = firstBlock; blockIndex < endBlock && success; ++blockIndex)
+    {
+      const vtkTeemNRRDReader::CompressedBlockInfo& block = layout.Blocks[static_cast<size_t>(blockIndex)];
+      if (!vtkTeemNRRDReader::DecompressBlock(compressedData.data() + block.MemberOffset - layout.DataOffset,
+        block, data + block.DataOffset))
+      {
+        success = false;
+      }
+    }
+  });
+  if (!success)
+  {
+    return nullptr;
+  }
+  return imageData;
+}
+
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLSegmentationStorageNode);
 
@@ -579,9 +649,19 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
 
   if (archetypeImageReader->CanReadFile(path.c_str()))
   {
-    // Read the volume
+    // Read the volume. Image data of files written with parallel compression
+    // is decompressed on multiple threads, only the header is read by the archetype reader.
     this->GetUserMessages()->SetObservedObject(archetypeImageReader);
-    archetypeImageReader->Update();
+    archetypeImageReader->UpdateInformation();
+    if (archetypeImageReader->GetErrorCode() == vtkErrorCode::NoError)
+    {
+      imageData = ReadBlockCompressedImageData(path, archetypeImageReader);
+      if (!imageData)
+      {
+        archetypeImageReader->Update();
+        imageData = archetypeImageReader->GetOutput();
+      }
+    }
     this->GetUserMessages()->SetObservedObject(nullptr);
     if (archetypeImageReader->GetErrorCode() != vtkErrorCode::NoError)
     {
@@ -591,7 +671,6 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
     }
 
     // Copy image data to sequence of volume nodes
-    imageData = archetypeImageReader->GetOutput();
     rasToFileIjk = archetypeImageReader->GetRasToIjkMatrix();
     imageData->GetExtent(imageExtentInFile);
     imageData->GetExtent(commonGeometryExtent);
@@ -1365,6 +1444,8 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
   vtkNew<vtkTeemNRRDWriter> writer;
   writer->SetFileName(fullName.c_str());
   writer->SetUseCompression(this->GetUseCompression());
+  // Compress image data blocks on multiple threads, the file remains readable by any NRRD reader
+  writer->SetParallelCompression(true);
   writer->SetSpace(nrrdSpaceLeftPosteriorSuperior);
   writer->SetMeasurementFrameMatrix(nullptr);
 
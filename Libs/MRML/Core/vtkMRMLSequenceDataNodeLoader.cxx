@@ -0,0 +1,29 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLSequenceDataNodeLoader.h"
+
+//----------------------------------------------------------------------------
+vtkMRMLSequenceDataNodeLoader::vtkMRMLSequenceDataNodeLoader() = default;
+
+//----------------------------------------------------------------------------
+vtkMRMLSequenceDataNodeLoader::~vtkMRMLSequenceDataNodeLoader() = default;
+
+//----------------------------------------------------------------------------
+void vtkMRMLSequenceDataNodeLoader::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
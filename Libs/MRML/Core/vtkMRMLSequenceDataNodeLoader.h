@@ -0,0 +1,60 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkMRMLSequenceDataNodeLoader_h
+#define __vtkMRMLSequenceDataNodeLoader_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+class vtkMRMLNode;
+class vtkMRMLSequenceNode;
+
+/// \brief Abstract class for loading content of sequence data nodes on demand.
+///
+/// Storage nodes may only create placeholder data nodes when a sequence is read
+/// and set a loader in the sequence node to read the content of the data nodes
+/// when they are accessed.
+/// \sa vtkMRMLSequenceNode::SetDataNodeLoader
+class VTK_MRML_EXPORT vtkMRMLSequenceDataNodeLoader : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkMRMLSequenceDataNodeLoader, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Make sure the content of the data node is available.
+  /// Called by the sequence node each time a data node is accessed, therefore
+  /// it must return quickly if the content is already loaded.
+  /// While this method is running, the sequence node returns data nodes without loading them.
+  /// Returns false if the content could not be loaded.
+  virtual bool LoadDataNode(vtkMRMLSequenceNode* sequenceNode, int itemNumber, vtkMRMLNode* dataNode) = 0;
+
+  /// Load content of all data nodes of the sequence and keep them loaded.
+  /// Returns false if the content of any of the data nodes could not be loaded.
+  virtual bool LoadAllDataNodes(vtkMRMLSequenceNode* sequenceNode) = 0;
+
+protected:
+  vtkMRMLSequenceDataNodeLoader();
+  ~vtkMRMLSequenceDataNodeLoader() override;
+
+private:
+  vtkMRMLSequenceDataNodeLoader(const vtkMRMLSequenceDataNodeLoader&) = delete;
+  void operator=(const vtkMRMLSequenceDataNodeLoader&) = delete;
+};
+
+#endif
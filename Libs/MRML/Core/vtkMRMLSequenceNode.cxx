@@ -17,6 +17,7 @@
 
 // MRMLSequence includes
 #include "vtkMRMLLinearTransformSequenceStorageNode.h"
+#include "vtkMRMLSequenceDataNodeLoader.h"
 #include "vtkMRMLSequenceNode.h"
 #include "vtkMRMLSequenceStorageNode.h"
 #include "vtkMRMLStorableNode.h"
@@ -79,6 +80,8 @@ vtkMRMLSequenceNode::~vtkMRMLSequenceNode()
 void vtkMRMLSequenceNode::RemoveAllDataNodes()
 {
   this->IndexEntries.clear();
+  this->TextIndexLookupValid = false;
+  this->DataNodeLoader = nullptr;
   if (!this->SequenceScene)
   {
     return;
@@ -188,6 +191,7 @@ void vtkMRMLSequenceNode::ReadIndexValues(const std::string& indexText)
   if (!this->IndexEntries.empty())
   {
     this->IndexEntries.clear();
+    this->TextIndexLookupValid = false;
     modified = true;
   }
 
@@ -202,11 +206,12 @@ void vtkMRMLSequenceNode::ReadIndexValues(const std::string& indexText)
       std::string indexValue = nodeId_indexValue.substr(indexValueSeparatorPos+1, nodeId_indexValue.size()-indexValueSeparatorPos-1);
 
       IndexEntryType indexEntry;
-      indexEntry.IndexValue=indexValue;
+      indexEntry.SetIndexValue(indexValue);
       // The nodes are not read yet, so we can only store the node ID and get the pointer to the node later (in UpdateScene())
       indexEntry.DataNodeID=nodeId;
       indexEntry.DataNode=nullptr;
       this->IndexEntries.push_back(indexEntry);
+      this->TextIndexLookupValid = false;
       modified = true;
     }
   }
@@ -268,10 +273,12 @@ void vtkMRMLSequenceNode::Copy(vtkMRMLNode *anode)
   bool mapDataNodeIds = !sourceToTargetDataNodeID.empty();
 
   this->IndexEntries.clear();
+  this->TextIndexLookupValid = false;
   for(std::deque< IndexEntryType >::iterator sourceIndexIt=snode->IndexEntries.begin(); sourceIndexIt!=snode->IndexEntries.end(); ++sourceIndexIt)
   {
     IndexEntryType seqItem;
     seqItem.IndexValue=sourceIndexIt->IndexValue;
+    seqItem.NumericIndexValue=sourceIndexIt->NumericIndexValue;
     seqItem.DataNode = nullptr;
     if (sourceIndexIt->DataNode!=nullptr)
     {
@@ -291,6 +298,8 @@ void vtkMRMLSequenceNode::Copy(vtkMRMLNode *anode)
     }
     this->IndexEntries.push_back(seqItem);
   }
+  // Data nodes that are not loaded yet are copied as placeholders, they can be loaded by the same loader
+  this->DataNodeLoader = snode->DataNodeLoader;
   this->Modified();
   this->StorableModifiedTime.Modified();
 
@@ -309,10 +318,12 @@ void vtkMRMLSequenceNode::CopySequenceIndex(vtkMRMLNode *anode)
   if (this->IndexEntries.size() > 0 || snode->IndexEntries.size() > 0)
   {
     this->IndexEntries.clear();
+    this->TextIndexLookupValid = false;
     for (std::deque< IndexEntryType >::iterator sourceIndexIt = snode->IndexEntries.begin(); sourceIndexIt != snode->IndexEntries.end(); ++sourceIndexIt)
     {
       IndexEntryType seqItem;
       seqItem.IndexValue = sourceIndexIt->IndexValue;
+      seqItem.NumericIndexValue = sourceIndexIt->NumericIndexValue;
       if (sourceIndexIt->DataNode != nullptr)
       {
         seqItem.DataNodeID = sourceIndexIt->DataNode->GetID();
@@ -386,7 +397,7 @@ int vtkMRMLSequenceNode::GetInsertPosition(const std::string& indexValue)
   {
     int itemNumber = this->GetItemNumberFromIndexValue(indexValue, false);
     double numericIndexValue = atof(indexValue.c_str());
-    double foundNumericIndexValue = atof(this->IndexEntries[itemNumber].IndexValue.c_str());
+    double foundNumericIndexValue = this->IndexEntries[itemNumber].NumericIndexValue;
     if (numericIndexValue < foundNumericIndexValue) // Deals with case of index value being smaller than any in the sequence and numeric tolerances
     {
       insertPosition = itemNumber;
@@ -424,8 +435,9 @@ vtkMRMLNode* vtkMRMLSequenceNode::SetDataNodeAtValue(vtkMRMLNode* node, const st
     seqItemIndex = GetInsertPosition(indexValue);
     // Create new item
     IndexEntryType seqItem;
-    seqItem.IndexValue = indexValue;
+    seqItem.SetIndexValue(indexValue);
     this->IndexEntries.insert(this->IndexEntries.begin() + seqItemIndex, seqItem);
+    this->TextIndexLookupValid = false;
   }
   this->IndexEntries[seqItemIndex].DataNode = newNode;
   this->IndexEntries[seqItemIndex].DataNodeID.clear();
@@ -469,6 +481,7 @@ void vtkMRMLSequenceNode::RemoveDataNodeAtValue(const std::string& indexValue)
     this->SequenceScene->RemoveNode(dataNode);
   }
   this->IndexEntries.erase(this->IndexEntries.begin()+seqItemIndex);
+  this->TextIndexLookupValid = false;
   this->Modified();
   this->StorableModifiedTime.Modified();
 }
@@ -476,8 +489,7 @@ void vtkMRMLSequenceNode::RemoveDataNodeAtValue(const std::string& indexValue)
 //---------------------------------------------------------------------------
 int vtkMRMLSequenceNode::GetItemNumberFromIndexValue(const std::string& indexValue, bool exactMatchRequired /* =true */)
 {
-  int numberOfSeqItems=this->IndexEntries.size();
-  if (numberOfSeqItems == 0)
+  if (this->IndexEntries.empty())
   {
     return -1;
   }
@@ -485,72 +497,102 @@ int vtkMRMLSequenceNode::GetItemNumberFromIndexValue(const std::string& indexVal
   // Binary search will be faster for numeric index
   if (this->IndexType == NumericIndex)
   {
-    int lowerBound = 0;
-    int upperBound = numberOfSeqItems-1;
+    int itemNumber = this->GetItemNumberFromNumericIndexValue(atof(indexValue.c_str()), exactMatchRequired);
+    if (itemNumber >= 0 || !exactMatchRequired)
+    {
+      return itemNumber;
+    }
+  }
 
-    // Deal with index values not within the range of index values in the Sequence
-    double numericIndexValue = atof(indexValue.c_str());
-    double lowerNumericIndexValue = atof(this->IndexEntries[lowerBound].IndexValue.c_str());
-    double upperNumericIndexValue = atof(this->IndexEntries[upperBound].IndexValue.c_str());
-    if (numericIndexValue <= lowerNumericIndexValue + this->NumericIndexValueTolerance)
+  // Need exact string matching for non-numeric index
+  return this->GetItemNumberFromTextIndexValue(indexValue);
+}
+
+//---------------------------------------------------------------------------
+int vtkMRMLSequenceNode::GetItemNumberFromNumericIndexValue(double numericIndexValue, bool exactMatchRequired /* =true */)
+{
+  int numberOfSeqItems=this->IndexEntries.size();
+  if (numberOfSeqItems == 0 || this->IndexType != NumericIndex)
+  {
+    return -1;
+  }
+
+  int lowerBound = 0;
+  int upperBound = numberOfSeqItems-1;
+
+  // Deal with index values not within the range of index values in the Sequence
+  double lowerNumericIndexValue = this->IndexEntries[lowerBound].NumericIndexValue;
+  double upperNumericIndexValue = this->IndexEntries[upperBound].NumericIndexValue;
+  if (numericIndexValue <= lowerNumericIndexValue + this->NumericIndexValueTolerance)
+  {
+    if (numericIndexValue < lowerNumericIndexValue - this->NumericIndexValueTolerance && exactMatchRequired)
     {
-      if (numericIndexValue < lowerNumericIndexValue - this->NumericIndexValueTolerance && exactMatchRequired)
-      {
-        return -1;
-      }
-      else
-      {
-        return lowerBound;
-      }
+      return -1;
     }
-    if (numericIndexValue >= upperNumericIndexValue - this->NumericIndexValueTolerance)
+    else
     {
-      if (numericIndexValue > upperNumericIndexValue + this->NumericIndexValueTolerance && exactMatchRequired)
-      {
-        return -1;
-      }
-      else
-      {
-        return upperBound;
-      }
+      return lowerBound;
     }
-
-    while (upperBound - lowerBound > 1)
+  }
+  if (numericIndexValue >= upperNumericIndexValue - this->NumericIndexValueTolerance)
+  {
+    if (numericIndexValue > upperNumericIndexValue + this->NumericIndexValueTolerance && exactMatchRequired)
     {
-      // Note that if middle is equal to either lowerBound or upperBound then upperBound - lowerBound <= 1
-      int middle = int((lowerBound + upperBound)/2);
-      double middleNumericIndexValue = atof(this->IndexEntries[middle].IndexValue.c_str());
-      if (fabs(numericIndexValue - middleNumericIndexValue) <= this->NumericIndexValueTolerance)
-      {
-        return middle;
-      }
-      if (numericIndexValue > middleNumericIndexValue)
-      {
-        lowerBound = middle;
-      }
-      if (numericIndexValue < middleNumericIndexValue)
-      {
-        upperBound = middle;
-      }
+      return -1;
     }
-    if (!exactMatchRequired)
+    else
     {
-      return lowerBound;
+      return upperBound;
     }
   }
 
-  // Need linear search for non-numeric index
-  for (int i=0; i<numberOfSeqItems; i++)
+  while (upperBound - lowerBound > 1)
   {
-    if (this->IndexEntries[i].IndexValue.compare(indexValue)==0)
+    // Note that if middle is equal to either lowerBound or upperBound then upperBound - lowerBound <= 1
+    int middle = int((lowerBound + upperBound)/2);
+    double middleNumericIndexValue = this->IndexEntries[middle].NumericIndexValue;
+    if (fabs(numericIndexValue - middleNumericIndexValue) <= this->NumericIndexValueTolerance)
     {
-      return i;
+      return middle;
+    }
+    if (numericIndexValue > middleNumericIndexValue)
+    {
+      lowerBound = middle;
+    }
+    if (numericIndexValue < middleNumericIndexValue)
+    {
+      upperBound = middle;
     }
   }
-
+  if (!exactMatchRequired)
+  {
+    return lowerBound;
+  }
   return -1;
 }
 
+//---------------------------------------------------------------------------
+int vtkMRMLSequenceNode::GetItemNumberFromTextIndexValue(const std::string& indexValue)
+{
+  if (!this->TextIndexLookupValid)
+  {
+    this->TextIndexLookup.clear();
+    int numberOfSeqItems = this->IndexEntries.size();
+    for (int i = 0; i < numberOfSeqItems; i++)
+    {
+      // If the same index value occurs multiple times then the first item is found
+      this->TextIndexLookup.emplace(this->IndexEntries[i].IndexValue, i);
+    }
+    this->TextIndexLookupValid = true;
+  }
+  std::unordered_map< std::string, int >::const_iterator foundIt = this->TextIndexLookup.find(indexValue);
+  if (foundIt == this->TextIndexLookup.end())
+  {
+    return -1;
+  }
+  return foundIt->second;
+}
+
 //---------------------------------------------------------------------------
 vtkMRMLNode* vtkMRMLSequenceNode::GetDataNodeAtValue(const std::string& indexValue, bool exactMatchRequired /* =true */)
 {
@@ -565,7 +607,7 @@ vtkMRMLNode* vtkMRMLSequenceNode::GetDataNodeAtValue(const std::string& indexVal
     // not found
     return nullptr;
   }
-  return this->IndexEntries[seqItemIndex].DataNode;
+  return this->GetLoadedDataNode(seqItemIndex);
 }
 
 //---------------------------------------------------------------------------
@@ -605,7 +647,8 @@ bool vtkMRMLSequenceNode::UpdateIndexValue(const std::string& oldIndexValue, con
     return false;
   }
   // Update the index value
-  this->IndexEntries[oldSeqItemIndex].IndexValue = newIndexValue;
+  this->IndexEntries[oldSeqItemIndex].SetIndexValue(newIndexValue);
+  this->TextIndexLookupValid = false;
   if (this->IndexType == vtkMRMLSequenceNode::NumericIndex)
   {
     IndexEntryType movingEntry = this->IndexEntries[oldSeqItemIndex];
@@ -669,9 +712,74 @@ vtkMRMLNode* vtkMRMLSequenceNode::GetNthDataNode(int itemNumber)
     vtkErrorMacro("vtkMRMLSequenceNode::GetNthDataNode failed: itemNumber "<<itemNumber<<" is out of range");
     return nullptr;
   }
+  return this->GetLoadedDataNode(itemNumber);
+}
+
+//-----------------------------------------------------------------------------
+vtkMRMLNode* vtkMRMLSequenceNode::GetNthDataNodeWithoutLoading(int itemNumber)
+{
+  if (itemNumber < 0 || static_cast<int>(this->IndexEntries.size()) <= itemNumber)
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::GetNthDataNodeWithoutLoading failed: itemNumber "<<itemNumber<<" is out of range");
+    return nullptr;
+  }
   return this->IndexEntries[itemNumber].DataNode;
 }
 
+//-----------------------------------------------------------------------------
+vtkMRMLNode* vtkMRMLSequenceNode::GetLoadedDataNode(int itemNumber)
+{
+  vtkMRMLNode* dataNode = this->IndexEntries[itemNumber].DataNode;
+  if (!this->DataNodeLoader || !dataNode || this->LoadingDataNode)
+  {
+    return dataNode;
+  }
+  this->LoadingDataNode = true;
+  if (!this->DataNodeLoader->LoadDataNode(this, itemNumber, dataNode))
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::GetLoadedDataNode: failed to load data node at index value "
+      << this->IndexEntries[itemNumber].IndexValue);
+  }
+  this->LoadingDataNode = false;
+  return dataNode;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::SetDataNodeLoader(vtkMRMLSequenceDataNodeLoader* loader)
+{
+  if (this->DataNodeLoader == loader)
+  {
+    return;
+  }
+  this->DataNodeLoader = loader;
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+vtkMRMLSequenceDataNodeLoader* vtkMRMLSequenceNode::GetDataNodeLoader()
+{
+  return this->DataNodeLoader;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::LoadAllDataNodes()
+{
+  if (!this->DataNodeLoader)
+  {
+    return true;
+  }
+  this->LoadingDataNode = true;
+  bool success = this->DataNodeLoader->LoadAllDataNodes(this);
+  this->LoadingDataNode = false;
+  if (!success)
+  {
+    vtkErrorMacro("vtkMRMLSequenceNode::LoadAllDataNodes failed");
+    return false;
+  }
+  this->SetDataNodeLoader(nullptr);
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 vtkMRMLScene* vtkMRMLSequenceNode::GetSequenceScene(bool autoCreate/*=true*/)
 {
@@ -706,7 +814,8 @@ std::string vtkMRMLSequenceNode::GetDefaultStorageNodeClassName(const char* file
   }
 
   // Use specific sequence storage node, if possible
-  vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(this->GetNthDataNode(0));
+  // Only the node type is needed, do not load the content of the data node
+  vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(this->GetNthDataNodeWithoutLoading(0));
   if (storableNode && this->GetScene())
   {
     std::string sequenceStorageNodeClassName = storableNode->GetDefaultSequenceStorageNodeClassName();
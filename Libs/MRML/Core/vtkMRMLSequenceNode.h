@@ -22,10 +22,16 @@
 #include <vtkMRML.h>
 #include <vtkMRMLStorableNode.h>
 
+// VTK includes
+#include <vtkSmartPointer.h>
+
 // std includes
+#include <cstdlib>
 #include <deque>
 #include <set>
+#include <unordered_map>
 
+class vtkMRMLSequenceDataNodeLoader;
 
 /// \brief MRML node for representing a sequence of MRML nodes
 ///
@@ -124,6 +130,21 @@ public:
   /// Get the data node corresponding to the n-th index value
   vtkMRMLNode* GetNthDataNode(int itemNumber);
 
+  /// Get the data node corresponding to the n-th index value without loading its content.
+  /// If a data node loader is set then the returned node may only contain placeholder data.
+  vtkMRMLNode* GetNthDataNodeWithoutLoading(int itemNumber);
+
+  /// Set loader that reads the content of data nodes when they are accessed.
+  /// If a loader is set then GetNthDataNode and GetDataNodeAtValue make sure that
+  /// the content of the returned data node is loaded.
+  /// The loader is shared with copies of this sequence node.
+  void SetDataNodeLoader(vtkMRMLSequenceDataNodeLoader* loader);
+  vtkMRMLSequenceDataNodeLoader* GetDataNodeLoader();
+
+  /// Load the content of all data nodes and remove the data node loader.
+  /// Returns false if loading of any of the data nodes failed.
+  bool LoadAllDataNodes();
+
   /// Index value of n-th data node.
   std::string GetNthIndexValue(int itemNumber);
 
@@ -131,6 +152,10 @@ public:
   /// If the sequences has numeric index, uses data node just before the index value in the case of non-exact match
   int GetItemNumberFromIndexValue(const std::string& indexValue, bool exactMatchRequired = true);
 
+  /// Same as GetItemNumberFromIndexValue but the index value is specified as a number,
+  /// which avoids string conversions. Returns -1 if the sequence does not have numeric index.
+  int GetItemNumberFromNumericIndexValue(double indexValue, bool exactMatchRequired = true);
+
   /// Change index value of an existing data node.
   bool UpdateIndexValue(const std::string& oldIndexValue, const std::string& newIndexValue);
 
@@ -181,11 +206,23 @@ protected:
 
   void ReadIndexValues(const std::string& indexText);
 
+  /// Find item by exact string match of the index value. Returns -1 if not found.
+  int GetItemNumberFromTextIndexValue(const std::string& indexValue);
+
   vtkMRMLNode* DeepCopyNodeToScene(vtkMRMLNode* source, vtkMRMLScene* scene);
 
+  /// Get data node of the specified item and load its content if a data node loader is set.
+  vtkMRMLNode* GetLoadedDataNode(int itemNumber);
+
   struct IndexEntryType
   {
+    void SetIndexValue(const std::string& indexValue)
+    {
+      this->IndexValue = indexValue;
+      this->NumericIndexValue = atof(indexValue.c_str());
+    }
     std::string IndexValue;
+    double NumericIndexValue{0.0}; // index value converted to number, kept in sync with IndexValue
     vtkWeakPointer<vtkMRMLNode> DataNode;
     std::string DataNodeID; // only used temporarily, during scene load
   };
@@ -204,6 +241,16 @@ protected:
 
   /// List of data items (the scene may contain some more nodes, such as storage nodes)
   std::deque< IndexEntryType > IndexEntries;
+
+  /// Map from index value to item number for fast exact string matching.
+  /// Built on demand, must be invalidated whenever IndexEntries is changed.
+  std::unordered_map< std::string, int > TextIndexLookup;
+  bool TextIndexLookupValid{false};
+
+  /// Reads content of data nodes on demand, optional.
+  vtkSmartPointer<vtkMRMLSequenceDataNodeLoader> DataNodeLoader;
+  /// Prevents loading data nodes while the loader is accessing the sequence.
+  bool LoadingDataNode{false};
 };
 
 #endif
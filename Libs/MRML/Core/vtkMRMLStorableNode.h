@@ -156,6 +156,10 @@ public:
   /// \sa GetStoredTime() StorableModifiedTime Modified() GetModifiedSinceRead()
   virtual void StorableModified();
 
+  /// Takes into account the modification time of storable properties.
+  /// \sa StorableModifiedTime
+  vtkMTimeType GetContentMTime() override;
+
  protected:
   vtkMRMLStorableNode();
   ~vtkMRMLStorableNode() override;
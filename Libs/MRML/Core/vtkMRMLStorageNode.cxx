@@ -1311,6 +1311,13 @@ int vtkMRMLStorageNode::ReadData(vtkMRMLNode* refNode, bool temporary)
 
 //------------------------------------------------------------------------------
 int vtkMRMLStorageNode::WriteData(vtkMRMLNode* refNode)
+{
+  int success = this->WriteDataFile(refNode);
+  return this->CompleteWriteData(refNode, success);
+}
+
+//------------------------------------------------------------------------------
+int vtkMRMLStorageNode::WriteDataFile(vtkMRMLNode* refNode)
 {
   this->WriteState = this->Idle;
   if (refNode == nullptr)
@@ -1336,6 +1343,12 @@ int vtkMRMLStorageNode::WriteData(vtkMRMLNode* refNode)
     success = 0;
   }
 
+  return success;
+}
+
+//------------------------------------------------------------------------------
+int vtkMRMLStorageNode::CompleteWriteData(vtkMRMLNode* refNode, int success)
+{
   if (success)
   {
     this->StageWriteData(refNode);
@@ -1345,6 +1358,12 @@ int vtkMRMLStorageNode::WriteData(vtkMRMLNode* refNode)
   return success;
 }
 
+//------------------------------------------------------------------------------
+bool vtkMRMLStorageNode::CanWriteDataInBackground(vtkMRMLNode* vtkNotUsed(refNode))
+{
+  return false;
+}
+
 //------------------------------------------------------------------------------
 int vtkMRMLStorageNode::ReadDataInternal(vtkMRMLNode* vtkNotUsed(refNode))
 {
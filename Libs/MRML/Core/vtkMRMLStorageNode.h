@@ -66,6 +66,24 @@ public:
   /// \sa WriteDataInternal()
   virtual int WriteData(vtkMRMLNode *refNode);
 
+  /// Write data in two steps, to allow writing multiple nodes concurrently.
+  /// WriteDataFile() writes the file(s), it may be called from a background thread
+  /// if CanWriteDataInBackground() returned true. CompleteWriteData() must then be called
+  /// from the main thread with the returned value, after all background writing is finished.
+  /// Calling these two methods is equivalent to calling WriteData().
+  /// Return 1 on success, 0 on failure.
+  /// \sa WriteData(), CanWriteDataInBackground()
+  int WriteDataFile(vtkMRMLNode* refNode);
+  int CompleteWriteData(vtkMRMLNode* refNode, int success);
+
+  /// Return true if WriteDataFile() can be called from a background thread for the
+  /// reference node. It is only allowed if WriteDataInternal() of the storage node
+  /// only reads the data of the reference node and does not invoke events or access other nodes.
+  /// The method is called from the main thread right before writing starts,
+  /// therefore subclasses may use it to bring the data of the reference node up-to-date.
+  /// Returns false by default.
+  virtual bool CanWriteDataInBackground(vtkMRMLNode* refNode);
+
   ///
   /// Write this node's information to a MRML file in XML format.
   void WriteXML(ostream& of, int indent) override;
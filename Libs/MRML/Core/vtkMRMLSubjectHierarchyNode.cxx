@@ -41,6 +41,8 @@
 #include <sstream>
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 
 //----------------------------------------------------------------------------
@@ -105,8 +107,18 @@ public:
 
   /// Item and data node cache to speed up lookups that are needed many times.
   /// It can be static as the item IDs are unique in one application session.
-  static std::map<vtkIdType, vtkWeakPointer<vtkSubjectHierarchyItem> > ItemCache;
-  static std::map<vtkMRMLNode*, vtkWeakPointer<vtkSubjectHierarchyItem> > DataNodeCache;
+  static std::unordered_map<vtkIdType, vtkWeakPointer<vtkSubjectHierarchyItem> > ItemCache;
+  static std::unordered_map<vtkMRMLNode*, vtkWeakPointer<vtkSubjectHierarchyItem> > DataNodeCache;
+  /// Items by UID name and value, to speed up UID lookups in large hierarchies (DICOM instance UIDs).
+  /// Items are added to the list of the UID when the UID is set and are not removed when the UID
+  /// is changed, therefore the candidates need to be validated by the caller.
+  /// \sa FindChildByUIDInCache
+  static std::unordered_map<std::string, std::vector<vtkWeakPointer<vtkSubjectHierarchyItem> > > UIDCache;
+  /// Items by attribute name and value, to speed up attribute lookups in large hierarchies.
+  /// Unlike \sa UIDCache it is kept up to date when attributes are changed or items are deleted,
+  /// therefore the items can be stored as raw pointers.
+  /// \sa FindChildrenByAttribute
+  static std::unordered_map<std::string, std::unordered_map<std::string, std::unordered_set<vtkSubjectHierarchyItem*> > > AttributeCache;
 
 // Get/set functions
 public:
@@ -127,6 +139,21 @@ public:
   /// Get name of the item. If has data node associated then return name of data node, \sa Name member otherwise
   std::string GetName();
 
+  /// Add item to \sa UIDCache with the given UID
+  void AddToUIDCache(const std::string& uidName, const std::string& uidValue);
+  /// Remove item and deleted items from \sa UIDCache for the given UID
+  void RemoveFromUIDCache(const std::string& uidName, const std::string& uidValue);
+  /// Key of the UID in \sa UIDCache
+  static std::string GetUIDCacheKey(const std::string& uidName, const std::string& uidValue);
+  /// Add item to \sa AttributeCache with the given attribute
+  void AddToAttributeCache(const std::string& attributeName, const std::string& attributeValue);
+  /// Remove item from \sa AttributeCache for the given attribute
+  void RemoveFromAttributeCache(const std::string& attributeName, const std::string& attributeValue);
+  /// Set attribute value and update \sa AttributeCache without invoking events
+  void SetAttributeValue(const std::string& attributeName, const std::string& attributeValue);
+  /// Remove all attributes from the item and from \sa AttributeCache without invoking events
+  void RemoveAllAttributes();
+
   /// Set UID to the item
   void SetUID(std::string uidName, std::string uidValue);
   /// Remove UID from the item
@@ -180,10 +207,22 @@ public:
   /// \param recursive Flag whether to find only direct children (false) or in the whole branch (true). True by default
   /// \return Item if found, nullptr otherwise
   vtkSubjectHierarchyItem* FindChildByUID(std::string uidName, std::string uidValue, bool recursive=true);
+  /// Find item in the branch by UID using \sa UIDCache.
+  /// \param foundItem Item if found, nullptr otherwise
+  /// \return False if multiple items in the branch have the UID, in which case the branch needs to be
+  ///   traversed to find the first one in depth-first order. True otherwise
+  bool FindChildByUIDInCache(const std::string& uidName, const std::string& uidValue, vtkSubjectHierarchyItem*& foundItem);
   /// Find child by UID list (containing). For example find UID in instance UID list
   /// \param recursive Flag whether to find only direct children (false) or in the whole branch (true). True by default
   /// \return Item if found, nullptr otherwise
   vtkSubjectHierarchyItem* FindChildByUIDList(std::string uidName, std::string uidValue, bool recursive=true);
+  /// Find items in the branch by attribute using \sa AttributeCache
+  /// \param attributeName Name of the attribute that the found items need to have
+  /// \param attributeValue Value of the attribute that needs to match exactly. Only used if matchValue is true
+  /// \param matchValue Flag whether the attribute value needs to match or only the attribute needs to be present
+  /// \param foundItems List of found items, sorted by item ID (the order in which they were added to the tree)
+  void FindChildrenByAttribute(const std::string& attributeName, const std::string& attributeValue, bool matchValue,
+                               std::vector<vtkSubjectHierarchyItem*>& foundItems);
   /// Find children by name
   /// \param name Name (or part of a name) to find
   /// \param foundItemIDs List of found item IDs. Needs to be empty when passing as argument!
@@ -257,10 +296,14 @@ vtkStandardNewMacro(vtkSubjectHierarchyItem);
 
 vtkIdType vtkSubjectHierarchyItem::NextSubjectHierarchyItemID = vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID + 1;
 
-std::map<vtkIdType, vtkWeakPointer<vtkSubjectHierarchyItem> > vtkSubjectHierarchyItem::ItemCache =
-  std::map<vtkIdType, vtkWeakPointer<vtkSubjectHierarchyItem> >();
-std::map<vtkMRMLNode*, vtkWeakPointer<vtkSubjectHierarchyItem> > vtkSubjectHierarchyItem::DataNodeCache =
-  std::map<vtkMRMLNode*, vtkWeakPointer<vtkSubjectHierarchyItem> >();
+std::unordered_map<vtkIdType, vtkWeakPointer<vtkSubjectHierarchyItem> > vtkSubjectHierarchyItem::ItemCache =
+  std::unordered_map<vtkIdType, vtkWeakPointer<vtkSubjectHierarchyItem> >();
+std::unordered_map<vtkMRMLNode*, vtkWeakPointer<vtkSubjectHierarchyItem> > vtkSubjectHierarchyItem::DataNodeCache =
+  std::unordered_map<vtkMRMLNode*, vtkWeakPointer<vtkSubjectHierarchyItem> >();
+std::unordered_map<std::string, std::vector<vtkWeakPointer<vtkSubjectHierarchyItem> > > vtkSubjectHierarchyItem::UIDCache =
+  std::unordered_map<std::string, std::vector<vtkWeakPointer<vtkSubjectHierarchyItem> > >();
+std::unordered_map<std::string, std::unordered_map<std::string, std::unordered_set<vtkSubjectHierarchyItem*> > > vtkSubjectHierarchyItem::AttributeCache =
+  std::unordered_map<std::string, std::unordered_map<std::string, std::unordered_set<vtkSubjectHierarchyItem*> > >();
 
 //---------------------------------------------------------------------------
 // vtkSubjectHierarchyItem methods
@@ -285,7 +328,12 @@ vtkSubjectHierarchyItem::~vtkSubjectHierarchyItem()
 {
   this->RemoveAllChildren();
 
-  this->Attributes.clear();
+  for (std::map<std::string, std::string>::iterator uidIt = this->UIDs.begin(); uidIt != this->UIDs.end(); ++uidIt)
+  {
+    this->RemoveFromUIDCache(uidIt->first, uidIt->second);
+  }
+
+  this->RemoveAllAttributes();
   this->UIDs.clear();
 }
 
@@ -344,7 +392,7 @@ vtkIdType vtkSubjectHierarchyItem::AddToTree(vtkSubjectHierarchyItem* parent, st
   // Set basic properties
   this->DataNode = nullptr;
   this->Name = name;
-  this->Attributes[vtkMRMLSubjectHierarchyConstants::GetSubjectHierarchyLevelAttributeName()] = level;
+  this->SetAttributeValue(vtkMRMLSubjectHierarchyConstants::GetSubjectHierarchyLevelAttributeName(), level);
 
   this->Parent = parent;
   if (parent)
@@ -482,6 +530,10 @@ void vtkSubjectHierarchyItem::ReadXMLAttributes(const char** atts)
       ss << attValue;
       std::string valueStr = ss.str();
 
+      for (std::map<std::string, std::string>::iterator uidIt = this->UIDs.begin(); uidIt != this->UIDs.end(); ++uidIt)
+      {
+        this->RemoveFromUIDCache(uidIt->first, uidIt->second);
+      }
       this->UIDs.clear();
       size_t itemSeparatorPosition = valueStr.find(vtkMRMLSubjectHierarchyNode::SUBJECTHIERARCHY_SEPARATOR);
       while (itemSeparatorPosition != std::string::npos)
@@ -492,6 +544,7 @@ void vtkSubjectHierarchyItem::ReadXMLAttributes(const char** atts)
         std::string name = itemStr.substr(0, nameValueSeparatorPosition);
         std::string value = itemStr.substr(nameValueSeparatorPosition + vtkMRMLSubjectHierarchyNode::SUBJECTHIERARCHY_NAME_VALUE_SEPARATOR.size());
         this->UIDs[name] = value;
+        this->AddToUIDCache(name, value);
 
         valueStr = valueStr.substr(itemSeparatorPosition + vtkMRMLSubjectHierarchyNode::SUBJECTHIERARCHY_SEPARATOR.size());
         itemSeparatorPosition = valueStr.find(vtkMRMLSubjectHierarchyNode::SUBJECTHIERARCHY_SEPARATOR);
@@ -504,6 +557,7 @@ void vtkSubjectHierarchyItem::ReadXMLAttributes(const char** atts)
         std::string name = itemStr.substr(0, nameValueSeparatorPosition);
         std::string value = itemStr.substr(nameValueSeparatorPosition + vtkMRMLSubjectHierarchyNode::SUBJECTHIERARCHY_NAME_VALUE_SEPARATOR.size());
         this->UIDs[name] = value;
+        this->AddToUIDCache(name, value);
       }
     }
     else if (!strcmp(attName, "attributes"))
@@ -512,7 +566,7 @@ void vtkSubjectHierarchyItem::ReadXMLAttributes(const char** atts)
       ss << attValue;
       std::string valueStr = ss.str();
 
-      this->Attributes.clear();
+      this->RemoveAllAttributes();
       size_t itemSeparatorPosition = valueStr.find(vtkMRMLSubjectHierarchyNode::SUBJECTHIERARCHY_SEPARATOR);
       while (itemSeparatorPosition != std::string::npos)
       {
@@ -521,7 +575,7 @@ void vtkSubjectHierarchyItem::ReadXMLAttributes(const char** atts)
 
         std::string name = itemStr.substr(0, nameValueSeparatorPosition);
         std::string value = itemStr.substr(nameValueSeparatorPosition + vtkMRMLSubjectHierarchyNode::SUBJECTHIERARCHY_NAME_VALUE_SEPARATOR.size());
-        this->Attributes[name] = value;
+        this->SetAttributeValue(name, value);
 
         valueStr = valueStr.substr(itemSeparatorPosition + vtkMRMLSubjectHierarchyNode::SUBJECTHIERARCHY_SEPARATOR.size());
         itemSeparatorPosition = valueStr.find(vtkMRMLSubjectHierarchyNode::SUBJECTHIERARCHY_SEPARATOR);
@@ -533,7 +587,7 @@ void vtkSubjectHierarchyItem::ReadXMLAttributes(const char** atts)
 
         std::string name = itemStr.substr(0, nameValueSeparatorPosition);
         std::string value = itemStr.substr(nameValueSeparatorPosition + vtkMRMLSubjectHierarchyNode::SUBJECTHIERARCHY_NAME_VALUE_SEPARATOR.size());
-        this->Attributes[name] = value;
+        this->SetAttributeValue(name, value);
       }
     }
   }
@@ -651,8 +705,20 @@ void vtkSubjectHierarchyItem::DeepCopy(vtkSubjectHierarchyItem* item, bool copyC
   this->Name = item->Name;
   this->OwnerPluginName = item->OwnerPluginName;
   this->Expanded = item->Expanded;
+  for (std::map<std::string, std::string>::iterator uidIt = this->UIDs.begin(); uidIt != this->UIDs.end(); ++uidIt)
+  {
+    this->RemoveFromUIDCache(uidIt->first, uidIt->second);
+  }
   this->UIDs = item->UIDs;
-  this->Attributes = item->Attributes;
+  for (std::map<std::string, std::string>::iterator uidIt = this->UIDs.begin(); uidIt != this->UIDs.end(); ++uidIt)
+  {
+    this->AddToUIDCache(uidIt->first, uidIt->second);
+  }
+  this->RemoveAllAttributes();
+  for (std::map<std::string, std::string>::iterator attIt = item->Attributes.begin(); attIt != item->Attributes.end(); ++attIt)
+  {
+    this->SetAttributeValue(attIt->first, attIt->second);
+  }
 
   // Copy temporary members if they are valid, otherwise save from live members
   if (item->TemporaryID)
@@ -707,6 +773,101 @@ std::string vtkSubjectHierarchyItem::GetName()
   return this->Name;
 }
 
+//---------------------------------------------------------------------------
+std::string vtkSubjectHierarchyItem::GetUIDCacheKey(const std::string& uidName, const std::string& uidValue)
+{
+  std::string key(uidName);
+  key += '\0';
+  key += uidValue;
+  return key;
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::AddToUIDCache(const std::string& uidName, const std::string& uidValue)
+{
+  std::vector<vtkWeakPointer<vtkSubjectHierarchyItem> >& items =
+    vtkSubjectHierarchyItem::UIDCache[vtkSubjectHierarchyItem::GetUIDCacheKey(uidName, uidValue)];
+  if (std::find(items.begin(), items.end(), this) == items.end())
+  {
+    items.push_back(this);
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::RemoveFromUIDCache(const std::string& uidName, const std::string& uidValue)
+{
+  auto cacheIt = vtkSubjectHierarchyItem::UIDCache.find(vtkSubjectHierarchyItem::GetUIDCacheKey(uidName, uidValue));
+  if (cacheIt == vtkSubjectHierarchyItem::UIDCache.end())
+  {
+    return;
+  }
+  // Weak pointers are already cleared when called from the destructor
+  std::vector<vtkWeakPointer<vtkSubjectHierarchyItem> >& items = cacheIt->second;
+  items.erase(std::remove_if(items.begin(), items.end(),
+    [this](const vtkWeakPointer<vtkSubjectHierarchyItem>& item) { return item.GetPointer() == nullptr || item.GetPointer() == this; }),
+    items.end());
+  if (items.empty())
+  {
+    vtkSubjectHierarchyItem::UIDCache.erase(cacheIt);
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::AddToAttributeCache(const std::string& attributeName, const std::string& attributeValue)
+{
+  vtkSubjectHierarchyItem::AttributeCache[attributeName][attributeValue].insert(this);
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::RemoveFromAttributeCache(const std::string& attributeName, const std::string& attributeValue)
+{
+  auto nameIt = vtkSubjectHierarchyItem::AttributeCache.find(attributeName);
+  if (nameIt == vtkSubjectHierarchyItem::AttributeCache.end())
+  {
+    return;
+  }
+  auto valueIt = nameIt->second.find(attributeValue);
+  if (valueIt == nameIt->second.end())
+  {
+    return;
+  }
+  valueIt->second.erase(this);
+  if (valueIt->second.empty())
+  {
+    nameIt->second.erase(valueIt);
+    if (nameIt->second.empty())
+    {
+      vtkSubjectHierarchyItem::AttributeCache.erase(nameIt);
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::SetAttributeValue(const std::string& attributeName, const std::string& attributeValue)
+{
+  auto it = this->Attributes.find(attributeName);
+  if (it != this->Attributes.end())
+  {
+    this->RemoveFromAttributeCache(attributeName, it->second);
+    it->second = attributeValue;
+  }
+  else
+  {
+    this->Attributes[attributeName] = attributeValue;
+  }
+  this->AddToAttributeCache(attributeName, attributeValue);
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::RemoveAllAttributes()
+{
+  for (std::map<std::string, std::string>::iterator attIt = this->Attributes.begin(); attIt != this->Attributes.end(); ++attIt)
+  {
+    this->RemoveFromAttributeCache(attIt->first, attIt->second);
+  }
+  this->Attributes.clear();
+}
+
 //---------------------------------------------------------------------------
 bool vtkSubjectHierarchyItem::HasChildren()
 {
@@ -805,6 +966,11 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByUID(std::string uid
   {
     return nullptr;
   }
+  vtkSubjectHierarchyItem* foundItem = nullptr;
+  if (recursive && this->FindChildByUIDInCache(uidName, uidValue, foundItem))
+  {
+    return foundItem;
+  }
   ChildVector::iterator childIt;
   for (childIt=this->Children.begin(); childIt!=this->Children.end(); ++childIt)
   {
@@ -825,6 +991,47 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByUID(std::string uid
   return nullptr;
 }
 
+//---------------------------------------------------------------------------
+bool vtkSubjectHierarchyItem::FindChildByUIDInCache(const std::string& uidName, const std::string& uidValue, vtkSubjectHierarchyItem*& foundItem)
+{
+  foundItem = nullptr;
+  if (uidName.empty() || uidValue.empty())
+  {
+    return true;
+  }
+  auto cacheIt = vtkSubjectHierarchyItem::UIDCache.find(vtkSubjectHierarchyItem::GetUIDCacheKey(uidName, uidValue));
+  if (cacheIt == vtkSubjectHierarchyItem::UIDCache.end())
+  {
+    return true;
+  }
+  for (const vtkWeakPointer<vtkSubjectHierarchyItem>& item : cacheIt->second)
+  {
+    // The UID may have been changed since the item was added to the cache, and the item
+    // may be in another branch or another subject hierarchy (e.g. in scene views)
+    if (!item || item.GetPointer() == this || item->GetUID(uidName) != uidValue)
+    {
+      continue;
+    }
+    vtkSubjectHierarchyItem* ancestor = item->Parent;
+    while (ancestor && ancestor != this)
+    {
+      ancestor = ancestor->Parent;
+    }
+    if (!ancestor)
+    {
+      continue;
+    }
+    if (foundItem)
+    {
+      // Multiple matches, the order of the items in the tree determines which one is found
+      foundItem = nullptr;
+      return false;
+    }
+    foundItem = item;
+  }
+  return true;
+}
+
 //---------------------------------------------------------------------------
 vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByUIDList(std::string uidName, std::string uidValue, bool recursive/*=true*/)
 {
@@ -852,6 +1059,41 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByUIDList(std::string
   return nullptr;
 }
 
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::FindChildrenByAttribute(const std::string& attributeName, const std::string& attributeValue,
+  bool matchValue, std::vector<vtkSubjectHierarchyItem*>& foundItems)
+{
+  auto nameIt = vtkSubjectHierarchyItem::AttributeCache.find(attributeName);
+  if (nameIt == vtkSubjectHierarchyItem::AttributeCache.end())
+  {
+    return;
+  }
+  size_t numberOfPreviouslyFoundItems = foundItems.size();
+  for (auto valueIt = nameIt->second.begin(); valueIt != nameIt->second.end(); ++valueIt)
+  {
+    if (matchValue && valueIt->first != attributeValue)
+    {
+      continue;
+    }
+    for (vtkSubjectHierarchyItem* item : valueIt->second)
+    {
+      // The cache contains items of all subject hierarchies (e.g. in scene views),
+      // therefore only the items in the branch of this item are kept
+      vtkSubjectHierarchyItem* ancestor = item->Parent;
+      while (ancestor && ancestor != this)
+      {
+        ancestor = ancestor->Parent;
+      }
+      if (ancestor)
+      {
+        foundItems.push_back(item);
+      }
+    }
+  }
+  std::sort(foundItems.begin() + numberOfPreviouslyFoundItems, foundItems.end(),
+    [](vtkSubjectHierarchyItem* item1, vtkSubjectHierarchyItem* item2) { return item1->ID < item2->ID; });
+}
+
 //---------------------------------------------------------------------------
 void vtkSubjectHierarchyItem::FindChildrenByName(std::string name, std::vector<vtkIdType> &foundItemIDs, bool contains/*=false*/, bool recursive/*=true*/)
 {
@@ -1304,7 +1546,12 @@ void vtkSubjectHierarchyItem::SetUID(std::string uidName, std::string uidValue)
         << "' with value '" << it->second << "'. Replacing it with value '" << uidValue << "'" );
     }
   }
+  if (it != this->UIDs.end())
+  {
+    this->RemoveFromUIDCache(uidName, it->second);
+  }
   this->UIDs[uidName] = uidValue;
+  this->AddToUIDCache(uidName, uidValue);
   this->InvokeEvent(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemUIDAddedEvent, this);
   this->Modified();
 }
@@ -1320,6 +1567,7 @@ bool vtkSubjectHierarchyItem::RemoveUID(std::string uidName)
   }
 
   // Use the find function to prevent adding an empty UID to the map
+  this->RemoveFromUIDCache(it->first, it->second);
   this->UIDs.erase(it);
   this->Modified();
   return true;
@@ -1371,7 +1619,7 @@ void vtkSubjectHierarchyItem::SetAttribute(std::string attributeName, std::strin
     // Attribute to set is same as original value, nothing to do
     return;
   }
-  this->Attributes[attributeName] = attributeValue;
+  this->SetAttributeValue(attributeName, attributeValue);
   this->InvokeEvent(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemOwnerPluginSearchRequested, this);
   this->Modified();
 }
@@ -1387,6 +1635,7 @@ bool vtkSubjectHierarchyItem::RemoveAttribute(std::string attributeName)
   }
 
   // Use the find function to prevent adding an empty attribute to the map
+  this->RemoveFromAttributeCache(it->first, it->second);
   this->Attributes.erase(it);
   this->InvokeEvent(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemOwnerPluginSearchRequested, this);
   this->Modified();
@@ -2687,6 +2936,39 @@ vtkIdType vtkMRMLSubjectHierarchyNode::CreateItem(vtkIdType parentItemID, vtkMRM
   return itemID;
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLSubjectHierarchyNode::CreateItems(vtkIdType parentItemID, vtkCollection* dataNodes, vtkIdList* createdItemIDs/*=nullptr*/)
+{
+  if (!dataNodes)
+  {
+    vtkErrorMacro("CreateItems: Invalid data node collection given");
+    return;
+  }
+  if (createdItemIDs)
+  {
+    createdItemIDs->Reset();
+    createdItemIDs->Allocate(dataNodes->GetNumberOfItems());
+  }
+
+  vtkMRMLScene* scene = this->GetScene();
+  if (scene)
+  {
+    scene->StartState(vtkMRMLScene::BatchProcessState);
+  }
+  for (int index = 0; index < dataNodes->GetNumberOfItems(); ++index)
+  {
+    vtkIdType itemID = this->CreateItem(parentItemID, vtkMRMLNode::SafeDownCast(dataNodes->GetItemAsObject(index)));
+    if (createdItemIDs)
+    {
+      createdItemIDs->InsertNextId(itemID);
+    }
+  }
+  if (scene)
+  {
+    scene->EndState(vtkMRMLScene::BatchProcessState);
+  }
+}
+
 //---------------------------------------------------------------------------
 vtkIdType vtkMRMLSubjectHierarchyNode::CreateHierarchyItem(vtkIdType parentItemID, std::string name, std::string level, int positionUnderParent/*=-1*/)
 {
@@ -2915,6 +3197,30 @@ void vtkMRMLSubjectHierarchyNode::SetItemParent(vtkIdType itemID, vtkIdType pare
   item->Reparent(parentItem);
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLSubjectHierarchyNode::SetItemsParent(vtkIdList* itemIDs, vtkIdType parentItemID, bool enableCircularCheck/*=true*/)
+{
+  if (!itemIDs)
+  {
+    vtkErrorMacro("SetItemsParent: Invalid item ID list given");
+    return;
+  }
+
+  vtkMRMLScene* scene = this->GetScene();
+  if (scene)
+  {
+    scene->StartState(vtkMRMLScene::BatchProcessState);
+  }
+  for (vtkIdType index = 0; index < itemIDs->GetNumberOfIds(); ++index)
+  {
+    this->SetItemParent(itemIDs->GetId(index), parentItemID, enableCircularCheck);
+  }
+  if (scene)
+  {
+    scene->EndState(vtkMRMLScene::BatchProcessState);
+  }
+}
+
 //----------------------------------------------------------------------------
 vtkIdType vtkMRMLSubjectHierarchyNode::GetItemParent(vtkIdType itemID)
 {
@@ -3144,6 +3450,40 @@ void vtkMRMLSubjectHierarchyNode::GetItemsByName(std::string name, vtkIdList* fo
   }
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLSubjectHierarchyNode::GetItemsByAttribute(std::string attributeName, vtkIdList* foundItemIds)
+{
+  if (!foundItemIds)
+  {
+    vtkErrorMacro("GetItemsByAttribute: Invalid output ID list");
+    return;
+  }
+  foundItemIds->Reset();
+  std::vector<vtkSubjectHierarchyItem*> foundItems;
+  this->Internal->SceneItem->FindChildrenByAttribute(attributeName, std::string(), false, foundItems);
+  for (vtkSubjectHierarchyItem* item : foundItems)
+  {
+    foundItemIds->InsertNextId(item->ID);
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLSubjectHierarchyNode::GetItemsByAttributeValue(std::string attributeName, std::string attributeValue, vtkIdList* foundItemIds)
+{
+  if (!foundItemIds)
+  {
+    vtkErrorMacro("GetItemsByAttributeValue: Invalid output ID list");
+    return;
+  }
+  foundItemIds->Reset();
+  std::vector<vtkSubjectHierarchyItem*> foundItems;
+  this->Internal->SceneItem->FindChildrenByAttribute(attributeName, attributeValue, true, foundItems);
+  for (vtkSubjectHierarchyItem* item : foundItems)
+  {
+    foundItemIds->InsertNextId(item->ID);
+  }
+}
+
 //---------------------------------------------------------------------------
 vtkIdType vtkMRMLSubjectHierarchyNode::GetItemChildWithName(vtkIdType parentItemID, std::string name, bool recursive/*=false*/)
 {
@@ -3547,12 +3887,13 @@ std::vector<vtkIdType> vtkMRMLSubjectHierarchyNode::GetItemsReferencingItemByDIC
   std::vector<std::string> uidVector;
   this->DeserializeUIDList(uidsString, uidVector);
 
-  // Find subject hierarchy items containing first SOP instance UID in referenced UIDs attribute
-  std::vector<vtkIdType> allItemIDs;
-  this->Internal->SceneItem->GetAllChildren(allItemIDs);
-  for (std::vector<vtkIdType>::iterator itemIt=allItemIDs.begin(); itemIt!=allItemIDs.end(); ++itemIt)
+  // Find subject hierarchy items containing first SOP instance UID in referenced UIDs attribute.
+  // Only the items that have the attribute are checked.
+  std::vector<vtkSubjectHierarchyItem*> itemsWithReferences;
+  this->Internal->SceneItem->FindChildrenByAttribute(
+    vtkMRMLSubjectHierarchyConstants::GetDICOMReferencedInstanceUIDsAttributeName(), std::string(), false, itemsWithReferences);
+  for (vtkSubjectHierarchyItem* currentItem : itemsWithReferences)
   {
-    vtkSubjectHierarchyItem* currentItem =this->Internal->SceneItem->FindChildByID(*itemIt);
     std::string referencedUids = currentItem->GetAttribute(vtkMRMLSubjectHierarchyConstants::GetDICOMReferencedInstanceUIDsAttributeName());
     bool referencesUid = false;
     for (std::vector<std::string>::iterator uidIt=uidVector.begin(); uidIt!=uidVector.end(); ++uidIt)
@@ -3566,7 +3907,7 @@ std::vector<vtkIdType> vtkMRMLSubjectHierarchyNode::GetItemsReferencingItemByDIC
     if (referencesUid)
     {
       // UID is referenced, add referencing item to the list
-      referencingItemIDs.push_back(*itemIt);
+      referencingItemIDs.push_back(currentItem->ID);
     }
   }
 
@@ -210,6 +210,13 @@ public:
   /// \param dataNode Associated data MRML node
   /// \return ID of the item in the hierarchy that was assigned automatically when adding
   vtkIdType CreateItem(vtkIdType parentItemID, vtkMRMLNode* dataNode, const char* ownerPluginName=nullptr);
+  /// Create subject hierarchy items for multiple data nodes under the same parent.
+  /// Item events are emitted while the scene is in batch processing state, so that observers
+  /// (e.g. subject hierarchy views) can update once at the end instead of for every item.
+  /// \param dataNodes Associated data MRML nodes
+  /// \param createdItemIDs Optional list that receives the ID of the item of each data node
+  ///   (INVALID_ITEM_ID if the item could not be created)
+  void CreateItems(vtkIdType parentItemID, vtkCollection* dataNodes, vtkIdList* createdItemIDs=nullptr);
   /// Generic function to create hierarchy items of given level. Convenience functions are available for frequently used levels
   /// \sa CreateSubjectItem, \sa CreateStudyItem, \sa CreateFolderItem
   /// \param parentItemID Parent item under which the created item is inserted. If top-level then use \sa GetSceneItemID
@@ -254,6 +261,10 @@ public:
   /// Set the parent of a subject hierarchy item
   /// \param enableCircularCheck Option to do a safety check for circular parenthood in performance-critical cases. On by default.
   void SetItemParent(vtkIdType itemID, vtkIdType parentItemID, bool enableCircularCheck=true);
+  /// Set the parent of multiple subject hierarchy items.
+  /// Item events are emitted while the scene is in batch processing state, so that observers
+  /// (e.g. subject hierarchy views) can update once at the end instead of for every item.
+  void SetItemsParent(vtkIdList* itemIDs, vtkIdType parentItemID, bool enableCircularCheck=true);
   /// Get ID of the parent of a subject hierarchy item
   /// \return Parent item ID, INVALID_ITEM_ID if there is no parent
   vtkIdType GetItemParent(vtkIdType itemID);
@@ -313,6 +324,19 @@ public:
   /// \return Item ID of the first item found by name using exact match. Warning is logged if more than one found
   void GetItemsByName(std::string name, vtkIdList* foundItemIds, bool contains=false);
 
+  /// Get items in whole subject hierarchy that have a given attribute.
+  /// An attribute index is used, therefore the hierarchy is not traversed.
+  /// \param attributeName Name of the attribute to find
+  /// \param foundItemIds List of found items, in the order they were added to the hierarchy
+  void GetItemsByAttribute(std::string attributeName, vtkIdList* foundItemIds);
+
+  /// Get items in whole subject hierarchy that have a given attribute with a given value (exact match).
+  /// An attribute index is used, therefore the hierarchy is not traversed.
+  /// \param attributeName Name of the attribute to find
+  /// \param attributeValue Value of the attribute to find
+  /// \param foundItemIds List of found items, in the order they were added to the hierarchy
+  void GetItemsByAttributeValue(std::string attributeName, std::string attributeValue, vtkIdList* foundItemIds);
+
   /// Get child subject hierarchy item with specific name
   /// \param parent Parent subject hierarchy item to start from
   /// \param name Name to find
@@ -36,10 +36,23 @@
 #include <vtkStringArray.h>
 #include <vtkBitArray.h>
 #include <vtkNew.h>
+#include <vtkSMPTools.h>
+#include <vtksys/FStream.hxx>
 #include <vtksys/SystemTools.hxx>
 
 // STL includes
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <set>
+#include <type_traits>
 
 //------------------------------------------------------------------------------
 // Helper class to be able to read tables that have "\" characters in them.
@@ -72,6 +85,527 @@ protected:
 
 vtkStandardNewMacro(vtkNoEscapeDelimitedTextReader);
 
+//------------------------------------------------------------------------------
+namespace
+{
+
+/// Field values that are enclosed between string delimiters may contain field and record delimiters.
+/// There is no escape character, the same way as in vtkNoEscapeDelimitedTextReader.
+const char STRING_DELIMITER = '"';
+
+/// Table files are read in blocks of this size, so that the raw file content
+/// does not need to be kept in memory all at once.
+const std::size_t READ_BLOCK_SIZE = 64 * 1024 * 1024;
+
+/// Complete records of a block are split into chunks of at least this size,
+/// which are parsed in parallel.
+const std::size_t MINIMUM_CHUNK_SIZE = 1024 * 1024;
+
+/// Written rows are collected in a buffer of this size before they are written to the file.
+const std::size_t WRITE_BUFFER_SIZE = 4 * 1024 * 1024;
+
+//----------------------------------------------------------------------------
+bool IsRecordDelimiter(char c)
+{
+  return c == '\n' || c == '\r';
+}
+
+//----------------------------------------------------------------------------
+/// Returns true if values of the type are decoded directly from the file
+/// (other non-string types are converted from string columns).
+bool IsDecodedValueType(int valueType)
+{
+  switch (valueType)
+  {
+    case VTK_BIT:
+    case VTK_CHAR:
+    case VTK_SIGNED_CHAR:
+    case VTK_UNSIGNED_CHAR:
+    case VTK_SHORT:
+    case VTK_UNSIGNED_SHORT:
+    case VTK_INT:
+    case VTK_UNSIGNED_INT:
+    case VTK_LONG:
+    case VTK_UNSIGNED_LONG:
+    case VTK_LONG_LONG:
+    case VTK_UNSIGNED_LONG_LONG:
+    case VTK_ID_TYPE:
+    case VTK_FLOAT:
+    case VTK_DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Returns the end of the field that starts at pos. Characters between string delimiters
+/// belong to the field, even if they are field or record delimiters.
+const char* FindFieldEnd(const char* pos, const char* end, char fieldDelimiter, bool& hasStringDelimiter)
+{
+  bool withinString = false;
+  hasStringDelimiter = false;
+  for (; pos < end; ++pos)
+  {
+    const char c = *pos;
+    if (c == STRING_DELIMITER)
+    {
+      withinString = !withinString;
+      hasStringDelimiter = true;
+    }
+    else if (!withinString && (c == fieldDelimiter || IsRecordDelimiter(c)))
+    {
+      break;
+    }
+  }
+  return pos;
+}
+
+//----------------------------------------------------------------------------
+void RemoveStringDelimiters(const char* begin, const char* end, std::string& field)
+{
+  field.clear();
+  for (const char* pos = begin; pos < end; ++pos)
+  {
+    if (*pos != STRING_DELIMITER)
+    {
+      field.push_back(*pos);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Parses the first non-empty record of the data as column names.
+/// Returns the position after the record or std::string::npos if the record is not complete yet.
+std::size_t ParseHeader(const std::string& data, bool atEnd, char fieldDelimiter, std::vector<std::string>& columnNames)
+{
+  std::size_t recordBegin = 0;
+  // Skip UTF-8 byte order mark
+  if (data.compare(0, 3, "\xEF\xBB\xBF") == 0)
+  {
+    recordBegin = 3;
+  }
+  while (recordBegin < data.size() && IsRecordDelimiter(data[recordBegin]))
+  {
+    ++recordBegin;
+  }
+  bool withinString = false;
+  std::size_t recordEnd = recordBegin;
+  for (; recordEnd < data.size(); ++recordEnd)
+  {
+    if (data[recordEnd] == STRING_DELIMITER)
+    {
+      withinString = !withinString;
+    }
+    else if (!withinString && IsRecordDelimiter(data[recordEnd]))
+    {
+      break;
+    }
+  }
+  if (recordEnd == data.size() && !atEnd)
+  {
+    return std::string::npos;
+  }
+
+  columnNames.clear();
+  const char* pos = data.data() + recordBegin;
+  const char* end = data.data() + recordEnd;
+  std::string columnName;
+  while (pos < end)
+  {
+    bool hasStringDelimiter = false;
+    const char* fieldEnd = FindFieldEnd(pos, end, fieldDelimiter, hasStringDelimiter);
+    if (hasStringDelimiter)
+    {
+      RemoveStringDelimiters(pos, fieldEnd, columnName);
+    }
+    else
+    {
+      columnName.assign(pos, fieldEnd);
+    }
+    columnNames.push_back(columnName);
+    if (fieldEnd < end)
+    {
+      // skip field delimiter
+      ++fieldEnd;
+      if (fieldEnd == end)
+      {
+        // field delimiter at the end of the record, last column name is empty
+        columnNames.emplace_back();
+      }
+    }
+    pos = fieldEnd;
+  }
+  return recordEnd;
+}
+
+//----------------------------------------------------------------------------
+/// Describes how values of a column of the file are stored.
+struct ParsedColumn
+{
+  /// VTK_VOID: the column is not used, VTK_STRING: values are stored as strings,
+  /// other types: values are decoded into a data array of this type.
+  int ValueType = VTK_VOID;
+  /// Value of empty and invalid cells of numeric columns.
+  double NullValue = 0.0;
+};
+
+//----------------------------------------------------------------------------
+/// Part of a table file that contains complete records.
+struct TableChunk
+{
+  std::size_t Begin = 0;
+  std::size_t End = 0;
+  vtkIdType NumberOfRows = 0;
+  /// Decoded values of each column of the file (nullptr for string and unused columns).
+  /// Bit values are stored in unsigned char arrays.
+  std::vector<vtkSmartPointer<vtkDataArray>> DecodedColumns;
+  /// Values of each string column of the file (empty for other columns).
+  std::vector<std::vector<std::string>> StringColumns;
+  /// Number of values that do not have a corresponding column header.
+  vtkIdType NumberOfIgnoredValues = 0;
+
+  void Allocate(const std::vector<ParsedColumn>& columns)
+  {
+    this->DecodedColumns.resize(columns.size());
+    this->StringColumns.resize(columns.size());
+    for (std::size_t columnIndex = 0; columnIndex < columns.size(); ++columnIndex)
+    {
+      int valueType = columns[columnIndex].ValueType;
+      if (valueType == VTK_VOID)
+      {
+        continue;
+      }
+      if (valueType == VTK_STRING)
+      {
+        this->StringColumns[columnIndex].resize(this->NumberOfRows);
+        continue;
+      }
+      vtkSmartPointer<vtkDataArray> values = vtkSmartPointer<vtkDataArray>::Take(
+        vtkDataArray::CreateDataArray(valueType == VTK_BIT ? VTK_UNSIGNED_CHAR : valueType));
+      values->SetNumberOfValues(this->NumberOfRows);
+      this->DecodedColumns[columnIndex] = values;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+/// Splits data (starting at a record boundary) into chunks of complete records,
+/// each at least chunkSize long. Returns the position after the last complete record.
+/// If atEnd is true then the last record is complete even if it is not terminated by a record delimiter.
+std::size_t SplitIntoChunks(const std::string& data, std::size_t begin, bool atEnd, std::size_t chunkSize,
+  std::vector<TableChunk>& chunks)
+{
+  const char* values = data.data();
+  const std::size_t size = data.size();
+  bool withinString = false;
+  bool withinRecord = false;
+  std::size_t chunkBegin = begin;
+  std::size_t recordEnd = begin;
+  vtkIdType numberOfRows = 0;
+  for (std::size_t pos = begin; pos < size; ++pos)
+  {
+    const char c = values[pos];
+    if (c == STRING_DELIMITER)
+    {
+      withinString = !withinString;
+      withinRecord = true;
+    }
+    else if (!IsRecordDelimiter(c))
+    {
+      withinRecord = true;
+    }
+    else if (!withinString && withinRecord)
+    {
+      withinRecord = false;
+      ++numberOfRows;
+      recordEnd = pos + 1;
+      if (recordEnd - chunkBegin >= chunkSize)
+      {
+        TableChunk chunk;
+        chunk.Begin = chunkBegin;
+        chunk.End = recordEnd;
+        chunk.NumberOfRows = numberOfRows;
+        chunks.push_back(std::move(chunk));
+        chunkBegin = recordEnd;
+        numberOfRows = 0;
+      }
+    }
+  }
+  if (atEnd && withinRecord)
+  {
+    ++numberOfRows;
+    recordEnd = size;
+  }
+  if (numberOfRows > 0)
+  {
+    TableChunk chunk;
+    chunk.Begin = chunkBegin;
+    chunk.End = recordEnd;
+    chunk.NumberOfRows = numberOfRows;
+    chunks.push_back(std::move(chunk));
+  }
+  return recordEnd;
+}
+
+//----------------------------------------------------------------------------
+/// Converts a field to a number. Leading whitespace is allowed but the whole field must be used
+/// for the conversion, as in vtkVariant string to number conversion.
+/// Character types are parsed as integer numbers.
+template <typename T>
+bool ParseNumber(const char* begin, const char* end, T& value)
+{
+  if constexpr (std::is_floating_point<T>::value)
+  {
+    // Fields are always followed by a delimiter or a terminating null character,
+    // which stops the conversion.
+    char* numberEnd = nullptr;
+    errno = 0;
+    double parsedValue = std::strtod(begin, &numberEnd);
+    if (numberEnd != end || (errno == ERANGE && std::isinf(parsedValue)))
+    {
+      return false;
+    }
+    if (std::isfinite(parsedValue) && std::abs(parsedValue) > std::numeric_limits<T>::max())
+    {
+      // out of range
+      return false;
+    }
+    value = static_cast<T>(parsedValue);
+    return true;
+  }
+  else
+  {
+    while (begin < end && std::isspace(static_cast<unsigned char>(*begin)))
+    {
+      ++begin;
+    }
+    if (end - begin > 1 && begin[0] == '+' && begin[1] != '-')
+    {
+      ++begin;
+    }
+    using ParsedType = typename std::conditional<sizeof(T) == 1, int, T>::type;
+    ParsedType parsedValue = 0;
+    std::from_chars_result result = std::from_chars(begin, end, parsedValue);
+    if (result.ec != std::errc() || result.ptr != end)
+    {
+      return false;
+    }
+    value = static_cast<T>(parsedValue);
+    return true;
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Empty and invalid fields are set to the null value.
+template <typename T>
+void DecodeValue(const char* begin, const char* end, double nullValue, T& value)
+{
+  if (begin == end || !ParseNumber(begin, end, value))
+  {
+    value = static_cast<T>(nullValue);
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Parses chunks of table file data into the values of the chunks.
+/// Chunks are independent, therefore they can be parsed in parallel.
+class TableChunkParser
+{
+public:
+  TableChunkParser(const std::string& data, char fieldDelimiter, const std::vector<ParsedColumn>& columns,
+    std::vector<TableChunk>& chunks)
+    : Data(data)
+    , FieldDelimiter(fieldDelimiter)
+    , Columns(columns)
+    , Chunks(chunks)
+  {
+  }
+
+  void operator()(vtkIdType beginChunkIndex, vtkIdType endChunkIndex)
+  {
+    std::string field;
+    for (vtkIdType chunkIndex = beginChunkIndex; chunkIndex < endChunkIndex; ++chunkIndex)
+    {
+      this->ParseChunk(this->Chunks[chunkIndex], field);
+    }
+  }
+
+private:
+  void ParseChunk(TableChunk& chunk, std::string& field)
+  {
+    const int numberOfColumns = static_cast<int>(this->Columns.size());
+    std::vector<void*> decodedValues(numberOfColumns, nullptr);
+    for (int columnIndex = 0; columnIndex < numberOfColumns; ++columnIndex)
+    {
+      if (chunk.DecodedColumns[columnIndex])
+      {
+        decodedValues[columnIndex] = chunk.DecodedColumns[columnIndex]->GetVoidPointer(0);
+      }
+    }
+
+    const char* pos = this->Data.data() + chunk.Begin;
+    const char* end = this->Data.data() + chunk.End;
+    vtkIdType row = 0;
+    while (pos < end && row < chunk.NumberOfRows)
+    {
+      if (IsRecordDelimiter(*pos))
+      {
+        // skip empty records
+        ++pos;
+        continue;
+      }
+      int columnIndex = 0;
+      while (true)
+      {
+        bool hasStringDelimiter = false;
+        const char* fieldEnd = FindFieldEnd(pos, end, this->FieldDelimiter, hasStringDelimiter);
+        if (columnIndex < numberOfColumns)
+        {
+          if (hasStringDelimiter)
+          {
+            RemoveStringDelimiters(pos, fieldEnd, field);
+            this->SetValue(chunk, decodedValues[columnIndex], columnIndex, row, field.c_str(), field.c_str() + field.size());
+          }
+          else
+          {
+            this->SetValue(chunk, decodedValues[columnIndex], columnIndex, row, pos, fieldEnd);
+          }
+        }
+        else
+        {
+          ++chunk.NumberOfIgnoredValues;
+        }
+        ++columnIndex;
+        pos = fieldEnd;
+        if (pos < end && *pos == this->FieldDelimiter)
+        {
+          ++pos;
+          continue;
+        }
+        break;
+      }
+      // Missing values at the end of the record are empty
+      for (; columnIndex < numberOfColumns; ++columnIndex)
+      {
+        this->SetValue(chunk, decodedValues[columnIndex], columnIndex, row, pos, pos);
+      }
+      ++row;
+    }
+  }
+
+  void SetValue(TableChunk& chunk, void* decodedValues, int columnIndex, vtkIdType row, const char* begin, const char* end)
+  {
+    const ParsedColumn& column = this->Columns[columnIndex];
+    switch (column.ValueType)
+    {
+      case VTK_VOID:
+        break;
+      case VTK_STRING:
+        chunk.StringColumns[columnIndex][row].assign(begin, end);
+        break;
+      case VTK_BIT:
+      {
+        int value = 0;
+        DecodeValue(begin, end, column.NullValue, value);
+        static_cast<unsigned char*>(decodedValues)[row] = (value != 0 ? 1 : 0);
+        break;
+      }
+      vtkTemplateMacro(DecodeValue(begin, end, column.NullValue, static_cast<VTK_TT*>(decodedValues)[row]));
+    }
+  }
+
+  const std::string& Data;
+  const char FieldDelimiter;
+  const std::vector<ParsedColumn>& Columns;
+  std::vector<TableChunk>& Chunks;
+};
+
+//----------------------------------------------------------------------------
+/// Single-component column of a written table file.
+struct OutputField
+{
+  vtkAbstractArray* Array = nullptr;
+  vtkDataArray* DataArray = nullptr;
+  vtkStringArray* StringArray = nullptr;
+  int Component = 0;
+  /// Values of data arrays that have standard memory layout, nullptr otherwise.
+  void* Values = nullptr;
+};
+
+//----------------------------------------------------------------------------
+template <typename T>
+void AppendNumber(std::string& line, T value)
+{
+  char buffer[64];
+  if constexpr (std::is_floating_point<T>::value)
+  {
+    // Values are written with the fewest digits (digits10 or max_digits10)
+    // that are read back as exactly the same value
+    int length = std::snprintf(buffer, sizeof(buffer), "%.*g", std::numeric_limits<T>::digits10, static_cast<double>(value));
+    if (std::isfinite(value) && static_cast<T>(std::strtod(buffer, nullptr)) != value)
+    {
+      length = std::snprintf(buffer, sizeof(buffer), "%.*g", std::numeric_limits<T>::max_digits10, static_cast<double>(value));
+    }
+    line.append(buffer, length);
+  }
+  else
+  {
+    // Character types are written as numbers, the same way as they are read
+    using WrittenType = typename std::conditional<sizeof(T) == 1, int, T>::type;
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<WrittenType>(value));
+    line.append(buffer, result.ptr);
+  }
+}
+
+//----------------------------------------------------------------------------
+void AppendString(std::string& line, const std::string& value, bool useStringDelimiter)
+{
+  if (useStringDelimiter)
+  {
+    line += STRING_DELIMITER;
+    line += value;
+    line += STRING_DELIMITER;
+  }
+  else
+  {
+    line += value;
+  }
+}
+
+//----------------------------------------------------------------------------
+void AppendFieldValue(std::string& line, const OutputField& field, vtkIdType row, bool useStringDelimiter)
+{
+  vtkAbstractArray* array = field.Array;
+  if (row >= array->GetNumberOfTuples())
+  {
+    // column is shorter than the table
+    return;
+  }
+  vtkIdType valueIndex = row * array->GetNumberOfComponents() + field.Component;
+  if (field.Values)
+  {
+    switch (array->GetDataType())
+    {
+      vtkTemplateMacro(AppendNumber(line, static_cast<const VTK_TT*>(field.Values)[valueIndex]));
+    }
+  }
+  else if (field.StringArray)
+  {
+    AppendString(line, field.StringArray->GetValue(valueIndex), useStringDelimiter);
+  }
+  else if (field.DataArray)
+  {
+    AppendNumber(line, field.DataArray->GetComponent(row, field.Component));
+  }
+  else
+  {
+    AppendString(line, array->GetVariantValue(valueIndex).ToString(), useStringDelimiter);
+  }
+}
+
+} // end of anonymous namespace
+
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLTableStorageNode);
 
@@ -406,12 +940,15 @@ std::vector<vtkMRMLTableStorageNode::ColumnInfo> vtkMRMLTableStorageNode::GetCol
               "Not found column '" << columnInfo.ColumnName << "'"
               << " component '" << componentName << "', the column is filled with default values.");
           }
-          componentArrays.push_back(rawColumn);
-          int componentColumnIndex = rawTable->GetColumnIndex(rawColumn->GetName());
-          if (columnIndex < 0 || componentColumnIndex < columnIndex)
+          else
           {
-            columnIndex = componentColumnIndex;
+            int componentColumnIndex = rawTable->GetColumnIndex(rawColumn->GetName());
+            if (columnIndex < 0 || componentColumnIndex < columnIndex)
+            {
+              columnIndex = componentColumnIndex;
+            }
           }
+          componentArrays.push_back(rawColumn);
           columnInfo.ComponentNames.push_back(componentName);
           columnNamesAddedBySchema.insert(componentColumnName);
         }
@@ -588,26 +1125,32 @@ void vtkMRMLTableStorageNode::AddColumnToTable(vtkTable* table, vtkMRMLTableStor
     vtkIdType componentIndex = 0;
     for (vtkAbstractArray* componentArray : rawComponentArrays)
     {
-      vtkSmartPointer<vtkStringArray> rawComponentArray = vtkStringArray::SafeDownCast(componentArray);
-      if (rawComponentArray == nullptr)
+      // Single-component array for a potentially multi-component column
+      vtkSmartPointer<vtkDataArray> typedComponentArray = vtkDataArray::SafeDownCast(componentArray);
+      if (typedComponentArray == nullptr || typedComponentArray->GetDataType() != valueTypeId
+        || typedComponentArray->GetNumberOfComponents() != 1)
       {
-        vtkWarningToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadTable",
-          "Failed to read component for column '" << columnName << "'.");
-        // Add an empty default array for components that are not found
-        rawComponentArray = vtkSmartPointer<vtkStringArray>::New();
-        rawComponentArray->SetName(columnName.c_str());
-        rawComponentArray->SetNumberOfComponents(1);
-        rawComponentArray->SetNumberOfTuples(numberOfTuples);
-      }
+        // Values are not decoded yet, convert them from strings
+        vtkSmartPointer<vtkStringArray> rawComponentArray = vtkStringArray::SafeDownCast(componentArray);
+        if (rawComponentArray == nullptr)
+        {
+          vtkWarningToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadTable",
+            "Failed to read component for column '" << columnName << "'.");
+          // Add an empty default array for components that are not found
+          rawComponentArray = vtkSmartPointer<vtkStringArray>::New();
+          rawComponentArray->SetName(columnName.c_str());
+          rawComponentArray->SetNumberOfComponents(1);
+          rawComponentArray->SetNumberOfTuples(numberOfTuples);
+        }
 
-      // Single-component array for a potentially multi-component column
-      vtkSmartPointer<vtkDataArray> typedComponentArray = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(valueTypeId));
-      typedComponentArray->SetName(rawComponentArray->GetName());
-      typedComponentArray->SetNumberOfComponents(1);
-      typedComponentArray->SetNumberOfTuples(numberOfTuples);
+        typedComponentArray = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(valueTypeId));
+        typedComponentArray->SetName(rawComponentArray->GetName());
+        typedComponentArray->SetNumberOfComponents(1);
+        typedComponentArray->SetNumberOfTuples(numberOfTuples);
 
-      /// Fill the component array with the correct values of the correct type
-      this->FillDataFromStringArray(rawComponentArray, typedComponentArray, nullValueString);
+        /// Fill the component array with the correct values of the correct type
+        this->FillDataFromStringArray(rawComponentArray, typedComponentArray, nullValueString);
+      }
 
       if (rawComponentArrays.size() > 1)
       {
@@ -707,36 +1250,206 @@ bool vtkMRMLTableStorageNode::ReadSchema(std::string filename, vtkMRMLTableNode*
 //----------------------------------------------------------------------------
 bool vtkMRMLTableStorageNode::ReadTable(std::string filename, vtkMRMLTableNode* tableNode)
 {
-  vtkNew<vtkNoEscapeDelimitedTextReader> reader;
-  reader->SetFileName(filename.c_str());
-  reader->SetHaveHeaders(true);
-  reader->SetFieldDelimiterCharacters(this->GetFieldDelimiterCharacters(filename).c_str());
-  // Make sure string delimiter characters are removed (somebody may have written a tsv with string delimiters)
-  reader->SetUseStringDelimiter(true);
-  // File contents is preserved better if we don't try to detect numeric columns
-  reader->DetectNumericColumnsOff();
-
-  // Read table
-  vtkTable* rawTable = nullptr;
-  try
+  std::string fieldDelimiterCharacters = this->GetFieldDelimiterCharacters(filename);
+  if (fieldDelimiterCharacters.empty())
   {
-    reader->Update();
-    rawTable = reader->GetOutput();
+    return false;
   }
-  catch (...)
+  const char fieldDelimiter = fieldDelimiterCharacters[0];
+
+  vtksys::ifstream inputStream(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!inputStream)
   {
     vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadTable",
-      "Failed to read table file: '" << filename << "'.");
+      "Failed to open table file: '" << filename << "'.");
     return false;
   }
 
-  /// Get the info for the columns defined in the schema (Column name, component arrays, component names, scalar type)
-  /// If the schema does not exist, then the raw table is used to generate the table info.
-  std::vector<vtkMRMLTableStorageNode::ColumnInfo> columnDetails = this->GetColumnInfo(tableNode, rawTable);
+  // The file is read in blocks. Complete records of each block are split into chunks that are parsed
+  // in parallel. Values of typed columns are decoded directly into data arrays, only string columns
+  // (and columns of types that cannot be decoded directly) are stored as strings.
+  std::string data;
+  bool headerRead = false;
+  bool atEnd = false;
+  std::vector<std::string> columnNames;
+  vtkNew<vtkTable> headerTable;
+  std::vector<vtkMRMLTableStorageNode::ColumnInfo> columnDetails;
+  std::vector<ParsedColumn> parsedColumns;
+  std::vector<TableChunk> chunks;
+  // Blocks are not larger than the file, so that small tables do not allocate a full block.
+  // One more byte than the remaining file size is requested to detect the end of the file.
+  const std::size_t fileSize = static_cast<std::size_t>(vtksys::SystemTools::FileLength(filename));
+  std::size_t readSize = 0;
+  while (!atEnd)
+  {
+    std::size_t blockSize = READ_BLOCK_SIZE;
+    if (readSize <= fileSize && fileSize - readSize < READ_BLOCK_SIZE)
+    {
+      blockSize = fileSize - readSize + 1;
+    }
+    std::size_t dataSize = data.size();
+    data.resize(dataSize + blockSize);
+    inputStream.read(&data[dataSize], blockSize);
+    data.resize(dataSize + static_cast<std::size_t>(inputStream.gcount()));
+    readSize += static_cast<std::size_t>(inputStream.gcount());
+    if (inputStream.bad())
+    {
+      vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadTable",
+        "Failed to read table file: '" << filename << "'.");
+      return false;
+    }
+    atEnd = !inputStream;
+
+    std::size_t recordsBegin = 0;
+    if (!headerRead)
+    {
+      recordsBegin = ParseHeader(data, atEnd, fieldDelimiter, columnNames);
+      if (recordsBegin == std::string::npos)
+      {
+        // header is not complete yet
+        continue;
+      }
+      headerRead = true;
+
+      // Get the info for the columns defined in the schema (Column name, component arrays, component names, scalar type)
+      // from empty placeholder columns, to know how the values of each column must be stored.
+      std::map<vtkAbstractArray*, int> fileColumnIndices;
+      for (const std::string& columnName : columnNames)
+      {
+        vtkNew<vtkStringArray> placeholderColumn;
+        placeholderColumn->SetName(columnName.c_str());
+        fileColumnIndices[placeholderColumn] = headerTable->GetNumberOfColumns();
+        headerTable->AddColumn(placeholderColumn);
+      }
+      columnDetails = this->GetColumnInfo(tableNode, headerTable);
+      parsedColumns.resize(columnNames.size());
+      for (const vtkMRMLTableStorageNode::ColumnInfo& columnInfo : columnDetails)
+      {
+        ParsedColumn parsedColumn;
+        parsedColumn.ValueType = IsDecodedValueType(columnInfo.ScalarType) ? columnInfo.ScalarType : VTK_STRING;
+        if (!columnInfo.NullValueString.empty())
+        {
+          parsedColumn.NullValue = vtkVariant(columnInfo.NullValueString).ToDouble();
+        }
+        for (vtkAbstractArray* rawComponentArray : columnInfo.RawComponentArrays)
+        {
+          auto fileColumnIndexIt = fileColumnIndices.find(rawComponentArray);
+          if (fileColumnIndexIt != fileColumnIndices.end())
+          {
+            parsedColumns[fileColumnIndexIt->second] = parsedColumn;
+          }
+        }
+      }
+    }
+
+    std::vector<TableChunk> blockChunks;
+    std::size_t chunkSize = std::max(MINIMUM_CHUNK_SIZE,
+      (data.size() - recordsBegin) / (4 * std::max(1, vtkSMPTools::GetEstimatedNumberOfThreads())));
+    std::size_t recordsEnd = SplitIntoChunks(data, recordsBegin, atEnd, chunkSize, blockChunks);
+    for (TableChunk& chunk : blockChunks)
+    {
+      chunk.Allocate(parsedColumns);
+    }
+    TableChunkParser parser(data, fieldDelimiter, parsedColumns, blockChunks);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(blockChunks.size()), 1, parser);
+    std::move(blockChunks.begin(), blockChunks.end(), std::back_inserter(chunks));
+
+    // Keep the incomplete last record for the next block
+    data.erase(0, recordsEnd);
+  }
+
+  vtkIdType numberOfRows = 0;
+  vtkIdType numberOfIgnoredValues = 0;
+  for (const TableChunk& chunk : chunks)
+  {
+    numberOfRows += chunk.NumberOfRows;
+    numberOfIgnoredValues += chunk.NumberOfIgnoredValues;
+  }
+  if (numberOfIgnoredValues > 0)
+  {
+    vtkWarningToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadTable",
+      "Table file '" << filename << "' contains " << numberOfIgnoredValues
+      << " values that do not have a column header. These values are ignored.");
+  }
+
+  // Merge the values of all chunks into the columns
+  std::map<vtkAbstractArray*, vtkSmartPointer<vtkAbstractArray>> parsedArrays;
+  for (int columnIndex = 0; columnIndex < static_cast<int>(parsedColumns.size()); ++columnIndex)
+  {
+    int valueType = parsedColumns[columnIndex].ValueType;
+    vtkSmartPointer<vtkAbstractArray> parsedArray;
+    if (valueType == VTK_VOID)
+    {
+      continue;
+    }
+    else if (valueType == VTK_STRING)
+    {
+      vtkNew<vtkStringArray> stringArray;
+      stringArray->SetNumberOfValues(numberOfRows);
+      vtkIdType row = 0;
+      for (TableChunk& chunk : chunks)
+      {
+        for (std::string& value : chunk.StringColumns[columnIndex])
+        {
+          stringArray->GetPointer(row++)->swap(value);
+        }
+        std::vector<std::string>().swap(chunk.StringColumns[columnIndex]);
+      }
+      parsedArray = stringArray;
+    }
+    else if (valueType == VTK_BIT)
+    {
+      vtkNew<vtkBitArray> bitArray;
+      bitArray->SetNumberOfValues(numberOfRows);
+      vtkIdType row = 0;
+      for (TableChunk& chunk : chunks)
+      {
+        const unsigned char* values = static_cast<unsigned char*>(chunk.DecodedColumns[columnIndex]->GetVoidPointer(0));
+        for (vtkIdType chunkRow = 0; chunkRow < chunk.NumberOfRows; ++chunkRow)
+        {
+          bitArray->SetValue(row++, values[chunkRow]);
+        }
+        chunk.DecodedColumns[columnIndex] = nullptr;
+      }
+      parsedArray = bitArray;
+    }
+    else if (chunks.size() == 1)
+    {
+      parsedArray = chunks[0].DecodedColumns[columnIndex];
+      chunks[0].DecodedColumns[columnIndex] = nullptr;
+    }
+    else
+    {
+      vtkSmartPointer<vtkDataArray> dataArray = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(valueType));
+      dataArray->SetNumberOfValues(numberOfRows);
+      unsigned char* values = static_cast<unsigned char*>(dataArray->GetVoidPointer(0));
+      for (TableChunk& chunk : chunks)
+      {
+        vtkDataArray* chunkValues = chunk.DecodedColumns[columnIndex];
+        std::size_t chunkDataSize = static_cast<std::size_t>(chunkValues->GetNumberOfValues()) * chunkValues->GetDataTypeSize();
+        memcpy(values, chunkValues->GetVoidPointer(0), chunkDataSize);
+        values += chunkDataSize;
+        chunk.DecodedColumns[columnIndex] = nullptr;
+      }
+      parsedArray = dataArray;
+    }
+    parsedArray->SetName(columnNames[columnIndex].c_str());
+    parsedArrays[headerTable->GetColumn(columnIndex)] = parsedArray;
+  }
+  chunks.clear();
 
   vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
   for (vtkMRMLTableStorageNode::ColumnInfo columnInfo : columnDetails)
   {
+    // Replace placeholder columns by the parsed columns
+    for (vtkAbstractArray*& rawComponentArray : columnInfo.RawComponentArrays)
+    {
+      auto parsedArrayIt = parsedArrays.find(rawComponentArray);
+      if (parsedArrayIt != parsedArrays.end())
+      {
+        rawComponentArray = parsedArrayIt->second;
+      }
+    }
     this->AddColumnToTable(table, columnInfo);
   }
 
@@ -747,76 +1460,103 @@ bool vtkMRMLTableStorageNode::ReadTable(std::string filename, vtkMRMLTableNode*
 //----------------------------------------------------------------------------
 bool vtkMRMLTableStorageNode::WriteTable(std::string filename, vtkMRMLTableNode* tableNode)
 {
-  vtkTable* originalTable = tableNode->GetTable();
-
-  vtkNew<vtkTable> newTable;
-  for (int i = 0; i < originalTable->GetNumberOfColumns(); ++i)
+  vtkTable* table = tableNode->GetTable();
+  if (table == nullptr)
   {
-    vtkAbstractArray* oldColumn = originalTable->GetColumn(i);
-    vtkDataArray* oldDataArray = vtkDataArray::SafeDownCast(oldColumn);
-    int numberOfComponents = oldColumn->GetNumberOfComponents();
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::WriteTable",
+      "Failed to write file: '" << filename << "'. Table is missing.");
+    return false;
+  }
+
+  std::string delimiter = this->GetFieldDelimiterCharacters(filename);
+
+  // Writing each string value in double-quotes is not very nice, but if the delimiter character
+  // is the comma then we have to use this mode, as commas occur in string values quite often.
+  bool useStringDelimiter = (delimiter == ",");
 
-    // Component names are only valid for vtkDataArray
-    // If we cannot cast to a vtkDataArray, then add to table as is.
-    // Otherwise, separate to individual components
-    if (!oldDataArray)
+  // Component names are only valid for vtkDataArray, therefore data arrays are separated
+  // to individual component columns. Other arrays are written the same way as by vtkDelimitedTextWriter.
+  std::vector<OutputField> fields;
+  std::string buffer;
+  for (int i = 0; i < table->GetNumberOfColumns(); ++i)
+  {
+    vtkAbstractArray* column = table->GetColumn(i);
+    if (column == nullptr)
+    {
+      continue;
+    }
+    std::string columnName;
+    if (column->GetName())
     {
-      newTable->AddColumn(oldColumn);
+      columnName = column->GetName();
     }
-    else
+    OutputField field;
+    field.Array = column;
+    field.DataArray = vtkDataArray::SafeDownCast(column);
+    field.StringArray = vtkStringArray::SafeDownCast(column);
+    if (field.DataArray && field.DataArray->GetDataType() != VTK_BIT && IsDecodedValueType(field.DataArray->GetDataType())
+      && field.DataArray->HasStandardMemoryLayout())
     {
-      std::string columnName;
-      if (oldColumn->GetName())
+      field.Values = field.DataArray->GetVoidPointer(0);
+    }
+    std::vector<std::string> componentNames;
+    if (field.DataArray)
+    {
+      componentNames = tableNode->GetComponentNames(columnName);
+    }
+    int numberOfComponents = column->GetNumberOfComponents();
+    for (int componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
+    {
+      std::string fieldName = columnName;
+      if (field.DataArray && static_cast<int>(componentNames.size()) > componentIndex)
       {
-        columnName = oldColumn->GetName();
+        fieldName += COMPONENT_SEPERATOR + componentNames[componentIndex];
       }
-
-      std::vector<std::string> componentNames = tableNode->GetComponentNames(columnName);
-      for (int componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
+      else if (!field.DataArray && numberOfComponents > 1)
       {
-        std::string newColumnName = columnName;
-        if (static_cast<int>(componentNames.size()) > componentIndex)
-        {
-          std::stringstream newColumnNameSS;
-          newColumnNameSS << columnName << COMPONENT_SEPERATOR << componentNames[componentIndex];
-          newColumnName = newColumnNameSS.str();
-        }
-        vtkSmartPointer<vtkDataArray> newColumn = vtkSmartPointer<vtkDataArray>::Take(oldDataArray->NewInstance());
-        newColumn->SetNumberOfComponents(1);
-        newColumn->SetNumberOfTuples(oldColumn->GetNumberOfTuples());
-        newColumn->SetName(newColumnName.c_str());
-        newColumn->CopyComponent(0, oldDataArray, componentIndex);
-        newTable->AddColumn(newColumn);
+        fieldName += ":" + std::to_string(componentIndex);
+      }
+      if (!fields.empty())
+      {
+        buffer += delimiter;
       }
+      AppendString(buffer, fieldName, useStringDelimiter);
+      field.Component = componentIndex;
+      fields.push_back(field);
     }
   }
+  buffer += '\n';
 
-  vtkNew<vtkDelimitedTextWriter> writer;
-  writer->SetFileName(filename.c_str());
-  writer->SetInputData(newTable);
-
-  std::string delimiter = this->GetFieldDelimiterCharacters(filename);
-  writer->SetFieldDelimiter(delimiter.c_str());
-
-  // SetUseStringDelimiter(true) causes writing each value in double-quotes, which is not very nice,
-  // but if the delimiter character is the comma then we have to use this mode, as commas occur in
-  // string values quite often.
-  writer->SetUseStringDelimiter(delimiter==",");
-
-  vtkNew<vtkErrorSink> errorWarningObserver;
-  errorWarningObserver->SetObservedObject(writer);
-  try
-  {
-    writer->Write();
-  }
-  catch (...)
+  vtksys::ofstream outputStream(filename.c_str(), std::ios::out);
+  if (!outputStream)
   {
     vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::WriteTable",
-      "Failed to write file: '" << filename << "'.");
+      "Failed to open file for writing: '" << filename << "'.");
     return false;
   }
-  errorWarningObserver->DisplayMessages();
-  if (errorWarningObserver->HasErrors())
+
+  // Rows are formatted directly from the table columns and written to the file in large pieces
+  vtkIdType numberOfRows = table->GetNumberOfRows();
+  for (vtkIdType row = 0; row < numberOfRows; ++row)
+  {
+    for (std::size_t fieldIndex = 0; fieldIndex < fields.size(); ++fieldIndex)
+    {
+      if (fieldIndex > 0)
+      {
+        buffer += delimiter;
+      }
+      AppendFieldValue(buffer, fields[fieldIndex], row, useStringDelimiter);
+    }
+    buffer += '\n';
+    if (buffer.size() >= WRITE_BUFFER_SIZE)
+    {
+      outputStream.write(buffer.data(), buffer.size());
+      buffer.clear();
+    }
+  }
+  outputStream.write(buffer.data(), buffer.size());
+  outputStream.close();
+  if (outputStream.fail())
   {
     vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::WriteTable",
       "Failed to write file: '" << filename << "'.");
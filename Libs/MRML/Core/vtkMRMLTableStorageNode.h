@@ -118,12 +118,19 @@ protected:
   void FillDataFromStringArray(vtkStringArray* stringComponentArray, vtkDataArray* dataArray, std::string nullValueString="");
 
   /// Adds the column specified by the given columnInfo to the table.
-  /// Handles both single and multi-component columns
+  /// Handles both single and multi-component columns.
+  /// Raw component arrays that are already data arrays of the column type are used as is,
+  /// string arrays are converted to the column type.
   void AddColumnToTable(vtkTable* table, ColumnInfo columnInfo);
 
   bool ReadSchema(std::string filename, vtkMRMLTableNode* tableNode);
+
+  /// Read the table file in blocks and parse each block in parallel, in chunks of complete lines.
+  /// Values of columns that have a numeric type in the schema are decoded directly into data arrays,
+  /// all other values are stored in string arrays.
   bool ReadTable(std::string filename, vtkMRMLTableNode* tableNode);
 
+  /// Write the table file directly from the columns of the table, without creating temporary tables.
   bool WriteTable(std::string filename, vtkMRMLTableNode* tableNode);
   bool WriteSchema(std::string filename, vtkMRMLTableNode* tableNode);
 
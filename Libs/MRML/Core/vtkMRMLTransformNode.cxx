@@ -42,6 +42,7 @@ Version:   $Revision: 1.14 $
 #include <vtksys/SystemTools.hxx>
 
 // STD includes
+#include <algorithm>
 #include <sstream>
 #include <stack>
 
@@ -880,6 +881,21 @@ bool vtkMRMLTransformNode::GetModifiedSinceRead()
   return false;
 }
 
+//---------------------------------------------------------------------------
+vtkMTimeType vtkMRMLTransformNode::GetContentMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetContentMTime();
+  if (this->TransformToParent)
+  {
+    mTime = std::max(mTime, this->TransformToParent->GetMTime());
+  }
+  if (this->TransformFromParent)
+  {
+    mTime = std::max(mTime, this->TransformFromParent->GetMTime());
+  }
+  return mTime;
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLTransformNode::GetMatrixTransformToParent(vtkMatrix4x4* matrix)
 {
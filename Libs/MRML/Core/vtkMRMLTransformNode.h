@@ -284,6 +284,9 @@ public:
 
   bool GetModifiedSinceRead() override;
 
+  /// Reimplemented to take into account the modified time of the transforms.
+  vtkMTimeType GetContentMTime() override;
+
   ///
   /// Retrieves the transform as the specified transform class.
   /// If modifiableOnly is set to true then nullptr will be returned for transforms that cannot be modified (e.g., because it is computed from its inverse).
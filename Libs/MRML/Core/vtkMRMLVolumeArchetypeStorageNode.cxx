@@ -36,6 +36,8 @@ Version:   $Revision: 1.6 $
 
 // VTK includes
 #include <vtkAddonMathUtilities.h>
+#include <vtkAlgorithm.h>
+#include <vtkAlgorithmOutput.h>
 #include <vtkCallbackCommand.h>
 #include <vtkDataArray.h>
 #include <vtkErrorCode.h>
@@ -50,7 +52,9 @@ Version:   $Revision: 1.6 $
 
 // STD includes
 #include <algorithm>
+#include <atomic>
 #include <iterator>
+#include <sstream>
 
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLVolumeArchetypeStorageNode);
@@ -62,11 +66,15 @@ vtkMRMLVolumeArchetypeStorageNode::vtkMRMLVolumeArchetypeStorageNode()
   this->SingleFile  = 0;
   this->UseOrientationFromFile = 1;
   this->ForceRightHandedIJKCoordinateSystem = true;
+  this->DICOMHeaderCacheDirectory = nullptr;
   this->DefaultWriteFileExtension = "nrrd";
 }
 
 //----------------------------------------------------------------------------
-vtkMRMLVolumeArchetypeStorageNode::~vtkMRMLVolumeArchetypeStorageNode() = default;
+vtkMRMLVolumeArchetypeStorageNode::~vtkMRMLVolumeArchetypeStorageNode()
+{
+  this->SetDICOMHeaderCacheDirectory(nullptr);
+}
 
 //----------------------------------------------------------------------------
 void vtkMRMLVolumeArchetypeStorageNode::WriteXML(ostream& of, int nIndent)
@@ -146,6 +154,7 @@ void vtkMRMLVolumeArchetypeStorageNode::Copy(vtkMRMLNode *anode)
   this->SetSingleFile(node->SingleFile);
   this->SetUseOrientationFromFile(node->UseOrientationFromFile);
   this->SetForceRightHandedIJKCoordinateSystem(node->ForceRightHandedIJKCoordinateSystem);
+  this->SetDICOMHeaderCacheDirectory(node->DICOMHeaderCacheDirectory);
 
   this->EndModify(disabledModify);
 }
@@ -158,6 +167,8 @@ void vtkMRMLVolumeArchetypeStorageNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "SingleFile:   " << this->SingleFile << "\n";
   os << indent << "UseOrientationFromFile:   " << this->UseOrientationFromFile << "\n";
   os << indent << "ForceRightHandedIJKCoordinateSystem:   " << (this->ForceRightHandedIJKCoordinateSystem ? "true" : "false") << "\n";
+  os << indent << "DICOMHeaderCacheDirectory:   "
+     << (this->DICOMHeaderCacheDirectory ? this->DICOMHeaderCacheDirectory : "(none)") << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -201,6 +212,32 @@ bool vtkMRMLVolumeArchetypeStorageNode::CanWriteFromReferenceNode(vtkMRMLNode *r
   return refNode->IsA("vtkMRMLScalarVolumeNode");
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeArchetypeStorageNode::CanWriteDataInBackground(vtkMRMLNode* refNode)
+{
+  vtkMRMLVolumeNode* volNode = vtkMRMLVolumeNode::SafeDownCast(refNode);
+  if (!volNode || !this->CanWriteFromReferenceNode(refNode)
+    || volNode->GetVoxelVectorType() == vtkMRMLVolumeNode::VoxelVectorTypeSpatial)
+  {
+    return false;
+  }
+  if (this->WriteFileFormat)
+  {
+    // Look up the writer class on the main thread, as it initializes the list of supported file formats
+    if (!this->GetScene() || !this->GetScene()->GetDataIOManager()
+      || !this->GetScene()->GetDataIOManager()->GetFileFormatHelper()->GetClassNameFromFormatString(this->WriteFileFormat))
+    {
+      return false;
+    }
+  }
+  // Execute the image data pipeline now, the background thread only reads the output image
+  if (volNode->GetImageDataConnection() && volNode->GetImageDataConnection()->GetProducer())
+  {
+    volNode->GetImageDataConnection()->GetProducer()->Update();
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 vtkITKArchetypeImageSeriesReader*
 vtkMRMLVolumeArchetypeStorageNode::InstantiateVectorVolumeReader(const std::string& fullName)
@@ -369,6 +406,7 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
   }
 
   reader->AddObserver( vtkCommand::ProgressEvent,  this->MRMLCallbackCommand);
+  reader->SetDICOMHeaderCacheDirectory(this->DICOMHeaderCacheDirectory);
 
   if (volNode->GetImageData())
   {
@@ -858,6 +896,13 @@ std::string vtkMRMLVolumeArchetypeStorageNode::UpdateFileList(vtkMRMLNode *refNo
   std::string tempSubDir = std::string("TempWrite") + vtksys::SystemTools::GetFilenameWithoutExtension(oldName);
   // trim whitespace from the right because a folder name cannot end with space (there can be a space before the ".")
   tempSubDir.erase(tempSubDir.find_last_not_of(" ") + 1);
+  // Volumes may be written concurrently into the same directory and the file name prefix
+  // is not unique (for example "CT 1.25mm.nrrd" and "CT 1.5mm.nrrd"), therefore make
+  // the temp dir name unique by adding the node ID and a write counter.
+  static std::atomic<unsigned int> tempWriteCounter(0);
+  std::stringstream tempSubDirSuffix;
+  tempSubDirSuffix << "_" << (refNode->GetID() ? refNode->GetID() : "") << "_" << tempWriteCounter++;
+  tempSubDir += tempSubDirSuffix.str();
   pathComponents.push_back(tempSubDir);
   std::string tempDir = vtksys::SystemTools::JoinPath(pathComponents);
   vtkDebugMacro("UpdateFileList: deleting and then re-creating temp dir "<< tempDir.c_str());
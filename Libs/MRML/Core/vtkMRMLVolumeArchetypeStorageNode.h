@@ -86,6 +86,19 @@ public:
   vtkBooleanMacro(ForceRightHandedIJKCoordinateSystem, bool);
   //@}
 
+  ///
+  /// Directory where DICOM header information is cached when reading a DICOM series.
+  /// Reopening a series only reads the headers of files that changed since they were cached.
+  /// The cache is disabled if no directory is set (default).
+  /// It is an application setting, therefore it is not saved in the scene.
+  /// \sa vtkITKArchetypeImageSeriesReader::SetDICOMHeaderCacheDirectory
+  vtkSetStringMacro(DICOMHeaderCacheDirectory);
+  vtkGetStringMacro(DICOMHeaderCacheDirectory);
+
+  /// Volumes can be written in a background thread, except volumes that contain spatial vectors
+  /// (voxel values are temporarily converted to LPS during writing).
+  bool CanWriteDataInBackground(vtkMRMLNode* refNode) override;
+
   /// Convert voxel vector type enum from vtkITK type to MRML type
   static int ConvertVoxelVectorTypeVTKITKToMRML(int vtkitkType);
   /// Convert voxel vector type enum from MRML type to vtkITK type
@@ -131,6 +144,7 @@ protected:
   int SingleFile;
   int UseOrientationFromFile;
   bool ForceRightHandedIJKCoordinateSystem;
+  char* DICOMHeaderCacheDirectory;
 
 };
 
@@ -14,6 +14,7 @@ Version:   $Revision: 1.14 $
 
 // MRML includes
 #include "vtkEventBroker.h"
+#include "vtkImageHistogramCache.h"
 #include "vtkMRMLLinearTransformNode.h"
 #include "vtkMRMLScalarVolumeDisplayNode.h"
 #include "vtkMRMLScene.h"
@@ -73,6 +74,7 @@ vtkMRMLVolumeNode::vtkMRMLVolumeNode()
 
   this->ImageDataConnection = nullptr;
   this->DataEventForwarder = nullptr;
+  this->ImageHistogramCache = nullptr;
 
   this->VoxelVectorType = vtkMRMLVolumeNode::VoxelVectorTypeUndefined;
 
@@ -87,6 +89,10 @@ vtkMRMLVolumeNode::~vtkMRMLVolumeNode()
   {
     this->DataEventForwarder->Delete();
   }
+  if (this->ImageHistogramCache)
+  {
+    this->ImageHistogramCache->Delete();
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -990,6 +996,17 @@ bool vtkMRMLVolumeNode::GetModifiedSinceRead()
     (this->GetImageData() && this->GetImageData()->GetMTime() > this->GetStoredTime());
 }
 
+//---------------------------------------------------------------------------
+vtkMTimeType vtkMRMLVolumeNode::GetContentMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetContentMTime();
+  if (this->GetImageData())
+  {
+    mTime = std::max(mTime, this->GetImageData()->GetMTime());
+  }
+  return mTime;
+}
+
 //---------------------------------------------------------------------------
 bool vtkMRMLVolumeNode::CanApplyNonLinearTransforms()const
 {
@@ -1166,6 +1183,28 @@ void vtkMRMLVolumeNode::ShiftImageDataExtentToZeroStart()
   imageData->SetExtent(extent);
 }
 
+//---------------------------------------------------------------------------
+vtkImageHistogramCache* vtkMRMLVolumeNode::GetImageHistogramCache()
+{
+  if (!this->ImageHistogramCache)
+  {
+    this->ImageHistogramCache = vtkImageHistogramCache::New();
+  }
+  return this->ImageHistogramCache;
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLVolumeNode::GetImageDataPercentileRange(double lowerPercentile, double upperPercentile,
+  double range[2], int sampleStride/*=1*/)
+{
+  vtkImageData* imageData = this->GetImageData();
+  if (!imageData)
+  {
+    return false;
+  }
+  return this->GetImageHistogramCache()->GetPercentileRange(imageData, lowerPercentile, upperPercentile, range, sampleStride);
+}
+
 //---------------------------------------------------------------------------
 double vtkMRMLVolumeNode::GetImageBackgroundScalarComponentAsDouble(int component)
 {
@@ -23,6 +23,7 @@ class vtkMRMLVolumeDisplayNode;
 class vtkAlgorithmOutput;
 class vtkEventForwarderCommand;
 class vtkImageData;
+class vtkImageHistogramCache;
 class vtkMatrix4x4;
 
 // ITK includes
@@ -227,12 +228,31 @@ public:
 
   bool GetModifiedSinceRead() override;
 
+  /// Reimplemented to take into account the modified time of the image data.
+  vtkMTimeType GetContentMTime() override;
+
   ///
   /// Get background voxel value of the image. It can be used for assigning
   /// intensity value to "empty" voxels when the image is transformed.
   /// It is computed as median value of the 8 corner voxels.
   virtual double GetImageBackgroundScalarComponentAsDouble(int component);
 
+  /// Get the intensity range of the image data that contains all voxels except the
+  /// lowest and highest percentiles (specified as percentage, between 0 and 100).
+  /// The histogram is computed only once for each modification of the image data
+  /// and shared by all display nodes and modules that use this method.
+  /// If sampleStride is larger than 1 then only every sampleStride-th voxel along
+  /// each axis is used, which gives a quick estimate for large images.
+  /// Returns false if the volume has no image data.
+  /// \sa GetImageHistogramCache()
+  bool GetImageDataPercentileRange(double lowerPercentile, double upperPercentile,
+    double range[2], int sampleStride = 1);
+
+  /// Cache of the histograms of the image data of this volume.
+  /// Histograms of recently used image data are kept, which speeds up
+  /// browsing frames of volume sequences.
+  vtkImageHistogramCache* GetImageHistogramCache();
+
   /// Creates the most appropriate display node class for storing a sequence of these nodes.
   void CreateDefaultSequenceDisplayNodes() override;
 
@@ -310,6 +330,7 @@ protected:
 
   vtkAlgorithmOutput* ImageDataConnection;
   vtkEventForwarderCommand* DataEventForwarder;
+  vtkImageHistogramCache* ImageHistogramCache;
 
   int VoxelVectorType;
   itk::MetaDataDictionary Dictionary;
@@ -0,0 +1,434 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLSequenceNode.h"
+#include "vtkMRMLVolumeNode.h"
+#include "vtkMRMLVolumeSequenceLazyLoader.h"
+
+// vtkTeem includes
+#include <vtkTeemNRRDReader.h>
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+#include <vtksys/FStream.hxx>
+
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <list>
+
+namespace
+{
+// Size of uncompressed data read from the file at once
+const size_t RAW_CHUNK_SIZE = 16 * 1024 * 1024;
+
+//----------------------------------------------------------------------------
+/// Copy bytes of the requested frames from a part of the interleaved image data.
+/// Handles scalars that are split between chunks.
+void GatherFrames(const unsigned char* chunk, size_t chunkStart, size_t chunkSize,
+  size_t numberOfVoxels, size_t numberOfFrames, size_t scalarSize,
+  const std::vector<int>& frameIndices, const std::vector<unsigned char*>& frameBuffers)
+{
+  size_t voxelStride = numberOfFrames * scalarSize;
+  size_t chunkEnd = chunkStart + chunkSize;
+  size_t firstVoxel = chunkStart / voxelStride;
+  size_t lastVoxel = std::min(numberOfVoxels, (chunkEnd + voxelStride - 1) / voxelStride);
+  for (size_t voxel = firstVoxel; voxel < lastVoxel; ++voxel)
+  {
+    for (size_t i = 0; i < frameIndices.size(); ++i)
+    {
+      size_t scalarStart = voxel * voxelStride + static_cast<size_t>(frameIndices[i]) * scalarSize;
+      size_t begin = std::max(scalarStart, chunkStart);
+      size_t end = std::min(scalarStart + scalarSize, chunkEnd);
+      if (begin < end)
+      {
+        memcpy(frameBuffers[i] + voxel * scalarSize + (begin - scalarStart), chunk + (begin - chunkStart), end - begin);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+bool IsFrameLoaded(vtkMRMLVolumeNode* frameVolume)
+{
+  vtkImageData* imageData = frameVolume->GetImageData();
+  return imageData && imageData->GetPointData() && imageData->GetPointData()->GetScalars();
+}
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+class vtkMRMLVolumeSequenceLazyLoader::vtkInternal
+{
+public:
+  struct LoadedFrame
+  {
+    vtkWeakPointer<vtkMRMLVolumeNode> FrameVolume;
+    vtkWeakPointer<vtkImageData> ImageData;
+    vtkMTimeType ImageDataMTime;
+  };
+
+  void RemoveFrame(vtkMRMLVolumeNode* frameVolume)
+  {
+    for (std::list<LoadedFrame>::iterator it = this->LoadedFrames.begin(); it != this->LoadedFrames.end(); ++it)
+    {
+      if (it->FrameVolume == frameVolume)
+      {
+        this->LoadedFrames.erase(it);
+        return;
+      }
+    }
+  }
+
+  vtkTeemNRRDReader::DataLayout Layout;
+  /// Most recently used frame is at the front
+  std::list<LoadedFrame> LoadedFrames;
+};
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkMRMLVolumeSequenceLazyLoader);
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeSequenceLazyLoader::vtkMRMLVolumeSequenceLazyLoader()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeSequenceLazyLoader::~vtkMRMLVolumeSequenceLazyLoader()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceLazyLoader::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << this->FileName << "\n";
+  os << indent << "NumberOfFrames: " << this->NumberOfFrames << "\n";
+  os << indent << "MaximumNumberOfLoadedFrames: " << this->MaximumNumberOfLoadedFrames << "\n";
+  os << indent << "NumberOfReadAheadFrames: " << this->NumberOfReadAheadFrames << "\n";
+  os << indent << "NumberOfLoadedFrames: " << this->Internal->LoadedFrames.size() << "\n";
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceLazyLoader::SetFile(const char* fileName, int numberOfFrames, int scalarType, const int extent[6])
+{
+  this->FileName.clear();
+  this->Internal->LoadedFrames.clear();
+  vtkTeemNRRDReader::DataLayout layout;
+  if (!fileName || numberOfFrames < 1 || !vtkTeemNRRDReader::GetDataLayout(fileName, layout))
+  {
+    return false;
+  }
+  if (!layout.NativeByteOrder || (!layout.Raw && layout.Blocks.empty()))
+  {
+    return false;
+  }
+  // Frames must be interleaved: list of frames is the fastest axis, followed by the 3 spatial axes
+  if (layout.RangeAxis != 0 || layout.AxisSizes.size() != 4
+    || layout.AxisSizes[0] != static_cast<size_t>(numberOfFrames)
+    || layout.AxisSizes[1] != static_cast<size_t>(extent[1] - extent[0] + 1)
+    || layout.AxisSizes[2] != static_cast<size_t>(extent[3] - extent[2] + 1)
+    || layout.AxisSizes[3] != static_cast<size_t>(extent[5] - extent[4] + 1))
+  {
+    return false;
+  }
+  size_t numberOfVoxels = layout.AxisSizes[1] * layout.AxisSizes[2] * layout.AxisSizes[3];
+  size_t scalarSize = static_cast<size_t>(vtkDataArray::GetDataTypeSize(scalarType));
+  if (scalarSize == 0 || layout.DataSize != numberOfVoxels * static_cast<size_t>(numberOfFrames) * scalarSize)
+  {
+    return false;
+  }
+  this->FileName = fileName;
+  this->NumberOfFrames = numberOfFrames;
+  this->ScalarType = scalarType;
+  std::copy(extent, extent + 6, this->Extent);
+  this->Internal->Layout = layout;
+  this->LastItemNumber = -1;
+  this->ReadAheadDirection = 1;
+  this->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceLazyLoader::InitializeFrameVolume(vtkMRMLVolumeNode* frameVolume, int frameIndex)
+{
+  if (!frameVolume)
+  {
+    return;
+  }
+  vtkNew<vtkImageData> placeholder;
+  placeholder->SetExtent(this->Extent);
+  frameVolume->SetAndObserveImageData(placeholder);
+  frameVolume->SetAttribute(vtkMRMLVolumeSequenceLazyLoader::GetFrameIndexAttributeName(), std::to_string(frameIndex).c_str());
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceLazyLoader::GetNumberOfLoadedFrames()
+{
+  return static_cast<int>(this->Internal->LoadedFrames.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceLazyLoader::GetFrameIndex(vtkMRMLNode* node)
+{
+  const char* frameIndexStr = (node ? node->GetAttribute(vtkMRMLVolumeSequenceLazyLoader::GetFrameIndexAttributeName()) : nullptr);
+  if (!frameIndexStr)
+  {
+    return -1;
+  }
+  return atoi(frameIndexStr);
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceLazyLoader::LoadDataNode(vtkMRMLSequenceNode* sequenceNode, int itemNumber, vtkMRMLNode* dataNode)
+{
+  vtkMRMLVolumeNode* frameVolume = vtkMRMLVolumeNode::SafeDownCast(dataNode);
+  if (!sequenceNode || !frameVolume || vtkMRMLVolumeSequenceLazyLoader::GetFrameIndex(frameVolume) < 0)
+  {
+    // not managed by this loader
+    return true;
+  }
+
+  if (this->LastItemNumber >= 0 && itemNumber != this->LastItemNumber)
+  {
+    this->ReadAheadDirection = (itemNumber > this->LastItemNumber ? 1 : -1);
+  }
+  this->LastItemNumber = itemNumber;
+
+  if (IsFrameLoaded(frameVolume))
+  {
+    // Move to the front of the list of recently used frames
+    for (std::list<vtkInternal::LoadedFrame>::iterator it = this->Internal->LoadedFrames.begin();
+      it != this->Internal->LoadedFrames.end(); ++it)
+    {
+      if (it->FrameVolume == frameVolume)
+      {
+        this->Internal->LoadedFrames.splice(this->Internal->LoadedFrames.begin(), this->Internal->LoadedFrames, it);
+        break;
+      }
+    }
+    return true;
+  }
+
+  std::vector<vtkMRMLVolumeNode*> frameVolumes;
+  frameVolumes.push_back(frameVolume);
+  int numberOfItems = sequenceNode->GetNumberOfDataNodes();
+  for (int readAheadIndex = 1; readAheadIndex <= this->NumberOfReadAheadFrames; ++readAheadIndex)
+  {
+    int readAheadItemNumber = itemNumber + readAheadIndex * this->ReadAheadDirection;
+    if (readAheadItemNumber < 0 || readAheadItemNumber >= numberOfItems)
+    {
+      break;
+    }
+    vtkMRMLVolumeNode* readAheadVolume = vtkMRMLVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(readAheadItemNumber));
+    if (readAheadVolume && vtkMRMLVolumeSequenceLazyLoader::GetFrameIndex(readAheadVolume) >= 0 && !IsFrameLoaded(readAheadVolume))
+    {
+      frameVolumes.push_back(readAheadVolume);
+    }
+  }
+
+  if (!this->ReadFrames(frameVolumes))
+  {
+    return false;
+  }
+  this->UnloadFrames();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceLazyLoader::LoadAllDataNodes(vtkMRMLSequenceNode* sequenceNode)
+{
+  if (!sequenceNode)
+  {
+    return false;
+  }
+  std::vector<vtkMRMLVolumeNode*> managedFrameVolumes;
+  std::vector<vtkMRMLVolumeNode*> frameVolumesToLoad;
+  for (int itemNumber = 0; itemNumber < sequenceNode->GetNumberOfDataNodes(); ++itemNumber)
+  {
+    vtkMRMLVolumeNode* frameVolume = vtkMRMLVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(itemNumber));
+    if (!frameVolume || vtkMRMLVolumeSequenceLazyLoader::GetFrameIndex(frameVolume) < 0)
+    {
+      continue;
+    }
+    managedFrameVolumes.push_back(frameVolume);
+    if (!IsFrameLoaded(frameVolume))
+    {
+      frameVolumesToLoad.push_back(frameVolume);
+    }
+  }
+  if (!frameVolumesToLoad.empty() && !this->ReadFrames(frameVolumesToLoad))
+  {
+    return false;
+  }
+  // Loaded frames are not managed by the loader anymore
+  for (vtkMRMLVolumeNode* frameVolume : managedFrameVolumes)
+  {
+    this->Internal->RemoveFrame(frameVolume);
+    frameVolume->RemoveAttribute(vtkMRMLVolumeSequenceLazyLoader::GetFrameIndexAttributeName());
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceLazyLoader::ReadFrames(const std::vector<vtkMRMLVolumeNode*>& frameVolumes)
+{
+  if (this->FileName.empty())
+  {
+    vtkErrorMacro("ReadFrames: file name is not set");
+    return false;
+  }
+
+  // Allocate frame images, voxels are read directly into them
+  std::vector<int> frameIndices;
+  std::vector<unsigned char*> frameBuffers;
+  std::vector<vtkSmartPointer<vtkImageData> > frameImages;
+  for (vtkMRMLVolumeNode* frameVolume : frameVolumes)
+  {
+    int frameIndex = vtkMRMLVolumeSequenceLazyLoader::GetFrameIndex(frameVolume);
+    if (frameIndex < 0 || frameIndex >= this->NumberOfFrames)
+    {
+      vtkErrorMacro("ReadFrames: invalid frame index " << frameIndex);
+      return false;
+    }
+    vtkSmartPointer<vtkImageData> frameImage = vtkSmartPointer<vtkImageData>::New();
+    frameImage->SetExtent(this->Extent);
+    frameImage->AllocateScalars(this->ScalarType, 1);
+    frameIndices.push_back(frameIndex);
+    frameBuffers.push_back(static_cast<unsigned char*>(frameImage->GetScalarPointer()));
+    frameImages.push_back(frameImage);
+  }
+
+  const vtkTeemNRRDReader::DataLayout& layout = this->Internal->Layout;
+  size_t scalarSize = static_cast<size_t>(vtkDataArray::GetDataTypeSize(this->ScalarType));
+  size_t numberOfFrames = static_cast<size_t>(this->NumberOfFrames);
+  size_t numberOfVoxels = layout.DataSize / (numberOfFrames * scalarSize);
+
+  vtksys::ifstream inputStream(this->FileName.c_str(), std::ios::in | std::ios::binary);
+  if (!inputStream.good())
+  {
+    vtkErrorMacro("ReadFrames: failed to open file " << this->FileName);
+    return false;
+  }
+
+  if (layout.Raw)
+  {
+    std::vector<unsigned char> chunk(std::min(RAW_CHUNK_SIZE, layout.DataSize));
+    inputStream.seekg(static_cast<std::streamoff>(layout.DataOffset), std::ios::beg);
+    for (size_t chunkStart = 0; chunkStart < layout.DataSize; chunkStart += chunk.size())
+    {
+      size_t chunkSize = std::min(chunk.size(), layout.DataSize - chunkStart);
+      inputStream.read(reinterpret_cast<char*>(chunk.data()), chunkSize);
+      if (static_cast<size_t>(inputStream.gcount()) != chunkSize)
+      {
+        vtkErrorMacro("ReadFrames: failed to read data from file " << this->FileName);
+        return false;
+      }
+      GatherFrames(chunk.data(), chunkStart, chunkSize, numberOfVoxels, numberOfFrames, scalarSize, frameIndices, frameBuffers);
+    }
+  }
+  else
+  {
+    // Decompress a batch of gzip members in parallel, each thread copies frame voxels from its own block
+    size_t batchSize = static_cast<size_t>(std::max(1, 2 * vtkSMPTools::GetEstimatedNumberOfThreads()));
+    std::vector<unsigned char> compressedData;
+    for (size_t firstBlock = 0; firstBlock < layout.Blocks.size(); firstBlock += batchSize)
+    {
+      size_t lastBlock = std::min(firstBlock + batchSize, layout.Blocks.size());
+      size_t batchOffset = layout.Blocks[firstBlock].MemberOffset;
+      size_t batchEnd = layout.Blocks[lastBlock - 1].MemberOffset + layout.Blocks[lastBlock - 1].MemberSize;
+      compressedData.resize(batchEnd - batchOffset);
+      inputStream.seekg(static_cast<std::streamoff>(batchOffset), std::ios::beg);
+      inputStream.read(reinterpret_cast<char*>(compressedData.data()), compressedData.size());
+      if (static_cast<size_t>(inputStream.gcount()) != compressedData.size())
+      {
+        vtkErrorMacro("ReadFrames: failed to read data from file " << this->FileName);
+        return false;
+      }
+      std::atomic<bool> success(true);
+      vtkSMPTools::For(static_cast<vtkIdType>(firstBlock), static_cast<vtkIdType>(lastBlock), 1,
+        [&](vtkIdType begin, vtkIdType end)
+      {
+        std::vector<unsigned char> blockData;
+        for (vtkIdType blockIndex = begin; blockIndex < end && success; ++blockIndex)
+        {
+          const vtkTeemNRRDReader::CompressedBlockInfo& block = layout.Blocks[static_cast<size_t>(blockIndex)];
+          blockData.resize(block.DataSize);
+          if (!vtkTeemNRRDReader::DecompressBlock(compressedData.data() + block.MemberOffset - batchOffset, block, blockData.data()))
+          {
+            success = false;
+            break;
+          }
+          GatherFrames(blockData.data(), block.DataOffset, block.DataSize, numberOfVoxels, numberOfFrames, scalarSize,
+            frameIndices, frameBuffers);
+        }
+      });
+      if (!success)
+      {
+        vtkErrorMacro("ReadFrames: failed to decompress data from file " << this->FileName);
+        return false;
+      }
+    }
+  }
+
+  // Set the images in the frame volumes. The farthest read-ahead frame is the least recently used.
+  for (size_t i = frameVolumes.size(); i-- > 0;)
+  {
+    frameVolumes[i]->SetAndObserveImageData(frameImages[i]);
+    vtkInternal::LoadedFrame loadedFrame = { frameVolumes[i], frameImages[i].GetPointer(), frameImages[i]->GetMTime() };
+    this->Internal->RemoveFrame(frameVolumes[i]);
+    this->Internal->LoadedFrames.push_front(loadedFrame);
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceLazyLoader::UnloadFrames()
+{
+  size_t maximumNumberOfLoadedFrames = static_cast<size_t>(
+    std::max(this->MaximumNumberOfLoadedFrames, this->NumberOfReadAheadFrames + 1));
+  while (this->Internal->LoadedFrames.size() > maximumNumberOfLoadedFrames)
+  {
+    vtkInternal::LoadedFrame loadedFrame = this->Internal->LoadedFrames.back();
+    this->Internal->LoadedFrames.pop_back();
+    vtkMRMLVolumeNode* frameVolume = loadedFrame.FrameVolume;
+    if (!frameVolume)
+    {
+      // frame volume has been deleted
+      continue;
+    }
+    vtkImageData* imageData = frameVolume->GetImageData();
+    if (!imageData || imageData != loadedFrame.ImageData || imageData->GetMTime() != loadedFrame.ImageDataMTime)
+    {
+      // Image data has been modified, the frame cannot be reloaded from the file anymore
+      frameVolume->RemoveAttribute(vtkMRMLVolumeSequenceLazyLoader::GetFrameIndexAttributeName());
+      continue;
+    }
+    // Replace the image instead of releasing its memory, as proxy nodes may still use the image data
+    vtkNew<vtkImageData> placeholder;
+    placeholder->SetExtent(this->Extent);
+    frameVolume->SetAndObserveImageData(placeholder);
+  }
+}
@@ -0,0 +1,111 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkMRMLVolumeSequenceLazyLoader_h
+#define __vtkMRMLVolumeSequenceLazyLoader_h
+
+// MRML includes
+#include "vtkMRMLSequenceDataNodeLoader.h"
+
+// STD includes
+#include <string>
+#include <vector>
+
+class vtkMRMLVolumeNode;
+
+/// \brief Reads frames of a volume sequence NRRD file when they are accessed.
+///
+/// Frames are expected to be interleaved in the file ("kinds: list domain domain domain"),
+/// stored uncompressed or compressed by vtkTeemNRRDWriter with parallel compression enabled.
+/// Frames that are not loaded have image data with valid extent but without scalars.
+///
+/// The requested frame and the next few frames in the direction of the previous access
+/// (read-ahead) are read in a single pass over the file. Least recently used frames
+/// are unloaded when more than MaximumNumberOfLoadedFrames frames are in memory.
+/// Frames that are modified after loading are not unloaded anymore.
+/// \sa vtkMRMLVolumeSequenceStorageNode::SetLazyLoading
+class VTK_MRML_EXPORT vtkMRMLVolumeSequenceLazyLoader : public vtkMRMLSequenceDataNodeLoader
+{
+public:
+  static vtkMRMLVolumeSequenceLazyLoader* New();
+  vtkTypeMacro(vtkMRMLVolumeSequenceLazyLoader, vtkMRMLSequenceDataNodeLoader);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Set file and frame geometry. Returns false if frames of the file cannot be read
+  /// on demand (for example, the file was compressed by teem or bytes would need to be swapped).
+  bool SetFile(const char* fileName, int numberOfFrames, int scalarType, const int extent[6]);
+  vtkGetMacro(FileName, std::string);
+  vtkGetMacro(NumberOfFrames, int);
+  /// Scalar type and extent of each frame. Frames have a single scalar component.
+  vtkGetMacro(ScalarType, int);
+  vtkGetVector6Macro(Extent, int);
+
+  /// Returns frame index of a node managed by this loader, -1 otherwise.
+  static int GetFrameIndex(vtkMRMLNode* node);
+
+  /// Set placeholder image data and frame index attribute in a frame volume node.
+  /// The voxels of the frame are read when the node is accessed in the sequence.
+  void InitializeFrameVolume(vtkMRMLVolumeNode* frameVolume, int frameIndex);
+
+  /// Name of the data node attribute that stores the index of the frame in the file.
+  /// The attribute is removed when a frame is not managed by the loader anymore.
+  static const char* GetFrameIndexAttributeName() { return "VolumeSequenceLazyLoader.FrameIndex"; };
+
+  /// Maximum number of frames kept in memory. At least the requested frame and the read-ahead
+  /// frames are kept in memory. Default is 16.
+  vtkSetClampMacro(MaximumNumberOfLoadedFrames, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfLoadedFrames, int);
+
+  /// Number of frames loaded after the requested frame, in the direction of the previous access.
+  /// Default is 4.
+  vtkSetClampMacro(NumberOfReadAheadFrames, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfReadAheadFrames, int);
+
+  /// Number of frames that are currently loaded and may be unloaded.
+  int GetNumberOfLoadedFrames();
+
+  bool LoadDataNode(vtkMRMLSequenceNode* sequenceNode, int itemNumber, vtkMRMLNode* dataNode) override;
+  bool LoadAllDataNodes(vtkMRMLSequenceNode* sequenceNode) override;
+
+protected:
+  vtkMRMLVolumeSequenceLazyLoader();
+  ~vtkMRMLVolumeSequenceLazyLoader() override;
+
+  /// Read voxels of the specified frames into the frame volumes in a single pass over the file.
+  bool ReadFrames(const std::vector<vtkMRMLVolumeNode*>& frameVolumes);
+
+  /// Unload least recently used frames that are not modified.
+  void UnloadFrames();
+
+  std::string FileName;
+  int NumberOfFrames{0};
+  int ScalarType{VTK_VOID};
+  int Extent[6]{0, -1, 0, -1, 0, -1};
+
+  int MaximumNumberOfLoadedFrames{16};
+  int NumberOfReadAheadFrames{4};
+
+  int LastItemNumber{-1};
+  int ReadAheadDirection{1};
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkMRMLVolumeSequenceLazyLoader(const vtkMRMLVolumeSequenceLazyLoader&) = delete;
+  void operator=(const vtkMRMLVolumeSequenceLazyLoader&) = delete;
+};
+
+#endif
@@ -18,6 +18,7 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include "vtkMRMLScalarVolumeNode.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLSequenceNode.h"
+#include "vtkMRMLVolumeSequenceLazyLoader.h"
 
 #include "vtkTeemNRRDReader.h"
 #include "vtkTeemNRRDWriter.h"
@@ -28,6 +29,7 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #endif
 #include "vtkImageExtractComponents.h"
 #include "vtkNew.h"
+#include "vtkPointData.h"
 #include "vtkStringArray.h"
 #include "vtksys/SystemTools.hxx"
 
@@ -40,6 +42,44 @@ vtkMRMLVolumeSequenceStorageNode::vtkMRMLVolumeSequenceStorageNode() = default;
 //----------------------------------------------------------------------------
 vtkMRMLVolumeSequenceStorageNode::~vtkMRMLVolumeSequenceStorageNode() = default;
 
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::PrintSelf(ostream& os, vtkIndent indent)
+{
+  Superclass::PrintSelf(os,indent);
+  vtkMRMLPrintBeginMacro(os, indent);
+  vtkMRMLPrintBooleanMacro(LazyLoading);
+  vtkMRMLPrintEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::ReadXMLAttributes(const char** atts)
+{
+  MRMLNodeModifyBlocker blocker(this);
+  Superclass::ReadXMLAttributes(atts);
+  vtkMRMLReadXMLBeginMacro(atts);
+  vtkMRMLReadXMLBooleanMacro(lazyLoading, LazyLoading);
+  vtkMRMLReadXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::WriteXML(ostream& of, int nIndent)
+{
+  Superclass::WriteXML(of, nIndent);
+  vtkMRMLWriteXMLBeginMacro(of);
+  vtkMRMLWriteXMLBooleanMacro(lazyLoading, LazyLoading);
+  vtkMRMLWriteXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::Copy(vtkMRMLNode *anode)
+{
+  MRMLNodeModifyBlocker blocker(this);
+  Superclass::Copy(anode);
+  vtkMRMLCopyBeginMacro(anode);
+  vtkMRMLCopyBooleanMacro(LazyLoading);
+  vtkMRMLCopyEndMacro();
+}
+
 //----------------------------------------------------------------------------
 bool vtkMRMLVolumeSequenceStorageNode::CanReadInReferenceNode(vtkMRMLNode *refNode)
 {
@@ -158,6 +198,32 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
   const char* sequenceAxisUnit = reader->GetAxisUnit(frameAxis);
   volSequenceNode->SetIndexUnit(sequenceAxisUnit ? sequenceAxisUnit : "");
 
+  if (dataNodeClassName.empty())
+  {
+    dataNodeClassName = "vtkMRMLScalarVolumeNode";
+  }
+
+  // Only create placeholder frames, voxels are read when frames are accessed
+  volSequenceNode->SetDataNodeLoader(nullptr);
+  if (this->LazyLoading && frameAxis == 0)
+  {
+    vtkNew<vtkMRMLVolumeSequenceLazyLoader> loader;
+    if (loader->SetFile(fullName.c_str(), reader->GetNumberOfComponents(), reader->GetDataScalarType(), reader->GetDataExtent()))
+    {
+      for (int frameIndex = 0; frameIndex < loader->GetNumberOfFrames(); ++frameIndex)
+      {
+        vtkSmartPointer<vtkMRMLVolumeNode> frameVolume = this->CreateFrameVolume(dataNodeClassName);
+        loader->InitializeFrameVolume(frameVolume, frameIndex);
+        frameVolume->SetRASToIJKMatrix(reader->GetRasToIjkMatrix());
+        this->AddFrameVolume(volSequenceNode, frameVolume, frameIndex, indexValues);
+      }
+      volSequenceNode->SetDataNodeLoader(loader);
+      vtkDebugMacro(<< " vtkMRMLVolumeSequenceStorageNode::ReadDataInternal: sequence frames will be read on demand. ");
+      return 1;
+    }
+    vtkDebugMacro("vtkMRMLVolumeSequenceStorageNode::ReadDataInternal: frames cannot be read on demand, read all frames");
+  }
+
   // Read and copy the data to sequence of volume nodes
 #ifdef NRRD_CHUNK_IO_AVAILABLE
   int numberOfFrames = reader->GetNumberOfImages();
@@ -219,56 +285,96 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
     // Slicer expects normalized image position and spacing
     frameVoxels->SetOrigin(0, 0, 0);
     frameVoxels->SetSpacing(1, 1, 1);
-    vtkSmartPointer<vtkMRMLVolumeNode> frameVolume;
-    if (dataNodeClassName.empty())
-    {
-      dataNodeClassName = "vtkMRMLScalarVolumeNode";
-    }
-    if (this->GetScene())
-    {
-      frameVolume = vtkSmartPointer<vtkMRMLVolumeNode>::Take(vtkMRMLVolumeNode::SafeDownCast(this->GetScene()->CreateNodeByClass(dataNodeClassName.c_str())));
-    }
-    else
-    {
-      vtkWarningMacro("vtkMRMLVolumeSequenceStorageNode::ReadDataInternal: Scene is not set.");
-    }
-    if (frameVolume == nullptr)
-    {
-      if (dataNodeClassName != "vtkMRMLScalarVolumeNode")
-      {
-        vtkErrorMacro("Requested DataNodeClass is " << dataNodeClassName << " but volume sequence will be read into vtkMRMLScalarVolumeNode.");
-      }
-      frameVolume = vtkSmartPointer<vtkMRMLScalarVolumeNode>::New();
-    }
+    vtkSmartPointer<vtkMRMLVolumeNode> frameVolume = this->CreateFrameVolume(dataNodeClassName);
 #ifdef NRRD_CHUNK_IO_AVAILABLE
     frameVolume->SetAndObserveImageData(frameVoxels);
 #else
     frameVolume->SetAndObserveImageData(frameVoxels.GetPointer());
 #endif
     frameVolume->SetRASToIJKMatrix(reader->GetRasToIjkMatrix());
+    this->AddFrameVolume(volSequenceNode, frameVolume, frameIndex, indexValues);
+  }
 
-    std::ostringstream indexStr;
-    if (static_cast<int>(indexValues.size()) > frameIndex)
-    {
-      indexStr << indexValues[frameIndex] << std::ends;
-    }
-    else
+  vtkDebugMacro(<< " vtkMRMLVolumeSequenceStorageNode::ReadDataInternal: sequence successfully read. ");
+
+  // success
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkMRMLVolumeNode> vtkMRMLVolumeSequenceStorageNode::CreateFrameVolume(const std::string& dataNodeClassName)
+{
+  vtkSmartPointer<vtkMRMLVolumeNode> frameVolume;
+  if (this->GetScene())
+  {
+    frameVolume = vtkSmartPointer<vtkMRMLVolumeNode>::Take(vtkMRMLVolumeNode::SafeDownCast(this->GetScene()->CreateNodeByClass(dataNodeClassName.c_str())));
+  }
+  else
+  {
+    vtkWarningMacro("vtkMRMLVolumeSequenceStorageNode::ReadDataInternal: Scene is not set.");
+  }
+  if (frameVolume == nullptr)
+  {
+    if (dataNodeClassName != "vtkMRMLScalarVolumeNode")
     {
-      indexStr << frameIndex << std::ends;
+      vtkErrorMacro("Requested DataNodeClass is " << dataNodeClassName << " but volume sequence will be read into vtkMRMLScalarVolumeNode.");
     }
+    frameVolume = vtkSmartPointer<vtkMRMLScalarVolumeNode>::New();
+  }
+  return frameVolume;
+}
 
-    std::ostringstream nameStr;
-    nameStr << refNode->GetName() << "_" << std::setw(4) << std::setfill('0') << frameIndex << std::ends;
-    frameVolume->SetName( nameStr.str().c_str() );
-    volSequenceNode->SetDataNodeAtValue(frameVolume.GetPointer(), indexStr.str().c_str() );
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::AddFrameVolume(vtkMRMLSequenceNode* volSequenceNode, vtkMRMLVolumeNode* frameVolume,
+  int frameIndex, const std::vector<std::string>& indexValues)
+{
+  std::ostringstream indexStr;
+  if (static_cast<int>(indexValues.size()) > frameIndex)
+  {
+    indexStr << indexValues[frameIndex] << std::ends;
+  }
+  else
+  {
+    indexStr << frameIndex << std::ends;
   }
 
-  vtkDebugMacro(<< " vtkMRMLVolumeSequenceStorageNode::ReadDataInternal: sequence successfully read. ");
+  std::ostringstream nameStr;
+  nameStr << volSequenceNode->GetName() << "_" << std::setw(4) << std::setfill('0') << frameIndex << std::ends;
+  frameVolume->SetName( nameStr.str().c_str() );
+  volSequenceNode->SetDataNodeAtValue(frameVolume, indexStr.str().c_str() );
+}
 
-  // success
-  return 1;
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Get extent, scalar type, and number of components of a frame volume.
+/// Frames that are not loaded yet are described by the lazy loader, so that they are not read from file.
+/// Returns false if the frame volume has no image data.
+bool GetFrameImageProperties(vtkMRMLVolumeNode* frameVolume, vtkMRMLVolumeSequenceLazyLoader* lazyLoader,
+  int extent[6], int& scalarType, int& numberOfComponents)
+{
+  vtkImageData* imageData = frameVolume->GetImageData();
+  if (!imageData)
+  {
+    return false;
+  }
+  if (lazyLoader && !imageData->GetPointData()->GetScalars()
+    && vtkMRMLVolumeSequenceLazyLoader::GetFrameIndex(frameVolume) >= 0)
+  {
+    lazyLoader->GetExtent(extent);
+    scalarType = lazyLoader->GetScalarType();
+    numberOfComponents = 1;
+    return true;
+  }
+  imageData->GetExtent(extent);
+  scalarType = imageData->GetScalarType();
+  numberOfComponents = imageData->GetNumberOfScalarComponents();
+  return true;
 }
 
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 bool vtkMRMLVolumeSequenceStorageNode::CanWriteFromReferenceNode(vtkMRMLNode *refNode)
 {
@@ -278,7 +384,9 @@ bool vtkMRMLVolumeSequenceStorageNode::CanWriteFromReferenceNode(vtkMRMLNode *re
     this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Data node must be a sequence node."));
     return false;
   }
-  vtkMRMLVolumeNode* firstFrameVolume = vtkMRMLVolumeNode::SafeDownCast(volSequenceNode->GetNthDataNode(0));
+  // Frames are checked without loading them: frames that are read on demand are only loaded when writing
+  vtkMRMLVolumeSequenceLazyLoader* lazyLoader = vtkMRMLVolumeSequenceLazyLoader::SafeDownCast(volSequenceNode->GetDataNodeLoader());
+  vtkMRMLVolumeNode* firstFrameVolume = vtkMRMLVolumeNode::SafeDownCast(volSequenceNode->GetNthDataNodeWithoutLoading(0));
   if (firstFrameVolume == nullptr)
   {
     this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Only volume nodes can be written."));
@@ -288,11 +396,9 @@ bool vtkMRMLVolumeSequenceStorageNode::CanWriteFromReferenceNode(vtkMRMLNode *re
   int firstFrameVolumeExtent[6] = { 0, -1, 0, -1, 0, -1 };
   int firstFrameVolumeScalarType = VTK_VOID;
   int firstFrameVolumeNumberOfComponents = 0;
-  if (firstFrameVolume->GetImageData())
+  if (GetFrameImageProperties(firstFrameVolume, lazyLoader,
+    firstFrameVolumeExtent, firstFrameVolumeScalarType, firstFrameVolumeNumberOfComponents))
   {
-    firstFrameVolume->GetImageData()->GetExtent(firstFrameVolumeExtent);
-    firstFrameVolumeScalarType = firstFrameVolume->GetImageData()->GetScalarType();
-    firstFrameVolumeNumberOfComponents = firstFrameVolume->GetImageData()->GetNumberOfScalarComponents();
     // VTK NRRD writer only supports 4D volumes (writing a 3D color volume sequence would require 5D)
     if (firstFrameVolumeNumberOfComponents != 1)
     {
@@ -306,7 +412,7 @@ bool vtkMRMLVolumeSequenceStorageNode::CanWriteFromReferenceNode(vtkMRMLNode *re
   int numberOfFrameVolumes = volSequenceNode->GetNumberOfDataNodes();
   for (int frameIndex = 1; frameIndex<numberOfFrameVolumes; frameIndex++)
   {
-    vtkMRMLVolumeNode* currentFrameVolume = vtkMRMLVolumeNode::SafeDownCast(volSequenceNode->GetNthDataNode(frameIndex));
+    vtkMRMLVolumeNode* currentFrameVolume = vtkMRMLVolumeNode::SafeDownCast(volSequenceNode->GetNthDataNodeWithoutLoading(frameIndex));
     if (currentFrameVolume == nullptr)
     {
       vtkDebugMacro("vtkMRMLVolumeSequenceStorageNode::CanWriteFromReferenceNode: only volume nodes can be written (frame "<<frameIndex<<")");
@@ -326,12 +432,8 @@ bool vtkMRMLVolumeSequenceStorageNode::CanWriteFromReferenceNode(vtkMRMLNode *re
     int currentFrameVolumeExtent[6] = { 0, -1, 0, -1, 0, -1 };
     int currentFrameVolumeScalarType = VTK_VOID;
     int currentFrameVolumeNumberOfComponents = 0;
-    if (currentFrameVolume->GetImageData())
-    {
-      currentFrameVolume->GetImageData()->GetExtent(currentFrameVolumeExtent);
-      currentFrameVolumeScalarType = currentFrameVolume->GetImageData()->GetScalarType();
-      currentFrameVolumeNumberOfComponents = currentFrameVolume->GetImageData()->GetNumberOfScalarComponents();
-    }
+    GetFrameImageProperties(currentFrameVolume, lazyLoader,
+      currentFrameVolumeExtent, currentFrameVolumeScalarType, currentFrameVolumeNumberOfComponents);
     for (int i = 0; i < 6; i++)
     {
       if (firstFrameVolumeExtent[i] != currentFrameVolumeExtent[i])
@@ -368,6 +470,11 @@ int vtkMRMLVolumeSequenceStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
     this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Only sequence nodes can be written in this format."));
     return 0;
   }
+  if (!volSequenceNode->LoadAllDataNodes())
+  {
+    this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Failed to read frames of the sequence."));
+    return 0;
+  }
 
   vtkNew<vtkMatrix4x4> firstVolumeIjkToRas;
   int frameVolumeDimensions[3] = {0};
@@ -462,6 +569,8 @@ int vtkMRMLVolumeSequenceStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
 #endif
 
   writer->SetUseCompression(this->GetUseCompression());
+  // Compress image data blocks on multiple threads, the file remains readable by any NRRD reader
+  writer->SetParallelCompression(true);
 
   // Set volume attributes
   writer->SetIJKToRASMatrix(firstVolumeIjkToRas.GetPointer());
@@ -16,7 +16,16 @@
 #include "vtkMRML.h"
 
 #include "vtkMRMLNRRDStorageNode.h"
+
+// VTK includes
+#include <vtkSmartPointer.h>
+
+// STD includes
 #include <string>
+#include <vector>
+
+class vtkMRMLSequenceNode;
+class vtkMRMLVolumeNode;
 
 class VTK_MRML_EXPORT vtkMRMLVolumeSequenceStorageNode : public vtkMRMLNRRDStorageNode
 {
@@ -26,6 +35,16 @@ class VTK_MRML_EXPORT vtkMRMLVolumeSequenceStorageNode : public vtkMRMLNRRDStora
   vtkTypeMacro(vtkMRMLVolumeSequenceStorageNode,vtkMRMLNRRDStorageNode);
 
   vtkMRMLNode* CreateNodeInstance() override;
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Read node attributes from XML file
+  void ReadXMLAttributes(const char** atts) override;
+
+  /// Write this node's information to a MRML file in XML format.
+  void WriteXML(ostream& of, int indent) override;
+
+  /// Copy the node's attributes to this object
+  void Copy(vtkMRMLNode *node) override;
 
   ///
   /// Get node XML tag name (like Storage, Model)
@@ -34,6 +53,14 @@ class VTK_MRML_EXPORT vtkMRMLVolumeSequenceStorageNode : public vtkMRMLNRRDStora
   /// Return true if the node can be read in.
   bool CanReadInReferenceNode(vtkMRMLNode *refNode) override;
 
+  /// If enabled then voxels of a frame are only read from the file when the frame is accessed
+  /// in the sequence node, and only a limited number of frames are kept in memory
+  /// (see vtkMRMLVolumeSequenceLazyLoader). Used for uncompressed files and files written with
+  /// parallel compression, other files are always read completely. Disabled by default.
+  vtkSetMacro(LazyLoading, bool);
+  vtkGetMacro(LazyLoading, bool);
+  vtkBooleanMacro(LazyLoading, bool);
+
   /// Return true if the node can be written by using the writer.
   bool CanWriteFromReferenceNode(vtkMRMLNode* refNode) override;
 
@@ -74,11 +101,20 @@ protected:
 
   int ReadDataInternal(vtkMRMLNode* refNode) override;
 
+  /// Create a frame volume node of the specified class (vtkMRMLScalarVolumeNode if the class cannot be instantiated)
+  vtkSmartPointer<vtkMRMLVolumeNode> CreateFrameVolume(const std::string& dataNodeClassName);
+
+  /// Name the frame volume and add it to the sequence at the index value read from the file
+  void AddFrameVolume(vtkMRMLSequenceNode* volSequenceNode, vtkMRMLVolumeNode* frameVolume,
+    int frameIndex, const std::vector<std::string>& indexValues);
+
   /// Initialize all the supported write file types
   void InitializeSupportedReadFileTypes() override;
 
   /// Initialize all the supported write file types
   void InitializeSupportedWriteFileTypes() override;
+
+  bool LazyLoading{false};
 };
 
 #endif
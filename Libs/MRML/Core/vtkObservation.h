@@ -90,6 +90,14 @@ class VTK_MRML_EXPORT vtkObservation : public vtkObject
   vtkGetMacro (TotalElapsedTime, double);
   vtkSetMacro (TotalElapsedTime, double);
 
+  /// Description
+  /// Number of times the observation was invoked and number of events
+  /// that were merged into an already queued invocation
+  vtkGetMacro (InvocationCount, unsigned long);
+  vtkSetMacro (InvocationCount, unsigned long);
+  vtkGetMacro (CoalescedCount, unsigned long);
+  vtkSetMacro (CoalescedCount, unsigned long);
+
   struct CallType
   {
     inline CallType(unsigned long eventID, void* callData);
@@ -160,6 +168,9 @@ protected:
   double LastElapsedTime;
   double TotalElapsedTime;
 
+  unsigned long InvocationCount;
+  unsigned long CoalescedCount;
+
 };
 
 //----------------------------------------------------------------------------
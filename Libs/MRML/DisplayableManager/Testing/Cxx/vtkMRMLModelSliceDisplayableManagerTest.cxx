@@ -33,12 +33,16 @@
 #include <vtkMRMLSliceNode.h>
 
 // VTK includes
+#include <vtkActor2D.h>
+#include <vtkActor2DCollection.h>
 #include <vtkCamera.h>
 #include <vtkErrorCode.h>
 #include <vtkImageData.h>
 #include <vtkInteractorEventRecorder.h>
 #include <vtkNew.h>
 #include <vtkPNGWriter.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataMapper2D.h>
 #include <vtkRegressionTestImage.h>
 #include <vtkRenderer.h>
 #include <vtkRendererCollection.h>
@@ -50,6 +54,7 @@
 
 // STD includes
 bool TestBatchRemoveDisplayNode();
+bool TestSliceIntersection();
 
 //----------------------------------------------------------------------------
 int vtkMRMLModelSliceDisplayableManagerTest(int vtkNotUsed(argc),
@@ -57,6 +62,7 @@ int vtkMRMLModelSliceDisplayableManagerTest(int vtkNotUsed(argc),
 {
   bool res = true;
   res = TestBatchRemoveDisplayNode() && res;
+  res = TestSliceIntersection() && res;
   return res ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
@@ -137,3 +143,95 @@ bool TestBatchRemoveDisplayNode()
   sliceNode->Modified();
   return true;
 }
+
+//----------------------------------------------------------------------------
+int GetNumberOfIntersectionPoints(vtkRenderer* renderer)
+{
+  vtkActor2DCollection* actors = renderer->GetActors2D();
+  actors->InitTraversal();
+  vtkActor2D* actor = actors->GetNextActor2D();
+  if (!actor || !actor->GetVisibility())
+  {
+    return 0;
+  }
+  vtkPolyDataMapper2D* mapper = vtkPolyDataMapper2D::SafeDownCast(actor->GetMapper());
+  mapper->Update();
+  return mapper->GetInput() ? mapper->GetInput()->GetNumberOfPoints() : 0;
+}
+
+//----------------------------------------------------------------------------
+bool TestSliceIntersection()
+{
+  vtkSmartPointer<vtkRenderWindow> renderWindow = CreateRenderWindow();
+  vtkRenderer* renderer = renderWindow->GetRenderers()->GetFirstRenderer();
+  vtkNew<vtkMRMLScene> scene;
+  vtkSmartPointer<vtkMRMLDisplayableManagerGroup> displayableManagerGroup =
+    CreateDisplayableManager(scene.GetPointer(), renderer);
+  vtkMRMLSliceNode* sliceNode = vtkMRMLSliceNode::SafeDownCast(scene->GetNodeByID("vtkMRMLSliceNodeRed"));
+
+  vtkNew<vtkMRMLModelDisplayNode> modelDisplayNode;
+  modelDisplayNode->SetVisibility2D(true);
+  scene->AddNode(modelDisplayNode);
+
+  vtkNew<vtkMRMLModelNode> modelNode;
+  vtkNew<vtkSphereSource> sphereSource;
+  sphereSource->SetRadius(10.);
+  sphereSource->SetThetaResolution(32);
+  sphereSource->SetPhiResolution(32);
+  sphereSource->Update();
+  modelNode->SetPolyDataConnection(sphereSource->GetOutputPort());
+  modelNode->AddAndObserveDisplayNodeID(modelDisplayNode->GetID());
+  scene->AddNode(modelNode);
+
+  // Slice through the center of the sphere
+  sliceNode->SetSliceOffset(0.0);
+  int numberOfPointsAtCenter = GetNumberOfIntersectionPoints(renderer);
+  if (numberOfPointsAtCenter < 32)
+  {
+    std::cerr << "Line " << __LINE__ << ": Unexpected number of intersection points at slice offset 0: "
+      << numberOfPointsAtCenter << std::endl;
+    return false;
+  }
+
+  // Slice outside of the sphere, the model is culled
+  sliceNode->SetSliceOffset(50.0);
+  if (GetNumberOfIntersectionPoints(renderer) != 0)
+  {
+    std::cerr << "Line " << __LINE__ << ": Intersection is expected to be hidden at slice offset 50" << std::endl;
+    return false;
+  }
+
+  // Slice through the sphere again, the intersection is computed from the same cell index
+  sliceNode->SetSliceOffset(5.0);
+  int numberOfPointsAtOffset = GetNumberOfIntersectionPoints(renderer);
+  if (numberOfPointsAtOffset < 32)
+  {
+    std::cerr << "Line " << __LINE__ << ": Unexpected number of intersection points at slice offset 5: "
+      << numberOfPointsAtOffset << std::endl;
+    return false;
+  }
+  sliceNode->SetSliceOffset(0.0);
+  if (GetNumberOfIntersectionPoints(renderer) != numberOfPointsAtCenter)
+  {
+    std::cerr << "Line " << __LINE__ << ": Intersection changed after moving the slice back to offset 0" << std::endl;
+    return false;
+  }
+
+  // Changing the mesh invalidates the cell index
+  sphereSource->SetRadius(2.);
+  sphereSource->Update();
+  sliceNode->SetSliceOffset(1.0);
+  if (GetNumberOfIntersectionPoints(renderer) < 32)
+  {
+    std::cerr << "Line " << __LINE__ << ": Intersection is expected after changing the mesh" << std::endl;
+    return false;
+  }
+  sliceNode->SetSliceOffset(5.0);
+  if (GetNumberOfIntersectionPoints(renderer) != 0)
+  {
+    std::cerr << "Line " << __LINE__ << ": Intersection is expected to be hidden after changing the mesh" << std::endl;
+    return false;
+  }
+
+  return true;
+}
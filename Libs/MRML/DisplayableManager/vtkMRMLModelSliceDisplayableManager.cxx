@@ -38,19 +38,25 @@
 #include <vtkActor2D.h>
 #include <vtkAlgorithmOutput.h>
 #include <vtkCallbackCommand.h>
+#include <vtkCellData.h>
 #include <vtkColorTransferFunction.h>
 #include <vtkDataSetSurfaceFilter.h>
 #include <vtkEventBroker.h>
 #include <vtkGeneralTransform.h>
+#include <vtkIdList.h>
 #include <vtkLookupTable.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPlane.h>
+#include <vtkPointData.h>
 #include <vtkPointLocator.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataMapper2D.h>
 #include <vtkProperty2D.h>
 #include <vtkRenderer.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkTransform.h>
 #include <vtkTransformFilter.h>
@@ -65,12 +71,189 @@
 // STD includes
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <memory>
 #include <set>
 #include <map>
+#include <vector>
 
 //---------------------------------------------------------------------------
 vtkStandardNewMacro(vtkMRMLModelSliceDisplayableManager );
 
+namespace
+{
+
+//---------------------------------------------------------------------------
+/// Index of the cells of a mesh by their extent along a plane normal.
+/// It allows finding the cells that may intersect a plane of that normal
+/// without visiting all the cells of the mesh, and remains valid as long as
+/// the mesh and the normal are not changed (e.g., while scrolling through slices).
+/// Cells are sorted into bins of equal size along the normal, each cell is
+/// added to all the bins that its extent overlaps.
+class CellIntervalIndex
+{
+public:
+  bool IsValid(vtkDataSet* mesh, const double normal[3]) const
+  {
+    return mesh && mesh == this->Mesh && mesh->GetMTime() == this->MeshMTime
+      && normal[0] == this->Normal[0] && normal[1] == this->Normal[1] && normal[2] == this->Normal[2];
+  }
+
+  void Build(vtkDataSet* mesh, const double normal[3])
+  {
+    this->Mesh = mesh;
+    this->MeshMTime = mesh ? mesh->GetMTime() : 0;
+    for (int i = 0; i < 3; ++i)
+    {
+      this->Normal[i] = normal[i];
+    }
+    this->CellMinimum.clear();
+    this->CellMaximum.clear();
+    this->Bins.clear();
+
+    vtkIdType numberOfCells = mesh ? mesh->GetNumberOfCells() : 0;
+    if (numberOfCells == 0)
+    {
+      return;
+    }
+
+    // Position of points along the normal
+    vtkIdType numberOfPoints = mesh->GetNumberOfPoints();
+    std::vector<double> pointOffsets(numberOfPoints);
+    vtkSMPTools::For(0, numberOfPoints, [&](vtkIdType begin, vtkIdType end)
+    {
+      double point[3];
+      for (vtkIdType pointId = begin; pointId < end; ++pointId)
+      {
+        mesh->GetPoint(pointId, point);
+        pointOffsets[pointId] = vtkMath::Dot(point, normal);
+      }
+    });
+
+    // Extent of cells along the normal.
+    // Cells are built by the first call of GetCellType, so that GetCellPoints can be called from multiple threads.
+    mesh->GetCellType(0);
+    this->CellMinimum.resize(numberOfCells);
+    this->CellMaximum.resize(numberOfCells);
+    vtkSMPThreadLocalObject<vtkIdList> threadCellPointIds;
+    vtkSMPTools::For(0, numberOfCells, [&](vtkIdType begin, vtkIdType end)
+    {
+      vtkIdList* cellPointIds = threadCellPointIds.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        mesh->GetCellPoints(cellId, cellPointIds);
+        double minimum = VTK_DOUBLE_MAX;
+        double maximum = VTK_DOUBLE_MIN;
+        for (vtkIdType i = 0; i < cellPointIds->GetNumberOfIds(); ++i)
+        {
+          double offset = pointOffsets[cellPointIds->GetId(i)];
+          minimum = std::min(minimum, offset);
+          maximum = std::max(maximum, offset);
+        }
+        this->CellMinimum[cellId] = minimum;
+        this->CellMaximum[cellId] = maximum;
+      }
+    });
+
+    this->Minimum = *std::min_element(this->CellMinimum.begin(), this->CellMinimum.end());
+    this->Maximum = *std::max_element(this->CellMaximum.begin(), this->CellMaximum.end());
+    if (this->Minimum > this->Maximum)
+    {
+      // only empty cells
+      this->CellMinimum.clear();
+      this->CellMaximum.clear();
+      return;
+    }
+
+    // Cells are added to the bins in increasing cell ID order, therefore cell IDs in each bin are sorted
+    const vtkIdType cellsPerBin = 64;
+    const vtkIdType maximumNumberOfBins = 4096;
+    vtkIdType numberOfBins = std::max<vtkIdType>(1, std::min(maximumNumberOfBins, numberOfCells / cellsPerBin));
+    this->BinSize = (this->Maximum - this->Minimum) / numberOfBins;
+    if (this->BinSize <= 0.0)
+    {
+      numberOfBins = 1;
+      this->BinSize = 1.0;
+    }
+    this->Bins.resize(numberOfBins);
+    for (vtkIdType cellId = 0; cellId < numberOfCells; ++cellId)
+    {
+      if (this->CellMinimum[cellId] > this->CellMaximum[cellId])
+      {
+        continue;
+      }
+      vtkIdType firstBin = this->GetBin(this->CellMinimum[cellId]);
+      vtkIdType lastBin = this->GetBin(this->CellMaximum[cellId]);
+      for (vtkIdType bin = firstBin; bin <= lastBin; ++bin)
+      {
+        this->Bins[bin].push_back(cellId);
+      }
+    }
+  }
+
+  /// Get IDs of cells that intersect the plane at the given offset along the normal.
+  /// Cell IDs are returned in increasing order.
+  void GetCellsIntersectingPlane(double offset, vtkIdList* cellIds) const
+  {
+    cellIds->Reset();
+    if (this->Bins.empty() || offset < this->Minimum || offset > this->Maximum)
+    {
+      return;
+    }
+    for (vtkIdType cellId : this->Bins[this->GetBin(offset)])
+    {
+      if (this->CellMinimum[cellId] <= offset && offset <= this->CellMaximum[cellId])
+      {
+        cellIds->InsertNextId(cellId);
+      }
+    }
+  }
+
+protected:
+  vtkIdType GetBin(double offset) const
+  {
+    vtkIdType bin = static_cast<vtkIdType>(std::floor((offset - this->Minimum) / this->BinSize));
+    return std::max<vtkIdType>(0, std::min<vtkIdType>(static_cast<vtkIdType>(this->Bins.size()) - 1, bin));
+  }
+
+  vtkWeakPointer<vtkDataSet> Mesh;
+  vtkMTimeType MeshMTime{ 0 };
+  double Normal[3]{ 0.0, 0.0, 0.0 };
+  double Minimum{ 0.0 };
+  double Maximum{ 0.0 };
+  double BinSize{ 1.0 };
+  std::vector<double> CellMinimum;
+  std::vector<double> CellMaximum;
+  std::vector<std::vector<vtkIdType> > Bins;
+};
+
+//---------------------------------------------------------------------------
+/// Copy the specified cells of the mesh into the output. Points and point data
+/// are shallow copied. Cell IDs must be sorted, so that vertices, lines, polygons,
+/// and strips are inserted in the same order as in the input mesh.
+void ExtractPolyDataCells(vtkPolyData* mesh, vtkIdList* cellIds, vtkPolyData* output)
+{
+  output->Initialize();
+  output->SetPoints(mesh->GetPoints());
+  output->GetPointData()->ShallowCopy(mesh->GetPointData());
+  vtkIdType numberOfCells = cellIds->GetNumberOfIds();
+  output->AllocateEstimate(numberOfCells, 3);
+  vtkCellData* inputCellData = mesh->GetCellData();
+  vtkCellData* outputCellData = output->GetCellData();
+  outputCellData->CopyAllocate(inputCellData, numberOfCells);
+  vtkNew<vtkIdList> cellPointIds;
+  for (vtkIdType i = 0; i < numberOfCells; ++i)
+  {
+    vtkIdType cellId = cellIds->GetId(i);
+    mesh->GetCellPoints(cellId, cellPointIds);
+    vtkIdType newCellId = output->InsertNextCell(mesh->GetCellType(cellId), cellPointIds);
+    outputCellData->CopyData(inputCellData, cellId, newCellId);
+  }
+  output->Squeeze();
+}
+
+} // end of anonymous namespace
+
 //---------------------------------------------------------------------------
 class vtkMRMLModelSliceDisplayableManager::vtkInternal
 {
@@ -84,6 +267,10 @@ public:
     vtkSmartPointer<vtkTransformFilter> ModelWarper;
     vtkSmartPointer<vtkPlane> Plane;
     vtkSmartPointer<vtkPlaneCutter> Cutter;
+    /// Index of cells along the slice normal, to only cut cells that may intersect the slice
+    std::unique_ptr<CellIntervalIndex> IntersectionIndex;
+    vtkSmartPointer<vtkIdList> IntersectingCellIds;
+    vtkSmartPointer<vtkPolyData> IntersectingCells;
     vtkSmartPointer<vtkGeometryFilter> GeometryFilter;
     vtkSmartPointer<vtkSampleImplicitFunctionFilter> SliceDistance;
     vtkSmartPointer<vtkProp> Actor;
@@ -319,6 +506,9 @@ void vtkMRMLModelSliceDisplayableManager::vtkInternal
   pipeline->ModelWarper = vtkSmartPointer<vtkTransformFilter>::New();
   pipeline->SurfaceExtractor = vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
   pipeline->Plane = vtkSmartPointer<vtkPlane>::New();
+  pipeline->IntersectionIndex.reset(new CellIntervalIndex);
+  pipeline->IntersectingCellIds = vtkSmartPointer<vtkIdList>::New();
+  pipeline->IntersectingCells = vtkSmartPointer<vtkPolyData>::New();
 
   // Set up pipeline
   pipeline->Transformer->SetTransform(pipeline->TransformToSlice);
@@ -474,7 +664,37 @@ void vtkMRMLModelSliceDisplayableManager::vtkInternal
     // show intersection in the slice view
     // include clipper in the pipeline
     pipeline->Transformer->SetInputConnection(pipeline->GeometryFilter->GetOutputPort());
-    pipeline->Cutter->SetInputConnection(pipeline->ModelWarper->GetOutputPort());
+
+    // Find the cells that intersect the slice plane. The index is only rebuilt
+    // if the mesh, its transform, or the slice orientation is changed,
+    // therefore moving the slice offset does not require visiting all cells.
+    pipeline->ModelWarper->Update();
+    vtkPointSet* mesh = pipeline->ModelWarper->GetOutput();
+    double normal[3] = { 0.0, 0.0, 1.0 };
+    pipeline->Plane->GetNormal(normal);
+    if (!pipeline->IntersectionIndex->IsValid(mesh, normal))
+    {
+      pipeline->IntersectionIndex->Build(mesh, normal);
+    }
+    pipeline->IntersectionIndex->GetCellsIntersectingPlane(
+      vtkMath::Dot(normal, pipeline->Plane->GetOrigin()), pipeline->IntersectingCellIds);
+    if (pipeline->IntersectingCellIds->GetNumberOfIds() == 0)
+    {
+      // The model does not intersect the slice plane, there is nothing to cut
+      pipeline->Actor->SetVisibility(false);
+      return;
+    }
+    vtkPolyData* polyData = vtkPolyData::SafeDownCast(mesh);
+    if (polyData)
+    {
+      ExtractPolyDataCells(polyData, pipeline->IntersectingCellIds, pipeline->IntersectingCells);
+      pipeline->Cutter->SetInputData(pipeline->IntersectingCells);
+    }
+    else
+    {
+      // Volumetric meshes are cut entirely
+      pipeline->Cutter->SetInputConnection(pipeline->ModelWarper->GetOutputPort());
+    }
 
     // If there is no input or if the input has no points, the vtkTransformPolyDataFilter will display an error message
     // on every update: "No input data".
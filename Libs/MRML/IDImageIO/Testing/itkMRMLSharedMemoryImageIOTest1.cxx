@@ -0,0 +1,302 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+// MRMLIDImageIO includes
+#include "itkMRMLSharedMemoryImageIO.h"
+#include "itkMRMLSharedMemoryImageIOFactory.h"
+
+// ITK includes
+#include <itkImage.h>
+#include <itkImageFileReader.h>
+#include <itkImageFileWriter.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
+#include <itkVectorImage.h>
+
+// STD includes
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+typedef itk::Image<short, 3> ScalarImageType;
+typedef itk::VectorImage<float, 3> VectorImageType;
+
+//----------------------------------------------------------------------------
+#define CHECK(condition)                                                     \
+  if (!(condition))                                                          \
+  {                                                                          \
+    std::cerr << "Line " << __LINE__ << ": check failed: " #condition << std::endl; \
+    return EXIT_FAILURE;                                                     \
+  }
+
+//----------------------------------------------------------------------------
+std::string SegmentFileName(const std::string& suffix)
+{
+  std::ostringstream fileName;
+#ifdef _WIN32
+  fileName << itk::MRMLSharedMemoryImageIO::GetFileNamePrefix() << "/slcTest" << suffix;
+#else
+  fileName << itk::MRMLSharedMemoryImageIO::GetFileNamePrefix() << "/slcTest" << std::hex << getpid() << suffix;
+#endif
+  return fileName.str();
+}
+
+//----------------------------------------------------------------------------
+/// Set a non-identity geometry on the image: rotated axes, non-zero origin, anisotropic spacing.
+template <class TImage>
+void SetGeometry(TImage* image)
+{
+  typename TImage::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 1.25;
+  spacing[2] = 2.0;
+  image->SetSpacing(spacing);
+  typename TImage::PointType origin;
+  origin[0] = 10.0;
+  origin[1] = -20.5;
+  origin[2] = 3.0;
+  image->SetOrigin(origin);
+  typename TImage::DirectionType direction;
+  const double angle = 0.3;
+  direction.SetIdentity();
+  direction(0, 0) = cos(angle);
+  direction(0, 1) = -sin(angle);
+  direction(1, 0) = sin(angle);
+  direction(1, 1) = cos(angle);
+  direction(2, 2) = -1.0;
+  image->SetDirection(direction);
+}
+
+//----------------------------------------------------------------------------
+template <class TImage>
+int CheckGeometry(TImage* expected, TImage* actual)
+{
+  for (unsigned int axis = 0; axis < 3; ++axis)
+  {
+    CHECK(expected->GetLargestPossibleRegion().GetSize()[axis] == actual->GetLargestPossibleRegion().GetSize()[axis]);
+    CHECK(expected->GetSpacing()[axis] == actual->GetSpacing()[axis]);
+    CHECK(expected->GetOrigin()[axis] == actual->GetOrigin()[axis]);
+    for (unsigned int component = 0; component < 3; ++component)
+    {
+      CHECK(expected->GetDirection()(axis, component) == actual->GetDirection()(axis, component));
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestScalarImage()
+{
+  ScalarImageType::Pointer image = ScalarImageType::New();
+  ScalarImageType::SizeType size;
+  size[0] = 7;
+  size[1] = 5;
+  size[2] = 3;
+  image->SetRegions(ScalarImageType::RegionType(size));
+  SetGeometry(image.GetPointer());
+  image->Allocate();
+  short value = -50;
+  for (itk::ImageRegionIterator<ScalarImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    it.Set(value++);
+  }
+
+  std::string fileName = SegmentFileName("s");
+  itk::MRMLSharedMemoryImageIO::Pointer writerImageIO = itk::MRMLSharedMemoryImageIO::New();
+  CHECK(writerImageIO->CanWriteFile(fileName.c_str()));
+  typedef itk::ImageFileWriter<ScalarImageType> WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO(writerImageIO);
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->Update();
+
+  // Read through the registered factory, as command line module executables do
+  itk::MRMLSharedMemoryImageIOFactory::RegisterOneFactory();
+  typedef itk::ImageFileReader<ScalarImageType> ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->Update();
+  CHECK(dynamic_cast<itk::MRMLSharedMemoryImageIO*>(reader->GetImageIO()) != nullptr);
+
+  ScalarImageType* readImage = reader->GetOutput();
+  if (CheckGeometry(image.GetPointer(), readImage) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  itk::ImageRegionConstIterator<ScalarImageType> expectedIt(image, image->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<ScalarImageType> actualIt(readImage, readImage->GetLargestPossibleRegion());
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+  {
+    CHECK(expectedIt.Get() == actualIt.Get());
+  }
+
+  // Segment is kept until it is removed
+  CHECK(itk::MRMLSharedMemoryImageIO::RemoveSegment(fileName));
+  CHECK(!itk::MRMLSharedMemoryImageIO::RemoveSegment(fileName));
+  itk::MRMLSharedMemoryImageIO::Pointer readerImageIO = itk::MRMLSharedMemoryImageIO::New();
+  CHECK(!readerImageIO->CanReadFile(fileName.c_str()));
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestVectorImage()
+{
+  VectorImageType::Pointer image = VectorImageType::New();
+  VectorImageType::SizeType size;
+  size[0] = 4;
+  size[1] = 6;
+  size[2] = 2;
+  image->SetRegions(VectorImageType::RegionType(size));
+  image->SetNumberOfComponentsPerPixel(3);
+  SetGeometry(image.GetPointer());
+  image->Allocate();
+  float value = 0.25f;
+  for (itk::ImageRegionIterator<VectorImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    VectorImageType::PixelType pixel(3);
+    pixel[0] = value;
+    pixel[1] = -value;
+    pixel[2] = 2.0f * value;
+    it.Set(pixel);
+    value += 1.5f;
+  }
+
+  std::string fileName = SegmentFileName("v");
+  typedef itk::ImageFileWriter<VectorImageType> WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO(itk::MRMLSharedMemoryImageIO::New());
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->Update();
+
+  typedef itk::ImageFileReader<VectorImageType> ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetImageIO(itk::MRMLSharedMemoryImageIO::New());
+  reader->SetFileName(fileName);
+  reader->Update();
+  CHECK(itk::MRMLSharedMemoryImageIO::RemoveSegment(fileName));
+
+  VectorImageType* readImage = reader->GetOutput();
+  CHECK(readImage->GetNumberOfComponentsPerPixel() == 3);
+  if (CheckGeometry(image.GetPointer(), readImage) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  itk::ImageRegionConstIterator<VectorImageType> expectedIt(image, image->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<VectorImageType> actualIt(readImage, readImage->GetLargestPossibleRegion());
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+  {
+    for (unsigned int component = 0; component < 3; ++component)
+    {
+      CHECK(expectedIt.Get()[component] == actualIt.Get()[component]);
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestInvalidSegments()
+{
+  // Names that are too long or contain slashes are rejected
+  itk::MRMLSharedMemoryImageIO::Pointer imageIO = itk::MRMLSharedMemoryImageIO::New();
+  CHECK(!imageIO->CanWriteFile("slicershm:/slicer_12345_0_vtkMRMLScalarVolumeNode12"));
+  CHECK(!imageIO->CanWriteFile("slicershm:/slc/12345"));
+  CHECK(!imageIO->CanWriteFile("slicershm:slc12345"));
+  CHECK(!imageIO->CanWriteFile("/tmp/slc12345.nrrd"));
+
+  // Missing segment
+  std::string fileName = SegmentFileName("t");
+  itk::MRMLSharedMemoryImageIO::RemoveSegment(fileName);
+  CHECK(!imageIO->CanReadFile(fileName.c_str()));
+
+#ifndef _WIN32
+  // Segment truncated after it was written
+  ScalarImageType::Pointer image = ScalarImageType::New();
+  ScalarImageType::SizeType size;
+  size.Fill(8);
+  image->SetRegions(ScalarImageType::RegionType(size));
+  image->Allocate();
+  image->FillBuffer(7);
+  typedef itk::ImageFileWriter<ScalarImageType> WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO(itk::MRMLSharedMemoryImageIO::New());
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->Update();
+  CHECK(imageIO->CanReadFile(fileName.c_str()));
+
+  std::string segmentName = fileName.substr(std::string(itk::MRMLSharedMemoryImageIO::GetFileNamePrefix()).size());
+  int fd = shm_open(segmentName.c_str(), O_RDWR, 0);
+  CHECK(fd >= 0);
+  // Keep the header and a part of the voxels
+  bool truncated = (ftruncate(fd, 512) == 0);
+  close(fd);
+  CHECK(truncated);
+
+  CHECK(!imageIO->CanReadFile(fileName.c_str()));
+  imageIO->SetFileName(fileName);
+  bool exceptionThrown = false;
+  try
+  {
+    imageIO->ReadImageInformation();
+  }
+  catch (itk::ExceptionObject&)
+  {
+    exceptionThrown = true;
+  }
+  CHECK(exceptionThrown);
+  CHECK(itk::MRMLSharedMemoryImageIO::RemoveSegment(fileName));
+#endif
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int itkMRMLSharedMemoryImageIOTest1(int, char*[])
+{
+  if (!itk::MRMLSharedMemoryImageIO::IsSupported())
+  {
+    std::cout << "Shared memory segments are not supported on this platform, skip test." << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  try
+  {
+    if (TestScalarImage() != EXIT_SUCCESS
+      || TestVectorImage() != EXIT_SUCCESS
+      || TestInvalidSegments() != EXIT_SUCCESS)
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  catch (itk::ExceptionObject& exc)
+  {
+    std::cerr << "Unexpected exception: " << exc << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,15 @@
+#include "itkMRMLSharedMemoryIOPlugin.h"
+#include "itkMRMLSharedMemoryImageIOFactory.h"
+
+/**
+ * Routine that is called when the shared library is loaded by
+ * itk::ObjectFactoryBase::LoadDynamicFactories().
+ *
+ * itkLoad() is C (not C++) function.
+ */
+itk::ObjectFactoryBase* itkLoad()
+{
+  static itk::MRMLSharedMemoryImageIOFactory::Pointer f
+    = itk::MRMLSharedMemoryImageIOFactory::New();
+  return f;
+}
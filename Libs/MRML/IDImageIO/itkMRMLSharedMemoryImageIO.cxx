@@ -0,0 +1,393 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#include "itkMRMLSharedMemoryImageIO.h"
+
+// STD includes
+#include <cstdint>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+const char SharedMemoryImageMagic[8] = { 'S', 'L', 'C', 'R', 'S', 'H', 'M', '1' };
+const unsigned int SharedMemoryImageMaximumDimension = 3;
+const uint64_t SharedMemoryImageDataAlignment = 64;
+/// Longest segment name (including the leading slash) accepted on all
+/// supported platforms (PSHMNAMLEN on macOS).
+const size_t SharedMemorySegmentNameMaximumLength = 31;
+
+//----------------------------------------------------------------------------
+/// Header stored at the beginning of each segment. Geometry is in LPS,
+/// same as in ITK images.
+struct SharedMemoryImageHeader
+{
+  char Magic[8];
+  uint32_t ComponentType;
+  uint32_t PixelType;
+  uint32_t NumberOfComponents;
+  uint32_t NumberOfDimensions;
+  uint64_t Dimensions[3];
+  double Spacing[3];
+  double Origin[3];
+  /// Direction[axis * 3 + component]
+  double Direction[9];
+  uint64_t DataOffset;
+  uint64_t DataSize;
+};
+
+//----------------------------------------------------------------------------
+/// Memory mapping of a named segment. The mapping is released on destruction
+/// but the segment itself is only removed by shm_unlink.
+class SharedMemorySegment
+{
+public:
+  SharedMemorySegment() = default;
+  ~SharedMemorySegment()
+  {
+    this->Close();
+  }
+
+  bool OpenForReading(const std::string& name)
+  {
+    this->Close();
+#ifdef _WIN32
+    (void)name;
+    return false;
+#else
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+    {
+      return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(SharedMemoryImageHeader)))
+    {
+      close(fd);
+      return false;
+    }
+    void* pointer = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (pointer == MAP_FAILED)
+    {
+      return false;
+    }
+    this->Pointer = pointer;
+    this->Size = static_cast<size_t>(status.st_size);
+    return true;
+#endif
+  }
+
+  bool CreateForWriting(const std::string& name, size_t size)
+  {
+    this->Close();
+#ifdef _WIN32
+    (void)name;
+    (void)size;
+    return false;
+#else
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+    {
+      return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+      close(fd);
+      shm_unlink(name.c_str());
+      return false;
+    }
+    void* pointer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (pointer == MAP_FAILED)
+    {
+      shm_unlink(name.c_str());
+      return false;
+    }
+    this->Pointer = pointer;
+    this->Size = size;
+    return true;
+#endif
+  }
+
+  void Close()
+  {
+#ifndef _WIN32
+    if (this->Pointer)
+    {
+      munmap(this->Pointer, this->Size);
+    }
+#endif
+    this->Pointer = nullptr;
+    this->Size = 0;
+  }
+
+  /// Return the header if the segment contains a valid image.
+  const SharedMemoryImageHeader* GetHeader() const
+  {
+    if (!this->Pointer || this->Size < sizeof(SharedMemoryImageHeader))
+    {
+      return nullptr;
+    }
+    const SharedMemoryImageHeader* header = static_cast<const SharedMemoryImageHeader*>(this->Pointer);
+    if (memcmp(header->Magic, SharedMemoryImageMagic, sizeof(SharedMemoryImageMagic)) != 0
+      || header->NumberOfDimensions < 1 || header->NumberOfDimensions > SharedMemoryImageMaximumDimension
+      || header->DataOffset < sizeof(SharedMemoryImageHeader)
+      || header->DataOffset > this->Size || header->DataSize > this->Size - header->DataOffset)
+    {
+      return nullptr;
+    }
+    return header;
+  }
+
+  const void* GetData() const
+  {
+    const SharedMemoryImageHeader* header = this->GetHeader();
+    return header ? static_cast<const char*>(this->Pointer) + header->DataOffset : nullptr;
+  }
+
+  void* GetPointer() const { return this->Pointer; }
+
+private:
+  SharedMemorySegment(const SharedMemorySegment&) = delete;
+  void operator=(const SharedMemorySegment&) = delete;
+
+  void* Pointer{ nullptr };
+  size_t Size{ 0 };
+};
+
+} // end of anonymous namespace
+
+namespace itk {
+//----------------------------------------------------------------------------
+MRMLSharedMemoryImageIO
+::MRMLSharedMemoryImageIO() = default;
+
+//----------------------------------------------------------------------------
+MRMLSharedMemoryImageIO
+::~MRMLSharedMemoryImageIO() = default;
+
+//----------------------------------------------------------------------------
+const char*
+MRMLSharedMemoryImageIO
+::GetFileNamePrefix()
+{
+  return "slicershm:";
+}
+
+//----------------------------------------------------------------------------
+bool
+MRMLSharedMemoryImageIO
+::IsSharedMemoryFileName(const std::string& fileName)
+{
+  return fileName.compare(0, strlen(GetFileNamePrefix()), GetFileNamePrefix()) == 0;
+}
+
+//----------------------------------------------------------------------------
+bool
+MRMLSharedMemoryImageIO
+::IsSupported()
+{
+#ifdef _WIN32
+  return false;
+#else
+  return true;
+#endif
+}
+
+//----------------------------------------------------------------------------
+std::string
+MRMLSharedMemoryImageIO
+::GetSegmentName(const std::string& fileName)
+{
+  if (!IsSharedMemoryFileName(fileName))
+  {
+    return std::string();
+  }
+  // POSIX segment names start with a single slash and contain no other slash.
+  // Longer names are rejected here, as shm_open would fail on macOS.
+  std::string name = fileName.substr(strlen(GetFileNamePrefix()));
+  if (name.size() < 2 || name.size() > SharedMemorySegmentNameMaximumLength
+    || name[0] != '/' || name.find('/', 1) != std::string::npos)
+  {
+    return std::string();
+  }
+  return name;
+}
+
+//----------------------------------------------------------------------------
+bool
+MRMLSharedMemoryImageIO
+::RemoveSegment(const std::string& fileName)
+{
+  std::string name = GetSegmentName(fileName);
+  if (name.empty())
+  {
+    return false;
+  }
+#ifdef _WIN32
+  return false;
+#else
+  return shm_unlink(name.c_str()) == 0;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool
+MRMLSharedMemoryImageIO
+::CanReadFile(const char* filename)
+{
+  std::string name = GetSegmentName(filename ? filename : "");
+  if (name.empty())
+  {
+    return false;
+  }
+  SharedMemorySegment segment;
+  return segment.OpenForReading(name) && segment.GetHeader() != nullptr;
+}
+
+//----------------------------------------------------------------------------
+void
+MRMLSharedMemoryImageIO
+::ReadImageInformation()
+{
+  SharedMemorySegment segment;
+  if (!segment.OpenForReading(GetSegmentName(m_FileName)))
+  {
+    itkExceptionMacro("Failed to open shared memory segment " << m_FileName);
+  }
+  const SharedMemoryImageHeader* header = segment.GetHeader();
+  if (!header)
+  {
+    itkExceptionMacro("Shared memory segment " << m_FileName << " does not contain a valid image");
+  }
+
+  const unsigned int numberOfDimensions = header->NumberOfDimensions;
+  this->SetNumberOfDimensions(numberOfDimensions);
+  for (unsigned int axis = 0; axis < numberOfDimensions; ++axis)
+  {
+    this->SetDimensions(axis, static_cast<SizeValueType>(header->Dimensions[axis]));
+    this->SetSpacing(axis, header->Spacing[axis]);
+    this->SetOrigin(axis, header->Origin[axis]);
+    std::vector<double> direction(numberOfDimensions);
+    for (unsigned int component = 0; component < numberOfDimensions; ++component)
+    {
+      direction[component] = header->Direction[axis * 3 + component];
+    }
+    this->SetDirection(axis, direction);
+  }
+  this->SetComponentType(static_cast<IOComponentType>(header->ComponentType));
+  this->SetPixelType(static_cast<IOPixelType>(header->PixelType));
+  this->SetNumberOfComponents(header->NumberOfComponents);
+
+  if (header->DataSize != static_cast<uint64_t>(this->GetImageSizeInBytes()))
+  {
+    itkExceptionMacro("Shared memory segment " << m_FileName << " size does not match the image size");
+  }
+}
+
+//----------------------------------------------------------------------------
+void
+MRMLSharedMemoryImageIO
+::Read(void* buffer)
+{
+  SharedMemorySegment segment;
+  if (!segment.OpenForReading(GetSegmentName(m_FileName)))
+  {
+    itkExceptionMacro("Failed to open shared memory segment " << m_FileName);
+  }
+  const SharedMemoryImageHeader* header = segment.GetHeader();
+  if (!header || header->DataSize != static_cast<uint64_t>(this->GetImageSizeInBytes()))
+  {
+    itkExceptionMacro("Shared memory segment " << m_FileName << " does not match the image information");
+  }
+  memcpy(buffer, segment.GetData(), static_cast<size_t>(header->DataSize));
+}
+
+//----------------------------------------------------------------------------
+bool
+MRMLSharedMemoryImageIO
+::CanWriteFile(const char* filename)
+{
+  return IsSupported() && !GetSegmentName(filename ? filename : "").empty();
+}
+
+//----------------------------------------------------------------------------
+void
+MRMLSharedMemoryImageIO
+::WriteImageInformation()
+{
+}
+
+//----------------------------------------------------------------------------
+void
+MRMLSharedMemoryImageIO
+::Write(const void* buffer)
+{
+  const unsigned int numberOfDimensions = this->GetNumberOfDimensions();
+  if (numberOfDimensions < 1 || numberOfDimensions > SharedMemoryImageMaximumDimension)
+  {
+    itkExceptionMacro("Images of " << numberOfDimensions << " dimensions cannot be written to shared memory");
+  }
+
+  SharedMemoryImageHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.Magic, SharedMemoryImageMagic, sizeof(SharedMemoryImageMagic));
+  header.ComponentType = static_cast<uint32_t>(this->GetComponentType());
+  header.PixelType = static_cast<uint32_t>(this->GetPixelType());
+  header.NumberOfComponents = this->GetNumberOfComponents();
+  header.NumberOfDimensions = numberOfDimensions;
+  for (unsigned int axis = 0; axis < SharedMemoryImageMaximumDimension; ++axis)
+  {
+    header.Dimensions[axis] = 1;
+    header.Spacing[axis] = 1.0;
+    header.Direction[axis * 3 + axis] = 1.0;
+  }
+  for (unsigned int axis = 0; axis < numberOfDimensions; ++axis)
+  {
+    header.Dimensions[axis] = this->GetDimensions(axis);
+    header.Spacing[axis] = this->GetSpacing(axis);
+    header.Origin[axis] = this->GetOrigin(axis);
+    std::vector<double> direction = this->GetDirection(axis);
+    for (unsigned int component = 0; component < numberOfDimensions && component < direction.size(); ++component)
+    {
+      header.Direction[axis * 3 + component] = direction[component];
+    }
+  }
+  header.DataOffset = ((sizeof(SharedMemoryImageHeader) + SharedMemoryImageDataAlignment - 1)
+    / SharedMemoryImageDataAlignment) * SharedMemoryImageDataAlignment;
+  header.DataSize = static_cast<uint64_t>(this->GetImageSizeInBytes());
+
+  SharedMemorySegment segment;
+  if (!segment.CreateForWriting(GetSegmentName(m_FileName), static_cast<size_t>(header.DataOffset + header.DataSize)))
+  {
+    itkExceptionMacro("Failed to create shared memory segment " << m_FileName);
+  }
+  char* pointer = static_cast<char*>(segment.GetPointer());
+  memcpy(pointer + header.DataOffset, buffer, static_cast<size_t>(header.DataSize));
+  // Write the header last so that a partially written segment is never recognized as valid
+  memcpy(pointer, &header, sizeof(header));
+}
+
+//----------------------------------------------------------------------------
+void
+MRMLSharedMemoryImageIO
+::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+}
+
+} // end namespace itk
@@ -0,0 +1,115 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef itkMRMLSharedMemoryImageIO_h
+#define itkMRMLSharedMemoryImageIO_h
+
+#ifdef _MSC_VER
+#pragma warning ( disable : 4786 )
+#endif
+
+#include "itkMRMLSharedMemoryIOExport.h"
+
+#include "itkImageIOBase.h"
+
+namespace itk
+{
+/** \class MRMLSharedMemoryImageIO
+ * \brief ImageIO object for exchanging images through named shared memory segments
+ *
+ * MRMLSharedMemoryImageIO allows Slicer and a command line module
+ * executable running in a separate process to exchange images without
+ * writing them to disk. Slicer publishes each input image in a POSIX
+ * shared memory segment, the executable maps it read-only using a
+ * standard ITK ImageFileReader. Output images are written by the
+ * ImageFileWriter into new segments, which are read and removed by Slicer
+ * after the executable has completed.
+ *
+ * Unlike MRMLIDImageIO, this class only depends on ITK, therefore it can
+ * be loaded as a plugin into any executable, whatever the libraries it
+ * was linked with.
+ *
+ * The "filename" specified will look like:
+ *     <code>slicershm:/\<segment name\></code>
+ * Segment names are at most 31 characters long, including the leading
+ * slash, to be accepted on all platforms.
+ *
+ * A segment contains a fixed size header (pixel type, size, spacing,
+ * origin and direction in LPS) followed by the voxel buffer.
+ * Images of up to 3 dimensions are supported.
+ */
+class MRMLSharedMemoryIO_EXPORT MRMLSharedMemoryImageIO : public ImageIOBase
+{
+public:
+  /** Standard class typedefs. */
+  typedef MRMLSharedMemoryImageIO Self;
+  typedef ImageIOBase             Superclass;
+  typedef SmartPointer<Self>      Pointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MRMLSharedMemoryImageIO, ImageIOBase);
+
+  /** Determine the file type. Returns true if this ImageIO can read the
+   * file specified. */
+  bool CanReadFile(const char*) override;
+
+  /** Set the spacing and dimension information for the set filename. */
+  void ReadImageInformation() override;
+
+  /** Reads the data from the shared memory segment into the memory buffer provided. */
+  void Read(void* buffer) override;
+
+  /*-------- This part of the interfaces deals with writing data. ----- */
+
+  /** Determine the file type. Returns true if this ImageIO can write the
+   * file specified. */
+  bool CanWriteFile(const char*) override;
+
+  /** The header is written along with the data in Write(). */
+  void WriteImageInformation() override;
+
+  /** Create the shared memory segment and copy the header and the
+   * memory buffer provided into it. The segment persists after the
+   * process exits, until it is removed by RemoveSegment(). */
+  void Write(const void* buffer) override;
+
+  /** Prefix of the file names handled by this ImageIO. */
+  static const char* GetFileNamePrefix();
+
+  /** Return true if the file name refers to a shared memory segment. */
+  static bool IsSharedMemoryFileName(const std::string& fileName);
+
+  /** Return true if shared memory segments are supported on this platform. */
+  static bool IsSupported();
+
+  /** Remove the shared memory segment referred to by the file name.
+   * Returns false if the segment does not exist. */
+  static bool RemoveSegment(const std::string& fileName);
+
+protected:
+  MRMLSharedMemoryImageIO();
+  ~MRMLSharedMemoryImageIO() override;
+  void PrintSelf(std::ostream& os, Indent indent) const override;
+
+private:
+  MRMLSharedMemoryImageIO(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  /** Return the name of the segment (starting with a slash) from the
+   * file name or an empty string if the file name is not valid. */
+  static std::string GetSegmentName(const std::string& fileName);
+
+};
+
+
+} /// end namespace itk
+#endif
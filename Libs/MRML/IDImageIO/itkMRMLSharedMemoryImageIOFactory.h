@@ -0,0 +1,73 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMRMLSharedMemoryImageIOFactory_h
+#define itkMRMLSharedMemoryImageIOFactory_h
+
+#include "itkObjectFactoryBase.h"
+#include "itkImageIOBase.h"
+
+#include "itkMRMLSharedMemoryImageIO.h"
+
+#include "itkMRMLSharedMemoryIOExport.h"
+
+namespace itk
+{
+/** \class MRMLSharedMemoryImageIOFactory
+ * \brief Create instances of MRMLSharedMemoryImageIO objects using an object factory.
+ */
+class MRMLSharedMemoryIO_EXPORT MRMLSharedMemoryImageIOFactory : public ObjectFactoryBase
+{
+public:
+  /** Standard class typedefs. */
+  typedef MRMLSharedMemoryImageIOFactory  Self;
+  typedef ObjectFactoryBase               Superclass;
+  typedef SmartPointer<Self>              Pointer;
+  typedef SmartPointer<const Self>        ConstPointer;
+
+  /** Class methods used to interface with the registered factories. */
+  const char* GetITKSourceVersion() const override;
+  const char* GetDescription() const override;
+
+  /** Method for class instantiation. */
+  itkFactorylessNewMacro(Self);
+  static MRMLSharedMemoryImageIOFactory* FactoryNew() { return new MRMLSharedMemoryImageIOFactory;}
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MRMLSharedMemoryImageIOFactory, ObjectFactoryBase);
+
+  /** Register one factory of this type  */
+  static void RegisterOneFactory()
+  {
+    MRMLSharedMemoryImageIOFactory::Pointer sharedMemoryFactory = MRMLSharedMemoryImageIOFactory::New();
+    ObjectFactoryBase::RegisterFactory(sharedMemoryFactory);
+  }
+
+protected:
+  MRMLSharedMemoryImageIOFactory();
+  ~MRMLSharedMemoryImageIOFactory() override;
+
+private:
+  MRMLSharedMemoryImageIOFactory(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+};
+
+
+} /// end namespace itk
+
+#endif
@@ -0,0 +1,176 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLLogic includes
+#include "vtkImageLabelMapToRGBA.h"
+#include "vtkImageLabelOutline.h"
+
+// MRML includes
+#include <vtkMRMLCoreTestingMacros.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkImageMapToRGBA.h>
+#include <vtkLookupTable.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+bool CompareImages(vtkImageData* actual, vtkImageData* expected)
+{
+  int actualDimensions[3] = { 0, 0, 0 };
+  int expectedDimensions[3] = { 0, 0, 0 };
+  actual->GetDimensions(actualDimensions);
+  expected->GetDimensions(expectedDimensions);
+  for (int i = 0; i < 3; ++i)
+  {
+    if (actualDimensions[i] != expectedDimensions[i])
+    {
+      std::cerr << "Image dimensions mismatch" << std::endl;
+      return false;
+    }
+  }
+  vtkIdType size = actual->GetPointData()->GetScalars()->GetDataSize();
+  if (size != expected->GetPointData()->GetScalars()->GetDataSize()
+    || memcmp(actual->GetScalarPointer(), expected->GetScalarPointer(), size) != 0)
+  {
+    std::cerr << "Image content mismatch" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool IsTransparent(vtkImageData* image)
+{
+  const unsigned char* pixels = static_cast<const unsigned char*>(image->GetScalarPointer());
+  vtkIdType size = image->GetPointData()->GetScalars()->GetDataSize();
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    if (pixels[i] != 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkImageLabelMapToRGBATest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  // Label map with a few overlapping rectangles of different labels
+  vtkNew<vtkImageData> labelMap;
+  labelMap->SetDimensions(40, 30, 2);
+  labelMap->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(labelMap->GetScalarPointer());
+  for (int k = 0; k < 2; ++k)
+  {
+    for (int j = 0; j < 30; ++j)
+    {
+      for (int i = 0; i < 40; ++i)
+      {
+        short label = 0;
+        if (i >= 5 && i < 20 && j >= 5 && j < 25)
+        {
+          label = 1;
+        }
+        if (i >= 15 && i < 39 && j >= 10 && j < 30 - k * 5)
+        {
+          label = 2;
+        }
+        if (i == 30 && j == 3)
+        {
+          label = 3;
+        }
+        *(voxels++) = label;
+      }
+    }
+  }
+
+  vtkNew<vtkLookupTable> fillLookupTable;
+  fillLookupTable->SetNumberOfTableValues(4);
+  fillLookupTable->SetTableRange(0, 3);
+  fillLookupTable->SetTableValue(0, 0.0, 0.0, 0.0, 0.0);
+  fillLookupTable->SetTableValue(1, 1.0, 0.0, 0.0, 0.5);
+  fillLookupTable->SetTableValue(2, 0.0, 1.0, 0.0, 0.25);
+  fillLookupTable->SetTableValue(3, 0.0, 0.0, 1.0, 0.0);
+
+  vtkNew<vtkLookupTable> outlineLookupTable;
+  outlineLookupTable->SetNumberOfTableValues(4);
+  outlineLookupTable->SetTableRange(0, 3);
+  outlineLookupTable->SetTableValue(0, 0.0, 0.0, 0.0, 0.0);
+  outlineLookupTable->SetTableValue(1, 1.0, 0.5, 0.0, 1.0);
+  outlineLookupTable->SetTableValue(2, 0.0, 1.0, 0.5, 1.0);
+  outlineLookupTable->SetTableValue(3, 0.5, 0.0, 1.0, 1.0);
+
+  // Reference pipeline
+  vtkNew<vtkImageLabelOutline> labelOutline;
+  labelOutline->SetInputData(labelMap);
+  vtkNew<vtkImageMapToRGBA> outlineColorMapper;
+  outlineColorMapper->SetInputConnection(labelOutline->GetOutputPort());
+  outlineColorMapper->SetOutputFormatToRGBA();
+  outlineColorMapper->SetLookupTable(outlineLookupTable);
+  vtkNew<vtkImageMapToRGBA> fillColorMapper;
+  fillColorMapper->SetInputData(labelMap);
+  fillColorMapper->SetOutputFormatToRGBA();
+  fillColorMapper->SetLookupTable(fillLookupTable);
+
+  vtkNew<vtkImageLabelMapToRGBA> labelMapToRGBA;
+  EXERCISE_BASIC_OBJECT_METHODS(labelMapToRGBA.GetPointer());
+  labelMapToRGBA->SetInputData(labelMap);
+  labelMapToRGBA->SetFillLookupTable(fillLookupTable);
+  labelMapToRGBA->SetOutlineLookupTable(outlineLookupTable);
+
+  for (int outline = 1; outline <= 3; ++outline)
+  {
+    labelOutline->SetOutline(outline);
+    labelMapToRGBA->SetOutline(outline);
+    outlineColorMapper->Update();
+    fillColorMapper->Update();
+    labelMapToRGBA->Update();
+    CHECK_BOOL(CompareImages(vtkImageData::SafeDownCast(labelMapToRGBA->GetOutputDataObject(0)), fillColorMapper->GetOutput()), true);
+    CHECK_BOOL(CompareImages(vtkImageData::SafeDownCast(labelMapToRGBA->GetOutputDataObject(1)), outlineColorMapper->GetOutput()), true);
+  }
+
+  // Lookup table changes are taken into account
+  fillLookupTable->SetTableValue(1, 1.0, 1.0, 0.0, 1.0);
+  fillColorMapper->Update();
+  labelMapToRGBA->Update();
+  CHECK_BOOL(CompareImages(vtkImageData::SafeDownCast(labelMapToRGBA->GetOutputDataObject(0)), fillColorMapper->GetOutput()), true);
+
+  // Disabled outputs are transparent
+  labelMapToRGBA->GenerateFillOff();
+  labelMapToRGBA->Update();
+  CHECK_BOOL(IsTransparent(vtkImageData::SafeDownCast(labelMapToRGBA->GetOutputDataObject(0))), true);
+  CHECK_BOOL(CompareImages(vtkImageData::SafeDownCast(labelMapToRGBA->GetOutputDataObject(1)), outlineColorMapper->GetOutput()), true);
+  labelMapToRGBA->GenerateFillOn();
+  labelMapToRGBA->GenerateOutlineOff();
+  labelMapToRGBA->Update();
+  CHECK_BOOL(IsTransparent(vtkImageData::SafeDownCast(labelMapToRGBA->GetOutputDataObject(1))), true);
+  CHECK_BOOL(CompareImages(vtkImageData::SafeDownCast(labelMapToRGBA->GetOutputDataObject(0)), fillColorMapper->GetOutput()), true);
+
+  std::cout << "Success" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -24,21 +24,27 @@
 // MRML includes
 #include "vtkMRMLCoreTestingMacros.h"
 #include "vtkMRMLScene.h"
+#include "vtkMRMLSliceNode.h"
+#include "vtkMRMLTransformNode.h"
 
 // VTK includes
 #include <vtkAssignAttribute.h>
 #include <vtkDataSetAttributes.h>
 #include <vtkFloatArray.h>
+#include <vtkGeneralTransform.h>
 #include <vtkImageData.h>
 #include <vtkImageInterpolator.h>
 #include <vtkImageReslice.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkThinPlateSplineTransform.h>
 #include <vtkTrivialProducer.h>
 
 namespace
 {
 bool testDTIPipeline();
+bool testBakedNonLinearTransform();
 }
 
 //----------------------------------------------------------------------------
@@ -73,6 +79,7 @@ int vtkMRMLSliceLayerLogicTest(int , char * [] )
 
   bool res = true;
   res = res && testDTIPipeline();
+  res = res && testBakedNonLinearTransform();
   return res ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
@@ -136,4 +143,102 @@ bool testDTIPipeline()
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool testBakedNonLinearTransform()
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(21, 21, 21);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  imageData->GetPointData()->GetScalars()->Fill(0);
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetSpacing(10.0, 10.0, 10.0);
+  volumeNode->SetOrigin(-100.0, -100.0, -100.0);
+  volumeNode->SetAndObserveImageData(imageData);
+  scene->AddNode(volumeNode);
+
+  // Smooth deformation that moves the center of the volume
+  vtkNew<vtkPoints> sourceLandmarks;
+  vtkNew<vtkPoints> targetLandmarks;
+  for (int i = 0; i < 8; ++i)
+  {
+    double corner[3] = { (i & 1) ? 80.0 : -80.0, (i & 2) ? 80.0 : -80.0, (i & 4) ? 80.0 : -80.0 };
+    sourceLandmarks->InsertNextPoint(corner);
+    targetLandmarks->InsertNextPoint(corner);
+  }
+  sourceLandmarks->InsertNextPoint(0.0, 0.0, 0.0);
+  targetLandmarks->InsertNextPoint(5.0, -3.0, 2.0);
+  vtkNew<vtkThinPlateSplineTransform> thinPlateSplineTransform;
+  thinPlateSplineTransform->SetBasisToR();
+  thinPlateSplineTransform->SetSourceLandmarks(sourceLandmarks);
+  thinPlateSplineTransform->SetTargetLandmarks(targetLandmarks);
+  vtkNew<vtkMRMLTransformNode> transformNode;
+  scene->AddNode(transformNode);
+  transformNode->SetAndObserveTransformToParent(thinPlateSplineTransform);
+  volumeNode->SetAndObserveTransformNodeID(transformNode->GetID());
+
+  vtkNew<vtkMRMLSliceNode> sliceNode;
+  sliceNode->SetLayoutName("Red");
+  sliceNode->SetOrientationToAxial();
+  sliceNode->SetDimensions(256, 256, 1);
+  sliceNode->SetFieldOfView(250.0, 250.0, 1.0);
+  scene->AddNode(sliceNode);
+
+  vtkNew<vtkMRMLSliceLayerLogic> logic;
+  logic->SetMRMLScene(scene);
+  logic->SetSliceNode(sliceNode);
+  logic->SetVolumeNode(volumeNode);
+  CHECK_BOOL(logic->GetBakeNonLinearTransform(), false);
+  CHECK_INT(logic->GetNumberOfBakedTransformUpdates(), 0);
+
+  const int numberOfTestPoints = 3;
+  const double xyTestPoints[numberOfTestPoints][3] = { { 128.0, 128.0, 0.0 }, { 100.0, 140.0, 0.0 }, { 150.0, 110.0, 0.0 } };
+  double ijkExpected[numberOfTestPoints][3];
+  for (int i = 0; i < numberOfTestPoints; ++i)
+  {
+    logic->GetXYToIJKTransform()->TransformPoint(xyTestPoints[i], ijkExpected[i]);
+  }
+
+  // Baked transform approximates the exact transform
+  logic->BakeNonLinearTransformOn();
+  CHECK_INT(logic->GetNumberOfBakedTransformUpdates(), 1);
+  for (int i = 0; i < numberOfTestPoints; ++i)
+  {
+    double ijkBaked[3] = { 0.0, 0.0, 0.0 };
+    logic->GetXYToIJKTransform()->TransformPoint(xyTestPoints[i], ijkBaked);
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      // tolerance is 0.1 voxel (1 mm)
+      CHECK_DOUBLE_TOLERANCE(ijkBaked[axis], ijkExpected[i][axis], 0.1);
+    }
+  }
+
+  // Baked transform is reused if the transform is not modified
+  logic->UpdateTransforms();
+  sliceNode->SetSliceOffset(10.0);
+  CHECK_INT(logic->GetNumberOfBakedTransformUpdates(), 1);
+
+  // Baked transform is updated if the transform is modified
+  targetLandmarks->SetPoint(8, -5.0, 3.0, -2.0);
+  thinPlateSplineTransform->SetTargetLandmarks(targetLandmarks);
+  thinPlateSplineTransform->Modified();
+  logic->UpdateTransforms();
+  CHECK_INT(logic->GetNumberOfBakedTransformUpdates(), 2);
+
+  // Changing the grid size updates the baked transform
+  logic->SetBakedTransformGridSize(32);
+  CHECK_INT(logic->GetBakedTransformGridSize(), 32);
+  CHECK_INT(logic->GetNumberOfBakedTransformUpdates(), 3);
+
+  // Linear transforms are not baked
+  vtkNew<vtkMRMLTransformNode> linearTransformNode;
+  scene->AddNode(linearTransformNode);
+  volumeNode->SetAndObserveTransformNodeID(linearTransformNode->GetID());
+  logic->UpdateTransforms();
+  CHECK_INT(logic->GetNumberOfBakedTransformUpdates(), 3);
+
+  return true;
+}
+
 }
@@ -0,0 +1,253 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLLogic includes
+#include <vtkMRMLSliceLayerLogic.h>
+#include <vtkMRMLSliceLogic.h>
+
+// MRML includes
+#include <vtkMRMLColorTableNode.h>
+#include <vtkMRMLCoreTestingMacros.h>
+#include <vtkMRMLLabelMapVolumeDisplayNode.h>
+#include <vtkMRMLLabelMapVolumeNode.h>
+#include <vtkMRMLScalarVolumeDisplayNode.h>
+#include <vtkMRMLScalarVolumeNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSliceCompositeNode.h>
+#include <vtkMRMLSliceNode.h>
+
+// VTK includes
+#include <vtkAlgorithm.h>
+#include <vtkAlgorithmOutput.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+#include <vtkTransform.h>
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkMRMLScalarVolumeNode* AddScalarVolume(vtkMRMLScene* scene, vtkMRMLColorTableNode* colorNode, double offset)
+{
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(64, 64, 32);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(imageData->GetScalarPointer());
+  for (int k = 0; k < 32; ++k)
+  {
+    for (int j = 0; j < 64; ++j)
+    {
+      for (int i = 0; i < 64; ++i)
+      {
+        *(voxels++) = static_cast<short>(offset + 10 * i + 5 * j + 20 * k);
+      }
+    }
+  }
+
+  vtkNew<vtkMRMLScalarVolumeDisplayNode> displayNode;
+  displayNode->SetAutoWindowLevel(false);
+  displayNode->SetAutoThreshold(false);
+  displayNode->SetWindowLevel(600, 500);
+  displayNode->SetInterpolate(true);
+  scene->AddNode(displayNode);
+  displayNode->SetAndObserveColorNodeID(colorNode->GetID());
+
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetSpacing(1.5, 1.5, 2.0);
+  volumeNode->SetOrigin(-48.0, -48.0, -32.0);
+  volumeNode->SetAndObserveImageData(imageData);
+  scene->AddNode(volumeNode);
+  volumeNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+  return volumeNode;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLLabelMapVolumeNode* AddLabelVolume(vtkMRMLScene* scene, vtkMRMLColorTableNode* colorNode)
+{
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(48, 48, 24);
+  imageData->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  unsigned char* voxels = static_cast<unsigned char*>(imageData->GetScalarPointer());
+  for (int k = 0; k < 24; ++k)
+  {
+    for (int j = 0; j < 48; ++j)
+    {
+      for (int i = 0; i < 48; ++i)
+      {
+        *(voxels++) = (i > 10 && i < 30 && j > 5 && j < 40) ? (k < 12 ? 1 : 2) : 0;
+      }
+    }
+  }
+
+  vtkNew<vtkMRMLLabelMapVolumeDisplayNode> displayNode;
+  scene->AddNode(displayNode);
+  displayNode->SetAndObserveColorNodeID(colorNode->GetID());
+
+  vtkNew<vtkMRMLLabelMapVolumeNode> volumeNode;
+  volumeNode->SetSpacing(2.0, 2.0, 2.5);
+  volumeNode->SetOrigin(-40.0, -40.0, -30.0);
+  volumeNode->SetAndObserveImageData(imageData);
+  scene->AddNode(volumeNode);
+  volumeNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+  return volumeNode;
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> GetSliceImage(vtkMRMLSliceLogic* sliceLogic, int repeat)
+{
+  vtkAlgorithmOutput* imagePort = sliceLogic->GetImageDataConnection();
+  if (!imagePort)
+  {
+    return nullptr;
+  }
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  for (int i = 0; i < repeat; ++i)
+  {
+    // Force re-execution of the entire slice pipeline
+    sliceLogic->GetBackgroundLayer()->GetVolumeNode()->GetImageData()->Modified();
+    imagePort->GetProducer()->Update(imagePort->GetIndex());
+  }
+  timer->StopTimer();
+  std::cout << (sliceLogic->GetFusedBlendingActive() ? "Fused" : "Default") << " slice pipeline: "
+    << timer->GetElapsedTime() / repeat * 1000.0 << "ms" << std::endl;
+  vtkSmartPointer<vtkImageData> sliceImage = vtkSmartPointer<vtkImageData>::New();
+  sliceImage->DeepCopy(imagePort->GetProducer()->GetOutputDataObject(imagePort->GetIndex()));
+  return sliceImage;
+}
+
+//----------------------------------------------------------------------------
+int CompareSliceImages(vtkMRMLSliceLogic* sliceLogic)
+{
+  sliceLogic->SetFusedBlending(false);
+  CHECK_BOOL(sliceLogic->GetFusedBlendingActive(), false);
+  vtkSmartPointer<vtkImageData> defaultImage = GetSliceImage(sliceLogic, 10);
+  sliceLogic->SetFusedBlending(true);
+  CHECK_BOOL(sliceLogic->GetFusedBlendingActive(), true);
+  vtkSmartPointer<vtkImageData> fusedImage = GetSliceImage(sliceLogic, 10);
+  CHECK_NOT_NULL(defaultImage);
+  CHECK_NOT_NULL(fusedImage);
+
+  int* defaultDimensions = defaultImage->GetDimensions();
+  int* fusedDimensions = fusedImage->GetDimensions();
+  for (int i = 0; i < 3; ++i)
+  {
+    CHECK_INT(fusedDimensions[i], defaultDimensions[i]);
+  }
+  CHECK_INT(fusedImage->GetNumberOfScalarComponents(), 4);
+  CHECK_INT(fusedImage->GetScalarType(), VTK_UNSIGNED_CHAR);
+
+  // Small differences are allowed because of rounding and at the volume boundaries
+  const unsigned char* defaultVoxels = static_cast<unsigned char*>(defaultImage->GetScalarPointer());
+  const unsigned char* fusedVoxels = static_cast<unsigned char*>(fusedImage->GetScalarPointer());
+  vtkIdType numberOfPixels = defaultImage->GetNumberOfPoints();
+  vtkIdType numberOfDifferentPixels = 0;
+  for (vtkIdType i = 0; i < numberOfPixels * 4; i += 4)
+  {
+    for (int c = 0; c < 4; ++c)
+    {
+      if (std::abs(static_cast<int>(defaultVoxels[i + c]) - static_cast<int>(fusedVoxels[i + c])) > 3)
+      {
+        ++numberOfDifferentPixels;
+        break;
+      }
+    }
+  }
+  std::cout << "Number of different pixels: " << numberOfDifferentPixels << " / " << numberOfPixels << std::endl;
+  CHECK_BOOL(numberOfDifferentPixels <= numberOfPixels / 100, true);
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLSliceLogicFusedBlendingTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLSliceNode::AddDefaultSliceOrientationPresets(scene);
+
+  vtkNew<vtkMRMLSliceLogic> sliceLogic;
+  sliceLogic->SetMRMLScene(scene);
+  vtkMRMLSliceNode* sliceNode = sliceLogic->AddSliceNode("Red");
+  CHECK_NOT_NULL(sliceNode);
+  sliceNode->SetSliceResolutionMode(vtkMRMLSliceNode::SliceResolutionMatch2DView);
+  sliceLogic->ResizeSliceNode(400, 300);
+  CHECK_BOOL(sliceLogic->GetFusedBlending(), false);
+
+  vtkNew<vtkMRMLColorTableNode> greyColorNode;
+  greyColorNode->SetTypeToGrey();
+  scene->AddNode(greyColorNode);
+  vtkNew<vtkMRMLColorTableNode> labelColorNode;
+  labelColorNode->SetTypeToUser();
+  labelColorNode->SetNumberOfColors(3);
+  labelColorNode->SetColor(0, "background", 0.0, 0.0, 0.0, 0.0);
+  labelColorNode->SetColor(1, "red", 1.0, 0.0, 0.0, 1.0);
+  labelColorNode->SetColor(2, "green", 0.0, 1.0, 0.0, 1.0);
+  scene->AddNode(labelColorNode);
+
+  vtkMRMLScalarVolumeNode* backgroundVolume = AddScalarVolume(scene, greyColorNode, 0.0);
+  vtkMRMLScalarVolumeNode* foregroundVolume = AddScalarVolume(scene, greyColorNode, 300.0);
+  vtkMRMLLabelMapVolumeNode* labelVolume = AddLabelVolume(scene, labelColorNode);
+  vtkMRMLScalarVolumeDisplayNode* foregroundDisplayNode =
+    vtkMRMLScalarVolumeDisplayNode::SafeDownCast(foregroundVolume->GetDisplayNode());
+  foregroundDisplayNode->SetInterpolate(false);
+  foregroundDisplayNode->SetThreshold(400, 900);
+  foregroundDisplayNode->SetApplyThreshold(true);
+
+  vtkMRMLSliceCompositeNode* sliceCompositeNode = sliceLogic->GetSliceCompositeNode();
+  sliceCompositeNode->SetBackgroundVolumeID(backgroundVolume->GetID());
+  sliceCompositeNode->SetForegroundVolumeID(foregroundVolume->GetID());
+  sliceCompositeNode->SetLabelVolumeID(labelVolume->GetID());
+  sliceCompositeNode->SetForegroundOpacity(0.4);
+  sliceCompositeNode->SetLabelOpacity(0.7);
+  sliceNode->SetUseLabelOutline(false);
+  sliceLogic->FitSliceToAll();
+
+  // Axial slice
+  CHECK_EXIT_SUCCESS(CompareSliceImages(sliceLogic));
+
+  // Oblique slice with reverse alpha blending and no clipping to background
+  vtkNew<vtkTransform> rotation;
+  rotation->RotateX(25.0);
+  rotation->RotateZ(-10.0);
+  vtkNew<vtkMatrix4x4> sliceToRAS;
+  vtkMatrix4x4::Multiply4x4(rotation->GetMatrix(), sliceNode->GetSliceToRAS(), sliceToRAS);
+  sliceNode->GetSliceToRAS()->DeepCopy(sliceToRAS);
+  sliceNode->UpdateMatrices();
+  sliceCompositeNode->SetCompositing(vtkMRMLSliceCompositeNode::ReverseAlpha);
+  sliceCompositeNode->SetClipToBackgroundVolume(false);
+  CHECK_EXIT_SUCCESS(CompareSliceImages(sliceLogic));
+
+  // Unsupported cases use the default pipeline
+  sliceCompositeNode->SetCompositing(vtkMRMLSliceCompositeNode::Add);
+  CHECK_BOOL(sliceLogic->GetFusedBlendingActive(), false);
+  sliceCompositeNode->SetCompositing(vtkMRMLSliceCompositeNode::Alpha);
+  CHECK_BOOL(sliceLogic->GetFusedBlendingActive(), true);
+  sliceNode->SetUseLabelOutline(true);
+  CHECK_BOOL(sliceLogic->GetFusedBlendingActive(), false);
+  sliceNode->SetUseLabelOutline(false);
+  CHECK_BOOL(sliceLogic->GetFusedBlendingActive(), true);
+
+  sliceLogic->SetFusedBlending(false);
+  CHECK_BOOL(sliceLogic->GetFusedBlendingActive(), false);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,615 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkImageFusedSliceBlend.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkLookupTable.h>
+#include <vtkMatrix4x4.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+vtkStandardNewMacro(vtkImageFusedSliceBlend);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+struct LayerParameters
+{
+  LayerParameters()
+  {
+    vtkMatrix4x4::Identity(this->XYToIJK);
+  }
+  double XYToIJK[16];
+  vtkSmartPointer<vtkScalarsToColors> LookupTable;
+  bool LabelMap{ false };
+  double Window{ 255.0 };
+  double Level{ 127.5 };
+  bool ApplyThreshold{ false };
+  double LowerThreshold{ 0.0 };
+  double UpperThreshold{ 0.0 };
+  bool Interpolate{ false };
+  double Opacity{ 1.0 };
+};
+
+//----------------------------------------------------------------------------
+// Layer information that is prepared before the parallel execution
+struct LayerData
+{
+  const void* Scalars{ nullptr };
+  int ScalarType{ VTK_VOID };
+  int Extent[6];
+  vtkIdType Increments[3];
+  double XYToIJK[16];
+  bool Interpolate{ false };
+  double Opacity{ 1.0 };
+
+  bool LabelMap{ false };
+  vtkSmartPointer<vtkLookupTable> LabelLookupTable;
+
+  // Same computation as in vtkImageMapToWindowLevelColors
+  double Shift{ 0.0 };
+  double Scale{ 1.0 };
+  double LowerValue{ 0.0 };
+  double UpperValue{ 255.0 };
+  unsigned char LowerLuminance{ 0 };
+  unsigned char UpperLuminance{ 255 };
+  bool ApplyThreshold{ false };
+  double LowerThreshold{ 0.0 };
+  double UpperThreshold{ 0.0 };
+  unsigned char Colors[256][4];
+};
+
+//----------------------------------------------------------------------------
+// Sample a row of the output image from a layer the same way as vtkImageReslice.
+// Points within half voxel of the volume boundary are inside, outside points are set to 0.
+template <class T>
+void SampleRow(const LayerData& layer, int xMin, int xMax, int y, int z, double* values, unsigned char* inside)
+{
+  const T* scalars = static_cast<const T*>(layer.Scalars);
+  const double* m = layer.XYToIJK;
+  const int* ext = layer.Extent;
+  const vtkIdType* inc = layer.Increments;
+  double point[3] =
+  {
+    m[0] * xMin + m[1] * y + m[2] * z + m[3],
+    m[4] * xMin + m[5] * y + m[6] * z + m[7],
+    m[8] * xMin + m[9] * y + m[10] * z + m[11]
+  };
+  const double step[3] = { m[0], m[4], m[8] };
+  const bool roundToInteger = std::numeric_limits<T>::is_integer;
+
+  for (int x = xMin; x <= xMax; ++x, point[0] += step[0], point[1] += step[1], point[2] += step[2])
+  {
+    double* value = values + (x - xMin);
+    unsigned char* isInside = inside + (x - xMin);
+    if (point[0] < ext[0] - 0.5 || point[0] > ext[1] + 0.5
+      || point[1] < ext[2] - 0.5 || point[1] > ext[3] + 0.5
+      || point[2] < ext[4] - 0.5 || point[2] > ext[5] + 0.5)
+    {
+      *value = 0.0;
+      *isInside = 0;
+      continue;
+    }
+    *isInside = 1;
+    if (!layer.Interpolate)
+    {
+      vtkIdType offset = 0;
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        int index = static_cast<int>(std::floor(point[axis] + 0.5));
+        index = std::min(std::max(index, ext[2 * axis]), ext[2 * axis + 1]);
+        offset += (index - ext[2 * axis]) * inc[axis];
+      }
+      *value = static_cast<double>(scalars[offset]);
+      continue;
+    }
+
+    vtkIdType offsets[3][2];
+    double weights[3][2];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      double floorPosition = std::floor(point[axis]);
+      double fraction = point[axis] - floorPosition;
+      int index0 = static_cast<int>(floorPosition);
+      int index1 = std::min(std::max(index0 + 1, ext[2 * axis]), ext[2 * axis + 1]);
+      index0 = std::min(std::max(index0, ext[2 * axis]), ext[2 * axis + 1]);
+      offsets[axis][0] = (index0 - ext[2 * axis]) * inc[axis];
+      offsets[axis][1] = (index1 - ext[2 * axis]) * inc[axis];
+      weights[axis][0] = 1.0 - fraction;
+      weights[axis][1] = fraction;
+    }
+    double interpolated = 0.0;
+    for (int k = 0; k < 2; ++k)
+    {
+      for (int j = 0; j < 2; ++j)
+      {
+        double weightJK = weights[1][j] * weights[2][k];
+        if (weightJK == 0.0)
+        {
+          continue;
+        }
+        const T* rowPtr = scalars + offsets[1][j] + offsets[2][k];
+        interpolated += weightJK * (weights[0][0] * rowPtr[offsets[0][0]] + weights[0][1] * rowPtr[offsets[0][1]]);
+      }
+    }
+    *value = roundToInteger ? std::floor(interpolated + 0.5) : interpolated;
+  }
+}
+
+//----------------------------------------------------------------------------
+void SampleLayerRow(const LayerData& layer, int xMin, int xMax, int y, int z, double* values, unsigned char* inside)
+{
+  switch (layer.ScalarType)
+  {
+    vtkTemplateMacro(SampleRow<VTK_TT>(layer, xMin, xMax, y, z, values, inside));
+    default:
+      std::fill(values, values + (xMax - xMin + 1), 0.0);
+      std::fill(inside, inside + (xMax - xMin + 1), 0);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Map values to RGBA the same way as vtkMRMLScalarVolumeDisplayNode or
+// vtkMRMLLabelMapVolumeDisplayNode image data pipeline
+void MapLayerRow(const LayerData& layer, int numberOfPixels, const double* values,
+  const unsigned char* inside, unsigned char* rgba)
+{
+  if (layer.LabelMap)
+  {
+    vtkLookupTable* lut = layer.LabelLookupTable;
+    vtkIdType maxIndex = lut->GetNumberOfTableValues() - 1;
+    double lastValue = std::numeric_limits<double>::quiet_NaN();
+    const unsigned char* lastColor = nullptr;
+    for (int i = 0; i < numberOfPixels; ++i, rgba += 4)
+    {
+      // label values are spatially coherent, avoid repeated lookups
+      if (values[i] != lastValue || !lastColor)
+      {
+        vtkIdType index = std::min(std::max(lut->GetIndex(values[i]), vtkIdType(0)), maxIndex);
+        lastColor = lut->GetPointer(index);
+        lastValue = values[i];
+      }
+      std::copy(lastColor, lastColor + 4, rgba);
+    }
+    return;
+  }
+
+  for (int i = 0; i < numberOfPixels; ++i, rgba += 4)
+  {
+    double value = values[i];
+    unsigned char luminance;
+    if (value <= layer.LowerValue)
+    {
+      luminance = layer.LowerLuminance;
+    }
+    else if (value >= layer.UpperValue)
+    {
+      luminance = layer.UpperLuminance;
+    }
+    else
+    {
+      luminance = static_cast<unsigned char>((value + layer.Shift) * layer.Scale);
+    }
+    const unsigned char* color = layer.Colors[luminance];
+    rgba[0] = color[0];
+    rgba[1] = color[1];
+    rgba[2] = color[2];
+    bool visible = inside[i] && color[3] != 0
+      && (!layer.ApplyThreshold || (value >= layer.LowerThreshold && value <= layer.UpperThreshold));
+    rgba[3] = visible ? 255 : 0;
+  }
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+class vtkImageFusedSliceBlend::vtkInternal
+{
+public:
+  std::vector<LayerParameters> Layers;
+
+  LayerParameters* GetLayer(vtkImageFusedSliceBlend* self, int layer)
+  {
+    if (layer < 0 || layer >= static_cast<int>(this->Layers.size()))
+    {
+      vtkErrorWithObjectMacro(self, "Invalid layer index: " << layer);
+      return nullptr;
+    }
+    return &this->Layers[layer];
+  }
+};
+
+//----------------------------------------------------------------------------
+vtkImageFusedSliceBlend::vtkImageFusedSliceBlend()
+{
+  this->Internal = new vtkInternal;
+  this->OutputExtent[0] = this->OutputExtent[2] = this->OutputExtent[4] = 0;
+  this->OutputExtent[1] = this->OutputExtent[3] = this->OutputExtent[5] = 0;
+  this->BlendAlpha = false;
+  this->SetNumberOfInputPorts(1);
+}
+
+//----------------------------------------------------------------------------
+vtkImageFusedSliceBlend::~vtkImageFusedSliceBlend()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFusedSliceBlend::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "OutputExtent: " << this->OutputExtent[0] << " " << this->OutputExtent[1] << " "
+    << this->OutputExtent[2] << " " << this->OutputExtent[3] << " "
+    << this->OutputExtent[4] << " " << this->OutputExtent[5] << "\n";
+  os << indent << "BlendAlpha: " << (this->BlendAlpha ? "true" : "false") << "\n";
+  os << indent << "NumberOfLayers: " << this->Internal->Layers.size() << "\n";
+  for (const LayerParameters& layer : this->Internal->Layers)
+  {
+    os << indent.GetNextIndent() << (layer.LabelMap ? "Label map" : "Scalar")
+      << " layer: window=" << layer.Window << " level=" << layer.Level
+      << " threshold=" << (layer.ApplyThreshold ? "on" : "off")
+      << " interpolate=" << (layer.Interpolate ? "on" : "off")
+      << " opacity=" << layer.Opacity << "\n";
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFusedSliceBlend::SetNumberOfLayers(int numberOfLayers)
+{
+  if (numberOfLayers < 0 || numberOfLayers == static_cast<int>(this->Internal->Layers.size()))
+  {
+    return;
+  }
+  this->Internal->Layers.resize(numberOfLayers);
+  this->SetNumberOfInputConnections(0, numberOfLayers);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkImageFusedSliceBlend::GetNumberOfLayers()
+{
+  return static_cast<int>(this->Internal->Layers.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFusedSliceBlend::SetLayerXYToIJKMatrix(int layerIndex, vtkMatrix4x4* xyToIJK)
+{
+  LayerParameters* layer = this->Internal->GetLayer(this, layerIndex);
+  if (!layer || !xyToIJK)
+  {
+    return;
+  }
+  const double* elements = xyToIJK->GetData();
+  if (std::equal(elements, elements + 16, layer->XYToIJK))
+  {
+    return;
+  }
+  std::copy(elements, elements + 16, layer->XYToIJK);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFusedSliceBlend::SetLayerLookupTable(int layerIndex, vtkScalarsToColors* lookupTable)
+{
+  LayerParameters* layer = this->Internal->GetLayer(this, layerIndex);
+  if (!layer || layer->LookupTable == lookupTable)
+  {
+    return;
+  }
+  layer->LookupTable = lookupTable;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFusedSliceBlend::SetLayerLabelMap(int layerIndex, bool labelMap)
+{
+  LayerParameters* layer = this->Internal->GetLayer(this, layerIndex);
+  if (!layer || layer->LabelMap == labelMap)
+  {
+    return;
+  }
+  layer->LabelMap = labelMap;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFusedSliceBlend::SetLayerWindowLevel(int layerIndex, double window, double level)
+{
+  LayerParameters* layer = this->Internal->GetLayer(this, layerIndex);
+  if (!layer || (layer->Window == window && layer->Level == level))
+  {
+    return;
+  }
+  layer->Window = window;
+  layer->Level = level;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFusedSliceBlend::SetLayerThreshold(int layerIndex, bool applyThreshold, double lower, double upper)
+{
+  LayerParameters* layer = this->Internal->GetLayer(this, layerIndex);
+  if (!layer || (layer->ApplyThreshold == applyThreshold
+    && layer->LowerThreshold == lower && layer->UpperThreshold == upper))
+  {
+    return;
+  }
+  layer->ApplyThreshold = applyThreshold;
+  layer->LowerThreshold = lower;
+  layer->UpperThreshold = upper;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFusedSliceBlend::SetLayerInterpolate(int layerIndex, bool interpolate)
+{
+  LayerParameters* layer = this->Internal->GetLayer(this, layerIndex);
+  if (!layer || layer->Interpolate == interpolate)
+  {
+    return;
+  }
+  layer->Interpolate = interpolate;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFusedSliceBlend::SetLayerOpacity(int layerIndex, double opacity)
+{
+  LayerParameters* layer = this->Internal->GetLayer(this, layerIndex);
+  if (!layer || layer->Opacity == opacity)
+  {
+    return;
+  }
+  layer->Opacity = opacity;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkImageFusedSliceBlend::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  for (const LayerParameters& layer : this->Internal->Layers)
+  {
+    if (layer.LookupTable)
+    {
+      mTime = std::max(mTime, layer.LookupTable->GetMTime());
+    }
+  }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageFusedSliceBlend::FillInputPortInformation(int port, vtkInformation* info)
+{
+  if (!this->Superclass::FillInputPortInformation(port, info))
+  {
+    return 0;
+  }
+  info->Set(vtkAlgorithm::INPUT_IS_REPEATABLE(), 1);
+  info->Set(vtkAlgorithm::INPUT_IS_OPTIONAL(), 1);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageFusedSliceBlend::RequestInformation(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** vtkNotUsed(inputVector), vtkInformationVector* outputVector)
+{
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), this->OutputExtent, 6);
+  outInfo->Set(vtkDataObject::SPACING(), spacing, 3);
+  outInfo->Set(vtkDataObject::ORIGIN(), origin, 3);
+  vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_UNSIGNED_CHAR, 4);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageFusedSliceBlend::RequestUpdateExtent(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* vtkNotUsed(outputVector))
+{
+  // Any voxel of the input volumes may be needed for reslicing
+  int numberOfInputs = inputVector[0]->GetNumberOfInformationObjects();
+  for (int inputIndex = 0; inputIndex < numberOfInputs; ++inputIndex)
+  {
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(inputIndex);
+    if (inInfo->Has(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()))
+    {
+      inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+        inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
+    }
+  }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageFusedSliceBlend::RequestData(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkImageData* output = vtkImageData::GetData(outInfo);
+  int outExt[6] = { 0, -1, 0, -1, 0, -1 };
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outExt);
+  this->AllocateOutputData(output, outInfo, outExt);
+  if (outExt[0] > outExt[1] || outExt[2] > outExt[3] || outExt[4] > outExt[5])
+  {
+    return 1;
+  }
+  unsigned char* outPtr = static_cast<unsigned char*>(output->GetScalarPointerForExtent(outExt));
+  vtkIdType outIncrements[3] = { 0, 0, 0 };
+  output->GetIncrements(outIncrements);
+
+  // Prepare layers that have valid input
+  std::vector<LayerData> layers;
+  int numberOfInputs = inputVector[0]->GetNumberOfInformationObjects();
+  for (int layerIndex = 0; layerIndex < this->GetNumberOfLayers() && layerIndex < numberOfInputs; ++layerIndex)
+  {
+    const LayerParameters& parameters = this->Internal->Layers[layerIndex];
+    vtkImageData* image = vtkImageData::GetData(inputVector[0], layerIndex);
+    if (!image || !image->GetPointData()->GetScalars() || image->GetNumberOfScalarComponents() != 1)
+    {
+      continue;
+    }
+    int* extent = image->GetExtent();
+    if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+    {
+      continue;
+    }
+
+    LayerData layer;
+    layer.Scalars = image->GetScalarPointer();
+    layer.ScalarType = image->GetScalarType();
+    std::copy(extent, extent + 6, layer.Extent);
+    image->GetIncrements(layer.Increments);
+    std::copy(parameters.XYToIJK, parameters.XYToIJK + 16, layer.XYToIJK);
+    layer.Interpolate = parameters.Interpolate;
+    layer.Opacity = parameters.Opacity;
+    layer.LabelMap = parameters.LabelMap;
+
+    if (parameters.LabelMap)
+    {
+      vtkLookupTable* lookupTable = vtkLookupTable::SafeDownCast(parameters.LookupTable);
+      if (!lookupTable || lookupTable->GetNumberOfTableValues() == 0)
+      {
+        vtkErrorMacro("RequestData: label map layer " << layerIndex << " requires a non-empty vtkLookupTable");
+        continue;
+      }
+      // Same range adjustment as in vtkMRMLLabelMapVolumeDisplayNode: 1:1 mapping of label values to colors
+      layer.LabelLookupTable = lookupTable;
+      if ((lookupTable->GetTableRange()[1] - lookupTable->GetTableRange()[0] + 1) != lookupTable->GetNumberOfTableValues())
+      {
+        layer.LabelLookupTable = vtkSmartPointer<vtkLookupTable>::New();
+        layer.LabelLookupTable->DeepCopy(lookupTable);
+        layer.LabelLookupTable->SetTableRange(0, lookupTable->GetNumberOfTableValues() - 1);
+      }
+    }
+    else
+    {
+      double window = parameters.Window;
+      double level = parameters.Level;
+      layer.Shift = window / 2.0 - level;
+      layer.Scale = 255.0 / window;
+      layer.LowerValue = level - std::fabs(window) / 2.0;
+      layer.UpperValue = level + std::fabs(window) / 2.0;
+      layer.LowerLuminance = (window >= 0 ? 0 : 255);
+      layer.UpperLuminance = (window >= 0 ? 255 : 0);
+      layer.ApplyThreshold = parameters.ApplyThreshold;
+      layer.LowerThreshold = parameters.LowerThreshold;
+      layer.UpperThreshold = parameters.UpperThreshold;
+
+      // Same range adjustment as in vtkMRMLScalarVolumeDisplayNode: table range matches window/level output
+      vtkSmartPointer<vtkScalarsToColors> lookupTable = parameters.LookupTable;
+      if (lookupTable && (lookupTable->GetRange()[0] != 0.0 || lookupTable->GetRange()[1] != 255.0))
+      {
+        lookupTable = vtkSmartPointer<vtkScalarsToColors>::Take(parameters.LookupTable->NewInstance());
+        lookupTable->DeepCopy(parameters.LookupTable);
+        lookupTable->SetRange(0, 255);
+      }
+      for (int luminance = 0; luminance < 256; ++luminance)
+      {
+        if (lookupTable)
+        {
+          const unsigned char* color = lookupTable->MapValue(luminance);
+          std::copy(color, color + 4, layer.Colors[luminance]);
+        }
+        else
+        {
+          std::fill(layer.Colors[luminance], layer.Colors[luminance] + 3, static_cast<unsigned char>(luminance));
+          layer.Colors[luminance][3] = 255;
+        }
+      }
+    }
+    layers.push_back(layer);
+  }
+
+  int numberOfPixelsInRow = outExt[1] - outExt[0] + 1;
+  int numberOfRowsInSlice = outExt[3] - outExt[2] + 1;
+  vtkIdType numberOfRows = static_cast<vtkIdType>(numberOfRowsInSlice) * (outExt[5] - outExt[4] + 1);
+  if (layers.empty())
+  {
+    for (vtkIdType row = 0; row < numberOfRows; ++row)
+    {
+      int y = static_cast<int>(row % numberOfRowsInSlice);
+      int z = static_cast<int>(row / numberOfRowsInSlice);
+      std::fill(outPtr + y * outIncrements[1] + z * outIncrements[2],
+        outPtr + y * outIncrements[1] + z * outIncrements[2] + 4 * numberOfPixelsInRow, 0);
+    }
+    return 1;
+  }
+
+  const bool blendAlpha = this->BlendAlpha;
+  vtkSMPTools::For(0, numberOfRows, [&](vtkIdType firstRow, vtkIdType lastRow)
+  {
+    std::vector<double> values(numberOfPixelsInRow);
+    std::vector<unsigned char> inside(numberOfPixelsInRow);
+    std::vector<unsigned char> layerRGBA(4 * numberOfPixelsInRow);
+    std::vector<double> blendedRGBA(4 * numberOfPixelsInRow);
+    for (vtkIdType row = firstRow; row < lastRow; ++row)
+    {
+      int y = outExt[2] + static_cast<int>(row % numberOfRowsInSlice);
+      int z = outExt[4] + static_cast<int>(row / numberOfRowsInSlice);
+      for (size_t layerIndex = 0; layerIndex < layers.size(); ++layerIndex)
+      {
+        const LayerData& layer = layers[layerIndex];
+        SampleLayerRow(layer, outExt[0], outExt[1], y, z, values.data(), inside.data());
+        MapLayerRow(layer, numberOfPixelsInRow, values.data(), inside.data(), layerRGBA.data());
+        if (layerIndex == 0)
+        {
+          // First layer is copied, same as in vtkImageBlend
+          std::copy(layerRGBA.begin(), layerRGBA.end(), blendedRGBA.begin());
+          continue;
+        }
+        if (layer.Opacity <= 0.0)
+        {
+          continue;
+        }
+        for (int i = 0; i < 4 * numberOfPixelsInRow; i += 4)
+        {
+          double r = layer.Opacity * layerRGBA[i + 3] / 255.0;
+          double f = 1.0 - r;
+          blendedRGBA[i] = blendedRGBA[i] * f + layerRGBA[i] * r;
+          blendedRGBA[i + 1] = blendedRGBA[i + 1] * f + layerRGBA[i + 1] * r;
+          blendedRGBA[i + 2] = blendedRGBA[i + 2] * f + layerRGBA[i + 2] * r;
+          if (blendAlpha)
+          {
+            blendedRGBA[i + 3] = blendedRGBA[i + 3] * f + layerRGBA[i + 3] * r;
+          }
+        }
+      }
+      unsigned char* outRowPtr = outPtr + (y - outExt[2]) * outIncrements[1] + (z - outExt[4]) * outIncrements[2];
+      for (int i = 0; i < 4 * numberOfPixelsInRow; ++i)
+      {
+        outRowPtr[i] = static_cast<unsigned char>(std::min(std::max(blendedRGBA[i], 0.0), 255.0) + 0.5);
+      }
+    }
+  });
+
+  return 1;
+}
@@ -0,0 +1,109 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkImageFusedSliceBlend_h
+#define __vtkImageFusedSliceBlend_h
+
+// VTK includes
+#include <vtkImageAlgorithm.h>
+
+#include "vtkMRMLLogicExport.h"
+
+class vtkMatrix4x4;
+class vtkScalarsToColors;
+
+/// \brief Reslice, map to colors and blend multiple volumes in a single pass.
+///
+/// Computes the same RGBA slice image as the default slice view pipeline
+/// (vtkImageReslice, window/level, lookup table, threshold, and vtkImageBlend)
+/// for scalar volumes and label maps, but without allocating intermediate images.
+/// Each input connection of port 0 is a layer, the first layer is copied
+/// to the output and the following layers are blended on top of it.
+///
+/// Only linear reslice transforms and nearest neighbor or linear interpolation
+/// are supported. vtkMRMLSliceLogic falls back to the default pipeline when
+/// a layer cannot be displayed by this filter.
+/// \sa vtkMRMLSliceLogic::SetFusedBlending
+class VTK_MRML_LOGIC_EXPORT vtkImageFusedSliceBlend : public vtkImageAlgorithm
+{
+public:
+  static vtkImageFusedSliceBlend *New();
+  vtkTypeMacro(vtkImageFusedSliceBlend, vtkImageAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Set number of layers. Layer input image data must be set using
+  /// SetNthInputConnection(0, layerIndex, ...).
+  void SetNumberOfLayers(int numberOfLayers);
+  int GetNumberOfLayers();
+
+  /// Transform from output (XY) to input (IJK) voxel coordinates.
+  void SetLayerXYToIJKMatrix(int layer, vtkMatrix4x4* xyToIJK);
+
+  /// Lookup table that maps window/level output (0..255) to colors.
+  /// For label maps, voxel values are mapped directly.
+  void SetLayerLookupTable(int layer, vtkScalarsToColors* lookupTable);
+
+  /// If enabled then voxel values are mapped directly through the
+  /// lookup table (no window/level, threshold, or clipping to the volume extent).
+  void SetLayerLabelMap(int layer, bool labelMap);
+
+  void SetLayerWindowLevel(int layer, double window, double level);
+
+  /// Voxels outside of the [lower, upper] range are transparent if threshold is applied.
+  void SetLayerThreshold(int layer, bool applyThreshold, double lower, double upper);
+
+  /// Use linear interpolation. Nearest neighbor interpolation is used if disabled.
+  void SetLayerInterpolate(int layer, bool interpolate);
+
+  /// Opacity of the layer. Ignored for the first layer.
+  void SetLayerOpacity(int layer, double opacity);
+
+  /// Extent of the output image
+  vtkSetVector6Macro(OutputExtent, int);
+  vtkGetVector6Macro(OutputExtent, int);
+
+  /// Blend alpha channel of the layers. If disabled then the alpha channel
+  /// of the first layer is used, same as vtkImageBlend::BlendAlpha.
+  vtkSetMacro(BlendAlpha, bool);
+  vtkGetMacro(BlendAlpha, bool);
+  vtkBooleanMacro(BlendAlpha, bool);
+
+  /// Reimplemented to take into account modification of lookup tables.
+  vtkMTimeType GetMTime() override;
+
+protected:
+  vtkImageFusedSliceBlend();
+  ~vtkImageFusedSliceBlend() override;
+
+  int FillInputPortInformation(int port, vtkInformation* info) override;
+  int RequestInformation(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+  int RequestUpdateExtent(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+
+  int OutputExtent[6];
+  bool BlendAlpha;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkImageFusedSliceBlend(const vtkImageFusedSliceBlend&) = delete;
+  void operator=(const vtkImageFusedSliceBlend&) = delete;
+};
+
+#endif
@@ -0,0 +1,290 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkImageLabelMapToRGBA.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkLookupTable.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+vtkStandardNewMacro(vtkImageLabelMapToRGBA);
+vtkCxxSetObjectMacro(vtkImageLabelMapToRGBA, FillLookupTable, vtkLookupTable);
+vtkCxxSetObjectMacro(vtkImageLabelMapToRGBA, OutlineLookupTable, vtkLookupTable);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Colors of all labels in the range of a lookup table, so that the lookup table
+/// is not accessed from multiple threads. Values outside of the table range are
+/// clamped, same as in vtkLookupTable.
+class LabelColorTable
+{
+public:
+  void Build(vtkLookupTable* lookupTable)
+  {
+    // Limit memory usage if the table range is unexpectedly large
+    const long long maximumNumberOfLabels = 1 << 20;
+    if (!lookupTable)
+    {
+      this->Minimum = 0;
+      this->Colors.assign(4, 0);
+      return;
+    }
+    const double* range = lookupTable->GetTableRange();
+    this->Minimum = static_cast<long long>(std::floor(range[0]));
+    long long maximum = static_cast<long long>(std::ceil(range[1]));
+    maximum = std::max(this->Minimum, std::min(maximum, this->Minimum + maximumNumberOfLabels - 1));
+    this->Colors.resize(4 * (maximum - this->Minimum + 1));
+    for (long long label = this->Minimum; label <= maximum; ++label)
+    {
+      const unsigned char* color = lookupTable->MapValue(static_cast<double>(label));
+      std::copy(color, color + 4, this->Colors.begin() + 4 * (label - this->Minimum));
+    }
+  }
+
+  template <class T>
+  const unsigned char* GetColor(T value) const
+  {
+    double label = std::floor(static_cast<double>(value)) - static_cast<double>(this->Minimum);
+    long long numberOfLabels = static_cast<long long>(this->Colors.size() / 4);
+    long long index = (label <= 0.0 ? 0 : (label >= numberOfLabels - 1 ? numberOfLabels - 1 : static_cast<long long>(label)));
+    return this->Colors.data() + 4 * index;
+  }
+
+protected:
+  long long Minimum{ 0 };
+  std::vector<unsigned char> Colors;
+};
+
+//----------------------------------------------------------------------------
+/// Computes fill and outline colors of a row. Outline is computed the same way as in
+/// vtkImageLabelOutline: a non-background pixel is part of the outline if there is
+/// a pixel with different value or the image boundary within the outline thickness
+/// in the same slice.
+template <class T>
+void MapRow(vtkImageData* input, const int inExt[6], int y, int z, T background, int outline,
+  const LabelColorTable* fillColors, const LabelColorTable* outlineColors,
+  unsigned char* fillPtr, unsigned char* outlinePtr)
+{
+  vtkIdType inIncrements[3] = { 0, 0, 0 };
+  input->GetIncrements(inIncrements);
+  const T* inPtr = static_cast<const T*>(input->GetScalarPointer(inExt[0], y, z));
+  const unsigned char* outlineBackgroundColor = outlineColors ? outlineColors->GetColor(background) : nullptr;
+  for (int x = inExt[0]; x <= inExt[1]; ++x, inPtr += inIncrements[0])
+  {
+    const T value = *inPtr;
+    if (fillColors)
+    {
+      const unsigned char* color = fillColors->GetColor(value);
+      std::copy(color, color + 4, fillPtr);
+      fillPtr += 4;
+    }
+    if (!outlineColors)
+    {
+      continue;
+    }
+    bool isOutline = false;
+    if (value != background)
+    {
+      if (x - outline < inExt[0] || x + outline > inExt[1] || y - outline < inExt[2] || y + outline > inExt[3])
+      {
+        // neighborhood reaches outside of the input domain
+        isOutline = true;
+      }
+      for (int hoodY = -outline; hoodY <= outline && !isOutline; ++hoodY)
+      {
+        const T* hoodPtr = inPtr + hoodY * inIncrements[1] - outline * inIncrements[0];
+        for (int hoodX = -outline; hoodX <= outline; ++hoodX, hoodPtr += inIncrements[0])
+        {
+          if (*hoodPtr != value)
+          {
+            isOutline = true;
+            break;
+          }
+        }
+      }
+    }
+    const unsigned char* color = isOutline ? outlineColors->GetColor(value) : outlineBackgroundColor;
+    std::copy(color, color + 4, outlinePtr);
+    outlinePtr += 4;
+  }
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+vtkImageLabelMapToRGBA::vtkImageLabelMapToRGBA()
+{
+  this->FillLookupTable = nullptr;
+  this->OutlineLookupTable = nullptr;
+  this->Background = 0.0;
+  this->Outline = 1;
+  this->GenerateFill = true;
+  this->GenerateOutline = true;
+  this->SetNumberOfOutputPorts(2);
+}
+
+//----------------------------------------------------------------------------
+vtkImageLabelMapToRGBA::~vtkImageLabelMapToRGBA()
+{
+  this->SetFillLookupTable(nullptr);
+  this->SetOutlineLookupTable(nullptr);
+}
+
+//----------------------------------------------------------------------------
+void vtkImageLabelMapToRGBA::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FillLookupTable: " << this->FillLookupTable << "\n";
+  os << indent << "OutlineLookupTable: " << this->OutlineLookupTable << "\n";
+  os << indent << "Background: " << this->Background << "\n";
+  os << indent << "Outline: " << this->Outline << "\n";
+  os << indent << "GenerateFill: " << (this->GenerateFill ? "true" : "false") << "\n";
+  os << indent << "GenerateOutline: " << (this->GenerateOutline ? "true" : "false") << "\n";
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkImageLabelMapToRGBA::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->FillLookupTable)
+  {
+    mTime = std::max(mTime, this->FillLookupTable->GetMTime());
+  }
+  if (this->OutlineLookupTable)
+  {
+    mTime = std::max(mTime, this->OutlineLookupTable->GetMTime());
+  }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLabelMapToRGBA::RequestInformation(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** vtkNotUsed(inputVector), vtkInformationVector* outputVector)
+{
+  // Extent, origin, and spacing are copied from the input by the executive
+  for (int port = 0; port < this->GetNumberOfOutputPorts(); ++port)
+  {
+    vtkDataObject::SetPointDataActiveScalarInfo(outputVector->GetInformationObject(port), VTK_UNSIGNED_CHAR, 4);
+  }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLabelMapToRGBA::RequestUpdateExtent(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* vtkNotUsed(outputVector))
+{
+  // Outline of a pixel depends on its neighbors, the input is small (a slice), therefore
+  // the whole input is requested
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+    inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLabelMapToRGBA::RequestData(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkImageData* input = vtkImageData::GetData(inputVector[0]);
+  vtkImageData* fillOutput = vtkImageData::GetData(outputVector, 0);
+  vtkImageData* outlineOutput = vtkImageData::GetData(outputVector, 1);
+  if (!input || !fillOutput || !outlineOutput)
+  {
+    vtkErrorMacro("RequestData: invalid input or output");
+    return 0;
+  }
+
+  int inExt[6] = { 0, -1, 0, -1, 0, -1 };
+  input->GetExtent(inExt);
+  for (vtkImageData* output : { fillOutput, outlineOutput })
+  {
+    output->SetExtent(inExt);
+    output->AllocateScalars(VTK_UNSIGNED_CHAR, 4);
+  }
+  if (inExt[0] > inExt[1] || inExt[2] > inExt[3] || inExt[4] > inExt[5])
+  {
+    return 1;
+  }
+  if (!input->GetPointData()->GetScalars() || input->GetNumberOfScalarComponents() != 1)
+  {
+    vtkErrorMacro("RequestData: input image with a single scalar component is required");
+    return 0;
+  }
+
+  // Disabled outputs are transparent
+  LabelColorTable fillColors;
+  LabelColorTable outlineColors;
+  if (this->GenerateFill)
+  {
+    fillColors.Build(this->FillLookupTable);
+  }
+  else
+  {
+    memset(fillOutput->GetScalarPointer(), 0, fillOutput->GetPointData()->GetScalars()->GetDataSize());
+  }
+  if (this->GenerateOutline)
+  {
+    outlineColors.Build(this->OutlineLookupTable);
+  }
+  else
+  {
+    memset(outlineOutput->GetScalarPointer(), 0, outlineOutput->GetPointData()->GetScalars()->GetDataSize());
+  }
+  if (!this->GenerateFill && !this->GenerateOutline)
+  {
+    return 1;
+  }
+
+  const int numberOfPixelsInRow = inExt[1] - inExt[0] + 1;
+  const int numberOfRowsInSlice = inExt[3] - inExt[2] + 1;
+  const vtkIdType numberOfRows = static_cast<vtkIdType>(numberOfRowsInSlice) * (inExt[5] - inExt[4] + 1);
+  unsigned char* fillPtr = static_cast<unsigned char*>(fillOutput->GetScalarPointer());
+  unsigned char* outlinePtr = static_cast<unsigned char*>(outlineOutput->GetScalarPointer());
+  const LabelColorTable* fillColorsPtr = this->GenerateFill ? &fillColors : nullptr;
+  const LabelColorTable* outlineColorsPtr = this->GenerateOutline ? &outlineColors : nullptr;
+  const int outline = this->Outline;
+  const double background = this->Background;
+
+  vtkSMPTools::For(0, numberOfRows, [&](vtkIdType firstRow, vtkIdType lastRow)
+  {
+    for (vtkIdType row = firstRow; row < lastRow; ++row)
+    {
+      int y = inExt[2] + static_cast<int>(row % numberOfRowsInSlice);
+      int z = inExt[4] + static_cast<int>(row / numberOfRowsInSlice);
+      vtkIdType outOffset = 4 * row * numberOfPixelsInRow;
+      switch (input->GetScalarType())
+      {
+        vtkTemplateMacro(MapRow<VTK_TT>(input, inExt, y, z, static_cast<VTK_TT>(background), outline,
+          fillColorsPtr, outlineColorsPtr, fillPtr + outOffset, outlinePtr + outOffset));
+      }
+    }
+  });
+
+  return 1;
+}
@@ -0,0 +1,97 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkImageLabelMapToRGBA_h
+#define __vtkImageLabelMapToRGBA_h
+
+// VTK includes
+#include <vtkImageAlgorithm.h>
+
+#include "vtkMRMLLogicExport.h"
+
+class vtkLookupTable;
+
+/// \brief Map a label map to filled and outlined RGBA images in a single pass.
+///
+/// Computes the same images as vtkImageMapToRGBA applied to the input (fill, output port 0)
+/// and vtkImageMapToRGBA applied to the output of vtkImageLabelOutline (outline, output port 1),
+/// without allocating intermediate images. Each label is mapped to a color and opacity
+/// using the fill and outline lookup tables, therefore all the segments stored in the
+/// same label map can be displayed using a single filter.
+class VTK_MRML_LOGIC_EXPORT vtkImageLabelMapToRGBA : public vtkImageAlgorithm
+{
+public:
+  static vtkImageLabelMapToRGBA *New();
+  vtkTypeMacro(vtkImageLabelMapToRGBA, vtkImageAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Lookup table that maps label values to fill colors
+  void SetFillLookupTable(vtkLookupTable* lookupTable);
+  vtkGetObjectMacro(FillLookupTable, vtkLookupTable);
+
+  /// Lookup table that maps label values to outline colors
+  void SetOutlineLookupTable(vtkLookupTable* lookupTable);
+  vtkGetObjectMacro(OutlineLookupTable, vtkLookupTable);
+
+  /// Background pixel value in the image (usually 0)
+  vtkSetMacro(Background, double);
+  vtkGetMacro(Background, double);
+
+  /// Thickness of the outline in pixels
+  vtkSetClampMacro(Outline, int, 1, VTK_INT_MAX);
+  vtkGetMacro(Outline, int);
+
+  /// If disabled then the fill output is transparent.
+  /// Allows skipping computation of images that are not displayed.
+  vtkSetMacro(GenerateFill, bool);
+  vtkGetMacro(GenerateFill, bool);
+  vtkBooleanMacro(GenerateFill, bool);
+
+  /// If disabled then the outline output is transparent.
+  /// Allows skipping computation of images that are not displayed.
+  vtkSetMacro(GenerateOutline, bool);
+  vtkGetMacro(GenerateOutline, bool);
+  vtkBooleanMacro(GenerateOutline, bool);
+
+  vtkAlgorithmOutput* GetFillOutputPort() { return this->GetOutputPort(0); }
+  vtkAlgorithmOutput* GetOutlineOutputPort() { return this->GetOutputPort(1); }
+
+  /// Reimplemented to take into account modification of lookup tables.
+  vtkMTimeType GetMTime() override;
+
+protected:
+  vtkImageLabelMapToRGBA();
+  ~vtkImageLabelMapToRGBA() override;
+
+  int RequestInformation(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+  int RequestUpdateExtent(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+
+  vtkLookupTable* FillLookupTable;
+  vtkLookupTable* OutlineLookupTable;
+  double Background;
+  int Outline;
+  bool GenerateFill;
+  bool GenerateOutline;
+
+private:
+  vtkImageLabelMapToRGBA(const vtkImageLabelMapToRGBA&) = delete;
+  void operator=(const vtkImageLabelMapToRGBA&) = delete;
+};
+
+#endif
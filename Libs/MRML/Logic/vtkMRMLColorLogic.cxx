@@ -451,7 +451,7 @@ vtkMRMLColorNode* vtkMRMLColorLogic::LoadColorFile(const char *fileName, const c
 vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateLabelsNode()
 {
   vtkMRMLColorTableNode *labelsNode = vtkMRMLColorTableNode::New();
-  labelsNode->SetTypeToLabels();
+  labelsNode->SetTypeDeferred(vtkMRMLColorTableNode::Labels);
   labelsNode->SetAttribute("Category", "Discrete");
   labelsNode->SaveWithSceneOff();
   labelsNode->SetName(labelsNode->GetTypeAsString());
@@ -463,7 +463,8 @@ vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateLabelsNode()
 vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateDefaultTableNode(int type)
 {
   vtkMRMLColorTableNode *node = vtkMRMLColorTableNode::New();
-  node->SetType(type);
+  // colors are only built when the table is used
+  node->SetTypeDeferred(type);
   const char* typeName = node->GetTypeAsString();
   if (strstr(typeName, "Tint") != nullptr)
   {
@@ -587,7 +588,9 @@ vtkMRMLdGEMRICProceduralColorNode* vtkMRMLColorLogic::CreatedGEMRICColorNode(int
 //---------------------------------------------------------------------------------
 vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateDefaultFileNode(const std::string& colorFileName)
 {
-  vtkMRMLColorTableNode* ctnode = this->CreateFileNode(colorFileName.c_str());
+  // default color files are distributed with the application, so it is safe
+  // to defer reading them until the color table is used
+  vtkMRMLColorTableNode* ctnode = this->CreateFileNode(colorFileName.c_str(), true);
 
   if (!ctnode)
   {
@@ -637,10 +640,17 @@ std::vector<std::string> vtkMRMLColorLogic::FindUserColorFiles()
 }
 
 //--------------------------------------------------------------------------------
-vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateFileNode(const char* fileName)
+vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateFileNode(const char* fileName, bool deferReading/*=false*/)
 {
   vtkMRMLColorTableNode * ctnode =  vtkMRMLColorTableNode::New();
-  ctnode->SetTypeToFile();
+  if (deferReading)
+  {
+    ctnode->SetTypeDeferred(vtkMRMLColorTableNode::File);
+  }
+  else
+  {
+    ctnode->SetTypeToFile();
+  }
   ctnode->SaveWithSceneOff();
   ctnode->HideFromEditorsOn();
   ctnode->SetScene(this->GetMRMLScene());
@@ -665,6 +675,13 @@ vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateFileNode(const char* fileName)
   {
     ctnode->SetName(basename.c_str());
   }
+  if (deferReading)
+  {
+    ctnode->SetSingletonTag(
+      this->GetFileColorNodeSingletonTag(fileName).c_str());
+    return ctnode;
+  }
+
   vtkDebugMacro("CreateFileNode: About to read user file " << fileName);
 
   if (ctnode->GetStorageNode()->ReadData(ctnode) == 0)
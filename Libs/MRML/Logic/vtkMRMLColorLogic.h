@@ -228,7 +228,11 @@ protected:
   vtkMRMLdGEMRICProceduralColorNode* CreatedGEMRICColorNode(int type);
   vtkMRMLColorTableNode* CreateDefaultFileNode(const std::string& colorname);
   vtkMRMLColorTableNode* CreateUserFileNode(const std::string& colorname);
-  vtkMRMLColorTableNode* CreateFileNode(const char* fileName);
+  /// Create a color table node and a storage node for the color file.
+  /// If \a deferReading is true then the file is only read when the color table
+  /// is first accessed, otherwise the file is read immediately and nullptr
+  /// is returned if reading fails.
+  vtkMRMLColorTableNode* CreateFileNode(const char* fileName, bool deferReading = false);
   vtkMRMLProceduralColorNode* CreateProceduralFileNode(const char* fileName);
 
   void AddLabelsNode();
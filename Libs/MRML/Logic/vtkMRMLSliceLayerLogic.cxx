@@ -32,6 +32,7 @@
 #include <vtkDiffusionTensorMathematics.h>
 #include <vtkFloatArray.h>
 #include <vtkGeneralTransform.h>
+#include <vtkGridTransform.h>
 #include <vtkImageData.h>
 #include <vtkImageReslice.h>
 #include <vtkInformation.h>
@@ -40,9 +41,12 @@
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
 #include <vtkTrivialProducer.h>
 #include <vtkTransform.h>
 #include <vtkVersion.h>
+#include <vtkWeakPointer.h>
 #include <vtkAddonMathUtilities.h>
 
 //
@@ -50,10 +54,57 @@
 
 // STD includes
 #include <algorithm>
+#include <vector>
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkMRMLSliceLayerLogic);
 
+//----------------------------------------------------------------------------
+class vtkMRMLSliceLayerLogic::vtkInternal
+{
+public:
+  /// Transform of a node in the parent transform chain of the volume,
+  /// used for detecting changes that invalidate the baked transform.
+  struct TransformState
+  {
+    vtkWeakPointer<vtkMRMLTransformNode> Node;
+    vtkWeakPointer<vtkAbstractTransform> Transform;
+    vtkMTimeType TransformMTime{ 0 };
+
+    bool operator==(const TransformState& other) const
+    {
+      return this->Node == other.Node && this->Transform == other.Transform
+        && this->TransformMTime == other.TransformMTime;
+    }
+  };
+
+  static std::vector<TransformState> GetTransformStates(vtkMRMLTransformNode* transformNode)
+  {
+    std::vector<TransformState> states;
+    for (vtkMRMLTransformNode* node = transformNode; node; node = node->GetParentTransformNode())
+    {
+      TransformState state;
+      state.Node = node;
+      state.Transform = node->GetTransformToParent();
+      state.TransformMTime = state.Transform ? state.Transform->GetMTime() : 0;
+      states.push_back(state);
+    }
+    return states;
+  }
+
+  void ClearBakedTransform()
+  {
+    this->BakedTransform = nullptr;
+    this->BakedTransformStates.clear();
+  }
+
+  vtkSmartPointer<vtkGridTransform> BakedTransform;
+  std::vector<TransformState> BakedTransformStates;
+  double BakedVolumeIJKToRAS[16] = { 0.0 };
+  int BakedVolumeExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  int BakedGridSize{ 0 };
+};
+
 bool AreMatricesEqual(const vtkMatrix4x4* first, const vtkMatrix4x4* second)
 {
   return vtkAddonMathUtilities::MatrixAreEqual(first, second);
@@ -149,6 +200,11 @@ vtkMRMLSliceLayerLogic::vtkMRMLSliceLayerLogic()
   this->UpdatingTransforms = 0;
 
   this->InterpolationMode = VTK_RESLICE_LINEAR;
+
+  this->BakeNonLinearTransform = false;
+  this->BakedTransformGridSize = 64;
+  this->NumberOfBakedTransformUpdates = 0;
+  this->Internal = new vtkInternal;
 }
 
 //----------------------------------------------------------------------------
@@ -197,6 +253,7 @@ vtkMRMLSliceLayerLogic::~vtkMRMLSliceLayerLogic()
     this->VolumeDisplayNodeUVW->Delete();
   }
 
+  delete this->Internal;
 }
 
 //---------------------------------------------------------------------------
@@ -520,7 +577,21 @@ void vtkMRMLSliceLayerLogic::UpdateTransforms()
   {
     // Apply the transform, if it exists
     vtkMRMLTransformNode *transformNode = this->VolumeNode->GetParentTransformNode();
-    if ( transformNode != nullptr )
+    vtkAbstractTransform* bakedTransformFromWorld = nullptr;
+    if (transformNode != nullptr && this->BakeNonLinearTransform && !transformNode->IsTransformToWorldLinear())
+    {
+      bakedTransformFromWorld = this->GetBakedTransformFromWorld(transformNode);
+    }
+    else
+    {
+      this->Internal->ClearBakedTransform();
+    }
+    if (bakedTransformFromWorld != nullptr)
+    {
+      this->XYToIJKTransform->Concatenate(bakedTransformFromWorld);
+      this->UVWToIJKTransform->Concatenate(bakedTransformFromWorld);
+    }
+    else if ( transformNode != nullptr )
     {
       vtkNew<vtkGeneralTransform> worldTransform;
       worldTransform->Identity();
@@ -597,6 +668,118 @@ void vtkMRMLSliceLayerLogic::UpdateTransforms()
   }
 }
 
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkMRMLSliceLayerLogic::GetBakedTransformFromWorld(vtkMRMLTransformNode* transformNode)
+{
+  vtkImageData* imageData = this->VolumeNode ? this->VolumeNode->GetImageData() : nullptr;
+  if (!transformNode || !imageData)
+  {
+    this->Internal->ClearBakedTransform();
+    return nullptr;
+  }
+
+  // Reuse the baked transform if neither the transforms nor the volume geometry changed
+  std::vector<vtkInternal::TransformState> transformStates = vtkInternal::GetTransformStates(transformNode);
+  vtkNew<vtkMatrix4x4> ijkToRAS;
+  this->VolumeNode->GetIJKToRASMatrix(ijkToRAS);
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  imageData->GetExtent(extent);
+  if (this->Internal->BakedTransform
+    && this->Internal->BakedGridSize == this->BakedTransformGridSize
+    && this->Internal->BakedTransformStates == transformStates
+    && std::equal(extent, extent + 6, this->Internal->BakedVolumeExtent)
+    && std::equal(ijkToRAS->GetData(), ijkToRAS->GetData() + 16, this->Internal->BakedVolumeIJKToRAS))
+  {
+    return this->Internal->BakedTransform;
+  }
+  this->Internal->ClearBakedTransform();
+
+  // The grid covers the transformed volume with some margin, as slices
+  // may sample beyond the volume boundary where the displacement is still relevant
+  double bounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+  this->VolumeNode->GetRASBounds(bounds);
+  if (bounds[0] > bounds[1] || bounds[2] > bounds[3] || bounds[4] > bounds[5])
+  {
+    return nullptr;
+  }
+  const double marginFactor = 0.1;
+  const int gridSize = this->BakedTransformGridSize;
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    double size = bounds[axis * 2 + 1] - bounds[axis * 2];
+    double margin = std::max(size * marginFactor, 1.0);
+    origin[axis] = bounds[axis * 2] - margin;
+    spacing[axis] = (size + 2 * margin) / (gridSize - 1);
+  }
+
+  vtkNew<vtkGeneralTransform> transformFromWorld;
+  transformNode->GetTransformFromWorld(transformFromWorld);
+  // Update the transform before it is evaluated from multiple threads
+  transformFromWorld->Update();
+
+  vtkNew<vtkImageData> displacementGrid;
+  displacementGrid->SetOrigin(origin);
+  displacementGrid->SetSpacing(spacing);
+  displacementGrid->SetDimensions(gridSize, gridSize, gridSize);
+  displacementGrid->AllocateScalars(VTK_DOUBLE, 3);
+  double* displacements = static_cast<double*>(displacementGrid->GetScalarPointer());
+  vtkSMPTools::For(0, gridSize, [&](vtkIdType firstSlice, vtkIdType lastSlice)
+  {
+    for (vtkIdType k = firstSlice; k < lastSlice; ++k)
+    {
+      double* displacement = displacements + 3 * k * gridSize * gridSize;
+      for (int j = 0; j < gridSize; ++j)
+      {
+        for (int i = 0; i < gridSize; ++i, displacement += 3)
+        {
+          double point[3] = { origin[0] + i * spacing[0], origin[1] + j * spacing[1], origin[2] + k * spacing[2] };
+          double transformedPoint[3] = { 0.0, 0.0, 0.0 };
+          transformFromWorld->TransformPoint(point, transformedPoint);
+          for (int axis = 0; axis < 3; ++axis)
+          {
+            displacement[axis] = transformedPoint[axis] - point[axis];
+          }
+        }
+      }
+    }
+  });
+
+  this->Internal->BakedTransform = vtkSmartPointer<vtkGridTransform>::New();
+  this->Internal->BakedTransform->SetDisplacementGridData(displacementGrid);
+  this->Internal->BakedTransform->SetInterpolationModeToLinear();
+  this->Internal->BakedTransformStates = transformStates;
+  this->Internal->BakedGridSize = gridSize;
+  std::copy(extent, extent + 6, this->Internal->BakedVolumeExtent);
+  std::copy(ijkToRAS->GetData(), ijkToRAS->GetData() + 16, this->Internal->BakedVolumeIJKToRAS);
+  this->NumberOfBakedTransformUpdates++;
+  return this->Internal->BakedTransform;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::SetBakeNonLinearTransform(bool bake)
+{
+  if (this->BakeNonLinearTransform == bake)
+  {
+    return;
+  }
+  this->BakeNonLinearTransform = bake;
+  this->UpdateTransforms();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::SetBakedTransformGridSize(int size)
+{
+  size = std::max(2, std::min(size, 512));
+  if (this->BakedTransformGridSize == size)
+  {
+    return;
+  }
+  this->BakedTransformGridSize = size;
+  this->UpdateTransforms();
+}
+
 //----------------------------------------------------------------------------
 vtkImageData* vtkMRMLSliceLayerLogic::GetImageData()
 {
@@ -996,6 +1179,8 @@ void vtkMRMLSliceLayerLogic::PrintSelf(ostream& os, vtkIndent indent)
     os << indent << " (0)\n";
   }
 
+  os << indent << "BakeNonLinearTransform: " << (this->BakeNonLinearTransform ? "true" : "false") << "\n";
+  os << indent << "BakedTransformGridSize: " << this->BakedTransformGridSize << "\n";
   os << indent << "IsLabelLayer: " << this->GetIsLabelLayer() << "\n";
   os << indent << "LabelOutline:\n";
   if (this->LabelOutline)
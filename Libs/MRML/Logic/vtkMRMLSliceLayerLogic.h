@@ -47,9 +47,11 @@
 #include <vtkImageExtractComponents.h>
 #include <vtkVersion.h>
 
+class vtkAbstractTransform;
 class vtkAssignAttribute;
 class vtkImageReslice;
 class vtkGeneralTransform;
+class vtkMRMLTransformNode;
 
 // STL includes
 //#include <cstdlib>
@@ -135,6 +137,29 @@ public:
   vtkGetMacro(InterpolationMode, int);
   vtkSetMacro(InterpolationMode, int);
 
+  ///
+  /// If enabled then non-linear parent transforms of the volume are baked into a
+  /// displacement grid that covers the volume region, instead of evaluating the full
+  /// transform chain (e.g., thin-plate spline) at each resliced pixel.
+  /// This makes reslicing much faster at the cost of a small interpolation error.
+  /// The grid is recomputed only when the transforms or the volume geometry change.
+  /// Disabled by default.
+  vtkGetMacro(BakeNonLinearTransform, bool);
+  void SetBakeNonLinearTransform(bool bake);
+  vtkBooleanMacro(BakeNonLinearTransform, bool);
+
+  ///
+  /// Number of displacement grid points along each axis of the region
+  /// where non-linear transforms are baked. Default is 64.
+  /// \sa SetBakeNonLinearTransform()
+  vtkGetMacro(BakedTransformGridSize, int);
+  void SetBakedTransformGridSize(int size);
+
+  ///
+  /// Number of times the non-linear transform was baked into a displacement grid.
+  /// Used for testing that the baked transform is reused.
+  vtkGetMacro(NumberOfBakedTransformUpdates, int);
+
 protected:
   vtkMRMLSliceLayerLogic();
   ~vtkMRMLSliceLayerLogic() override;
@@ -189,6 +214,18 @@ protected:
   int UpdatingTransforms;
 
   int InterpolationMode;
+
+  bool BakeNonLinearTransform;
+  int BakedTransformGridSize;
+  int NumberOfBakedTransformUpdates;
+
+  /// Return the transform from world to the volume RAS coordinate system, baked into
+  /// a displacement grid. The grid is reused if the transforms and the volume did not change.
+  vtkAbstractTransform* GetBakedTransformFromWorld(vtkMRMLTransformNode* transformNode);
+
+private:
+  class vtkInternal;
+  vtkInternal* Internal;
 };
 
 #endif
@@ -13,6 +13,7 @@
 =========================================================================auto=*/
 
 // MRMLLogic includes
+#include "vtkImageFusedSliceBlend.h"
 #include "vtkMRMLApplicationLogic.h"
 #include "vtkMRMLSliceLogic.h"
 #include "vtkMRMLSliceLayerLogic.h"
@@ -22,6 +23,7 @@
 #include <vtkMRMLCrosshairNode.h>
 #include <vtkMRMLDiffusionTensorVolumeSliceDisplayNode.h>
 #include <vtkMRMLGlyphableVolumeDisplayNode.h>
+#include <vtkMRMLLabelMapVolumeDisplayNode.h>
 #include <vtkMRMLLinearTransformNode.h>
 #include <vtkMRMLModelNode.h>
 #include <vtkMRMLProceduralColorNode.h>
@@ -45,6 +47,8 @@
 #include <vtkImageReslice.h>
 #include <vtkImageThreshold.h>
 #include <vtkInformation.h>
+#include <vtkLinearTransform.h>
+#include <vtkLookupTable.h>
 #include <vtkMath.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
@@ -60,6 +64,7 @@
 
 // STD includes
 #include <algorithm>
+#include <cstring>
 
 //----------------------------------------------------------------------------
 const int vtkMRMLSliceLogic::SLICE_INDEX_ROTATED=-1;
@@ -79,6 +84,79 @@ struct SliceLayerInfo
   double Opacity;
 };
 
+//----------------------------------------------------------------------------
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkScalarsToColors* GetDisplayNodeLookupTable(vtkMRMLDisplayNode* displayNode)
+{
+  vtkMRMLColorNode* colorNode = displayNode ? displayNode->GetColorNode() : nullptr;
+  if (!colorNode)
+  {
+    return nullptr;
+  }
+  if (colorNode->GetLookupTable())
+  {
+    return colorNode->GetLookupTable();
+  }
+  vtkMRMLProceduralColorNode* proceduralColorNode = vtkMRMLProceduralColorNode::SafeDownCast(colorNode);
+  return proceduralColorNode ? proceduralColorNode->GetColorTransferFunction() : nullptr;
+}
+
+//----------------------------------------------------------------------------
+/// Returns true if the layer can be displayed using vtkImageFusedSliceBlend.
+/// Vector, tensor, and other derived display node types, non-linear transforms,
+/// label outline, and slab reconstruction require the default pipeline.
+bool IsFusedBlendingSupported(vtkMRMLSliceLayerLogic* layer)
+{
+  vtkMRMLVolumeNode* volumeNode = layer->GetVolumeNode();
+  vtkMRMLVolumeDisplayNode* displayNode = layer->GetVolumeDisplayNode();
+  if (!volumeNode || !volumeNode->GetImageData() || !volumeNode->GetImageDataConnection() || !displayNode)
+  {
+    return false;
+  }
+  if (volumeNode->GetImageData()->GetNumberOfScalarComponents() != 1)
+  {
+    return false;
+  }
+  vtkImageReslice* reslice = layer->GetReslice();
+  if (!vtkLinearTransform::SafeDownCast(reslice->GetResliceTransform())
+    || reslice->GetResliceAxes() != nullptr
+    || reslice->GetSlabNumberOfSlices() > 1)
+  {
+    return false;
+  }
+  if (strcmp(displayNode->GetClassName(), "vtkMRMLLabelMapVolumeDisplayNode") == 0)
+  {
+    vtkMRMLSliceNode* sliceNode = layer->GetSliceNode();
+    if (layer->GetIsLabelLayer() && sliceNode && sliceNode->GetUseLabelOutline())
+    {
+      return false;
+    }
+    vtkLookupTable* lookupTable = vtkLookupTable::SafeDownCast(GetDisplayNodeLookupTable(displayNode));
+    return (lookupTable && lookupTable->GetNumberOfTableValues() > 0);
+  }
+  if (strcmp(displayNode->GetClassName(), "vtkMRMLScalarVolumeDisplayNode") == 0)
+  {
+    vtkMRMLScalarVolumeDisplayNode* scalarDisplayNode = vtkMRMLScalarVolumeDisplayNode::SafeDownCast(displayNode);
+    if (scalarDisplayNode->GetScalarRangeFlag() == vtkMRMLDisplayNode::UseDirectMapping)
+    {
+      return false;
+    }
+    if (scalarDisplayNode->GetInterpolate()
+      && layer->GetInterpolationMode() != VTK_RESLICE_LINEAR
+      && layer->GetInterpolationMode() != VTK_RESLICE_NEAREST)
+    {
+      return false;
+    }
+    return true;
+  }
+  return false;
+}
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 struct BlendPipeline
 {
@@ -243,6 +321,10 @@ vtkMRMLSliceLogic::vtkMRMLSliceLogic()
   this->ExtractModelTexture->SetOutputDimensionality (2);
   this->ExtractModelTexture->SetInputConnection(this->PipelineUVW->Blend->GetOutputPort());
 
+  this->FusedBlend = vtkImageFusedSliceBlend::New();
+  this->FusedBlending = false;
+  this->FusedBlendingActive = false;
+
   this->SliceModelNode = nullptr;
   this->SliceModelTransformNode = nullptr;
   this->SliceModelDisplayNode = nullptr;
@@ -270,6 +352,12 @@ vtkMRMLSliceLogic::~vtkMRMLSliceLogic()
     this->ExtractModelTexture = nullptr;
   }
 
+  if (this->FusedBlend)
+  {
+    this->FusedBlend->Delete();
+    this->FusedBlend = nullptr;
+  }
+
   this->SetBackgroundLayer (nullptr);
   this->SetForegroundLayer (nullptr);
   this->SetLabelLayer (nullptr);
@@ -888,10 +976,13 @@ vtkAlgorithmOutput * vtkMRMLSliceLogic::GetImageDataConnection()
 //----------------------------------------------------------------------------
 void vtkMRMLSliceLogic::UpdateImageData ()
 {
+  // The fused blending filter replaces the 2D view pipeline if all layers are supported
+  vtkAlgorithmOutput* blendOutputPort = this->FusedBlendingActive ?
+    this->FusedBlend->GetOutputPort() : this->Pipeline->Blend->GetOutputPort();
   if (this->SliceNode->GetSliceResolutionMode() == vtkMRMLSliceNode::SliceResolutionMatch2DView)
   {
-    this->ExtractModelTexture->SetInputConnection( this->Pipeline->Blend->GetOutputPort() );
-    this->ImageDataConnection = this->Pipeline->Blend->GetOutputPort();
+    this->ExtractModelTexture->SetInputConnection( blendOutputPort );
+    this->ImageDataConnection = blendOutputPort;
   }
   else
   {
@@ -904,9 +995,10 @@ void vtkMRMLSliceLogic::UpdateImageData ()
        (this->GetForegroundLayer() != nullptr && this->GetForegroundLayer()->GetImageDataConnection() != nullptr) ||
        (this->GetLabelLayer() != nullptr && this->GetLabelLayer()->GetImageDataConnection() != nullptr) )
   {
-    if (this->ImageDataConnection == nullptr || this->Pipeline->Blend->GetOutputPort()->GetMTime() > this->ImageDataConnection->GetMTime())
+    if (this->ImageDataConnection == nullptr || this->ImageDataConnection != blendOutputPort
+      || blendOutputPort->GetMTime() > this->ImageDataConnection->GetMTime())
     {
-      this->ImageDataConnection = this->Pipeline->Blend->GetOutputPort();
+      this->ImageDataConnection = blendOutputPort;
     }
   }
   else
@@ -990,6 +1082,124 @@ bool vtkMRMLSliceLogic::UpdateFractions(vtkImageMathematics* fraction, double op
   return modified;
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLogic::SetFusedBlending(bool fusedBlending)
+{
+  if (this->FusedBlending == fusedBlending)
+  {
+    return;
+  }
+  this->FusedBlending = fusedBlending;
+  this->Modified();
+  this->UpdatePipeline();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLSliceLogic::UpdateFusedBlend(bool& modified)
+{
+  vtkMTimeType oldFusedBlendMTime = this->FusedBlend->GetMTime();
+  modified = false;
+
+  // Same layer order and opacities as in BlendPipeline::AddLayers
+  std::deque<std::pair<vtkMRMLSliceLayerLogic*, double> > layers;
+  bool supported = (this->FusedBlending && this->SliceCompositeNode != nullptr);
+  if (supported)
+  {
+    int compositing = this->SliceCompositeNode->GetCompositing();
+    vtkMRMLSliceLayerLogic* backgroundLayer =
+      (this->BackgroundLayer && this->BackgroundLayer->GetImageDataConnection()) ? this->BackgroundLayer : nullptr;
+    vtkMRMLSliceLayerLogic* foregroundLayer =
+      (this->ForegroundLayer && this->ForegroundLayer->GetImageDataConnection()) ? this->ForegroundLayer : nullptr;
+    vtkMRMLSliceLayerLogic* labelLayer =
+      (this->LabelLayer && this->LabelLayer->GetImageDataConnection()) ? this->LabelLayer : nullptr;
+    if ((compositing == vtkMRMLSliceCompositeNode::Add || compositing == vtkMRMLSliceCompositeNode::Subtract)
+      && (!backgroundLayer || !foregroundLayer))
+    {
+      // not enough inputs for add/subtract, alpha blending is used
+      compositing = vtkMRMLSliceCompositeNode::Alpha;
+    }
+    double foregroundOpacity = this->SliceCompositeNode->GetForegroundOpacity();
+    if (compositing == vtkMRMLSliceCompositeNode::Alpha)
+    {
+      if (backgroundLayer)
+      {
+        layers.emplace_back(backgroundLayer, 1.0);
+      }
+      if (foregroundLayer)
+      {
+        layers.emplace_back(foregroundLayer, foregroundOpacity);
+      }
+    }
+    else if (compositing == vtkMRMLSliceCompositeNode::ReverseAlpha)
+    {
+      if (foregroundLayer)
+      {
+        layers.emplace_back(foregroundLayer, 1.0);
+      }
+      if (backgroundLayer)
+      {
+        layers.emplace_back(backgroundLayer, foregroundOpacity);
+      }
+    }
+    else
+    {
+      supported = false;
+    }
+    if (labelLayer)
+    {
+      layers.emplace_back(labelLayer, this->SliceCompositeNode->GetLabelOpacity());
+    }
+    supported = supported && !layers.empty();
+    for (const std::pair<vtkMRMLSliceLayerLogic*, double>& layer : layers)
+    {
+      supported = supported && IsFusedBlendingSupported(layer.first);
+    }
+  }
+
+  if (!supported)
+  {
+    // Release references to the volumes
+    this->FusedBlend->SetNumberOfLayers(0);
+    modified = (this->FusedBlend->GetMTime() > oldFusedBlendMTime);
+    return false;
+  }
+
+  this->FusedBlend->SetNumberOfLayers(static_cast<int>(layers.size()));
+  this->FusedBlend->SetOutputExtent(layers.front().first->GetReslice()->GetOutputExtent());
+  this->FusedBlend->SetBlendAlpha(!this->SliceCompositeNode->GetClipToBackgroundVolume());
+  int layerIndex = 0;
+  for (std::deque<std::pair<vtkMRMLSliceLayerLogic*, double> >::const_iterator layerIt = layers.begin();
+    layerIt != layers.end(); ++layerIt, ++layerIndex)
+  {
+    vtkMRMLSliceLayerLogic* layer = layerIt->first;
+    vtkMRMLVolumeDisplayNode* displayNode = layer->GetVolumeDisplayNode();
+    vtkMRMLScalarVolumeDisplayNode* scalarDisplayNode = vtkMRMLScalarVolumeDisplayNode::SafeDownCast(displayNode);
+    bool labelMap = (vtkMRMLLabelMapVolumeDisplayNode::SafeDownCast(displayNode) != nullptr);
+
+    this->FusedBlend->SetNthInputConnection(0, layerIndex, layer->GetVolumeNode()->GetImageDataConnection());
+    this->FusedBlend->SetLayerXYToIJKMatrix(layerIndex,
+      vtkLinearTransform::SafeDownCast(layer->GetReslice()->GetResliceTransform())->GetMatrix());
+    this->FusedBlend->SetLayerLookupTable(layerIndex, GetDisplayNodeLookupTable(displayNode));
+    this->FusedBlend->SetLayerLabelMap(layerIndex, labelMap);
+    this->FusedBlend->SetLayerOpacity(layerIndex, layerIt->second);
+    if (labelMap)
+    {
+      this->FusedBlend->SetLayerInterpolate(layerIndex, false);
+    }
+    else
+    {
+      this->FusedBlend->SetLayerInterpolate(layerIndex,
+        scalarDisplayNode->GetInterpolate() && layer->GetInterpolationMode() == VTK_RESLICE_LINEAR);
+      this->FusedBlend->SetLayerWindowLevel(layerIndex, scalarDisplayNode->GetWindow(), scalarDisplayNode->GetLevel());
+      this->FusedBlend->SetLayerThreshold(layerIndex, scalarDisplayNode->GetApplyThreshold(),
+        scalarDisplayNode->GetLowerThreshold(), scalarDisplayNode->GetUpperThreshold());
+    }
+  }
+
+  modified = (this->FusedBlend->GetMTime() > oldFusedBlendMTime);
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLSliceLogic::UpdateReconstructionSlab(vtkMRMLSliceLogic* sliceLogic, vtkMRMLSliceLayerLogic* sliceLayerLogic)
 {
@@ -1142,6 +1352,14 @@ void vtkMRMLSliceLogic::UpdatePipeline()
       modified = 1;
     }
 
+    bool fusedBlendModified = false;
+    bool fusedBlendingActive = this->UpdateFusedBlend(fusedBlendModified);
+    if (fusedBlendModified || fusedBlendingActive != this->FusedBlendingActive)
+    {
+      this->FusedBlendingActive = fusedBlendingActive;
+      modified = 1;
+    }
+
     //Models
     this->UpdateImageData();
     vtkMRMLDisplayNode* displayNode = this->SliceModelNode ? this->SliceModelNode->GetModelDisplayNode() : nullptr;
@@ -1261,6 +1479,9 @@ void vtkMRMLSliceLogic::PrintSelf(ostream& os, vtkIndent indent)
     os << indent << "BlendUVW: (none)\n";
   }
 
+  os << indent << "FusedBlending: " << (this->FusedBlending ? "true" : "false") << "\n";
+  os << indent << "FusedBlendingActive: " << (this->FusedBlendingActive ? "true" : "false") << "\n";
+
   os << indent << "SLICE_MODEL_NODE_NAME_SUFFIX: " << this->SLICE_MODEL_NODE_NAME_SUFFIX << "\n";
 
 }
@@ -35,6 +35,7 @@ class vtkMRMLVolumeNode;
 class vtkAlgorithmOutput;
 class vtkCollection;
 class vtkImageBlend;
+class vtkImageFusedSliceBlend;
 class vtkTransform;
 class vtkImageData;
 class vtkImageMathematics;
@@ -179,6 +180,20 @@ public:
   /// Internally used by UpdatePipeline
   void UpdateImageData();
 
+  ///
+  /// Compute the slice image with a single-pass reslice, color mapping, and
+  /// blending filter (vtkImageFusedSliceBlend) instead of the multi-stage
+  /// imaging pipeline. It is only used if all displayed layers are scalar volumes
+  /// or label maps with linear transform and the compositing mode is alpha blending,
+  /// otherwise the default pipeline is used. Disabled by default.
+  void SetFusedBlending(bool fusedBlending);
+  vtkGetMacro(FusedBlending, bool);
+  vtkBooleanMacro(FusedBlending, bool);
+
+  ///
+  /// Returns true if the slice image is currently computed by the fused blending filter.
+  vtkGetMacro(FusedBlendingActive, bool);
+
   /// Reimplemented to avoid calling ProcessMRMLSceneEvents when we are adding the
   /// MRMLModelNode into the scene
   virtual bool EnterMRMLCallback() const;
@@ -444,6 +459,11 @@ protected:
   /// Helper to update foreground opacity when adding/subtracting the background layer
   bool UpdateFractions(vtkImageMathematics* fraction, double opacity);
 
+  /// Helper to set up the fused blending filter from the current layers.
+  /// Returns false if fused blending is disabled or any of the displayed layers
+  /// requires the default pipeline. Modified is set to true if the filter is changed.
+  bool UpdateFusedBlend(bool& modified);
+
   /// Helper to update reconstruction slab settings for a given layer.
   static void UpdateReconstructionSlab(vtkMRMLSliceLogic* sliceLogic, vtkMRMLSliceLayerLogic* sliceLayerLogic);
 
@@ -475,6 +495,9 @@ protected:
   BlendPipeline*                Pipeline;
   BlendPipeline*                PipelineUVW;
   vtkImageReslice*              ExtractModelTexture;
+  vtkImageFusedSliceBlend*      FusedBlend;
+  bool                          FusedBlending;
+  bool                          FusedBlendingActive;
   vtkAlgorithmOutput*           ImageDataConnection;
 
   vtkMRMLModelNode*             SliceModelNode;
@@ -0,0 +1,279 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+==========================================================================*/
+
+// vtkITK includes
+#include <vtkITKArchetypeImageSeriesScalarReader.h>
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtksys/Directory.hxx>
+#include <vtksys/SystemTools.hxx>
+
+// ITK includes
+#include <itkConfigure.h>
+#include <itkFactoryRegistration.h>
+#include <itkGDCMImageIO.h>
+#include <itkImage.h>
+#include <itkImageFileWriter.h>
+#include <itkMetaDataObject.h>
+
+// STD includes
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const char* const SeriesInstanceUIDs[2] = { "1.2.826.0.1.3680043.2.1125.8.1", "1.2.826.0.1.3680043.2.1125.8.2" };
+const char* const ModifiedSeriesInstanceUID = "1.2.826.0.1.3680043.2.1125.8.999";
+const int NumberOfSlicesPerSeries = 4;
+
+//----------------------------------------------------------------------------
+#define CHECK(condition)                                                     \
+  if (!(condition))                                                          \
+  {                                                                          \
+    std::cerr << "Line " << __LINE__ << ": check failed: " #condition << std::endl; \
+    return EXIT_FAILURE;                                                     \
+  }
+
+//----------------------------------------------------------------------------
+/// Write a single-slice DICOM file. The series description only changes the file size.
+bool WriteSlice(const std::string& fileName, int seriesIndex, int sliceIndex, const std::string& seriesDescription)
+{
+  typedef itk::Image<short, 3> ImageType;
+  ImageType::Pointer image = ImageType::New();
+  ImageType::SizeType size;
+  size[0] = 4;
+  size[1] = 4;
+  size[2] = 1;
+  image->SetRegions(ImageType::RegionType(size));
+  ImageType::PointType origin;
+  origin[0] = 0.0;
+  origin[1] = 0.0;
+  origin[2] = 1.5 * sliceIndex;
+  image->SetOrigin(origin);
+  image->Allocate();
+  image->FillBuffer(static_cast<short>(sliceIndex));
+
+  std::ostringstream instanceUID;
+  instanceUID << SeriesInstanceUIDs[seriesIndex] << "." << sliceIndex + 1;
+  std::ostringstream instanceNumber;
+  instanceNumber << sliceIndex + 1;
+  itk::MetaDataDictionary& dictionary = image->GetMetaDataDictionary();
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0016", "1.2.840.10008.5.1.4.1.1.2");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0018", instanceUID.str());
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0060", "CT");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|103e", seriesDescription);
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|000d", "1.2.826.0.1.3680043.2.1125.8");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|000e", SeriesInstanceUIDs[seriesIndex]);
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|0013", instanceNumber.str());
+
+  itk::GDCMImageIO::Pointer imageIO = itk::GDCMImageIO::New();
+  imageIO->KeepOriginalUIDOn();
+  typedef itk::ImageFileWriter<ImageType> WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO(imageIO);
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  try
+  {
+    writer->Update();
+  }
+  catch (itk::ExceptionObject& exc)
+  {
+    std::cerr << "Failed to write " << fileName << ": " << exc << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Read the headers and return the grouping result as a string.
+/// Empty string is returned on failure.
+std::string ReadHeaders(const std::vector<std::string>& fileNames, int numberOfThreads, const std::string& cacheDirectory)
+{
+  vtkNew<vtkITKArchetypeImageSeriesScalarReader> reader;
+  reader->SetArchetype(fileNames[0].c_str());
+  for (const std::string& fileName : fileNames)
+  {
+    reader->AddFileName(fileName.c_str());
+  }
+  reader->SetSingleFile(0);
+  reader->SetNumberOfHeaderReaderThreads(numberOfThreads);
+  reader->SetDICOMHeaderCacheDirectory(cacheDirectory.empty() ? nullptr : cacheDirectory.c_str());
+  reader->UpdateInformation();
+  if (reader->GetErrorCode() != 0)
+  {
+    return std::string();
+  }
+
+  std::ostringstream result;
+  result << "SeriesInstanceUIDs:";
+  for (unsigned int i = 0; i < reader->GetNumberOfSeriesInstanceUIDs(); ++i)
+  {
+    result << " " << reader->GetNthSeriesInstanceUID(i);
+  }
+  result << "\nContentTime: " << reader->GetNumberOfContentTime()
+    << "\nTriggerTime: " << reader->GetNumberOfTriggerTime()
+    << "\nEchoNumbers: " << reader->GetNumberOfEchoNumbers()
+    << "\nDiffusionGradientOrientation: " << reader->GetNumberOfDiffusionGradientOrientation()
+    << "\nSliceLocation: " << reader->GetNumberOfSliceLocation()
+    << "\nImageOrientationPatient: " << reader->GetNumberOfImageOrientationPatient()
+    << "\nImagePositionPatient:";
+  for (unsigned int i = 0; i < reader->GetNumberOfImagePositionPatient(); ++i)
+  {
+    float* position = reader->GetNthImagePositionPatient(i);
+    result << " (" << position[0] << "," << position[1] << "," << position[2] << ")";
+  }
+  result << "\nFileNames: " << reader->GetNumberOfFileNames() << "\n";
+  return result.str();
+}
+
+//----------------------------------------------------------------------------
+std::string GetCacheFileName(const std::string& cacheDirectory)
+{
+  vtksys::Directory dir;
+  dir.Load(cacheDirectory);
+  std::string cacheFileName;
+  for (unsigned long fileIndex = 0; fileIndex < dir.GetNumberOfFiles(); ++fileIndex)
+  {
+    std::string fileName = dir.GetFile(fileIndex);
+    if (fileName.find("DicomHeaders-") == 0)
+    {
+      if (!cacheFileName.empty())
+      {
+        // only one directory is read, there must be a single cache file
+        return std::string();
+      }
+      cacheFileName = cacheDirectory + "/" + fileName;
+    }
+  }
+  return cacheFileName;
+}
+
+//----------------------------------------------------------------------------
+/// Replace the series instance UID of a file in the cache file,
+/// and optionally its modification time.
+bool ModifyCachedHeader(const std::string& cacheFileName, const std::string& fileName, bool modifyTime)
+{
+  std::vector<std::string> lines;
+  {
+    std::ifstream cacheFile(cacheFileName.c_str());
+    std::string line;
+    while (std::getline(cacheFile, line))
+    {
+      lines.push_back(line);
+    }
+  }
+  bool found = false;
+  for (std::string& line : lines)
+  {
+    // file size, modification time, tag values (series instance UID is the first), file path
+    std::vector<std::string> fields;
+    std::istringstream lineStream(line);
+    std::string field;
+    while (std::getline(lineStream, field, '\t'))
+    {
+      fields.push_back(field);
+    }
+    if (fields.size() < 4 || fields.back() != fileName)
+    {
+      continue;
+    }
+    if (modifyTime)
+    {
+      fields[1] = "1";
+    }
+    fields[2] = ModifiedSeriesInstanceUID;
+    line = fields[0];
+    for (size_t fieldIndex = 1; fieldIndex < fields.size(); ++fieldIndex)
+    {
+      line += "\t" + fields[fieldIndex];
+    }
+    found = true;
+  }
+  std::ofstream cacheFile(cacheFileName.c_str());
+  for (const std::string& line : lines)
+  {
+    cacheFile << line << "\n";
+  }
+  return found && cacheFile.good();
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkITKArchetypeImageSeriesReaderDICOMHeaderCacheTest(int argc, char* argv[])
+{
+  itk::itkFactoryRegistration();
+
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string testDirectory = std::string(argv[1]) + "/vtkITKArchetypeImageSeriesReaderDICOMHeaderCacheTest";
+  std::string dicomDirectory = testDirectory + "/DICOM";
+  std::string cacheDirectory = testDirectory + "/Cache";
+  vtksys::SystemTools::RemoveADirectory(testDirectory);
+  CHECK(vtksys::SystemTools::MakeDirectory(dicomDirectory));
+
+  std::vector<std::string> fileNames;
+  for (int seriesIndex = 0; seriesIndex < 2; ++seriesIndex)
+  {
+    for (int sliceIndex = 0; sliceIndex < NumberOfSlicesPerSeries; ++sliceIndex)
+    {
+      std::ostringstream fileName;
+      fileName << dicomDirectory << "/IMG" << seriesIndex << sliceIndex << ".dcm";
+      CHECK(WriteSlice(fileName.str(), seriesIndex, sliceIndex, "Test"));
+      fileNames.push_back(fileName.str());
+    }
+  }
+
+  // Reading the headers in parallel gives the same result as reading them one by one
+  std::string serialResult = ReadHeaders(fileNames, 1, "");
+  std::string parallelResult = ReadHeaders(fileNames, 4, "");
+  std::cout << "Serial read:\n" << serialResult << std::endl;
+  CHECK(!serialResult.empty());
+  CHECK(serialResult.find(SeriesInstanceUIDs[0]) != std::string::npos);
+  CHECK(serialResult.find(SeriesInstanceUIDs[1]) != std::string::npos);
+  CHECK(parallelResult == serialResult);
+
+  // Cache miss: headers are read from the files and the cache file is created
+  CHECK(ReadHeaders(fileNames, 4, cacheDirectory) == serialResult);
+  std::string cacheFileName = GetCacheFileName(cacheDirectory);
+  CHECK(!cacheFileName.empty());
+
+  // Cache hit: header of unchanged files is taken from the cache, which is verified
+  // by modifying the cached series instance UID of a file
+  CHECK(ModifyCachedHeader(cacheFileName, fileNames[0], false));
+  std::string cachedResult = ReadHeaders(fileNames, 4, cacheDirectory);
+  CHECK(cachedResult != serialResult);
+  CHECK(cachedResult.find(ModifiedSeriesInstanceUID) != std::string::npos);
+
+  // Invalidation: file size changed
+  CHECK(WriteSlice(fileNames[0], 0, 0, "Test series with longer description"));
+  CHECK(ReadHeaders(fileNames, 4, cacheDirectory) == serialResult);
+
+  // Invalidation: modification time changed
+  CHECK(ModifyCachedHeader(cacheFileName, fileNames[0], true));
+  CHECK(ReadHeaders(fileNames, 4, cacheDirectory) == serialResult);
+
+  // Cache file was updated with the correct header
+  CHECK(ReadHeaders(fileNames, 1, cacheDirectory) == serialResult);
+
+  vtksys::SystemTools::RemoveADirectory(testDirectory);
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
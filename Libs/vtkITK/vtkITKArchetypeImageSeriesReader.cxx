@@ -28,6 +28,7 @@
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
+#include <vtksys/MD5.h>
 
 // ITK includes
 #include <itkNiftiImageIO.h>
@@ -40,6 +41,16 @@
 
 // STD includes
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
 #include <vector>
 
 #include "itkArchetypeSeriesFileNames.h"
@@ -53,6 +64,195 @@
 
 vtkStandardNewMacro(vtkITKArchetypeImageSeriesReader);
 
+#ifdef VTKITK_BUILD_DICOM_SUPPORT
+namespace
+{
+
+/// DICOM tags that are used for grouping the files of a series,
+/// in the order they are stored in DicomFileHeader::TagValues.
+const int NumberOfDicomHeaderTags = 8;
+const char* const DicomHeaderTags[NumberOfDicomHeaderTags] =
+{
+  "0020|000e", // series instance UID
+  "0008|0033", // content time
+  "0018|1060", // trigger time
+  "0018|0086", // echo numbers
+  "0010|9089", // diffusion gradient orientation
+  "0020|1041", // slice location
+  "0020|0037", // image orientation patient
+  "0020|0032"  // image position patient
+};
+const char* const DicomHeaderCacheFileSignature = "vtkITKArchetypeImageSeriesReader DICOM header cache 2";
+
+//----------------------------------------------------------------------------
+/// Header information of a file that is needed for grouping the files of a series.
+struct DicomFileHeader
+{
+  unsigned long long FileSize{ 0 };
+  long long ModifiedTime{ 0 };
+  std::string TagValues[NumberOfDicomHeaderTags];
+};
+
+typedef std::map<std::string, DicomFileHeader> DicomHeaderCacheType;
+
+//----------------------------------------------------------------------------
+/// All files of a directory are stored in the same cache file.
+/// The file name is computed from the MD5 hash of the directory path, which is
+/// the same in all builds, so the cache can be shared between application versions.
+std::string GetDicomHeaderCacheFileName(const std::string& cacheDirectory, const std::string& fileName)
+{
+  std::string directory = itksys::SystemTools::GetFilenamePath(itksys::SystemTools::CollapseFullPath(fileName));
+  char directoryHash[32];
+  vtksysMD5* md5 = vtksysMD5_New();
+  vtksysMD5_Initialize(md5);
+  vtksysMD5_Append(md5, reinterpret_cast<const unsigned char*>(directory.c_str()), static_cast<int>(directory.size()));
+  vtksysMD5_FinalizeHex(md5, directoryHash);
+  vtksysMD5_Delete(md5);
+  return cacheDirectory + "/DicomHeaders-" + std::string(directoryHash, 32) + ".txt";
+}
+
+//----------------------------------------------------------------------------
+/// Escape backslash, tab, and line break characters so that a field
+/// can be stored between tab separators in a single line.
+std::string EscapeDicomHeaderCacheField(const std::string& field)
+{
+  std::string escaped;
+  escaped.reserve(field.size());
+  for (char c : field)
+  {
+    switch (c)
+    {
+      case '\\': escaped += "\\\\"; break;
+      case '\t': escaped += "\\t"; break;
+      case '\n': escaped += "\\n"; break;
+      case '\r': escaped += "\\r"; break;
+      default: escaped += c;
+    }
+  }
+  return escaped;
+}
+
+//----------------------------------------------------------------------------
+/// Inverse of EscapeDicomHeaderCacheField.
+/// \return False if the field contains an invalid escape sequence.
+bool UnescapeDicomHeaderCacheField(const std::string& field, std::string& unescaped)
+{
+  unescaped.clear();
+  unescaped.reserve(field.size());
+  for (size_t i = 0; i < field.size(); ++i)
+  {
+    if (field[i] != '\\')
+    {
+      unescaped += field[i];
+      continue;
+    }
+    if (++i >= field.size())
+    {
+      return false;
+    }
+    switch (field[i])
+    {
+      case '\\': unescaped += '\\'; break;
+      case 't': unescaped += '\t'; break;
+      case 'n': unescaped += '\n'; break;
+      case 'r': unescaped += '\r'; break;
+      default: return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Each line contains: file size, modification time, tag values, and file path, separated by tabs.
+/// Tag values and file path are escaped with EscapeDicomHeaderCacheField.
+void ReadDicomHeaderCache(const std::string& cacheFileName, DicomHeaderCacheType& cache)
+{
+  std::ifstream cacheFile(cacheFileName.c_str());
+  std::string line;
+  if (!std::getline(cacheFile, line) || line != DicomHeaderCacheFileSignature)
+  {
+    return;
+  }
+  while (std::getline(cacheFile, line))
+  {
+    std::vector<std::string> fields;
+    size_t fieldStart = 0;
+    // The path is the last field
+    for (int fieldIndex = 0; fieldIndex < NumberOfDicomHeaderTags + 2; ++fieldIndex)
+    {
+      size_t fieldEnd = line.find('\t', fieldStart);
+      if (fieldEnd == std::string::npos)
+      {
+        break;
+      }
+      fields.push_back(line.substr(fieldStart, fieldEnd - fieldStart));
+      fieldStart = fieldEnd + 1;
+    }
+    if (fields.size() != NumberOfDicomHeaderTags + 2 || fieldStart >= line.size())
+    {
+      // invalid line
+      continue;
+    }
+    DicomFileHeader header;
+    header.FileSize = std::strtoull(fields[0].c_str(), nullptr, 10);
+    header.ModifiedTime = std::strtoll(fields[1].c_str(), nullptr, 10);
+    bool validLine = true;
+    for (int tagIndex = 0; tagIndex < NumberOfDicomHeaderTags && validLine; ++tagIndex)
+    {
+      validLine = UnescapeDicomHeaderCacheField(fields[tagIndex + 2], header.TagValues[tagIndex]);
+    }
+    std::string filePath;
+    if (!validLine || !UnescapeDicomHeaderCacheField(line.substr(fieldStart), filePath))
+    {
+      // invalid line, the file header will be read from the file
+      continue;
+    }
+    cache[filePath] = header;
+  }
+}
+
+//----------------------------------------------------------------------------
+bool WriteDicomHeaderCache(const std::string& cacheFileName, const DicomHeaderCacheType& cache)
+{
+  // Write to a temporary file and rename, so that readers never see a partially written cache
+  std::stringstream temporaryFileName;
+  temporaryFileName << cacheFileName << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+  {
+    std::ofstream cacheFile(temporaryFileName.str().c_str());
+    if (!cacheFile)
+    {
+      return false;
+    }
+    cacheFile << DicomHeaderCacheFileSignature << "\n";
+    for (const auto& pathAndHeader : cache)
+    {
+      const DicomFileHeader& header = pathAndHeader.second;
+      cacheFile << header.FileSize << "\t" << header.ModifiedTime;
+      for (int tagIndex = 0; tagIndex < NumberOfDicomHeaderTags; ++tagIndex)
+      {
+        cacheFile << "\t" << EscapeDicomHeaderCacheField(header.TagValues[tagIndex]);
+      }
+      cacheFile << "\t" << EscapeDicomHeaderCacheField(pathAndHeader.first) << "\n";
+    }
+    if (!cacheFile)
+    {
+      cacheFile.close();
+      itksys::SystemTools::RemoveFile(temporaryFileName.str());
+      return false;
+    }
+  }
+  itksys::SystemTools::RemoveFile(cacheFileName);
+  if (!itksys::SystemTools::RenameFile(temporaryFileName.str(), cacheFileName))
+  {
+    itksys::SystemTools::RemoveFile(temporaryFileName.str());
+    return false;
+  }
+  return true;
+}
+
+} // end of anonymous namespace
+#endif
+
 //----------------------------------------------------------------------------
 vtkITKArchetypeImageSeriesReader::vtkITKArchetypeImageSeriesReader()
 {
@@ -92,6 +292,8 @@ vtkITKArchetypeImageSeriesReader::vtkITKArchetypeImageSeriesReader()
   this->ImageOrientationPatient.resize( 0 );
 
   this->AnalyzeHeader = true;
+  this->NumberOfHeaderReaderThreads = 8;
+  this->DICOMHeaderCacheDirectory = nullptr;
 
   this->GroupingByTags = false;
   this->IsOnlyFile = false;
@@ -119,6 +321,7 @@ vtkITKArchetypeImageSeriesReader::~vtkITKArchetypeImageSeriesReader()
     delete [] this->Archetype;
     this->Archetype = nullptr;
   }
+  this->SetDICOMHeaderCacheDirectory(nullptr);
   if (RasToIjkMatrix)
   {
     this->RasToIjkMatrix->Delete();
@@ -178,6 +381,9 @@ void vtkITKArchetypeImageSeriesReader::PrintSelf(ostream& os, vtkIndent indent)
     os << ", " << this->DefaultDataOrigin[idx];
   }
   os << ")\n";
+  os << indent << "NumberOfHeaderReaderThreads: " << this->NumberOfHeaderReaderThreads << "\n";
+  os << indent << "DICOMHeaderCacheDirectory: "
+     << (this->DICOMHeaderCacheDirectory ? this->DICOMHeaderCacheDirectory : "(none)") << "\n";
 #ifdef VTKITK_BUILD_DICOM_SUPPORT
   os << indent << "DICOMImageIOApproach: " << this->GetDICOMImageIOApproach();
 #else
@@ -1368,20 +1574,117 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
   }
 
   // if Archetype is a Dicom File
-  gdcmIO->SetFileName( this->Archetype );
+
+  // Get header information from the cache or from the files
+  std::vector<DicomFileHeader> headers(nFiles);
+  std::vector<int> filesToRead;
+  DicomHeaderCacheType cache;
+  std::string cacheFileName;
+  if (this->DICOMHeaderCacheDirectory && strlen(this->DICOMHeaderCacheDirectory) > 0)
+  {
+    cacheFileName = GetDicomHeaderCacheFileName(this->DICOMHeaderCacheDirectory, this->Archetype);
+    ReadDicomHeaderCache(cacheFileName, cache);
+  }
   for (int f = 0; f < nFiles; f++)
   {
-    gdcmIO->SetFileName( this->AllFileNames[f] );
-    gdcmIO->ReadImageInformation();
-    itk::MetaDataDictionary &dict = gdcmIO->GetMetaDataDictionary();
-    std::string tagValue;
+    const std::string& fileName = this->AllFileNames[f];
+    headers[f].FileSize = itksys::SystemTools::FileLength(fileName);
+    headers[f].ModifiedTime = itksys::SystemTools::ModifiedTime(fileName);
+    DicomHeaderCacheType::iterator cachedHeaderIt = cache.find(fileName);
+    if (cachedHeaderIt != cache.end()
+      && cachedHeaderIt->second.FileSize == headers[f].FileSize
+      && cachedHeaderIt->second.ModifiedTime == headers[f].ModifiedTime)
+    {
+      headers[f] = cachedHeaderIt->second;
+    }
+    else
+    {
+      filesToRead.push_back(f);
+    }
+  }
+
+  // Use vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces to remove extra spaces
+  // from the DICOM tag, because extra spaces were found in some DICOM file before/after the
+  // multi-value separator backslashes.
+  auto readHeader = [this, &headers](itk::GDCMImageIO* imageIO, int f)
+  {
+    imageIO->SetFileName( this->AllFileNames[f] );
+    imageIO->ReadImageInformation();
+    const itk::MetaDataDictionary &dict = imageIO->GetMetaDataDictionary();
+    for (int tagIndex = 0; tagIndex < NumberOfDicomHeaderTags; ++tagIndex)
+    {
+      headers[f].TagValues[tagIndex] =
+        vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, DicomHeaderTags[tagIndex]);
+    }
+  };
+  if (!filesToRead.empty())
+  {
+    // The first header is read on this thread to initialize the DICOM dictionaries.
+    readHeader(gdcmIO, filesToRead[0]);
+    // Remaining headers are read by a limited number of threads, each thread has its own
+    // image IO and opens one file at a time.
+    std::atomic<size_t> nextFileToRead(1);
+    std::atomic<bool> readFailed(false);
+    std::exception_ptr readError;
+    std::mutex readErrorMutex;
+    auto readHeaders = [&]()
+    {
+      itk::GDCMImageIO::Pointer threadImageIO = itk::GDCMImageIO::New();
+      for (size_t i = nextFileToRead++; i < filesToRead.size() && !readFailed; i = nextFileToRead++)
+      {
+        try
+        {
+          readHeader(threadImageIO, filesToRead[i]);
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> lock(readErrorMutex);
+          if (!readFailed)
+          {
+            readError = std::current_exception();
+            readFailed = true;
+          }
+        }
+      }
+    };
+    size_t numberOfThreads = std::min(static_cast<size_t>(this->NumberOfHeaderReaderThreads), filesToRead.size() - 1);
+    std::vector<std::thread> threads;
+    for (size_t threadIndex = 1; threadIndex < numberOfThreads; ++threadIndex)
+    {
+      threads.emplace_back(readHeaders);
+    }
+    readHeaders();
+    for (std::thread& thread : threads)
+    {
+      thread.join();
+    }
+    if (readError)
+    {
+      std::rethrow_exception(readError);
+    }
+
+    if (!cacheFileName.empty())
+    {
+      for (int f : filesToRead)
+      {
+        cache[this->AllFileNames[f]] = headers[f];
+      }
+      itksys::SystemTools::MakeDirectory(this->DICOMHeaderCacheDirectory);
+      if (!WriteDicomHeaderCache(cacheFileName, cache))
+      {
+        vtkWarningMacro("AnalyzeDicomHeaders: failed to write DICOM header cache file " << cacheFileName);
+      }
+    }
+  }
 
-    // Use vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces to remove extra spaces
-    // from the DICOM tag, because extra spaces were found in some DICOM file before/after the
-    // multi-value separator backslashes.
+  // Group the files, in the order of the file names
+  for (int f = 0; f < nFiles; f++)
+  {
+    const DicomFileHeader& header = headers[f];
+    std::string tagValue;
 
     // series instance UID
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|000e");
+    tagValue = header.TagValues[0];
     if (!tagValue.empty())
     {
       int idx = InsertSeriesInstanceUIDs( tagValue.c_str() );
@@ -1393,7 +1696,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // content time
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0008|0033");
+    tagValue = header.TagValues[1];
     if (!tagValue.empty())
     {
       int idx = InsertContentTime( tagValue.c_str() );
@@ -1405,7 +1708,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // trigger time
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0018|1060");
+    tagValue = header.TagValues[2];
     if (!tagValue.empty())
     {
       int idx = InsertTriggerTime( tagValue.c_str() );
@@ -1417,7 +1720,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // echo numbers
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0018|0086");
+    tagValue = header.TagValues[3];
     if (!tagValue.empty())
     {
       int idx = InsertEchoNumbers( tagValue.c_str() );
@@ -1429,7 +1732,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // diffision gradient orientation
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0010|9089");
+    tagValue = header.TagValues[4];
     if (!tagValue.empty())
     {
       float a[3] = { -1 };
@@ -1443,7 +1746,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // slice location
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|1041");
+    tagValue = header.TagValues[5];
     if (!tagValue.empty())
     {
       float a = -1;
@@ -1457,7 +1760,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // image orientation patient
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|0037");
+    tagValue = header.TagValues[6];
     if (!tagValue.empty())
     {
       float a[6] = { -1 };
@@ -1470,7 +1773,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       this->IndexImageOrientationPatient[f] = -1;
     }
     // image position patient
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|0032");
+    tagValue = header.TagValues[7];
     if (!tagValue.empty())
     {
       float a[3] = { -1 };
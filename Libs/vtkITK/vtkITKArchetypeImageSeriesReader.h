@@ -246,6 +246,22 @@ public:
   vtkSetMacro(AnalyzeHeader, bool);
   vtkGetMacro(AnalyzeHeader, bool);
 
+  ///
+  /// Maximum number of threads used for reading DICOM headers of the files of a series.
+  /// It also limits the number of files opened at the same time, which matters when
+  /// the files are on network storage. Default is 8.
+  vtkSetClampMacro(NumberOfHeaderReaderThreads, int, 1, 256);
+  vtkGetMacro(NumberOfHeaderReaderThreads, int);
+
+  ///
+  /// Directory where the DICOM header information used for grouping the files is cached.
+  /// Cached information of a file is used if its path, size, and modification time
+  /// are unchanged, therefore reopening the same series does not require reading
+  /// the headers again. The directory is created when the cache is written.
+  /// The cache is disabled if no directory is set (default).
+  vtkSetStringMacro(DICOMHeaderCacheDirectory);
+  vtkGetStringMacro(DICOMHeaderCacheDirectory);
+
   ///
   /// Whether to use orientation from file
   vtkSetMacro(UseOrientationFromFile, int);
@@ -879,6 +895,8 @@ protected:
 
   std::vector<std::string> AllFileNames;
   bool AnalyzeHeader;
+  int NumberOfHeaderReaderThreads;
+  char* DICOMHeaderCacheDirectory;
   bool IsOnlyFile;
   bool ArchetypeIsDICOM;
 
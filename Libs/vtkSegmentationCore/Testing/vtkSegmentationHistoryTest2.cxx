@@ -0,0 +1,228 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// SegmentationCore includes
+#include "vtkBinaryLabelmapToClosedSurfaceConversionRule.h"
+#include "vtkClosedSurfaceToBinaryLabelmapConversionRule.h"
+#include "vtkOrientedImageData.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverterFactory.h"
+#include "vtkSegmentationHistory.h"
+
+// STD includes
+#include <vector>
+
+namespace
+{
+
+const int NUMBER_OF_EDITS = 10;
+
+//----------------------------------------------------------------------------
+int CountVoxels(vtkSegment* segment)
+{
+  vtkOrientedImageData* labelmap = vtkOrientedImageData::SafeDownCast(
+    segment->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+  if (!labelmap || !labelmap->GetPointData()->GetScalars())
+  {
+    return -1;
+  }
+  unsigned char* voxels = static_cast<unsigned char*>(labelmap->GetScalarPointer());
+  vtkIdType numberOfVoxels = labelmap->GetNumberOfPoints();
+  int count = 0;
+  for (vtkIdType i = 0; i < numberOfVoxels; ++i)
+  {
+    if (voxels[i] == segment->GetLabelValue())
+    {
+      ++count;
+    }
+  }
+  return count;
+}
+
+//----------------------------------------------------------------------------
+void PaintCube(vtkSegment* segment, int corner[3], int size)
+{
+  vtkOrientedImageData* labelmap = vtkOrientedImageData::SafeDownCast(
+    segment->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+  for (int k = corner[2]; k < corner[2] + size; ++k)
+  {
+    for (int j = corner[1]; j < corner[1] + size; ++j)
+    {
+      for (int i = corner[0]; i < corner[0] + size; ++i)
+      {
+        *static_cast<unsigned char*>(labelmap->GetScalarPointer(i, j, k)) = static_cast<unsigned char>(segment->GetLabelValue());
+      }
+    }
+  }
+  labelmap->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool CheckVoxelCounts(int line, vtkSegment* segment1, vtkSegment* segment2, const std::vector<int>& expectedCounts)
+{
+  int count1 = CountVoxels(segment1);
+  int count2 = CountVoxels(segment2);
+  if (count1 != expectedCounts[0] || count2 != expectedCounts[1])
+  {
+    std::cerr << "Line " << line << ": voxel count mismatch. Expected: " << expectedCounts[0] << ", " << expectedCounts[1]
+      << ". Actual: " << count1 << ", " << count2 << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkSegmentationHistoryTest2(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  // Register converter rules
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
+    vtkSmartPointer<vtkBinaryLabelmapToClosedSurfaceConversionRule>::New());
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
+    vtkSmartPointer<vtkClosedSurfaceToBinaryLabelmapConversionRule>::New());
+
+  // Two segments sharing a labelmap
+  vtkNew<vtkOrientedImageData> labelmap;
+  labelmap->SetExtent(0, 99, 0, 99, 0, 99);
+  labelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  labelmap->GetPointData()->GetScalars()->Fill(0);
+  vtkTypeInt64 labelmapMemorySize = static_cast<vtkTypeInt64>(labelmap->GetActualMemorySize()) * 1024;
+
+  vtkNew<vtkSegment> segment1;
+  segment1->SetLabelValue(1);
+  segment1->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), labelmap);
+  vtkNew<vtkSegment> segment2;
+  segment2->SetLabelValue(2);
+  segment2->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), labelmap);
+
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->AddSegment(segment1, "Segment_1");
+  segmentation->AddSegment(segment2, "Segment_2");
+
+  vtkNew<vtkSegmentationHistory> history;
+  history->SetSegmentation(segmentation);
+  history->SetMaximumNumberOfStates(NUMBER_OF_EDITS + 5);
+  history->SaveState();
+
+  // Make small edits and save a state after each
+  std::vector<std::vector<int> > expectedCounts;
+  expectedCounts.push_back({ 0, 0 });
+  for (int editIndex = 0; editIndex < NUMBER_OF_EDITS; ++editIndex)
+  {
+    int corner[3] = { 5 + editIndex * 8, 10 + editIndex * 3, 50 };
+    PaintCube(editIndex % 2 ? segment2 : segment1, corner, 5);
+    history->SaveState();
+    expectedCounts.push_back({ CountVoxels(segment1), CountVoxels(segment2) });
+  }
+  if (history->GetNumberOfStates() != NUMBER_OF_EDITS + 1)
+  {
+    std::cerr << __LINE__ << ": Number of states mismatch: " << history->GetNumberOfStates() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Only the last state contains a full labelmap
+  vtkTypeInt64 memorySize = history->GetMemorySize();
+  std::cout << "Labelmap size: " << labelmapMemorySize << " bytes, history size with " << history->GetNumberOfStates()
+    << " states: " << memorySize << " bytes" << std::endl;
+  if (memorySize >= 2 * labelmapMemorySize)
+  {
+    std::cerr << __LINE__ << ": History memory size is too large: " << memorySize << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Undo all edits
+  for (int stateIndex = NUMBER_OF_EDITS - 1; stateIndex >= 0; --stateIndex)
+  {
+    if (!history->RestorePreviousState()
+      || !CheckVoxelCounts(__LINE__, segment1, segment2, expectedCounts[stateIndex]))
+    {
+      std::cerr << __LINE__ << ": Failed to restore state " << stateIndex << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  if (history->IsRestorePreviousStateAvailable())
+  {
+    std::cerr << __LINE__ << ": Undo should not be available" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Redo all edits
+  for (int stateIndex = 1; stateIndex <= NUMBER_OF_EDITS; ++stateIndex)
+  {
+    if (!history->RestoreNextState()
+      || !CheckVoxelCounts(__LINE__, segment1, segment2, expectedCounts[stateIndex]))
+    {
+      std::cerr << __LINE__ << ": Failed to restore state " << stateIndex << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Undo a few edits then make a new edit, which removes the next states
+  for (int i = 0; i < 3; ++i)
+  {
+    history->RestorePreviousState();
+  }
+  if (!CheckVoxelCounts(__LINE__, segment1, segment2, expectedCounts[NUMBER_OF_EDITS - 3]))
+  {
+    return EXIT_FAILURE;
+  }
+  int corner[3] = { 80, 80, 80 };
+  PaintCube(segment1, corner, 10);
+  history->SaveState();
+  if (history->GetNumberOfStates() != NUMBER_OF_EDITS - 1)
+  {
+    std::cerr << __LINE__ << ": Number of states mismatch: " << history->GetNumberOfStates() << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::vector<int> lastCounts = { CountVoxels(segment1), CountVoxels(segment2) };
+  for (int stateIndex = NUMBER_OF_EDITS - 3; stateIndex > 0; --stateIndex)
+  {
+    history->RestorePreviousState();
+  }
+  if (!CheckVoxelCounts(__LINE__, segment1, segment2, expectedCounts[1]))
+  {
+    return EXIT_FAILURE;
+  }
+  while (history->IsRestoreNextStateAvailable())
+  {
+    history->RestoreNextState();
+  }
+  if (!CheckVoxelCounts(__LINE__, segment1, segment2, lastCounts))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Limit memory size to a single full labelmap: all previous states are removed
+  history->SetMaximumMemorySize(labelmapMemorySize);
+  if (history->GetNumberOfStates() != 1 || history->IsRestorePreviousStateAvailable())
+  {
+    std::cerr << __LINE__ << ": Memory limit is not applied. Memory size: " << history->GetMemorySize()
+      << ", number of states: " << history->GetNumberOfStates() << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (!CheckVoxelCounts(__LINE__, segment1, segment2, lastCounts))
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Segmentation history test 2 passed." << std::endl;
+  return EXIT_SUCCESS;
+}
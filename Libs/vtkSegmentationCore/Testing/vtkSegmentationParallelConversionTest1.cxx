@@ -0,0 +1,235 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkTimerLog.h>
+
+// SegmentationCore includes
+#include "vtkBinaryLabelmapToClosedSurfaceConversionRule.h"
+#include "vtkClosedSurfaceToBinaryLabelmapConversionRule.h"
+#include "vtkOrientedImageData.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+#include "vtkSegmentationConverterFactory.h"
+
+// STD includes
+#include <vector>
+
+namespace
+{
+
+const int NUMBER_OF_SEGMENTS = 6;
+
+//----------------------------------------------------------------------------
+/// If touchBorder is set then the spheres are clipped by the reference geometry extent,
+/// so the labelmap must be padded before surface generation.
+void CreateSphereSegmentation(vtkSegmentation* segmentation, bool touchBorder)
+{
+  segmentation->SetSourceRepresentationName(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName());
+
+  vtkNew<vtkMatrix4x4> referenceGeometryMatrix;
+  referenceGeometryMatrix->Identity();
+  int referenceGeometryExtent[6] = { 0, 99, 0, 99, 0, 99 };
+  segmentation->SetConversionParameter(vtkSegmentationConverter::GetReferenceImageGeometryParameterName(),
+    vtkSegmentationConverter::SerializeImageGeometry(referenceGeometryMatrix, referenceGeometryExtent));
+
+  for (int segmentIndex = 0; segmentIndex < NUMBER_OF_SEGMENTS; ++segmentIndex)
+  {
+    vtkNew<vtkSphereSource> sphere;
+    sphere->SetCenter(20 + 10 * segmentIndex, 50, touchBorder ? 95 : 50);
+    sphere->SetRadius(8 + segmentIndex);
+    sphere->SetThetaResolution(32);
+    sphere->SetPhiResolution(32);
+    sphere->Update();
+
+    vtkNew<vtkPolyData> spherePolyData;
+    spherePolyData->DeepCopy(sphere->GetOutput());
+    vtkNew<vtkSegment> segment;
+    segment->AddRepresentation(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName(), spherePolyData);
+    segmentation->AddSegment(segment);
+  }
+}
+
+//----------------------------------------------------------------------------
+int GetNumberOfSegmentVoxels(vtkSegment* segment)
+{
+  vtkOrientedImageData* labelmap = vtkOrientedImageData::SafeDownCast(
+    segment->GetRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()));
+  if (!labelmap)
+  {
+    return -1;
+  }
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  labelmap->GetExtent(extent);
+  int numberOfVoxels = 0;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+      {
+        if (labelmap->GetScalarComponentAsDouble(i, j, k, 0) == segment->GetLabelValue())
+        {
+          ++numberOfVoxels;
+        }
+      }
+    }
+  }
+  return numberOfVoxels;
+}
+
+//----------------------------------------------------------------------------
+int GetNumberOfSurfacePoints(vtkSegment* segment)
+{
+  vtkPolyData* surface = vtkPolyData::SafeDownCast(
+    segment->GetRepresentation(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName()));
+  return (surface ? surface->GetNumberOfPoints() : -1);
+}
+
+//----------------------------------------------------------------------------
+bool ConvertSegmentation(vtkSegmentation* segmentation, const std::string& targetRepresentationName,
+  bool parallel, std::vector<int>& results)
+{
+  segmentation->SetParallelConversion(parallel);
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  if (!segmentation->CreateRepresentation(targetRepresentationName, true))
+  {
+    std::cerr << "Failed to convert segmentation to " << targetRepresentationName << std::endl;
+    return false;
+  }
+  timer->StopTimer();
+  std::cout << "Convert to " << targetRepresentationName << (parallel ? " (parallel): " : " (sequential): ")
+    << timer->GetElapsedTime() << "s" << std::endl;
+
+  results.clear();
+  for (int segmentIndex = 0; segmentIndex < segmentation->GetNumberOfSegments(); ++segmentIndex)
+  {
+    vtkSegment* segment = segmentation->GetNthSegment(segmentIndex);
+    if (targetRepresentationName == vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName())
+    {
+      results.push_back(GetNumberOfSegmentVoxels(segment));
+    }
+    else
+    {
+      results.push_back(GetNumberOfSurfacePoints(segment));
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool CompareResults(const std::vector<int>& sequentialResults, const std::vector<int>& parallelResults)
+{
+  if (sequentialResults.size() != parallelResults.size())
+  {
+    std::cerr << "Number of segments mismatch: " << sequentialResults.size() << " != " << parallelResults.size() << std::endl;
+    return false;
+  }
+  for (size_t segmentIndex = 0; segmentIndex < sequentialResults.size(); ++segmentIndex)
+  {
+    if (sequentialResults[segmentIndex] <= 0 || sequentialResults[segmentIndex] != parallelResults[segmentIndex])
+    {
+      std::cerr << "Conversion result mismatch for segment " << segmentIndex << ": sequential " << sequentialResults[segmentIndex]
+        << ", parallel " << parallelResults[segmentIndex] << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkSegmentationParallelConversionTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  // Register converter rules
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
+    vtkSmartPointer<vtkBinaryLabelmapToClosedSurfaceConversionRule>::New());
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
+    vtkSmartPointer<vtkClosedSurfaceToBinaryLabelmapConversionRule>::New());
+
+  vtkNew<vtkSegmentation> segmentation;
+  if (segmentation->GetParallelConversion())
+  {
+    std::cerr << __LINE__ << ": Parallel conversion is expected to be disabled by default" << std::endl;
+    return EXIT_FAILURE;
+  }
+  CreateSphereSegmentation(segmentation, false);
+
+  // Closed surface to binary labelmap (segments are collapsed to a shared labelmap in PostConvert)
+  std::string binaryLabelmapName = vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName();
+  std::vector<int> sequentialResults;
+  std::vector<int> parallelResults;
+  if (!ConvertSegmentation(segmentation, binaryLabelmapName, false, sequentialResults)
+    || !ConvertSegmentation(segmentation, binaryLabelmapName, true, parallelResults)
+    || !CompareResults(sequentialResults, parallelResults))
+  {
+    std::cerr << __LINE__ << ": Parallel closed surface to binary labelmap conversion failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Binary labelmap to closed surface from the shared labelmap
+  std::string closedSurfaceName = vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName();
+  segmentation->SetSourceRepresentationName(binaryLabelmapName);
+  segmentation->SetConversionParameter(vtkBinaryLabelmapToClosedSurfaceConversionRule::GetJointSmoothingParameterName(), "0");
+  if (!ConvertSegmentation(segmentation, closedSurfaceName, false, sequentialResults)
+    || !ConvertSegmentation(segmentation, closedSurfaceName, true, parallelResults)
+    || !CompareResults(sequentialResults, parallelResults))
+  {
+    std::cerr << __LINE__ << ": Parallel binary labelmap to closed surface conversion failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Joint smoothing is not thread-safe, conversion falls back to sequential
+  segmentation->SetConversionParameter(vtkBinaryLabelmapToClosedSurfaceConversionRule::GetJointSmoothingParameterName(), "1");
+  if (!ConvertSegmentation(segmentation, closedSurfaceName, false, sequentialResults)
+    || !ConvertSegmentation(segmentation, closedSurfaceName, true, parallelResults)
+    || !CompareResults(sequentialResults, parallelResults))
+  {
+    std::cerr << __LINE__ << ": Binary labelmap to closed surface conversion with joint smoothing failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Segments touching the labelmap border: padding is performed concurrently on the shared labelmap
+  vtkNew<vtkSegmentation> borderSegmentation;
+  CreateSphereSegmentation(borderSegmentation, true);
+  if (!ConvertSegmentation(borderSegmentation, binaryLabelmapName, false, sequentialResults))
+  {
+    std::cerr << __LINE__ << ": Closed surface to binary labelmap conversion of border segments failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  borderSegmentation->SetSourceRepresentationName(binaryLabelmapName);
+  borderSegmentation->SetConversionParameter(vtkBinaryLabelmapToClosedSurfaceConversionRule::GetJointSmoothingParameterName(), "0");
+  for (int iteration = 0; iteration < 5; ++iteration)
+  {
+    if (!ConvertSegmentation(borderSegmentation, closedSurfaceName, false, sequentialResults)
+      || !ConvertSegmentation(borderSegmentation, closedSurfaceName, true, parallelResults)
+      || !CompareResults(sequentialResults, parallelResults))
+    {
+      std::cerr << __LINE__ << ": Parallel binary labelmap to closed surface conversion of border segments failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "Parallel conversion test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
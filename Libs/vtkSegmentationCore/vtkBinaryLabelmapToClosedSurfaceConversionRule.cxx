@@ -259,12 +259,10 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrie
     return false;
   }
 
-  vtkSmartPointer<vtkImageData> binaryLabelmap = orientedBinaryLabelmap;
-  if (!binaryLabelmap)
-  {
-    vtkErrorMacro("Convert: Source representation is not data");
-    return false;
-  }
+  // Filters are connected to a shallow copy of the labelmap, as the labelmap may be shared between
+  // segments that are converted concurrently and connecting a filter modifies the input pipeline information.
+  vtkSmartPointer<vtkImageData> binaryLabelmap = vtkSmartPointer<vtkImageData>::New();
+  binaryLabelmap->ShallowCopy(orientedBinaryLabelmap);
 
   // Pad labelmap if it has non-background border voxels
   int* binaryLabelmapExtent = binaryLabelmap->GetExtent();
@@ -475,6 +473,14 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrie
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool vtkBinaryLabelmapToClosedSurfaceConversionRule::IsThreadSafe()
+{
+  double smoothingFactor = this->ConversionParameters->GetValueAsDouble(GetSmoothingFactorParameterName());
+  int jointSmoothing = this->ConversionParameters->GetValueAsInt(GetJointSmoothingParameterName());
+  return !(jointSmoothing > 0 && smoothingFactor > 0);
+}
+
 //----------------------------------------------------------------------------
 bool vtkBinaryLabelmapToClosedSurfaceConversionRule::PostConvert(vtkSegmentation* vtkNotUsed(segmentation))
 {
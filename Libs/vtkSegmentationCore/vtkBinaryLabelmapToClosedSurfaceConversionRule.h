@@ -84,6 +84,10 @@ public:
   /// Clears the joint smoothing cache
   bool PostConvert(vtkSegmentation* segmentation) override;
 
+  /// Conversion is thread-safe unless joint smoothing is enabled,
+  /// as the joint smoothing cache is shared between segments.
+  bool IsThreadSafe() override;
+
   /// Get the cost of the conversion.
   unsigned int GetConversionCost(vtkDataObject* sourceRepresentation=nullptr, vtkDataObject* targetRepresentation=nullptr) override;
 
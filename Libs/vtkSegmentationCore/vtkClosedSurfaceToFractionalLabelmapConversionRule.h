@@ -63,6 +63,9 @@ public:
   /// Overridden to prevent vtkClosedSurfaceToBinaryLabelmapConversionRule::PostConvert
   bool PostConvert(vtkSegmentation* vtkNotUsed(segmentation)) override { return true; };
 
+  /// Overridden to prevent concurrent conversion, as the fractional labelmap filter is not verified to be thread-safe
+  bool IsThreadSafe() override { return false; };
+
   /// Get the cost of the conversion.
   unsigned int GetConversionCost(vtkDataObject* sourceRepresentation=nullptr, vtkDataObject* targetRepresentation=nullptr) override;
 
@@ -33,6 +33,7 @@
 #include <vtkBoundingBox.h>
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
+#include <vtkDataSet.h>
 #include <vtkImageThreshold.h>
 #include <vtkMath.h>
 #include <vtkMatrix4x4.h>
@@ -42,6 +43,7 @@
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
 #include <vtkSingleton.h>
+#include <vtkSMPTools.h>
 #include <vtkStringArray.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
@@ -51,6 +53,7 @@
 #include <algorithm>
 #include <chrono>
 #include <functional>
+#include <set>
 #include <sstream>
 
 // GDCM includes
@@ -102,6 +105,8 @@ vtkSegmentation::vtkSegmentation()
   this->UUIDSegmentIDs = false;
 #endif
 
+  this->ParallelConversion = false;
+
   this->SetSourceRepresentationName(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName());
 }
 
@@ -195,6 +200,7 @@ void vtkSegmentation::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Modified Time: " << this->GetMTime() << "\n";
 
   os << indent << "SourceRepresentationName:  " << this->SourceRepresentationName << "\n";
+  os << indent << "ParallelConversion:  " << (this->ParallelConversion ? "true" : "false") << "\n";
   os << indent << "Number of segments: " << this->Segments.size() << "\n";
   os << indent << "Segments:\n";
   for (std::deque< std::string >::iterator segmentIdIt = this->SegmentIds.begin();
@@ -1206,6 +1212,7 @@ bool vtkSegmentation::ConvertSegmentsUsingPath(std::vector<std::string> segmentI
 
     // Perform conversion step
     currentConversionRule->PreConvert(this);
+    std::vector<vtkSegment*> segmentsToConvert;
     for (auto segmentID : segmentIDs)
     {
       vtkSegment* segment = this->GetSegment(segmentID);
@@ -1228,7 +1235,19 @@ bool vtkSegmentation::ConvertSegmentsUsingPath(std::vector<std::string> segmentI
       {
         continue;
       }
-      currentConversionRule->Convert(segment);
+      segmentsToConvert.push_back(segment);
+    }
+
+    if (this->ParallelConversion && segmentsToConvert.size() > 1 && currentConversionRule->IsThreadSafe())
+    {
+      this->ConvertSegmentsInParallel(segmentsToConvert, currentConversionRule);
+    }
+    else
+    {
+      for (vtkSegment* segment : segmentsToConvert)
+      {
+        currentConversionRule->Convert(segment);
+      }
     }
     currentConversionRule->PostConvert(this);
 
@@ -1237,6 +1256,105 @@ bool vtkSegmentation::ConvertSegmentsUsingPath(std::vector<std::string> segmentI
   return true;
 }
 
+//-----------------------------------------------------------------------------
+bool vtkSegmentation::ConvertSegmentsInParallel(const std::vector<vtkSegment*>& segments, vtkSegmentationConverterRule* rule)
+{
+  if (!rule)
+  {
+    vtkErrorMacro("ConvertSegmentsInParallel: Invalid converter rule!");
+    return false;
+  }
+  std::string sourceRepresentationName = rule->GetSourceRepresentationName();
+  std::string targetRepresentationName = rule->GetTargetRepresentationName();
+
+  // Set up a temporary segment for each segment so that the conversion threads do not modify
+  // the segments (and do not invoke events) and do not share any modifiable objects.
+  std::vector<vtkSmartPointer<vtkSegment> > workSegments;
+  std::set<vtkDataObject*> sourceRepresentations;
+  for (vtkSegment* segment : segments)
+  {
+    vtkSmartPointer<vtkSegment> workSegment = vtkSmartPointer<vtkSegment>::New();
+    workSegment->SetLabelValue(segment->GetLabelValue());
+
+    vtkDataObject* sourceRepresentation = segment->GetRepresentation(sourceRepresentationName);
+    workSegment->AddRepresentation(sourceRepresentationName, sourceRepresentation);
+    sourceRepresentations.insert(sourceRepresentation);
+
+    // Existing target representation is passed as a shallow copy, as some rules use its geometry
+    vtkDataObject* targetRepresentation = segment->GetRepresentation(targetRepresentationName);
+    if (targetRepresentation)
+    {
+      vtkSmartPointer<vtkDataObject> targetRepresentationCopy = vtkSmartPointer<vtkDataObject>::Take(targetRepresentation->NewInstance());
+      targetRepresentationCopy->ShallowCopy(targetRepresentation);
+      workSegment->AddRepresentation(targetRepresentationName, targetRepresentationCopy);
+    }
+    workSegments.push_back(workSegment);
+  }
+
+  // Source representations may be shared between segments (shared labelmap).
+  // Compute lazily cached values (bounds, scalar range) now so that the threads only read them.
+  for (vtkDataObject* sourceRepresentation : sourceRepresentations)
+  {
+    vtkDataSet* sourceDataSet = vtkDataSet::SafeDownCast(sourceRepresentation);
+    if (!sourceDataSet)
+    {
+      continue;
+    }
+    double bounds[6] = { 0.0 };
+    sourceDataSet->GetBounds(bounds);
+    if (sourceDataSet->GetPointData() && sourceDataSet->GetPointData()->GetScalars())
+    {
+      double scalarRange[2] = { 0.0 };
+      sourceDataSet->GetScalarRange(scalarRange);
+    }
+  }
+
+  std::vector<char> conversionResults(workSegments.size(), 0);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(workSegments.size()), 1,
+    [&](vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType index = begin; index < end; ++index)
+      {
+        conversionResults[index] = (rule->Convert(workSegments[index]) ? 1 : 0);
+      }
+    });
+
+  // Add results to the segments in order
+  bool success = true;
+  for (size_t index = 0; index < segments.size(); ++index)
+  {
+    vtkSegment* segment = segments[index];
+    vtkSegment* workSegment = workSegments[index];
+    if (!conversionResults[index])
+    {
+      success = false;
+    }
+
+    vtkDataObject* convertedRepresentation = workSegment->GetRepresentation(targetRepresentationName);
+    vtkDataObject* targetRepresentation = segment->GetRepresentation(targetRepresentationName);
+    if (!convertedRepresentation || convertedRepresentation == targetRepresentation)
+    {
+      continue;
+    }
+    if (targetRepresentation && !rule->GetReplaceTargetRepresentation()
+      && strcmp(targetRepresentation->GetClassName(), convertedRepresentation->GetClassName()) == 0)
+    {
+      // Same as sequential conversion, which updates the existing target representation object
+      targetRepresentation->ShallowCopy(convertedRepresentation);
+    }
+    else
+    {
+      segment->AddRepresentation(targetRepresentationName, convertedRepresentation);
+    }
+    if (workSegment->GetLabelValue() != segment->GetLabelValue())
+    {
+      segment->SetLabelValue(workSegment->GetLabelValue());
+    }
+  }
+
+  return success;
+}
+
 //-----------------------------------------------------------------------------
 bool vtkSegmentation::ConvertSegmentUsingPath(vtkSegment* segment, vtkSegmentationConversionPath* path, bool overwriteExisting/*=false*/)
 {
@@ -528,6 +528,14 @@ public:
   vtkGetMacro(UUIDSegmentIDs, bool);
   vtkBooleanMacro(UUIDSegmentIDs, bool);
 
+  /// If enabled, then segments are converted concurrently by conversion rules that are thread-safe
+  /// (see vtkSegmentationConverterRule::IsThreadSafe). Converted representations are added to the
+  /// segments on the calling thread, in segment order, so segment modified events are invoked the
+  /// same way as in sequential conversion. Disabled by default.
+  vtkSetMacro(ParallelConversion, bool);
+  vtkGetMacro(ParallelConversion, bool);
+  vtkBooleanMacro(ParallelConversion, bool);
+
   static vtkMinimalStandardRandomSequence* GetSegmentIDRandomSequenceInstance();
 
 protected:
@@ -541,6 +549,13 @@ protected:
   /// \return Success flag
   bool ConvertSegmentUsingPath(vtkSegment* segment, vtkSegmentationConversionPath* path, bool overwriteExisting = false);
 
+  /// Convert segments concurrently using a thread-safe conversion rule.
+  /// Each segment is converted in a temporary segment that references the source representation,
+  /// then the results are added to the original segments on the calling thread.
+  /// PreConvert and PostConvert must be called by the caller.
+  /// \return Success flag
+  bool ConvertSegmentsInParallel(const std::vector<vtkSegment*>& segments, vtkSegmentationConverterRule* rule);
+
   /// Converts a single segment to a representation.
   bool ConvertSingleSegment(std::string segmentId, std::string targetRepresentationName);
 
@@ -631,6 +646,8 @@ protected:
 
   bool UUIDSegmentIDs;
 
+  bool ParallelConversion;
+
   /// Singleton class managing vtkMinimalStandardRandomSequence used for randomizing segment IDs
   friend class vtkSegmentationRandomSequenceInitialize;
 
@@ -93,6 +93,12 @@ public:
   /// This step should be unnecessary if only converting a single segment
   virtual bool PostConvert(vtkSegmentation* vtkNotUsed(segmentation)) { return true; };
 
+  /// Returns true if Convert can be called concurrently for different segments.
+  /// A thread-safe rule must not modify the rule object or any object that is shared between
+  /// segments in Convert. PreConvert and PostConvert are always called from the calling thread.
+  /// False by default.
+  virtual bool IsThreadSafe() { return false; };
+
   /// Get the cost of the conversion.
   /// \return Expected duration of the conversion in milliseconds. If the arguments are omitted, then a rough average can be
   ///   given just to indicate the relative computational cost of the algorithm. If the objects are given, then a more educated
@@ -130,6 +136,10 @@ public:
   /// Determine if the rule has a parameter with a certain name
   bool HasConversionParameter(const std::string& name);
 
+  /// If true, Convert replaces the target representation of the segment with a new object.
+  /// If false, the existing target representation object is updated.
+  vtkGetMacro(ReplaceTargetRepresentation, bool);
+
 protected:
   /// Update the target representation based on the source representation
   virtual bool CreateTargetRepresentation(vtkSegment* segment);
@@ -22,14 +22,178 @@
 #include "vtkSegmentationHistory.h"
 #include "vtkSegmentationConverterFactory.h"
 #include "vtkSegmentation.h"
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
 
 // VTK includes
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkCallbackCommand.h>
+#include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkZLibDataCompressor.h>
 
 // std includes
 #include <algorithm>
+#include <cstring>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+bool IsExtentEmpty(const int extent[6])
+{
+  return extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5];
+}
+
+//----------------------------------------------------------------------------
+// Returns true if the voxels of the labelmap can be stored as difference from the baseline labelmap
+bool CanStoreLabelmapDifference(vtkOrientedImageData* labelmap, vtkOrientedImageData* baselineLabelmap)
+{
+  if (!labelmap || !baselineLabelmap || labelmap->IsEmpty() || baselineLabelmap->IsEmpty())
+  {
+    return false;
+  }
+  if (!labelmap->GetPointData()->GetScalars() || !baselineLabelmap->GetPointData()->GetScalars())
+  {
+    return false;
+  }
+  return labelmap->GetScalarType() == baselineLabelmap->GetScalarType()
+    && labelmap->GetNumberOfScalarComponents() == baselineLabelmap->GetNumberOfScalarComponents()
+    && vtkOrientedImageDataResample::DoExtentsMatch(labelmap, baselineLabelmap);
+}
+
+//----------------------------------------------------------------------------
+// Get bounding box of the voxels that are different in the two images.
+// Images must have the same extent, scalar type, and number of components.
+// Returns false if the images are the same.
+bool GetDifferenceExtent(vtkImageData* image1, vtkImageData* image2, int differenceExtent[6])
+{
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  image1->GetExtent(extent);
+  const int voxelSize = image1->GetScalarSize() * image1->GetNumberOfScalarComponents();
+  const int rowLength = extent[1] - extent[0] + 1;
+  const size_t rowSize = static_cast<size_t>(rowLength) * voxelSize;
+  bool different = false;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      const unsigned char* row1 = static_cast<unsigned char*>(image1->GetScalarPointer(extent[0], j, k));
+      const unsigned char* row2 = static_cast<unsigned char*>(image2->GetScalarPointer(extent[0], j, k));
+      if (memcmp(row1, row2, rowSize) == 0)
+      {
+        continue;
+      }
+      int first = 0;
+      while (memcmp(row1 + first * voxelSize, row2 + first * voxelSize, voxelSize) == 0)
+      {
+        ++first;
+      }
+      int last = rowLength - 1;
+      while (memcmp(row1 + last * voxelSize, row2 + last * voxelSize, voxelSize) == 0)
+      {
+        --last;
+      }
+      if (!different)
+      {
+        differenceExtent[0] = extent[0] + first;
+        differenceExtent[1] = extent[0] + last;
+        differenceExtent[2] = differenceExtent[3] = j;
+        differenceExtent[4] = differenceExtent[5] = k;
+        different = true;
+        continue;
+      }
+      differenceExtent[0] = std::min(differenceExtent[0], extent[0] + first);
+      differenceExtent[1] = std::max(differenceExtent[1], extent[0] + last);
+      differenceExtent[2] = std::min(differenceExtent[2], j);
+      differenceExtent[3] = std::max(differenceExtent[3], j);
+      differenceExtent[5] = k;
+    }
+  }
+  return different;
+}
+
+//----------------------------------------------------------------------------
+// Copy voxels within extent between images that have the same extent, scalar type, and number of components
+void CopyImageRegion(vtkImageData* sourceImage, vtkImageData* targetImage, const int extent[6])
+{
+  const size_t rowSize = static_cast<size_t>(extent[1] - extent[0] + 1)
+    * sourceImage->GetScalarSize() * sourceImage->GetNumberOfScalarComponents();
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      memcpy(targetImage->GetScalarPointer(extent[0], j, k), sourceImage->GetScalarPointer(extent[0], j, k), rowSize);
+    }
+  }
+  targetImage->GetPointData()->GetScalars()->Modified();
+  targetImage->Modified();
+}
+
+//----------------------------------------------------------------------------
+// Compress voxels within extent
+vtkSmartPointer<vtkUnsignedCharArray> CompressImageRegion(vtkImageData* image, const int extent[6])
+{
+  const size_t rowSize = static_cast<size_t>(extent[1] - extent[0] + 1)
+    * image->GetScalarSize() * image->GetNumberOfScalarComponents();
+  std::vector<unsigned char> regionScalars(rowSize * (extent[3] - extent[2] + 1) * (extent[5] - extent[4] + 1));
+  unsigned char* regionScalarsPtr = regionScalars.data();
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      memcpy(regionScalarsPtr, image->GetScalarPointer(extent[0], j, k), rowSize);
+      regionScalarsPtr += rowSize;
+    }
+  }
+  // Labelmaps compress very well, fastest compression is sufficient
+  vtkNew<vtkZLibDataCompressor> compressor;
+  compressor->SetCompressionLevel(1);
+  return vtkSmartPointer<vtkUnsignedCharArray>::Take(compressor->Compress(regionScalars.data(), regionScalars.size()));
+}
+
+//----------------------------------------------------------------------------
+// Decompress voxels within extent into the image
+bool DecompressImageRegion(vtkUnsignedCharArray* compressedScalars, vtkImageData* image, const int extent[6])
+{
+  const size_t rowSize = static_cast<size_t>(extent[1] - extent[0] + 1)
+    * image->GetScalarSize() * image->GetNumberOfScalarComponents();
+  std::vector<unsigned char> regionScalars(rowSize * (extent[3] - extent[2] + 1) * (extent[5] - extent[4] + 1));
+  vtkNew<vtkZLibDataCompressor> compressor;
+  size_t uncompressedSize = compressor->Uncompress(compressedScalars->GetPointer(0),
+    static_cast<size_t>(compressedScalars->GetNumberOfValues()), regionScalars.data(), regionScalars.size());
+  if (uncompressedSize != regionScalars.size())
+  {
+    return false;
+  }
+  const unsigned char* regionScalarsPtr = regionScalars.data();
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      memcpy(image->GetScalarPointer(extent[0], j, k), regionScalarsPtr, rowSize);
+      regionScalarsPtr += rowSize;
+    }
+  }
+  image->GetPointData()->GetScalars()->Modified();
+  image->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Create a labelmap that has the same geometry as the input labelmap, without scalars
+vtkSmartPointer<vtkOrientedImageData> CreateLabelmapGeometry(vtkOrientedImageData* labelmap)
+{
+  vtkSmartPointer<vtkOrientedImageData> geometry = vtkSmartPointer<vtkOrientedImageData>::New();
+  geometry->SetExtent(labelmap->GetExtent());
+  geometry->SetOrigin(labelmap->GetOrigin());
+  geometry->SetSpacing(labelmap->GetSpacing());
+  geometry->CopyDirections(labelmap);
+  return geometry;
+}
+
+} // end of anonymous namespace
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSegmentationHistory);
@@ -40,6 +204,7 @@ vtkSegmentationHistory::vtkSegmentationHistory()
   this->Segmentation = nullptr;
 
   this->MaximumNumberOfStates = 5;
+  this->MaximumMemorySize = 0;
 
   this->LastRestoredState = 0;
   this->RestoreStateInProgress = false;
@@ -98,6 +263,9 @@ void vtkSegmentationHistory::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Modified Time: " << this->GetMTime() << "\n";
 
   os << indent << "Number of saved states:  " << this->SegmentationStates.size() << "\n";
+  os << indent << "MaximumNumberOfStates:  " << this->MaximumNumberOfStates << "\n";
+  os << indent << "MaximumMemorySize:  " << this->MaximumMemorySize << "\n";
+  os << indent << "MemorySize:  " << this->GetMemorySize() << "\n";
 }
 
 //---------------------------------------------------------------------------
@@ -130,6 +298,10 @@ bool vtkSegmentationHistory::SaveState()
   this->Segmentation->GetSegmentIDs(segmentIDs);
   newSegmentationState.SegmentIds = segmentIDs;
   std::map<vtkDataObject*, vtkDataObject*> savedObjects;
+  // Labelmaps of the last state that are updated to the current state and moved to the new state,
+  // mapped to the labelmap geometry that the voxel difference is stored with in the last state.
+  std::map<vtkOrientedImageData*, vtkSmartPointer<vtkOrientedImageData> > savedLabelmaps;
+  std::vector<vtkSmartPointer<vtkOrientedImageData> > copiedLabelmaps;
   for (std::vector<std::string>::iterator segmentIDIt = segmentIDs.begin(); segmentIDIt != segmentIDs.end(); ++segmentIDIt)
   {
     vtkSegment* segment = this->Segmentation->GetSegment(*segmentIDIt);
@@ -150,10 +322,62 @@ bool vtkSegmentationHistory::SaveState()
       }
     }
 
+    // Save labelmaps. Only the last state contains full labelmaps: if the labelmap in the last state has
+    // the same extent then the changed voxels are copied into it (and it is moved to the new state) and the
+    // overwritten voxels are stored in the last state as difference.
+    std::vector<std::string> representationNames;
+    segment->GetContainedRepresentationNames(representationNames);
+    for (const std::string& representationName : representationNames)
+    {
+      vtkOrientedImageData* labelmap = vtkOrientedImageData::SafeDownCast(segment->GetRepresentation(representationName));
+      if (!labelmap || savedObjects.find(labelmap) != savedObjects.end())
+      {
+        continue;
+      }
+      vtkOrientedImageData* baselineLabelmap = nullptr;
+      if (baselineSegment)
+      {
+        baselineLabelmap = vtkOrientedImageData::SafeDownCast(baselineSegment->GetRepresentation(representationName));
+      }
+      vtkOrientedImageData* savedLabelmap = nullptr;
+      if (baselineLabelmap && savedLabelmaps.find(baselineLabelmap) == savedLabelmaps.end()
+        && CanStoreLabelmapDifference(labelmap, baselineLabelmap))
+      {
+        vtkSmartPointer<vtkOrientedImageData> baselineGeometry = CreateLabelmapGeometry(baselineLabelmap);
+        LabelmapDifference difference;
+        difference.NextLabelmap = baselineLabelmap;
+        difference.ScalarType = baselineLabelmap->GetScalarType();
+        difference.NumberOfScalarComponents = baselineLabelmap->GetNumberOfScalarComponents();
+        if (GetDifferenceExtent(labelmap, baselineLabelmap, difference.Extent))
+        {
+          difference.CompressedScalars = CompressImageRegion(baselineLabelmap, difference.Extent);
+          CopyImageRegion(labelmap, baselineLabelmap, difference.Extent);
+        }
+        this->SegmentationStates.back().LabelmapDifferences[baselineGeometry] = difference;
+        savedLabelmaps[baselineLabelmap] = baselineGeometry;
+        savedLabelmap = baselineLabelmap;
+        savedLabelmap->SetOrigin(labelmap->GetOrigin());
+        savedLabelmap->SetSpacing(labelmap->GetSpacing());
+        savedLabelmap->CopyDirections(labelmap);
+      }
+      else
+      {
+        vtkSmartPointer<vtkOrientedImageData> labelmapCopy = vtkSmartPointer<vtkOrientedImageData>::New();
+        labelmapCopy->DeepCopy(labelmap);
+        copiedLabelmaps.push_back(labelmapCopy);
+        savedLabelmap = labelmapCopy;
+      }
+      savedObjects[labelmap] = savedLabelmap;
+    }
+
     vtkSmartPointer<vtkSegment> segmentClone = vtkSmartPointer<vtkSegment>::New();
     vtkSegmentation::CopySegment(segmentClone, segment, baselineSegment, savedObjects);
     newSegmentationState.Segments[*segmentIDIt] = segmentClone;
   }
+  if (!this->SegmentationStates.empty())
+  {
+    this->CompressLastState(savedLabelmaps);
+  }
   this->SegmentationStates.push_back(newSegmentationState);
 
   // Set the current state as last restored state.
@@ -226,6 +450,23 @@ bool vtkSegmentationHistory::RestoreState(unsigned int stateIndex)
 
   std::set<std::string> segmentIDsToKeep;
   std::map<vtkDataObject*, vtkDataObject*> restoredRepresentations;
+
+  // Labelmaps that are stored as difference are reconstructed into new objects,
+  // therefore they can be added to the segments without copying.
+  std::vector<vtkSmartPointer<vtkOrientedImageData> > reconstructedLabelmaps;
+  for (LabelmapDifferencesMap::iterator differenceIt = restoredState.LabelmapDifferences.begin();
+    differenceIt != restoredState.LabelmapDifferences.end(); ++differenceIt)
+  {
+    vtkSmartPointer<vtkOrientedImageData> labelmap = this->GetStateLabelmap(stateIndex, differenceIt->first);
+    if (!labelmap)
+    {
+      vtkErrorMacro("RestoreState failed: cannot reconstruct labelmap of state " << stateIndex);
+      this->RestoreStateInProgress = false;
+      return false;
+    }
+    reconstructedLabelmaps.push_back(labelmap);
+    restoredRepresentations[differenceIt->first] = labelmap;
+  }
   for (SegmentsMap::iterator restoredSegmentsIt = restoredState.Segments.begin();
     restoredSegmentsIt != restoredState.Segments.end(); ++restoredSegmentsIt)
   {
@@ -310,6 +551,11 @@ void vtkSegmentationHistory::RemoveAllNextStates()
   bool modified = false;
   while ((this->SegmentationStates.size() > this->LastRestoredState + 1) && (!this->SegmentationStates.empty()))
   {
+    if (this->SegmentationStates.size() > 1)
+    {
+      // The state before the removed state becomes the last state, which must contain full labelmaps
+      this->DecompressState(static_cast<unsigned int>(this->SegmentationStates.size()) - 2);
+    }
     this->SegmentationStates.pop_back();
     modified = true;
   }
@@ -323,8 +569,11 @@ void vtkSegmentationHistory::RemoveAllNextStates()
 void vtkSegmentationHistory::RemoveAllObsoleteStates()
 {
   bool modified = false;
-  while ((this->SegmentationStates.size() > this->MaximumNumberOfStates) && (!this->SegmentationStates.empty()))
+  while (!this->SegmentationStates.empty()
+    && (this->SegmentationStates.size() > this->MaximumNumberOfStates
+      || (this->MaximumMemorySize > 0 && this->LastRestoredState > 0 && this->GetMemorySize() > this->MaximumMemorySize)))
   {
+    // The oldest state is not referenced by other states, so it can be simply removed
     this->SegmentationStates.pop_front();
     this->LastRestoredState--;
     modified = true;
@@ -347,6 +596,235 @@ void vtkSegmentationHistory::SetMaximumNumberOfStates(unsigned int maximumNumber
   this->Modified();
 }
 
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::SetMaximumMemorySize(vtkTypeInt64 maximumMemorySize)
+{
+  if (maximumMemorySize == this->MaximumMemorySize)
+  {
+    return;
+  }
+  this->MaximumMemorySize = maximumMemorySize;
+  this->RemoveAllObsoleteStates();
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+vtkTypeInt64 vtkSegmentationHistory::GetMemorySize()
+{
+  vtkTypeInt64 memorySize = 0;
+  std::set<vtkDataObject*> countedObjects;
+  for (const SegmentationState& state : this->SegmentationStates)
+  {
+    for (LabelmapDifferencesMap::const_iterator differenceIt = state.LabelmapDifferences.begin();
+      differenceIt != state.LabelmapDifferences.end(); ++differenceIt)
+    {
+      countedObjects.insert(differenceIt->first);
+      if (differenceIt->second.CompressedScalars)
+      {
+        memorySize += differenceIt->second.CompressedScalars->GetNumberOfValues();
+      }
+    }
+    for (SegmentsMap::const_iterator segmentIt = state.Segments.begin(); segmentIt != state.Segments.end(); ++segmentIt)
+    {
+      std::vector<std::string> representationNames;
+      segmentIt->second->GetContainedRepresentationNames(representationNames);
+      for (const std::string& representationName : representationNames)
+      {
+        vtkDataObject* representation = segmentIt->second->GetRepresentation(representationName);
+        if (!representation || !countedObjects.insert(representation).second)
+        {
+          // already counted
+          continue;
+        }
+        // GetActualMemorySize returns size in kibibytes
+        memorySize += static_cast<vtkTypeInt64>(representation->GetActualMemorySize()) * 1024;
+      }
+    }
+  }
+  return memorySize;
+}
+
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::CompressLastState(std::map<vtkOrientedImageData*, vtkSmartPointer<vtkOrientedImageData> >& savedLabelmaps)
+{
+  SegmentationState& lastState = this->SegmentationStates.back();
+  for (SegmentsMap::iterator segmentIt = lastState.Segments.begin(); segmentIt != lastState.Segments.end(); ++segmentIt)
+  {
+    vtkSegment* segment = segmentIt->second;
+    std::vector<std::string> representationNames;
+    segment->GetContainedRepresentationNames(representationNames);
+    for (const std::string& representationName : representationNames)
+    {
+      vtkOrientedImageData* labelmap = vtkOrientedImageData::SafeDownCast(segment->GetRepresentation(representationName));
+      if (!labelmap)
+      {
+        continue;
+      }
+      std::map<vtkOrientedImageData*, vtkSmartPointer<vtkOrientedImageData> >::iterator savedLabelmapIt = savedLabelmaps.find(labelmap);
+      if (savedLabelmapIt == savedLabelmaps.end())
+      {
+        // Labelmap is not used in the new state, store the entire labelmap compressed
+        vtkSmartPointer<vtkOrientedImageData> geometry = CreateLabelmapGeometry(labelmap);
+        LabelmapDifference difference;
+        difference.ScalarType = labelmap->GetScalarType();
+        difference.NumberOfScalarComponents = labelmap->GetNumberOfScalarComponents();
+        if (!labelmap->IsEmpty() && labelmap->GetPointData()->GetScalars())
+        {
+          labelmap->GetExtent(difference.Extent);
+          difference.CompressedScalars = CompressImageRegion(labelmap, difference.Extent);
+        }
+        lastState.LabelmapDifferences[geometry] = difference;
+        savedLabelmapIt = savedLabelmaps.insert(std::make_pair(labelmap, geometry)).first;
+      }
+      segment->AddRepresentation(representationName, savedLabelmapIt->second);
+    }
+  }
+
+  // Differences in the state before the last state refer to labelmaps of the last state
+  if (this->SegmentationStates.size() > 1)
+  {
+    SegmentationState& previousState = this->SegmentationStates[this->SegmentationStates.size() - 2];
+    for (LabelmapDifferencesMap::iterator differenceIt = previousState.LabelmapDifferences.begin();
+      differenceIt != previousState.LabelmapDifferences.end(); ++differenceIt)
+    {
+      std::map<vtkOrientedImageData*, vtkSmartPointer<vtkOrientedImageData> >::iterator savedLabelmapIt =
+        savedLabelmaps.find(differenceIt->second.NextLabelmap);
+      if (savedLabelmapIt != savedLabelmaps.end())
+      {
+        differenceIt->second.NextLabelmap = savedLabelmapIt->second;
+      }
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::DecompressState(unsigned int stateIndex)
+{
+  SegmentationState& state = this->SegmentationStates[stateIndex];
+  std::map<vtkOrientedImageData*, vtkSmartPointer<vtkOrientedImageData> > fullLabelmaps;
+  for (LabelmapDifferencesMap::iterator differenceIt = state.LabelmapDifferences.begin();
+    differenceIt != state.LabelmapDifferences.end(); ++differenceIt)
+  {
+    // Labelmaps of the next state are updated in place, as the next state is about to be removed
+    vtkSmartPointer<vtkOrientedImageData> labelmap = differenceIt->second.NextLabelmap;
+    if (!labelmap)
+    {
+      labelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+    }
+    if (!vtkSegmentationHistory::ApplyLabelmapDifference(differenceIt->first, differenceIt->second, labelmap))
+    {
+      vtkErrorMacro("DecompressState: failed to reconstruct labelmap of state " << stateIndex);
+    }
+    fullLabelmaps[differenceIt->first] = labelmap;
+  }
+  if (fullLabelmaps.empty())
+  {
+    return;
+  }
+
+  for (SegmentsMap::iterator segmentIt = state.Segments.begin(); segmentIt != state.Segments.end(); ++segmentIt)
+  {
+    vtkSegment* segment = segmentIt->second;
+    std::vector<std::string> representationNames;
+    segment->GetContainedRepresentationNames(representationNames);
+    for (const std::string& representationName : representationNames)
+    {
+      std::map<vtkOrientedImageData*, vtkSmartPointer<vtkOrientedImageData> >::iterator fullLabelmapIt =
+        fullLabelmaps.find(vtkOrientedImageData::SafeDownCast(segment->GetRepresentation(representationName)));
+      if (fullLabelmapIt != fullLabelmaps.end())
+      {
+        segment->AddRepresentation(representationName, fullLabelmapIt->second);
+      }
+    }
+  }
+
+  // Differences in the previous state refer to the removed labelmap geometries
+  if (stateIndex > 0)
+  {
+    SegmentationState& previousState = this->SegmentationStates[stateIndex - 1];
+    for (LabelmapDifferencesMap::iterator differenceIt = previousState.LabelmapDifferences.begin();
+      differenceIt != previousState.LabelmapDifferences.end(); ++differenceIt)
+    {
+      std::map<vtkOrientedImageData*, vtkSmartPointer<vtkOrientedImageData> >::iterator fullLabelmapIt =
+        fullLabelmaps.find(differenceIt->second.NextLabelmap);
+      if (fullLabelmapIt != fullLabelmaps.end())
+      {
+        differenceIt->second.NextLabelmap = fullLabelmapIt->second;
+      }
+    }
+  }
+
+  state.LabelmapDifferences.clear();
+}
+
+//---------------------------------------------------------------------------
+vtkSmartPointer<vtkOrientedImageData> vtkSegmentationHistory::GetStateLabelmap(unsigned int stateIndex, vtkOrientedImageData* labelmap)
+{
+  if (stateIndex >= this->SegmentationStates.size() || !labelmap)
+  {
+    return nullptr;
+  }
+  SegmentationState& state = this->SegmentationStates[stateIndex];
+  LabelmapDifferencesMap::iterator differenceIt = state.LabelmapDifferences.find(labelmap);
+  if (differenceIt == state.LabelmapDifferences.end())
+  {
+    // Full labelmap
+    vtkSmartPointer<vtkOrientedImageData> labelmapCopy = vtkSmartPointer<vtkOrientedImageData>::New();
+    labelmapCopy->DeepCopy(labelmap);
+    return labelmapCopy;
+  }
+
+  vtkSmartPointer<vtkOrientedImageData> fullLabelmap;
+  if (differenceIt->second.NextLabelmap)
+  {
+    fullLabelmap = this->GetStateLabelmap(stateIndex + 1, differenceIt->second.NextLabelmap);
+    if (!fullLabelmap)
+    {
+      return nullptr;
+    }
+  }
+  else
+  {
+    fullLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+  }
+  if (!vtkSegmentationHistory::ApplyLabelmapDifference(differenceIt->first, differenceIt->second, fullLabelmap))
+  {
+    return nullptr;
+  }
+  return fullLabelmap;
+}
+
+//---------------------------------------------------------------------------
+bool vtkSegmentationHistory::ApplyLabelmapDifference(vtkOrientedImageData* geometry, const LabelmapDifference& difference,
+  vtkOrientedImageData* labelmap)
+{
+  if (!geometry || !labelmap)
+  {
+    return false;
+  }
+  if (!difference.NextLabelmap)
+  {
+    labelmap->SetExtent(geometry->GetExtent());
+    if (difference.CompressedScalars)
+    {
+      labelmap->AllocateScalars(difference.ScalarType, difference.NumberOfScalarComponents);
+    }
+  }
+  labelmap->SetOrigin(geometry->GetOrigin());
+  labelmap->SetSpacing(geometry->GetSpacing());
+  labelmap->CopyDirections(geometry);
+  if (difference.CompressedScalars && !IsExtentEmpty(difference.Extent))
+  {
+    if (!DecompressImageRegion(difference.CompressedScalars, labelmap, difference.Extent))
+    {
+      vtkErrorWithObjectMacro(nullptr, "ApplyLabelmapDifference: failed to decompress labelmap voxels");
+      return false;
+    }
+  }
+  labelmap->Modified();
+  return true;
+}
+
 //---------------------------------------------------------------------------
 void vtkSegmentationHistory::OnSegmentationModified(vtkObject* vtkNotUsed(caller),
   unsigned long vtkNotUsed(eid),
@@ -28,14 +28,24 @@
 // STD includes
 #include <deque>
 #include <map>
+#include <set>
 #include <vector>
 
 #include "vtkSegmentationCoreConfigure.h"
 
 class vtkCallbackCommand;
 class vtkDataObject;
+class vtkOrientedImageData;
 class vtkSegment;
 class vtkSegmentation;
+class vtkUnsignedCharArray;
+
+/// \brief Stores undo/redo states of a segmentation.
+///
+/// Binary labelmaps of the most recent state are stored as full copies. When a new state is saved,
+/// labelmaps of the previous state are replaced by the compressed difference from the new state
+/// (only the bounding box of the changed voxels is stored), therefore the memory needed for a state
+/// is proportional to the size of the edit instead of the size of the labelmap.
 
 class vtkSegmentationCore_EXPORT vtkSegmentationHistory : public vtkObject
 {
@@ -85,6 +95,17 @@ public:
   /// Get the current number of states.
   int GetNumberOfStates();
 
+  /// Limits the memory size of all stored states, in bytes.
+  /// If the limit is exceeded then the oldest states are removed. The last restored state is always kept.
+  /// 0 means that the memory size is not limited (default).
+  void SetMaximumMemorySize(vtkTypeInt64 maximumMemorySize);
+
+  /// Get the limit of the memory size of all stored states, in bytes.
+  vtkGetMacro(MaximumMemorySize, vtkTypeInt64);
+
+  /// Get the memory size of all stored states, in bytes.
+  vtkTypeInt64 GetMemorySize();
+
 protected:
   /// Callback function called when the segmentation has been modified.
   /// It clears all states that are more recent than the last restored state.
@@ -94,27 +115,67 @@ protected:
   void RemoveAllNextStates();
 
   /// Delete all old states so that we keep only up to MaximumNumberOfStates states
+  /// and the memory size does not exceed MaximumMemorySize
   void RemoveAllObsoleteStates();
 
   /// Restores a state defined by stateIndex.
   bool RestoreState(unsigned int stateIndex);
 
+  /// Replace full labelmaps of the last state by differences from the labelmaps of the state that is being saved.
+  /// \param savedLabelmaps Full labelmaps of the last state that are moved to the new state, mapped to the
+  ///   labelmap that stores the geometry of the difference. Other labelmaps of the last state are compressed.
+  void CompressLastState(std::map<vtkOrientedImageData*, vtkSmartPointer<vtkOrientedImageData> >& savedLabelmaps);
+
+  /// Replace labelmap differences in the specified state by full labelmaps.
+  /// Labelmaps of the next state are reused, therefore this must be called only before the next state
+  /// (which must be the last state) is removed.
+  void DecompressState(unsigned int stateIndex);
+
+  /// Get the full labelmap of a stored state labelmap. Labelmap differences are applied to the
+  /// labelmaps of the next states. The returned labelmap is a new object.
+  vtkSmartPointer<vtkOrientedImageData> GetStateLabelmap(unsigned int stateIndex, vtkOrientedImageData* labelmap);
+
 protected:
   vtkSegmentationHistory();
   ~vtkSegmentationHistory() override;
 
   typedef std::map<std::string, vtkSmartPointer<vtkSegment> > SegmentsMap;
 
+  /// Binary labelmap of a state that is stored as difference from a labelmap of the next state.
+  /// The labelmap representation in the state segments only contains the geometry (no scalars).
+  struct LabelmapDifference
+  {
+    /// Labelmap in the next state that the difference is applied to.
+    /// If nullptr then the difference contains the entire labelmap.
+    vtkSmartPointer<vtkOrientedImageData> NextLabelmap;
+    /// Extent of the stored voxels. Empty if there is no difference.
+    int Extent[6] = { 0, -1, 0, -1, 0, -1 };
+    int ScalarType{0};
+    int NumberOfScalarComponents{1};
+    /// Compressed voxels within Extent
+    vtkSmartPointer<vtkUnsignedCharArray> CompressedScalars;
+  };
+  typedef std::map<vtkSmartPointer<vtkOrientedImageData>, LabelmapDifference> LabelmapDifferencesMap;
+
   struct SegmentationState
   {
     SegmentsMap Segments;
     std::vector<std::string> SegmentIds; // order of segments
+    LabelmapDifferencesMap LabelmapDifferences;
   };
 
+  /// Apply labelmap difference to a labelmap.
+  /// \param geometry Labelmap that stores the geometry of the labelmap difference
+  /// \param difference Labelmap difference
+  /// \param labelmap Full labelmap of the next state (or empty labelmap if the difference contains the entire labelmap)
+  static bool ApplyLabelmapDifference(vtkOrientedImageData* geometry, const LabelmapDifference& difference,
+    vtkOrientedImageData* labelmap);
+
   vtkSegmentation* Segmentation;
   vtkCallbackCommand* SegmentationModifiedCallbackCommand;
   std::deque<SegmentationState> SegmentationStates;
   unsigned int MaximumNumberOfStates;
+  vtkTypeInt64 MaximumMemorySize;
 
   // Index of the state in SegmentationStates that was restored last.
   // If LastRestoredState == size of states then it means that the segmentation has changed
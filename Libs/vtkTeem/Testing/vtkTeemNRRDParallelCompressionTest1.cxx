@@ -0,0 +1,130 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include <vtkTeemNRRDReader.h>
+#include <vtkTeemNRRDWriter.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <cstring>
+#include <string>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+bool ReadAndCompare(const std::string& fileName, bool parallelDecompression, vtkImageData* expectedImage)
+{
+  vtkNew<vtkTeemNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->SetParallelDecompression(parallelDecompression);
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  reader->Update();
+  timer->StopTimer();
+  std::cout << "Read " << fileName << (parallelDecompression ? " (parallel): " : " (teem): ")
+    << timer->GetElapsedTime() << "s" << std::endl;
+
+  vtkImageData* image = reader->GetOutput();
+  int* dimensions = image->GetDimensions();
+  int* expectedDimensions = expectedImage->GetDimensions();
+  if (dimensions[0] != expectedDimensions[0] || dimensions[1] != expectedDimensions[1]
+    || dimensions[2] != expectedDimensions[2] || image->GetScalarType() != expectedImage->GetScalarType())
+  {
+    std::cerr << "Image geometry or scalar type mismatch in " << fileName << std::endl;
+    return false;
+  }
+  size_t dataSize = static_cast<size_t>(expectedImage->GetNumberOfPoints()) * expectedImage->GetScalarSize();
+  if (memcmp(image->GetScalarPointer(), expectedImage->GetScalarPointer(), dataSize) != 0)
+  {
+    std::cerr << "Voxel values mismatch in " << fileName << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkTeemNRRDParallelCompressionTest1(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string tempDir = argv[1];
+
+  // Image that spans multiple compression blocks, with a last block that is not full
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(97, 83, 61);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(image->GetScalarPointer());
+  vtkIdType numberOfVoxels = image->GetNumberOfPoints();
+  for (vtkIdType i = 0; i < numberOfVoxels; ++i)
+  {
+    voxels[i] = static_cast<short>((i * 7) % 1000 - 500);
+  }
+
+  vtkNew<vtkTeemNRRDWriter> writer;
+  if (writer->GetParallelCompression())
+  {
+    std::cerr << __LINE__ << ": Parallel compression is expected to be disabled by default" << std::endl;
+    return EXIT_FAILURE;
+  }
+  writer->SetInputData(image);
+  writer->SetUseCompression(true);
+
+  // Standard compression
+  std::string standardFileName = tempDir + "/vtkTeemNRRDParallelCompressionTest1_standard.nrrd";
+  writer->SetFileName(standardFileName.c_str());
+  writer->Write();
+  if (writer->GetWriteError())
+  {
+    std::cerr << __LINE__ << ": Failed to write " << standardFileName << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Parallel compression
+  std::string parallelFileName = tempDir + "/vtkTeemNRRDParallelCompressionTest1_parallel.nrrd";
+  writer->SetFileName(parallelFileName.c_str());
+  writer->SetParallelCompression(true);
+  writer->SetCompressionBlockSize(65536);
+  writer->Write();
+  if (writer->GetWriteError())
+  {
+    std::cerr << __LINE__ << ": Failed to write " << parallelFileName << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Both files must be readable by teem and by the parallel reader
+  if (!ReadAndCompare(standardFileName, false, image)
+    || !ReadAndCompare(standardFileName, true, image)
+    || !ReadAndCompare(parallelFileName, false, image)
+    || !ReadAndCompare(parallelFileName, true, image))
+  {
+    std::cerr << __LINE__ << ": Round-trip through NRRD file failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Parallel compression test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -47,11 +47,70 @@
 #include "vtkUnsignedShortArray.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnsignedLongArray.h"
+#include <vtkSMPTools.h>
+#include <vtk_zlib.h>
+#include <vtksys/FStream.hxx>
 #include <vtksys/SystemTools.hxx>
 
 // Teem includes
 #include "teem/ten.h"
 
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+// Layout of gzip members written by vtkTeemNRRDWriter::WriteBlockCompressedData.
+const size_t GZIP_BLOCK_HEADER_SIZE = 24;
+const size_t GZIP_BLOCK_TRAILER_SIZE = 8;
+
+//----------------------------------------------------------------------------
+vtkTypeUInt32 ReadUInt32LE(const unsigned char* buffer)
+{
+  return static_cast<vtkTypeUInt32>(buffer[0])
+    | (static_cast<vtkTypeUInt32>(buffer[1]) << 8)
+    | (static_cast<vtkTypeUInt32>(buffer[2]) << 16)
+    | (static_cast<vtkTypeUInt32>(buffer[3]) << 24);
+}
+
+//----------------------------------------------------------------------------
+bool IsBlockGzipMemberHeader(const unsigned char* header)
+{
+  return header[0] == 0x1f && header[1] == 0x8b && header[2] == 8 && header[3] == 4
+    && header[10] == 12 && header[11] == 0 && header[12] == 'S' && header[13] == 'B'
+    && header[14] == 8 && header[15] == 0;
+}
+
+//----------------------------------------------------------------------------
+bool DecompressGzipMember(const unsigned char* member, size_t memberSize, unsigned char* data, size_t dataSize)
+{
+  z_stream stream = {};
+  if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+  {
+    return false;
+  }
+  stream.next_in = const_cast<Bytef*>(member + GZIP_BLOCK_HEADER_SIZE);
+  stream.avail_in = static_cast<uInt>(memberSize - GZIP_BLOCK_HEADER_SIZE - GZIP_BLOCK_TRAILER_SIZE);
+  stream.next_out = data;
+  stream.avail_out = static_cast<uInt>(dataSize);
+  int result = inflate(&stream, Z_FINISH);
+  size_t decompressedSize = stream.total_out;
+  inflateEnd(&stream);
+  if (result != Z_STREAM_END || decompressedSize != dataSize)
+  {
+    return false;
+  }
+  uLong crc = crc32(0L, Z_NULL, 0);
+  crc = crc32(crc, data, static_cast<uInt>(dataSize));
+  const unsigned char* trailer = member + memberSize - GZIP_BLOCK_TRAILER_SIZE;
+  return ReadUInt32LE(trailer) == static_cast<vtkTypeUInt32>(crc)
+    && ReadUInt32LE(trailer + 4) == static_cast<vtkTypeUInt32>(dataSize);
+}
+} // end of anonymous namespace
+
 vtkStandardNewMacro(vtkTeemNRRDReader);
 
 //----------------------------------------------------------------------------
@@ -62,6 +121,7 @@ vtkTeemNRRDReader::vtkTeemNRRDReader()
   this->MeasurementFrameMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
   this->nrrd = nrrdNew();
   this->UseNativeOrigin = true;
+  this->ParallelDecompression = true;
   this->ReadStatus = 0;
   this->PointDataType = -1;
   this->DataType = -1;
@@ -925,7 +985,8 @@ void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInf
 
   // Read in the this->nrrd.  Yes, this means that the header is being read
   // twice: once by ExecuteInformation, and once here
-  if ( nrrdLoad(this->nrrd, this->GetFileName(), nullptr) != 0 )
+  bool dataLoaded = (this->ParallelDecompression && this->ReadBlockCompressedData());
+  if (!dataLoaded && nrrdLoad(this->nrrd, this->GetFileName(), nullptr) != 0)
   {
     char *err =  biffGetDone(NRRD); // would be nice to free(err)
     vtkErrorMacro("Read: Error reading " << this->GetFileName() << ":\n" << err);
@@ -1112,4 +1173,197 @@ void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInf
 void vtkTeemNRRDReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "ParallelDecompression: " << (this->ParallelDecompression ? "true" : "false") << "\n";
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDReader::GetDataLayout(const char* fileName, DataLayout& layout)
+{
+  layout = DataLayout();
+  if (!fileName)
+  {
+    return false;
+  }
+
+  // Read the header
+  Nrrd* nrrdHeader = nrrdNew();
+  NrrdIoState* nio = nrrdIoStateNew();
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  if (nrrdLoad(nrrdHeader, fileName, nio) != 0)
+  {
+    char* err = biffGetDone(NRRD);
+    free(err);
+    nio = nrrdIoStateNix(nio);
+    nrrdNuke(nrrdHeader);
+    return false;
+  }
+  bool attachedData = (nio->dataFNArr->len == 0 && nio->lineSkip == 0 && nio->byteSkip == 0 && !nio->detachedHeader);
+  layout.Raw = (nio->encoding == nrrdEncodingRaw);
+  bool gzip = (nio->encoding == nrrdEncodingGzip);
+  layout.NativeByteOrder = (nrrdElementSize(nrrdHeader) == 1 || nio->endian == airMyEndian());
+  layout.DataSize = nrrdElementNumber(nrrdHeader) * nrrdElementSize(nrrdHeader);
+  for (unsigned int axis = 0; axis < nrrdHeader->dim; ++axis)
+  {
+    layout.AxisSizes.push_back(nrrdHeader->axis[axis].size);
+  }
+  unsigned int rangeAxisIdx[NRRD_DIM_MAX] = { 0 };
+  if (nrrdRangeAxesGet(nrrdHeader, rangeAxisIdx) == 1)
+  {
+    layout.RangeAxis = static_cast<int>(rangeAxisIdx[0]);
+  }
+  nio = nrrdIoStateNix(nio);
+  nrrdNuke(nrrdHeader);
+  if (!attachedData || (!layout.Raw && !gzip))
+  {
+    return false;
+  }
+
+  vtksys::ifstream inputStream(fileName, std::ios::in | std::ios::binary);
+  if (!inputStream.good())
+  {
+    return false;
+  }
+
+  // Find the empty line that terminates the header
+  const size_t chunkSize = 65536;
+  const size_t maximumHeaderSize = 64 * chunkSize;
+  std::vector<char> header;
+  while (layout.DataOffset == 0 && header.size() < maximumHeaderSize)
+  {
+    size_t searchStart = (header.size() > 0 ? header.size() - 1 : 0);
+    header.resize(header.size() + chunkSize);
+    inputStream.read(header.data() + header.size() - chunkSize, chunkSize);
+    header.resize(header.size() - chunkSize + static_cast<size_t>(inputStream.gcount()));
+    for (size_t i = searchStart; i + 1 < header.size(); ++i)
+    {
+      if (header[i] == '\n' && header[i + 1] == '\n')
+      {
+        layout.DataOffset = i + 2;
+        break;
+      }
+    }
+    if (!inputStream.good())
+    {
+      break;
+    }
+  }
+  if (layout.DataOffset == 0)
+  {
+    return false;
+  }
+
+  inputStream.clear();
+  inputStream.seekg(0, std::ios::end);
+  size_t fileSize = static_cast<size_t>(inputStream.tellg());
+  if (layout.Raw)
+  {
+    return (layout.DataOffset + layout.DataSize <= fileSize);
+  }
+
+  // Locate all gzip members. Only the member headers are read.
+  size_t memberOffset = layout.DataOffset;
+  size_t uncompressedSize = 0;
+  unsigned char memberHeader[GZIP_BLOCK_HEADER_SIZE];
+  while (memberOffset < fileSize)
+  {
+    inputStream.seekg(static_cast<std::streamoff>(memberOffset), std::ios::beg);
+    inputStream.read(reinterpret_cast<char*>(memberHeader), GZIP_BLOCK_HEADER_SIZE);
+    if (static_cast<size_t>(inputStream.gcount()) != GZIP_BLOCK_HEADER_SIZE || !IsBlockGzipMemberHeader(memberHeader))
+    {
+      layout.Blocks.clear();
+      return false;
+    }
+    CompressedBlockInfo block = { memberOffset, ReadUInt32LE(memberHeader + 16), uncompressedSize, ReadUInt32LE(memberHeader + 20) };
+    if (block.MemberSize < GZIP_BLOCK_HEADER_SIZE + GZIP_BLOCK_TRAILER_SIZE
+      || memberOffset + block.MemberSize > fileSize)
+    {
+      layout.Blocks.clear();
+      return false;
+    }
+    layout.Blocks.push_back(block);
+    memberOffset += block.MemberSize;
+    uncompressedSize += block.DataSize;
+  }
+  if (layout.Blocks.empty() || uncompressedSize != layout.DataSize)
+  {
+    layout.Blocks.clear();
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDReader::DecompressBlock(const unsigned char* member, const CompressedBlockInfo& block, unsigned char* data)
+{
+  return DecompressGzipMember(member, block.MemberSize, data, block.DataSize);
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDReader::ReadBlockCompressedData()
+{
+  // The writer stores data in native byte order, other files are read by teem.
+  DataLayout layout;
+  if (!vtkTeemNRRDReader::GetDataLayout(this->GetFileName(), layout)
+    || layout.Blocks.empty() || !layout.NativeByteOrder)
+  {
+    return false;
+  }
+
+  // Read the header
+  NrrdIoState* nio = nrrdIoStateNew();
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  if (nrrdLoad(this->nrrd, this->GetFileName(), nio) != 0)
+  {
+    char* err = biffGetDone(NRRD);
+    free(err);
+    nio = nrrdIoStateNix(nio);
+    return false;
+  }
+  nio = nrrdIoStateNix(nio);
+  size_t dataSize = nrrdElementNumber(this->nrrd) * nrrdElementSize(this->nrrd);
+  if (dataSize != layout.DataSize)
+  {
+    return false;
+  }
+
+  // Read all compressed data
+  vtksys::ifstream inputStream(this->GetFileName(), std::ios::in | std::ios::binary);
+  const CompressedBlockInfo& lastBlock = layout.Blocks.back();
+  std::vector<unsigned char> compressedData(lastBlock.MemberOffset + lastBlock.MemberSize - layout.DataOffset);
+  inputStream.seekg(static_cast<std::streamoff>(layout.DataOffset), std::ios::beg);
+  inputStream.read(reinterpret_cast<char*>(compressedData.data()), compressedData.size());
+  if (static_cast<size_t>(inputStream.gcount()) != compressedData.size())
+  {
+    return false;
+  }
+  inputStream.close();
+
+  // Decompress members in parallel. nrrdEmpty/nrrdNuke releases the buffer.
+  unsigned char* data = static_cast<unsigned char*>(malloc(std::max<size_t>(dataSize, 1)));
+  if (!data)
+  {
+    return false;
+  }
+  std::atomic<bool> success(true);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(layout.Blocks.size()), 1, [&](vtkIdType firstBlock, vtkIdType lastBlock)
+  {
+    for (vtkIdType blockIndex = firstBlock; blockIndex < lastBlock && success; ++blockIndex)
+    {
+      const CompressedBlockInfo& block = layout.Blocks[static_cast<size_t>(blockIndex)];
+      if (!vtkTeemNRRDReader::DecompressBlock(compressedData.data() + block.MemberOffset - layout.DataOffset,
+        block, data + block.DataOffset))
+      {
+        success = false;
+      }
+    }
+  });
+  if (!success)
+  {
+    vtkWarningMacro("ReadBlockCompressedData: Failed to decompress image data in parallel, reading file using teem: "
+      << this->GetFileName());
+    free(data);
+    return false;
+  }
+  this->nrrd->data = data;
+  return true;
 }
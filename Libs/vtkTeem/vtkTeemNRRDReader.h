@@ -32,6 +32,7 @@
 #include <string>
 #include <map>
 #include <iostream>
+#include <vector>
 
 #include "vtkTeemConfigure.h"
 #include "vtkMedicalImageReader2.h"
@@ -155,6 +156,54 @@ public:
   vtkSetMacro(DataArrayName, std::string);
   vtkGetMacro(DataArrayName, std::string);
 
+  ///
+  /// Decompress image data in parallel if the file was written by vtkTeemNRRDWriter
+  /// with parallel compression enabled. Other files are always read using teem.
+  /// Enabled by default.
+  vtkSetMacro(ParallelDecompression, bool);
+  vtkGetMacro(ParallelDecompression, bool);
+  vtkBooleanMacro(ParallelDecompression, bool);
+
+#ifndef __VTK_WRAP__
+  /// Location of a gzip member in a file written by vtkTeemNRRDWriter
+  /// with parallel compression enabled.
+  struct CompressedBlockInfo
+  {
+    size_t MemberOffset; ///< position of the gzip member in the file
+    size_t MemberSize;
+    size_t DataOffset; ///< position of the decompressed block in the image data
+    size_t DataSize;
+  };
+
+  /// Describes where the image data is stored in a NRRD file.
+  struct DataLayout
+  {
+    /// Data is stored without compression.
+    bool Raw{false};
+    /// Data can be used without swapping bytes.
+    bool NativeByteOrder{false};
+    /// Position of the first byte of image data in the file.
+    size_t DataOffset{0};
+    /// Size of the image data after decompression, in bytes.
+    size_t DataSize{0};
+    /// Number of samples along each axis, fastest axis first.
+    std::vector<size_t> AxisSizes;
+    /// Index of the non-spatial axis (for example, list of frames), -1 if there is none or more than one.
+    int RangeAxis{-1};
+    /// List of gzip members if the data is block compressed.
+    std::vector<CompressedBlockInfo> Blocks;
+  };
+
+  /// Get location of the image data in the file.
+  /// Returns false if the data is not stored in the file as raw or block compressed data
+  /// (for example, the file is a detached header or it was compressed by teem).
+  static bool GetDataLayout(const char* fileName, DataLayout& layout);
+
+  /// Decompress a gzip member (read from the file from block.MemberOffset)
+  /// into data buffer of block.DataSize bytes. Returns false on error.
+  static bool DecompressBlock(const unsigned char* member, const CompressedBlockInfo& block, unsigned char* data);
+#endif
+
   int NrrdToVTKScalarType( const int nrrdPixelType ) const
   {
   switch( nrrdPixelType )
@@ -264,6 +313,7 @@ protected:
   int DataType;
   int NumberOfComponents;
   bool UseNativeOrigin;
+  bool ParallelDecompression;
   std::string DataArrayName;
 
   std::map <std::string, std::string> HeaderKeyValue;
@@ -275,6 +325,11 @@ protected:
   void ExecuteInformation() override;
   void ExecuteDataWithInformation(vtkDataObject *output, vtkInformation* outInfo) override;
 
+  /// Read image data into this->nrrd by decompressing gzip members in parallel.
+  /// Returns false if the file was not written by vtkTeemNRRDWriter with parallel compression
+  /// enabled or the data cannot be read this way. In this case the file must be read using teem.
+  bool ReadBlockCompressedData();
+
   int tenSpaceDirectionReduce(Nrrd *nout, const Nrrd *nin, double SD[9]);
 
 private:
@@ -7,13 +7,89 @@
 #include "vtkPointData.h"
 #include "vtkObjectFactory.h"
 #include "vtkInformation.h"
+#include <vtkSMPTools.h>
 #include <vtkVersion.h>
+#include <vtk_zlib.h>
+#include <vtksys/SystemTools.hxx>
 
 #include <itkMath.h>
 #include <vnl/vnl_double_3.h>
 
 #include "itkNumberToString.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+// Layout of a gzip member written by WriteBlockCompressedData (see RFC 1952).
+// The extra field contains a "SB" subfield that stores the size of the member
+// and the size of the uncompressed block, which allows vtkTeemNRRDReader to
+// locate all members without decompressing them.
+const size_t GZIP_BLOCK_HEADER_SIZE = 24;
+const size_t GZIP_BLOCK_TRAILER_SIZE = 8;
+
+//----------------------------------------------------------------------------
+void WriteUInt32LE(unsigned char* buffer, vtkTypeUInt32 value)
+{
+  buffer[0] = static_cast<unsigned char>(value & 0xff);
+  buffer[1] = static_cast<unsigned char>((value >> 8) & 0xff);
+  buffer[2] = static_cast<unsigned char>((value >> 16) & 0xff);
+  buffer[3] = static_cast<unsigned char>((value >> 24) & 0xff);
+}
+
+//----------------------------------------------------------------------------
+bool CompressGzipMember(const unsigned char* data, size_t dataSize, int compressionLevel, std::vector<unsigned char>& member)
+{
+  z_stream stream = {};
+  if (deflateInit2(&stream, compressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+  {
+    return false;
+  }
+  uLong maximumCompressedSize = deflateBound(&stream, static_cast<uLong>(dataSize));
+  member.resize(GZIP_BLOCK_HEADER_SIZE + maximumCompressedSize + GZIP_BLOCK_TRAILER_SIZE);
+  stream.next_in = const_cast<Bytef*>(data);
+  stream.avail_in = static_cast<uInt>(dataSize);
+  stream.next_out = member.data() + GZIP_BLOCK_HEADER_SIZE;
+  stream.avail_out = static_cast<uInt>(maximumCompressedSize);
+  int result = deflate(&stream, Z_FINISH);
+  size_t compressedSize = stream.total_out;
+  deflateEnd(&stream);
+  if (result != Z_STREAM_END)
+  {
+    return false;
+  }
+  size_t memberSize = GZIP_BLOCK_HEADER_SIZE + compressedSize + GZIP_BLOCK_TRAILER_SIZE;
+  member.resize(memberSize);
+
+  unsigned char* header = member.data();
+  header[0] = 0x1f; // ID1
+  header[1] = 0x8b; // ID2
+  header[2] = 8; // CM = deflate
+  header[3] = 4; // FLG = FEXTRA
+  WriteUInt32LE(header + 4, 0); // MTIME
+  header[8] = 0; // XFL
+  header[9] = 255; // OS = unknown
+  header[10] = 12; // XLEN
+  header[11] = 0;
+  header[12] = 'S'; // SI1
+  header[13] = 'B'; // SI2
+  header[14] = 8; // LEN
+  header[15] = 0;
+  WriteUInt32LE(header + 16, static_cast<vtkTypeUInt32>(memberSize));
+  WriteUInt32LE(header + 20, static_cast<vtkTypeUInt32>(dataSize));
+
+  unsigned char* trailer = member.data() + memberSize - GZIP_BLOCK_TRAILER_SIZE;
+  uLong crc = crc32(0L, Z_NULL, 0);
+  crc = crc32(crc, data, static_cast<uInt>(dataSize));
+  WriteUInt32LE(trailer, static_cast<vtkTypeUInt32>(crc));
+  WriteUInt32LE(trailer + 4, static_cast<vtkTypeUInt32>(dataSize));
+  return true;
+}
+} // end of anonymous namespace
+
 
 class AttributeMapType: public std::map<std::string, std::string> {};
 class AxisInfoMapType : public std::map<unsigned int, std::string> {};
@@ -31,6 +107,8 @@ vtkTeemNRRDWriter::vtkTeemNRRDWriter()
   this->UseCompression = 1;
   // use default CompressionLevel
   this->CompressionLevel = -1;
+  this->ParallelCompression = false;
+  this->CompressionBlockSize = 4 * 1024 * 1024;
   this->DiffusionWeightedData = 0;
   this->FileType = VTK_BINARY;
   this->WriteErrorOff();
@@ -414,15 +492,26 @@ void vtkTeemNRRDWriter::WriteData()
 
   NrrdIoState *nio = nrrdIoStateNew();
 
+  // Image data is compressed in parallel blocks after the header is written by teem.
+  // This is only possible if the data is stored in the same file as the header.
+  std::string extension = vtksys::SystemTools::LowerCase(
+    vtksys::SystemTools::GetFilenameLastExtension(this->GetFileName()));
+  bool writeBlockCompressedData = this->ParallelCompression && extension != ".nhdr";
+
   // set encoding for data: compressed (raw), (uncompressed) raw, or ascii
   if ( this->GetUseCompression() && nrrdEncodingGzip->available() )
   {
     // this is necessarily gzip-compressed *raw* data
     nio->encoding = nrrdEncodingGzip;
     nio->zlibLevel = this->CompressionLevel;
+    if (writeBlockCompressedData)
+    {
+      nrrdIoStateSet(nio, nrrdIoStateSkipData, AIR_TRUE);
+    }
   }
   else
   {
+    writeBlockCompressedData = false;
     int fileType = this->GetFileType();
     switch ( fileType )
     {
@@ -447,6 +536,15 @@ void vtkTeemNRRDWriter::WriteData()
                       << this->GetFileName() << ":\n" << err);
     this->WriteErrorOn();
   }
+  else if (writeBlockCompressedData)
+  {
+    size_t dataSize = nrrdElementNumber(nrrd) * nrrdElementSize(nrrd);
+    if (!this->WriteBlockCompressedData(nrrd->data, dataSize))
+    {
+      vtkErrorMacro("Write: Error writing compressed image data to " << this->GetFileName());
+      this->WriteErrorOn();
+    }
+  }
   // Free the nrrd struct but don't touch nrrd->data
   nrrd = nrrdNix(nrrd);
   nio = nrrdIoStateNix(nio);
@@ -460,6 +558,84 @@ void vtkTeemNRRDWriter::PrintSelf(ostream& os, vtkIndent indent)
      this->IJKToRASMatrix->PrintSelf(os,indent);
   os << indent << "Measurement frame: ";
      this->MeasurementFrameMatrix->PrintSelf(os,indent);
+  os << indent << "ParallelCompression: " << (this->ParallelCompression ? "true" : "false") << "\n";
+  os << indent << "CompressionBlockSize: " << this->CompressionBlockSize << "\n";
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDWriter::WriteBlockCompressedData(const void* data, size_t dataSize)
+{
+  FILE* file = vtksys::SystemTools::Fopen(this->GetFileName(), "r+b");
+  if (!file)
+  {
+    vtkErrorMacro("WriteBlockCompressedData: Failed to open " << this->GetFileName());
+    return false;
+  }
+
+  // The header must be terminated by an empty line, which is followed by the data.
+  bool success = true;
+  fseek(file, 0, SEEK_END);
+  long headerSize = ftell(file);
+  char headerEnd[2] = { 0, 0 };
+  if (headerSize >= 2)
+  {
+    fseek(file, headerSize - 2, SEEK_SET);
+    success = (fread(headerEnd, 1, 2, file) == 2);
+  }
+  fseek(file, 0, SEEK_END);
+  if (success && (headerEnd[0] != '\n' || headerEnd[1] != '\n'))
+  {
+    success = (fputc('\n', file) != EOF);
+  }
+
+  // Compress a batch of blocks in parallel then write them in order,
+  // to limit the amount of memory used for compressed data.
+  const unsigned char* dataBytes = static_cast<const unsigned char*>(data);
+  const size_t blockSize = static_cast<size_t>(this->CompressionBlockSize);
+  const vtkIdType numberOfBlocks = std::max<vtkIdType>(1, static_cast<vtkIdType>((dataSize + blockSize - 1) / blockSize));
+  const vtkIdType numberOfBlocksInBatch = 4 * std::max(1, vtkSMPTools::GetEstimatedNumberOfThreads());
+  const int compressionLevel = (this->CompressionLevel < 0 ? Z_DEFAULT_COMPRESSION : this->CompressionLevel);
+  std::vector<std::vector<unsigned char>> members(static_cast<size_t>(std::min(numberOfBlocks, numberOfBlocksInBatch)));
+  for (vtkIdType batchStart = 0; success && batchStart < numberOfBlocks; batchStart += numberOfBlocksInBatch)
+  {
+    vtkIdType batchEnd = std::min(numberOfBlocks, batchStart + numberOfBlocksInBatch);
+    std::atomic<bool> compressionSucceeded(true);
+    vtkSMPTools::For(batchStart, batchEnd, 1, [&](vtkIdType firstBlock, vtkIdType lastBlock)
+    {
+      for (vtkIdType blockIndex = firstBlock; blockIndex < lastBlock; ++blockIndex)
+      {
+        size_t blockStart = static_cast<size_t>(blockIndex) * blockSize;
+        size_t currentBlockSize = std::min(blockSize, dataSize - std::min(blockStart, dataSize));
+        if (!CompressGzipMember(dataBytes + blockStart, currentBlockSize, compressionLevel,
+          members[static_cast<size_t>(blockIndex - batchStart)]))
+        {
+          compressionSucceeded = false;
+        }
+      }
+    });
+    if (!compressionSucceeded)
+    {
+      vtkErrorMacro("WriteBlockCompressedData: Failed to compress image data");
+      success = false;
+      break;
+    }
+    for (vtkIdType blockIndex = batchStart; blockIndex < batchEnd; ++blockIndex)
+    {
+      const std::vector<unsigned char>& member = members[static_cast<size_t>(blockIndex - batchStart)];
+      if (fwrite(member.data(), 1, member.size(), file) != member.size())
+      {
+        vtkErrorMacro("WriteBlockCompressedData: Failed to write " << this->GetFileName());
+        success = false;
+        break;
+      }
+    }
+  }
+
+  if (fclose(file) != 0)
+  {
+    success = false;
+  }
+  return success;
 }
 
 void vtkTeemNRRDWriter::SetAttribute(const std::string& name, const std::string& value)
@@ -58,6 +58,21 @@ public:
   vtkSetClampMacro(CompressionLevel, int, 0, 9);
   vtkGetMacro(CompressionLevel, int);
 
+  /// Compress the image data in independent blocks using multiple threads.
+  /// Each block is written as a separate gzip member, therefore the file remains
+  /// a standard gzip-encoded NRRD file that any NRRD reader can load.
+  /// vtkTeemNRRDReader recognizes these files and decompresses the blocks in parallel.
+  /// Only used if compression is enabled and the header is not detached (.nrrd file).
+  /// Disabled by default.
+  vtkSetMacro(ParallelCompression, bool);
+  vtkGetMacro(ParallelCompression, bool);
+  vtkBooleanMacro(ParallelCompression, bool);
+
+  /// Size of uncompressed data in each block, in bytes, if parallel compression is enabled.
+  /// Default is 4MB.
+  vtkSetClampMacro(CompressionBlockSize, vtkIdType, 65536, VTK_INT_MAX);
+  vtkGetMacro(CompressionBlockSize, vtkIdType);
+
   vtkSetClampMacro(FileType,int,VTK_ASCII,VTK_BINARY);
   vtkGetMacro(FileType,int);
   void SetFileTypeToASCII() {this->SetFileType(VTK_ASCII);};
@@ -115,6 +130,10 @@ protected:
   /// Write method. It is called by vtkWriter::Write();
   void WriteData() override;
 
+  /// Append image data to the file as gzip members that are compressed in parallel.
+  /// Returns false on error.
+  bool WriteBlockCompressedData(const void* data, size_t dataSize);
+
   ///
   /// Flag to set to on when a write error occurred
   int WriteError;
@@ -129,6 +148,8 @@ protected:
 
   int UseCompression;
   int CompressionLevel;
+  bool ParallelCompression;
+  vtkIdType CompressionBlockSize;
   int FileType;
 
   AttributeMapType *Attributes;
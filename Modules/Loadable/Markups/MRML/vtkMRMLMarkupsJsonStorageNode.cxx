@@ -36,6 +36,9 @@
 
 #include "itkNumberToString.h"
 
+// STD includes
+#include <memory>
+
 namespace
 {
   // Schema ID used to be an URL where the schema was available, but since "master" branch was renamed
@@ -717,14 +720,19 @@ bool vtkMRMLMarkupsJsonStorageNode::ReadControlPoints(vtkMRMLMarkupsJsonElement*
       "File reading failed: invalid controlPoints item (it is expected to be an array).");
     return false;
   }
+  // Point added/modified events, curve and interaction handle updates are processed once,
+  // when all the points are added. Otherwise loading large point sets would take quadratic time.
+  int wasModified = markupsNode->StartModify();
   bool wasUpdatingPoints = markupsNode->IsUpdatingPoints;
   markupsNode->IsUpdatingPoints = true;
+  bool success = true;
   int numberOfControlPoints = controlPointsArray->GetArraySize();
+  markupsNode->ControlPoints.reserve(markupsNode->ControlPoints.size() + numberOfControlPoints);
   for (int controlPointIndex = 0; controlPointIndex < numberOfControlPoints; ++controlPointIndex)
   {
     vtkSmartPointer<vtkMRMLMarkupsJsonElement> controlPointItem
       = vtkSmartPointer<vtkMRMLMarkupsJsonElement>::Take(controlPointsArray->GetArrayItem(controlPointIndex));
-    vtkMRMLMarkupsNode::ControlPoint* cp = new vtkMRMLMarkupsNode::ControlPoint;
+    std::unique_ptr<vtkMRMLMarkupsNode::ControlPoint> cp(new vtkMRMLMarkupsNode::ControlPoint);
     controlPointItem->GetStringProperty("id", cp->ID);
     controlPointItem->GetStringProperty("label", cp->Label);
     controlPointItem->GetStringProperty("description", cp->Description);
@@ -741,7 +749,8 @@ bool vtkMRMLMarkupsJsonStorageNode::ReadControlPoints(vtkMRMLMarkupsJsonElement*
           "vtkMRMLMarkupsJsonStorageNode::ReadControlPoints",
           "File reading failed: invalid positionStatus '" << positionStatusStr
           << "' for control point " << controlPointIndex + 1 << ".");
-        return false;
+        success = false;
+        break;
       }
       cp->PositionStatus = positionStatus;
     }
@@ -758,7 +767,8 @@ bool vtkMRMLMarkupsJsonStorageNode::ReadControlPoints(vtkMRMLMarkupsJsonElement*
         "vtkMRMLMarkupsJsonStorageNode::ReadControlPoints",
         "File reading failed: position must be a 3-element numeric array"
         << " for control point " << controlPointIndex + 1 << ".");
-      return false;
+      success = false;
+      break;
     }
     if (hasPosition)
     {
@@ -787,7 +797,8 @@ bool vtkMRMLMarkupsJsonStorageNode::ReadControlPoints(vtkMRMLMarkupsJsonElement*
         "vtkMRMLMarkupsJsonStorageNode::ReadControlPoints",
         "File reading failed: orientation must be a 9-element numeric array"
         << " for control point " << controlPointIndex + 1 << ".");
-      return false;
+      success = false;
+      break;
     }
     if (hasOrientation)
     {
@@ -812,13 +823,14 @@ bool vtkMRMLMarkupsJsonStorageNode::ReadControlPoints(vtkMRMLMarkupsJsonElement*
     {
       cp->Visibility = controlPointItem->GetBoolProperty("visibility");
     }
-    markupsNode->AddControlPoint(cp, false);
+    markupsNode->AddControlPoint(cp.release(), false);
   }
 
   markupsNode->IsUpdatingPoints = wasUpdatingPoints;
-  markupsNode->UpdateAllMeasurements();
+  // Measurements are updated in EndModify
+  markupsNode->EndModify(wasModified);
 
-  return true;
+  return success;
 }
 
 //----------------------------------------------------------------------------
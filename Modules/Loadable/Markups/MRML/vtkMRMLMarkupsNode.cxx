@@ -39,6 +39,7 @@
 #include <vtkCallbackCommand.h>
 #include <vtkCellLocator.h>
 #include <vtkCollection.h>
+#include <vtkDataArray.h>
 #include <vtkParallelTransportFrame.h>
 #include <vtkGeneralTransform.h>
 #include <vtkMatrix3x3.h>
@@ -721,6 +722,8 @@ int vtkMRMLMarkupsNode::AddNControlPoints(int n, std::string label /*=std::strin
     return -1;
   }
 
+  // Point added/modified events are invoked once, when all the points are added
+  int wasModified = this->StartModify();
   int controlPointIndex = -1;
   for (int i = 0; i < n; i++)
   {
@@ -739,6 +742,7 @@ int vtkMRMLMarkupsNode::AddNControlPoints(int n, std::string label /*=std::strin
     }
     controlPointIndex = this->AddControlPoint(controlPoint);
   }
+  this->EndModify(wasModified);
 
   return controlPointIndex;
 }
@@ -1960,6 +1964,18 @@ bool vtkMRMLMarkupsNode::GetModifiedSinceRead()
   return false;
 }
 
+//---------------------------------------------------------------------------
+vtkMTimeType vtkMRMLMarkupsNode::GetContentMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetContentMTime();
+  vtkPoints* points = this->CurveInputPoly->GetPoints();
+  if (points != nullptr)
+  {
+    mTime = std::max(mTime, points->GetMTime());
+  }
+  return mTime;
+}
+
 //---------------------------------------------------------------------------
 bool vtkMRMLMarkupsNode::ResetNthControlPointID(int n)
 {
@@ -2544,32 +2560,78 @@ void vtkMRMLMarkupsNode::SetControlPointPositionsWorld(vtkPoints* points, bool s
     return;
   }
 
+  vtkIdType numberOfPoints = points->GetNumberOfPoints();
+  vtkIdType numberOfExistingPoints = this->GetNumberOfControlPoints();
+  // Number of control points after adding/removing points
+  vtkIdType numberOfControlPoints = numberOfPoints;
+  if (numberOfPoints != numberOfExistingPoints && this->GetFixedNumberOfControlPoints())
+  {
+    vtkErrorMacro("SetControlPointPositionsWorld: Markup node control point number is locked.");
+    numberOfControlPoints = numberOfExistingPoints;
+  }
+  else if (this->MaximumNumberOfControlPoints >= 0 && numberOfPoints > this->MaximumNumberOfControlPoints)
+  {
+    vtkErrorMacro("SetControlPointPositionsWorld: number of points (" << numberOfPoints
+      << ") is more than maximum number of control points allowed (" << this->MaximumNumberOfControlPoints << ")");
+    numberOfControlPoints = std::max(numberOfExistingPoints, static_cast<vtkIdType>(this->MaximumNumberOfControlPoints));
+  }
+
   int wasModified = this->StartModify();
   this->IsUpdatingPoints = true;
 
-  vtkIdType numberOfPoints = points->GetNumberOfPoints();
-  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+  // Get the transform once instead of for each point
+  vtkNew<vtkGeneralTransform> worldToNodeTransform;
+  vtkMRMLTransformNode::GetTransformBetweenNodes(nullptr, this->GetParentTransformNode(), worldToNodeTransform);
+
+  // Modified events are only stored (not invoked) until EndModify,
+  // therefore positions are set directly.
+  for (vtkIdType pointIndex = 0; pointIndex < std::min(numberOfPoints, numberOfExistingPoints); pointIndex++)
   {
-    double* posWorld = points->GetPoint(pointIndex);
-    if (pointIndex < this->GetNumberOfControlPoints())
+    ControlPoint* controlPoint = this->ControlPoints[pointIndex];
+    int oldPositionStatus = controlPoint->PositionStatus;
+    if (!setUndefinedPoints && oldPositionStatus != PositionDefined)
     {
-      // point already exists, just update it
-      if (setUndefinedPoints || this->GetNthControlPointPositionStatus(pointIndex) == PositionDefined)
-      {
-        this->SetNthControlPointPositionWorld(pointIndex, posWorld);
-      }
+      continue;
     }
-    else
+    worldToNodeTransform->TransformPoint(points->GetPoint(pointIndex), controlPoint->Position);
+    controlPoint->PositionStatus = PositionDefined;
+    int n = static_cast<int>(pointIndex);
+    this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointModifiedEvent, static_cast<void*>(&n));
+    if (oldPositionStatus != PositionDefined)
+    {
+      this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointPositionDefinedEvent, static_cast<void*>(&n));
+    }
+    if (oldPositionStatus == PositionMissing)
     {
-      // need to add a new point
-      vtkMRMLMarkupsNode::AddControlPointWorld(vtkVector3d(posWorld));
+      this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointPositionNonMissingEvent, static_cast<void*>(&n));
     }
   }
-  while (this->GetNumberOfControlPoints() > numberOfPoints)
+
+  // Add new points
+  if (numberOfControlPoints > numberOfExistingPoints)
+  {
+    this->ControlPoints.reserve(numberOfControlPoints);
+  }
+  for (vtkIdType pointIndex = numberOfExistingPoints; pointIndex < numberOfControlPoints; pointIndex++)
+  {
+    ControlPoint* controlPoint = new ControlPoint;
+    worldToNodeTransform->TransformPoint(points->GetPoint(pointIndex), controlPoint->Position);
+    controlPoint->PositionStatus = PositionDefined;
+    this->AddControlPoint(controlPoint);
+  }
+
+  // Remove extra points
+  while (this->GetNumberOfControlPoints() > numberOfControlPoints)
   {
     this->RemoveNthControlPoint(this->GetNumberOfControlPoints() - 1);
   }
 
+  this->StorableModifiedTime.Modified();
+  if (this->GetDisplayNode())
+  {
+    this->GetDisplayNode()->UpdateScalarRange();
+  }
+
   this->IsUpdatingPoints = false;
   // No need to call UpdateAllMeasurements(), because it is automatically
   // called in EndModify().
@@ -2583,16 +2645,41 @@ void vtkMRMLMarkupsNode::GetControlPointPositionsWorld(vtkPoints* points)
   {
     return;
   }
+  vtkNew<vtkGeneralTransform> nodeToWorldTransform;
+  vtkMRMLTransformNode::GetTransformBetweenNodes(this->GetParentTransformNode(), nullptr, nodeToWorldTransform);
   int numberOfControlPoints = this->GetNumberOfControlPoints();
   points->SetNumberOfPoints(numberOfControlPoints);
   double posWorld[3] = { 0.0, 0.0, 0.0 };
   for (int controlPointIndex = 0; controlPointIndex < numberOfControlPoints; controlPointIndex++)
   {
-    this->GetNthControlPointPositionWorld(controlPointIndex, posWorld);
+    nodeToWorldTransform->TransformPoint(this->ControlPoints[controlPointIndex]->Position, posWorld);
     points->SetPoint(controlPointIndex, posWorld);
   }
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::GetControlPointNormalsWorld(vtkDataArray* normalsWorld)
+{
+  if (!normalsWorld)
+  {
+    vtkErrorMacro("GetControlPointNormalsWorld failed: invalid normals array");
+    return;
+  }
+  vtkNew<vtkGeneralTransform> nodeToWorldTransform;
+  vtkMRMLTransformNode::GetTransformBetweenNodes(this->GetParentTransformNode(), nullptr, nodeToWorldTransform);
+  int numberOfControlPoints = this->GetNumberOfControlPoints();
+  normalsWorld->SetNumberOfComponents(3);
+  normalsWorld->SetNumberOfTuples(numberOfControlPoints);
+  double normalWorld[3] = { 0.0, 0.0, 1.0 };
+  for (int controlPointIndex = 0; controlPointIndex < numberOfControlPoints; controlPointIndex++)
+  {
+    ControlPoint* controlPoint = this->ControlPoints[controlPointIndex];
+    double normalNode[3] = { controlPoint->OrientationMatrix[2], controlPoint->OrientationMatrix[5], controlPoint->OrientationMatrix[8] };
+    nodeToWorldTransform->TransformVectorAtPoint(controlPoint->Position, normalNode, normalWorld);
+    normalsWorld->SetTuple(controlPointIndex, normalWorld);
+  }
+}
+
 //---------------------------------------------------------------------------
 bool vtkMRMLMarkupsNode::SetControlPointLabelsWorld(vtkStringArray* labels, vtkPoints* points, std::string separator /*=""*/)
 {
@@ -2920,12 +3007,15 @@ void vtkMRMLMarkupsNode::UpdateInteractionHandleToWorldMatrix()
   int numberOfControlPoints = this->GetNumberOfControlPoints();
   int numberOfMovableControlPoints = this->GetNumberOfMovableControlPoints();
   vtkNew<vtkPoints> controlPoints_World;
+  vtkNew<vtkGeneralTransform> nodeToWorldTransform;
+  vtkMRMLTransformNode::GetTransformBetweenNodes(this->GetParentTransformNode(), nullptr, nodeToWorldTransform);
   for (int i = 0; i < numberOfControlPoints; ++i)
   {
     double controlPointPosition_World[3] = { 0.0, 0.0, 0.0 };
-    if (!this->GetNthControlPointLocked(i) && this->GetNthControlPointPositionStatus(i) == PositionDefined)
+    ControlPoint* controlPoint = this->ControlPoints[i];
+    if (!controlPoint->Locked && controlPoint->PositionStatus == PositionDefined)
     {
-      this->GetNthControlPointPositionWorld(i, controlPointPosition_World);
+      nodeToWorldTransform->TransformPoint(controlPoint->Position, controlPointPosition_World);
 
       origin_World[0] += controlPointPosition_World[0] / numberOfMovableControlPoints;
       origin_World[1] += controlPointPosition_World[1] / numberOfMovableControlPoints;
@@ -308,6 +308,7 @@ public:
   /// otherwise control point positions are initialized to (0,0,0).
   /// If requested number of points would result more points than the maximum allowed number of points
   /// then no points are added at all.
+  /// Point added and modified events are invoked once, after all the points are added.
   /// Return index of the last placed control point, -1 on failure.
   int AddNControlPoints(int n, std::string label = std::string(), vtkVector3d* point = nullptr);
   int AddNControlPoints(int n, std::string label, double point[3]);
@@ -318,11 +319,19 @@ public:
   /// New control points are added if needed.
   /// Existing control points are updated with the new positions.
   /// Any extra existing control points are removed.
+  /// All points are transformed at once and modified events are only invoked
+  /// when all the points are set, therefore this method should be preferred over
+  /// setting positions one by one for large point sets.
   void SetControlPointPositionsWorld(vtkPoints* points, bool setUndefinedPoints=true);
 
   /// Get a copy of all control point positions in world coordinate system
   void GetControlPointPositionsWorld(vtkPoints* points);
 
+  /// Get normal vector of all control points in world coordinate system.
+  /// The array has 3 components and one tuple per control point.
+  /// \sa GetNthControlPointNormalWorld
+  void GetControlPointNormalsWorld(vtkDataArray* normalsWorld);
+
   ///@{
   /// Add a new control point, returning the point index, -1 on failure.
   int AddControlPoint(vtkVector3d point, std::string label = std::string());
@@ -629,6 +638,9 @@ public:
   /// \sa vtkMRMLStorableNode::GetModifiedSinceRead()
   bool GetModifiedSinceRead() override;
 
+  /// Reimplemented to take into account the modified time of the curve points.
+  vtkMTimeType GetContentMTime() override;
+
   /// Reset the id of the Nth control point according to the local policy
   /// Called after an already initialized markup has been added to the
   /// scene. Returns false if n out of bounds, true on success.
@@ -26,6 +26,7 @@
 #include <vtkTestingOutputWindow.h>
 
 // STL includes
+#include <algorithm>
 #include <vector>
 
 #include "vtkMRMLCoreTestingMacros.h"
@@ -150,5 +151,13 @@ int vtkMRMLMarkupsNodeEventsTest(int, char* [])
   node->RemoveNthControlPoint(0);
   CHECK_BOOL(containsEvent(observer, vtkMRMLMarkupsNode::PointAboutToBeRemovedEvent), true);
 
+  // Test 13: PointAddedEvent is invoked once when adding many points
+  observer->invokedEvents.clear();
+  node->AddNControlPoints(100, "", &point1);
+  CHECK_INT(node->GetNumberOfControlPoints(), 100);
+  CHECK_INT(static_cast<int>(std::count(observer->invokedEvents.begin(), observer->invokedEvents.end(),
+    vtkMRMLMarkupsNode::PointAddedEvent)), 1);
+  observer->invokedEvents.clear();
+
   return EXIT_SUCCESS;
 }
@@ -23,12 +23,14 @@
 #include "vtkMRMLScene.h"
 
 // VTK includes
+#include <vtkDoubleArray.h>
 #include <vtkImageData.h>
 #include <vtkGeneralTransform.h>
 #include <vtkMatrix3x3.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
 #include <vtkOrientedBSplineTransform.h>
 #include <vtkTransform.h>
 
@@ -144,6 +146,49 @@ int TestMarkupOrientation(std::vector<PointOrientation> originalOrientations, vt
     }
   }
 
+  // ------------------
+  // Check that positions and normals of all points match values of individual points
+  vtkNew<vtkPoints> positions_World;
+  markupsNode->GetControlPointPositionsWorld(positions_World);
+  vtkNew<vtkDoubleArray> normals_World;
+  markupsNode->GetControlPointNormalsWorld(normals_World);
+  CHECK_INT(positions_World->GetNumberOfPoints(), markupsNode->GetNumberOfControlPoints());
+  CHECK_INT(normals_World->GetNumberOfTuples(), markupsNode->GetNumberOfControlPoints());
+  for (int index = 0; index < markupsNode->GetNumberOfControlPoints(); ++index)
+  {
+    vtkVector3d position_World = markupsNode->GetNthControlPointPositionWorld(index);
+    vtkVector3d normal_World = markupsNode->GetNthControlPointNormalWorld(index);
+    for (int i = 0; i < 3; ++i)
+    {
+      CHECK_DOUBLE_TOLERANCE(positions_World->GetPoint(index)[i], position_World[i], TOLERANCE);
+      CHECK_DOUBLE_TOLERANCE(normals_World->GetComponent(index, i), normal_World[i], TOLERANCE);
+    }
+  }
+
+  // ------------------
+  // Check that setting all positions at once adds and removes points and keeps orientations
+  vtkNew<vtkPoints> newPositions_World;
+  newPositions_World->DeepCopy(positions_World);
+  newPositions_World->InsertNextPoint(1.0, 2.0, 3.0);
+  markupsNode->SetControlPointPositionsWorld(newPositions_World);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), static_cast<int>(originalOrientations.size()) + 1);
+  vtkVector3d addedPosition_World = markupsNode->GetNthControlPointPositionWorld(markupsNode->GetNumberOfControlPoints() - 1);
+  CHECK_DOUBLE_TOLERANCE(addedPosition_World[0], 1.0, TOLERANCE);
+  CHECK_DOUBLE_TOLERANCE(addedPosition_World[1], 2.0, TOLERANCE);
+  CHECK_DOUBLE_TOLERANCE(addedPosition_World[2], 3.0, TOLERANCE);
+  markupsNode->SetControlPointPositionsWorld(positions_World);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), static_cast<int>(originalOrientations.size()));
+  for (int index = 0; index < markupsNode->GetNumberOfControlPoints(); ++index)
+  {
+    vtkVector3d position_World = markupsNode->GetNthControlPointPositionWorld(index);
+    vtkVector3d normal_World = markupsNode->GetNthControlPointNormalWorld(index);
+    for (int i = 0; i < 3; ++i)
+    {
+      CHECK_DOUBLE_TOLERANCE(position_World[i], positions_World->GetPoint(index)[i], TOLERANCE);
+      CHECK_DOUBLE_TOLERANCE(normal_World[i], normals_World->GetComponent(index, i), TOLERANCE);
+    }
+  }
+
   return EXIT_SUCCESS;
 }
 
@@ -20,6 +20,7 @@
 #include "vtkCamera.h"
 #include "vtkCellLocator.h"
 #include "vtkDiscretizableColorTransferFunction.h"
+#include "vtkDoubleArray.h"
 #include "vtkGlyph2D.h"
 #include "vtkLabelPlacementMapper.h"
 #include "vtkLine.h"
@@ -202,6 +203,12 @@ void vtkSlicerMarkupsWidgetRepresentation2D::UpdateAllPointsAndLabelsFromMRML(do
 
   int numPoints = markupsNode->GetNumberOfControlPoints();
 
+  // Get positions and normals of all control points at once
+  vtkNew<vtkPoints> controlPointPositionsWorld;
+  markupsNode->GetControlPointPositionsWorld(controlPointPositionsWorld);
+  vtkNew<vtkDoubleArray> controlPointNormalsWorld;
+  markupsNode->GetControlPointNormalsWorld(controlPointNormalsWorld);
+
   for (int controlPointType = 0; controlPointType < NumberOfControlPointTypes; ++controlPointType)
   {
     ControlPointsPipeline2D* controlPoints = reinterpret_cast<ControlPointsPipeline2D*>(this->ControlPoints[controlPointType]);
@@ -289,7 +296,7 @@ void vtkSlicerMarkupsWidgetRepresentation2D::UpdateAllPointsAndLabelsFromMRML(do
       }
 
       double slicePos[3] = { 0.0 };
-      this->GetNthControlPointDisplayPosition(pointIndex, slicePos);
+      this->GetWorldToSliceCoordinates(controlPointPositionsWorld->GetPoint(pointIndex), slicePos);
 
       controlPoints->ControlPoints->InsertNextPoint(slicePos);
       slicePos[0] += labelsOffset / sqrt(2.0);
@@ -302,7 +309,7 @@ void vtkSlicerMarkupsWidgetRepresentation2D::UpdateAllPointsAndLabelsFromMRML(do
       controlPoints->LabelControlPoints->InsertNextPoint(viewPos);
 
       double pointNormalWorld[3] = { 0.0, 0.0, 1.0 };
-      markupsNode->GetNthControlPointNormalWorld(pointIndex, pointNormalWorld);
+      controlPointNormalsWorld->GetTuple(pointIndex, pointNormalWorld);
       // probably we should transform this orientation to display coordinate system
       controlPoints->ControlPointsPolyData->GetPointData()->GetNormals()->InsertNextTuple(pointNormalWorld);
       controlPoints->LabelControlPointsPolyData->GetPointData()->GetNormals()->InsertNextTuple(pointNormalWorld);
@@ -20,6 +20,7 @@
 #include "vtkCallbackCommand.h"
 #include "vtkCamera.h"
 #include "vtkCellPicker.h"
+#include "vtkDoubleArray.h"
 #include "vtkLabelPlacementMapper.h"
 #include "vtkLine.h"
 #include "vtkFloatArray.h"
@@ -250,6 +251,13 @@ void vtkSlicerMarkupsWidgetRepresentation3D::UpdateAllPointsAndLabelsFromMRML()
   int numPoints = markupsNode->GetNumberOfControlPoints();
   std::vector<int> activeControlPointIndices;
   this->MarkupsDisplayNode->GetActiveControlPoints(activeControlPointIndices);
+
+  // Get positions and normals of all control points at once
+  vtkNew<vtkPoints> controlPointPositionsWorld;
+  markupsNode->GetControlPointPositionsWorld(controlPointPositionsWorld);
+  vtkNew<vtkDoubleArray> controlPointNormalsWorld;
+  markupsNode->GetControlPointNormalsWorld(controlPointNormalsWorld);
+
   for (int controlPointType = 0; controlPointType < NumberOfControlPointTypes; ++controlPointType)
   {
     ControlPointsPipeline3D* controlPoints = reinterpret_cast<ControlPointsPipeline3D*>(this->ControlPoints[controlPointType]);
@@ -295,9 +303,9 @@ void vtkSlicerMarkupsWidgetRepresentation3D::UpdateAllPointsAndLabelsFromMRML()
       }
 
       double worldPos[3] = { 0.0, 0.0, 0.0 };
-      markupsNode->GetNthControlPointPositionWorld(pointIndex, worldPos);
+      controlPointPositionsWorld->GetPoint(pointIndex, worldPos);
       double pointNormalWorld[3] = { 0.0, 0.0, 1.0 };
-      markupsNode->GetNthControlPointNormalWorld(pointIndex, pointNormalWorld);
+      controlPointNormalsWorld->GetTuple(pointIndex, pointNormalWorld);
 
       controlPoints->ControlPoints->InsertNextPoint(worldPos);
 
@@ -0,0 +1,176 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Segmentations includes
+#include "vtkImageGrowCutSegment.h"
+
+// MRML includes
+#include <vtkMRMLCoreTestingMacros.h>
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <cstring>
+#include <set>
+
+namespace
+{
+
+const int Dimensions[3] = { 30, 28, 26 };
+
+//---------------------------------------------------------------------------
+/// Two regions of different brightness with noise. Intensity values are not
+/// rounded, so that paths from different seeds do not have exactly the same length
+/// (at such ties the engines may choose different labels).
+vtkSmartPointer<vtkImageData> CreateIntensityVolume()
+{
+  vtkSmartPointer<vtkImageData> intensityVolume = vtkSmartPointer<vtkImageData>::New();
+  intensityVolume->SetDimensions(Dimensions[0], Dimensions[1], Dimensions[2]);
+  intensityVolume->SetSpacing(0.8, 0.8, 1.5);
+  intensityVolume->AllocateScalars(VTK_FLOAT, 1);
+  float* voxels = static_cast<float*>(intensityVolume->GetScalarPointer());
+  unsigned int randomState = 12345;
+  for (int k = 0; k < Dimensions[2]; ++k)
+  {
+    for (int j = 0; j < Dimensions[1]; ++j)
+    {
+      for (int i = 0; i < Dimensions[0]; ++i)
+      {
+        randomState = randomState * 1664525u + 1013904223u;
+        float noise = static_cast<float>(randomState >> 8) / 16777216.0f;
+        *(voxels++) = (i < Dimensions[0] / 2 ? 10.0f : 60.0f) + 20.0f * noise;
+      }
+    }
+  }
+  return intensityVolume;
+}
+
+//---------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> CreateLabelVolume(int scalarType)
+{
+  vtkSmartPointer<vtkImageData> labelVolume = vtkSmartPointer<vtkImageData>::New();
+  labelVolume->SetDimensions(Dimensions[0], Dimensions[1], Dimensions[2]);
+  labelVolume->SetSpacing(0.8, 0.8, 1.5);
+  labelVolume->AllocateScalars(scalarType, 1);
+  labelVolume->GetPointData()->GetScalars()->Fill(0);
+  return labelVolume;
+}
+
+//---------------------------------------------------------------------------
+void SetBox(vtkImageData* labelVolume, int i0, int i1, int j0, int j1, int k0, int k1, double value)
+{
+  for (int k = k0; k <= k1; ++k)
+  {
+    for (int j = j0; j <= j1; ++j)
+    {
+      for (int i = i0; i <= i1; ++i)
+      {
+        labelVolume->SetScalarComponentFromDouble(i, j, k, 0, value);
+      }
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+/// Compute segmentation with both engines and check that the results are identical.
+/// Seeds are added between the two computations to test incremental update.
+int TestEnginesEquivalent(vtkImageData* maskVolume)
+{
+  vtkSmartPointer<vtkImageData> intensityVolume = CreateIntensityVolume();
+
+  vtkSmartPointer<vtkImageData> fibonacciHeapResults[2];
+  vtkSmartPointer<vtkImageData> radixQueueResults[2];
+  for (int engine = vtkImageGrowCutSegment::ENGINE_FIBONACCI_HEAP; engine <= vtkImageGrowCutSegment::ENGINE_RADIX_QUEUE; ++engine)
+  {
+    vtkSmartPointer<vtkImageData>* results = (engine == vtkImageGrowCutSegment::ENGINE_RADIX_QUEUE ? radixQueueResults : fibonacciHeapResults);
+
+    vtkSmartPointer<vtkImageData> seedVolume = CreateLabelVolume(VTK_SHORT);
+    SetBox(seedVolume, 4, 6, 4, 6, 4, 6, 1);
+    SetBox(seedVolume, 22, 24, 20, 22, 18, 20, 2);
+
+    vtkNew<vtkImageGrowCutSegment> growCut;
+    growCut->SetEngine(engine);
+    growCut->SetDistancePenalty(0.3);
+    growCut->SetIntensityVolume(intensityVolume);
+    growCut->SetSeedLabelVolume(seedVolume);
+    if (maskVolume)
+    {
+      growCut->SetMaskVolume(maskVolume);
+    }
+
+    // Full computation
+    growCut->Update();
+    results[0] = vtkSmartPointer<vtkImageData>::New();
+    results[0]->DeepCopy(growCut->GetOutput());
+
+    // Incremental update: new label and more seeds for an existing label
+    SetBox(seedVolume, 14, 15, 12, 13, 2, 3, 3);
+    SetBox(seedVolume, 24, 25, 4, 5, 20, 21, 1);
+    seedVolume->Modified();
+    growCut->Update();
+    results[1] = vtkSmartPointer<vtkImageData>::New();
+    results[1]->DeepCopy(growCut->GetOutput());
+  }
+
+  for (int resultIndex = 0; resultIndex < 2; ++resultIndex)
+  {
+    vtkDataArray* fibonacciHeapLabels = fibonacciHeapResults[resultIndex]->GetPointData()->GetScalars();
+    vtkDataArray* radixQueueLabels = radixQueueResults[resultIndex]->GetPointData()->GetScalars();
+    CHECK_NOT_NULL(fibonacciHeapLabels);
+    CHECK_NOT_NULL(radixQueueLabels);
+    CHECK_INT(fibonacciHeapLabels->GetDataType(), VTK_SHORT);
+    CHECK_INT(radixQueueLabels->GetDataType(), VTK_SHORT);
+    CHECK_INT(radixQueueLabels->GetNumberOfTuples(), Dimensions[0] * Dimensions[1] * Dimensions[2]);
+    CHECK_INT(fibonacciHeapLabels->GetNumberOfTuples(), radixQueueLabels->GetNumberOfTuples());
+
+    // All labels are present in the result
+    std::set<double> labels;
+    for (vtkIdType i = 0; i < radixQueueLabels->GetNumberOfTuples(); ++i)
+    {
+      labels.insert(radixQueueLabels->GetTuple1(i));
+    }
+    CHECK_BOOL(labels.count(1) > 0 && labels.count(2) > 0, true);
+    CHECK_BOOL(labels.count(3) > 0, resultIndex == 1);
+
+    CHECK_INT(memcmp(fibonacciHeapLabels->GetVoidPointer(0), radixQueueLabels->GetVoidPointer(0),
+      radixQueueLabels->GetNumberOfTuples() * radixQueueLabels->GetDataTypeSize()), 0);
+  }
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkImageGrowCutSegmentTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkImageGrowCutSegment> growCut;
+  CHECK_INT(growCut->GetEngine(), vtkImageGrowCutSegment::ENGINE_RADIX_QUEUE);
+
+  CHECK_EXIT_SUCCESS(TestEnginesEquivalent(nullptr));
+
+  // Mask that separates a part of the image
+  vtkSmartPointer<vtkImageData> maskVolume = CreateLabelVolume(VTK_UNSIGNED_CHAR);
+  SetBox(maskVolume, 10, 11, 0, Dimensions[1] - 1, 0, Dimensions[2] / 2, 1);
+  CHECK_EXIT_SUCCESS(TestEnginesEquivalent(maskVolume));
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -1,5 +1,7 @@
 #include "vtkImageGrowCutSegment.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <vector>
@@ -9,6 +11,7 @@
 #include <vtkMath.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkTimerLog.h>
@@ -27,6 +30,102 @@ const int MaskPixelTypeID = VTK_UNSIGNED_CHAR;
 const NodeKeyValueType DIST_INF = std::numeric_limits<NodeKeyValueType>::max();
 const NodeKeyValueType DIST_EPSILON = 1e-3;
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Monotone priority queue for Dijkstra's algorithm.
+///
+/// Keys must not be smaller than the key of the last extracted entry, which always holds
+/// for Dijkstra's algorithm, as path lengths never decrease. Entries are stored in buckets
+/// based on the highest bit that differs from the last extracted key, therefore each entry is
+/// moved between buckets at most 32 times and there is no need for per-voxel heap nodes.
+/// Voxels are not removed from the queue when their distance decreases but queued again,
+/// obsolete entries are skipped when extracted.
+class GrowCutRadixQueue
+{
+public:
+  struct Entry
+  {
+    unsigned int Key;
+    NodeIndexType Index;
+  };
+
+  /// Bit pattern of non-negative floating-point numbers have the same order as the numbers,
+  /// therefore they can be used as keys.
+  static unsigned int GetKey(NodeKeyValueType distance)
+  {
+    unsigned int key = 0;
+    memcpy(&key, &distance, sizeof(key));
+    return key;
+  }
+
+  bool IsEmpty() const
+  {
+    return this->Size == 0;
+  }
+
+  void Push(unsigned int key, NodeIndexType index)
+  {
+    if (key < this->LastKey)
+    {
+      // may only happen due to rounding errors
+      key = this->LastKey;
+    }
+    this->Buckets[GetBitWidth(key ^ this->LastKey)].push_back(Entry{ key, index });
+    ++this->Size;
+  }
+
+  /// Extract an entry that has the smallest key. The queue must not be empty.
+  Entry Pop()
+  {
+    if (this->Buckets[0].empty())
+    {
+      // Redistribute the first non-empty bucket based on its smallest key
+      int bucketIndex = 1;
+      while (this->Buckets[bucketIndex].empty())
+      {
+        ++bucketIndex;
+      }
+      this->Redistributed.swap(this->Buckets[bucketIndex]);
+      this->LastKey = this->Redistributed[0].Key;
+      for (const Entry& entry : this->Redistributed)
+      {
+        this->LastKey = std::min(this->LastKey, entry.Key);
+      }
+      for (const Entry& entry : this->Redistributed)
+      {
+        this->Buckets[GetBitWidth(entry.Key ^ this->LastKey)].push_back(entry);
+      }
+      this->Redistributed.clear();
+    }
+    Entry entry = this->Buckets[0].back();
+    this->Buckets[0].pop_back();
+    --this->Size;
+    return entry;
+  }
+
+private:
+  /// Number of bits needed to represent the value (0 for 0, 32 for values larger than 2^31).
+  static int GetBitWidth(unsigned int value)
+  {
+    int width = 0;
+    if (value >= (1u << 16)) { width += 16; value >>= 16; }
+    if (value >= (1u << 8)) { width += 8; value >>= 8; }
+    if (value >= (1u << 4)) { width += 4; value >>= 4; }
+    if (value >= (1u << 2)) { width += 2; value >>= 2; }
+    if (value >= (1u << 1)) { width += 1; value >>= 1; }
+    return width + static_cast<int>(value);
+  }
+
+  std::vector<Entry> Buckets[33];
+  std::vector<Entry> Redistributed;
+  unsigned int LastKey{ 0 };
+  std::size_t Size{ 0 };
+};
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 class vtkImageGrowCutSegment::vtkInternal
 {
@@ -36,18 +135,29 @@ public:
 
   void Reset();
 
+  /// Allocate result and distance volumes and compute neighborhood offsets and distance penalties
+  void InitializeVolumesAndNeighborhood(vtkImageData *seedLabelVolume, double distancePenalty);
+
   template<typename IntensityPixelType, typename LabelPixelType>
   bool InitializationAHP(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume, double distancePenalty);
 
   template<typename IntensityPixelType, typename LabelPixelType>
   void DijkstraBasedClassificationAHP(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume);
 
+  template<typename LabelPixelType>
+  void InitializationRadixQueue(vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume, double distancePenalty,
+    GrowCutRadixQueue& queue);
+
+  template<typename IntensityPixelType, typename LabelPixelType>
+  void RadixQueueClassification(vtkImageData *intensityVolume, GrowCutRadixQueue& queue);
+
   template <class SourceVolType>
   bool ExecuteGrowCut(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume,
-    vtkImageData *resultLabelVolume, double distancePenalty);
+    vtkImageData *resultLabelVolume, double distancePenalty, int engine);
 
   template< class SourceVolType, class SeedVolType>
-  bool ExecuteGrowCut2(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume, double distancePenalty);
+  bool ExecuteGrowCut2(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume,
+    double distancePenalty, int engine);
 
   // Stores the shortest distance from known labels to each point
   // If a point is set to DIST_INF then that point will modified, as a shorter distance path will be found.
@@ -107,6 +217,70 @@ void vtkImageGrowCutSegment::vtkInternal::Reset()
   m_ResultLabelVolume->Initialize();
 }
 
+//-----------------------------------------------------------------------------
+void vtkImageGrowCutSegment::vtkInternal::InitializeVolumesAndNeighborhood(vtkImageData *seedLabelVolume, double distancePenalty)
+{
+  NodeIndexType dimXYZ = m_DimX * m_DimY * m_DimZ;
+  m_ResultLabelVolume->SetOrigin(seedLabelVolume->GetOrigin());
+  m_ResultLabelVolume->SetSpacing(seedLabelVolume->GetSpacing());
+  m_ResultLabelVolume->SetExtent(seedLabelVolume->GetExtent());
+  m_ResultLabelVolume->AllocateScalars(seedLabelVolume->GetScalarType(), 1);
+  m_DistanceVolume->SetOrigin(seedLabelVolume->GetOrigin());
+  m_DistanceVolume->SetSpacing(seedLabelVolume->GetSpacing());
+  m_DistanceVolume->SetExtent(seedLabelVolume->GetExtent());
+  m_DistanceVolume->AllocateScalars(NodeKeyValueTypeID, 1);
+
+  // Compute index offset
+  m_DistancePenalty = distancePenalty;
+  m_NeighborIndexOffsets.clear();
+  m_NeighborDistancePenalties.clear();
+  // Neighbors are traversed in the order of m_NeighborIndexOffsets,
+  // therefore one would expect that the offsets should
+  // be as continuous as possible (e.g., x coordinate
+  // should change most quickly), but that resulted in
+  // about 5-6% longer computation time. Therefore,
+  // we put indices in order x1y1z1, x1y1z2, x1y1z3, etc.
+  double* spacing = seedLabelVolume->GetSpacing();
+  for (long ix = -1; ix <= 1; ix++)
+  {
+    for (long iy = -1; iy <= 1; iy++)
+    {
+      for (long iz = -1; iz <= 1; iz++)
+      {
+        if (ix == 0 && iy == 0 && iz == 0)
+        {
+          continue;
+        }
+        m_NeighborIndexOffsets.push_back(ix + long(m_DimX)*(iy + long(m_DimY)*iz));
+        m_NeighborDistancePenalties.push_back(this->m_DistancePenalty * sqrt((spacing[0] * ix) * (spacing[0] * ix)
+          + (spacing[1] * iy) * (spacing[1] * iy) + (spacing[2] * iz) * (spacing[2] * iz)));
+      }
+    }
+  }
+
+  // Determine neighborhood size for computation at each voxel.
+  // The neighborhood size is everywhere the same (size of m_NeighborIndexOffsets)
+  // except at the edges of the volume, where the neighborhood size is 0.
+  m_NumberOfNeighbors.resize(dimXYZ);
+  const unsigned char numberOfNeighbors = static_cast<unsigned char>(m_NeighborIndexOffsets.size());
+  unsigned char* nbSizePtr = &(m_NumberOfNeighbors[0]);
+  for (NodeIndexType z = 0; z < m_DimZ; z++)
+  {
+    bool zEdge = (z == 0 || z == m_DimZ - 1);
+    for (NodeIndexType y = 0; y < m_DimY; y++)
+    {
+      bool yEdge = (y == 0 || y == m_DimY - 1);
+      *(nbSizePtr++) = 0; // x == 0 (there is always padding, so we don't need to check if m_DimX>0)
+      unsigned char nbSize = (zEdge || yEdge) ? 0 : numberOfNeighbors;
+      for (NodeIndexType x = m_DimX-2; x > 0; x--)
+      {
+        *(nbSizePtr++) = nbSize;
+      }
+      *(nbSizePtr++) = 0; // x == m_DimX-1 (there is always padding, so we don'neighborNewDistance need to check if m_DimX>1)
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 template<typename IntensityPixelType, typename LabelPixelType>
 bool vtkImageGrowCutSegment::vtkInternal::InitializationAHP(
@@ -149,67 +323,10 @@ bool vtkImageGrowCutSegment::vtkInternal::InitializationAHP(
 
   if (!m_bSegInitialized)
   {
-    m_ResultLabelVolume->SetOrigin(seedLabelVolume->GetOrigin());
-    m_ResultLabelVolume->SetSpacing(seedLabelVolume->GetSpacing());
-    m_ResultLabelVolume->SetExtent(seedLabelVolume->GetExtent());
-    m_ResultLabelVolume->AllocateScalars(seedLabelVolume->GetScalarType(), 1);
-    m_DistanceVolume->SetOrigin(seedLabelVolume->GetOrigin());
-    m_DistanceVolume->SetSpacing(seedLabelVolume->GetSpacing());
-    m_DistanceVolume->SetExtent(seedLabelVolume->GetExtent());
-    m_DistanceVolume->AllocateScalars(NodeKeyValueTypeID, 1);
+    this->InitializeVolumesAndNeighborhood(seedLabelVolume, distancePenalty);
     LabelPixelType* resultLabelVolumePtr = static_cast<LabelPixelType*>(m_ResultLabelVolume->GetScalarPointer());
     NodeKeyValueType* distanceVolumePtr = static_cast<NodeKeyValueType*>(m_DistanceVolume->GetScalarPointer());
 
-    // Compute index offset
-    m_DistancePenalty = distancePenalty;
-    m_NeighborIndexOffsets.clear();
-    m_NeighborDistancePenalties.clear();
-    // Neighbors are traversed in the order of m_NeighborIndexOffsets,
-    // therefore one would expect that the offsets should
-    // be as continuous as possible (e.g., x coordinate
-    // should change most quickly), but that resulted in
-    // about 5-6% longer computation time. Therefore,
-    // we put indices in order x1y1z1, x1y1z2, x1y1z3, etc.
-    double* spacing = seedLabelVolume->GetSpacing();
-    for (long ix = -1; ix <= 1; ix++)
-    {
-      for (long iy = -1; iy <= 1; iy++)
-      {
-        for (long iz = -1; iz <= 1; iz++)
-        {
-          if (ix == 0 && iy == 0 && iz == 0)
-          {
-            continue;
-          }
-          m_NeighborIndexOffsets.push_back(ix + long(m_DimX)*(iy + long(m_DimY)*iz));
-          m_NeighborDistancePenalties.push_back(this->m_DistancePenalty * sqrt((spacing[0] * ix) * (spacing[0] * ix)
-            + (spacing[1] * iy) * (spacing[1] * iy) + (spacing[2] * iz) * (spacing[2] * iz)));
-        }
-      }
-    }
-
-    // Determine neighborhood size for computation at each voxel.
-    // The neighborhood size is everywhere the same (size of m_NeighborIndexOffsets)
-    // except at the edges of the volume, where the neighborhood size is 0.
-    m_NumberOfNeighbors.resize(dimXYZ);
-    const unsigned char numberOfNeighbors = static_cast<unsigned char>(m_NeighborIndexOffsets.size());
-    unsigned char* nbSizePtr = &(m_NumberOfNeighbors[0]);
-    for (NodeIndexType z = 0; z < m_DimZ; z++)
-    {
-      bool zEdge = (z == 0 || z == m_DimZ - 1);
-      for (NodeIndexType y = 0; y < m_DimY; y++)
-      {
-        bool yEdge = (y == 0 || y == m_DimY - 1);
-        *(nbSizePtr++) = 0; // x == 0 (there is always padding, so we don't need to check if m_DimX>0)
-        unsigned char nbSize = (zEdge || yEdge) ? 0 : numberOfNeighbors;
-        for (NodeIndexType x = m_DimX-2; x > 0; x--)
-        {
-          *(nbSizePtr++) = nbSize;
-        }
-        *(nbSizePtr++) = 0; // x == m_DimX-1 (there is always padding, so we don'neighborNewDistance need to check if m_DimX>1)
-      }
-    }
-
     if (!maskLabelVolumePtr)
     {
       // no mask
@@ -403,10 +520,128 @@ void vtkImageGrowCutSegment::vtkInternal::DijkstraBasedClassificationAHP(
   m_HeapNodes = nullptr;
 }
 
+//-----------------------------------------------------------------------------
+template<typename LabelPixelType>
+void vtkImageGrowCutSegment::vtkInternal::InitializationRadixQueue(
+    vtkImageData *seedLabelVolume,
+    vtkImageData *maskLabelVolume,
+    double distancePenalty,
+    GrowCutRadixQueue& queue)
+{
+  const bool fullComputation = !m_bSegInitialized;
+  if (fullComputation)
+  {
+    this->InitializeVolumesAndNeighborhood(seedLabelVolume, distancePenalty);
+  }
+
+  const LabelPixelType* seedLabelVolumePtr = static_cast<LabelPixelType*>(seedLabelVolume->GetScalarPointer());
+  const MaskPixelType* maskLabelVolumePtr = nullptr;
+  if (fullComputation && maskLabelVolume != nullptr)
+  {
+    maskLabelVolumePtr = static_cast<MaskPixelType*>(maskLabelVolume->GetScalarPointer());
+  }
+  LabelPixelType* resultLabelVolumePtr = static_cast<LabelPixelType*>(m_ResultLabelVolume->GetScalarPointer());
+  NodeKeyValueType* distanceVolumePtr = static_cast<NodeKeyValueType*>(m_DistanceVolume->GetScalarPointer());
+
+  // Voxels are initialized in parallel. Seeds are collected for each slice separately,
+  // so that they are queued in the same order, regardless of the number of threads.
+  const NodeIndexType sliceSize = m_DimX * m_DimY;
+  std::vector<std::vector<NodeIndexType>> sliceSeeds(m_DimZ);
+  vtkSMPTools::For(0, m_DimZ, [&](vtkIdType beginSlice, vtkIdType endSlice)
+  {
+    for (vtkIdType slice = beginSlice; slice < endSlice; ++slice)
+    {
+      std::vector<NodeIndexType>& seeds = sliceSeeds[slice];
+      const NodeIndexType endIndex = static_cast<NodeIndexType>(slice + 1) * sliceSize;
+      for (NodeIndexType index = static_cast<NodeIndexType>(slice) * sliceSize; index < endIndex; index++)
+      {
+        LabelPixelType seedValue = seedLabelVolumePtr[index];
+        if (fullComputation)
+        {
+          if (maskLabelVolumePtr && maskLabelVolumePtr[index] != 0)
+          {
+            // masked region, small distance will prevent overwriting of masked voxels
+            resultLabelVolumePtr[index] = 0;
+            distanceVolumePtr[index] = DIST_EPSILON;
+            continue;
+          }
+          resultLabelVolumePtr[index] = seedValue;
+          if (seedValue == 0)
+          {
+            distanceVolumePtr[index] = DIST_INF;
+            continue;
+          }
+        }
+        else if (seedValue == 0
+          || (resultLabelVolumePtr[index] == seedValue && distanceVolumePtr[index] <= DIST_EPSILON))
+        {
+          // Only grow from new/changed seeds. Old seeds are ignored in updates,
+          // as their labels have been already propagated.
+          continue;
+        }
+        resultLabelVolumePtr[index] = seedValue;
+        distanceVolumePtr[index] = DIST_EPSILON;
+        seeds.push_back(index);
+      }
+    }
+  });
+
+  const unsigned int seedKey = GrowCutRadixQueue::GetKey(DIST_EPSILON);
+  for (const std::vector<NodeIndexType>& seeds : sliceSeeds)
+  {
+    for (NodeIndexType index : seeds)
+    {
+      queue.Push(seedKey, index);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename IntensityPixelType, typename LabelPixelType>
+void vtkImageGrowCutSegment::vtkInternal::RadixQueueClassification(vtkImageData *intensityVolume, GrowCutRadixQueue& queue)
+{
+  LabelPixelType* resultLabelVolumePtr = static_cast<LabelPixelType*>(m_ResultLabelVolume->GetScalarPointer());
+  NodeKeyValueType* distanceVolumePtr = static_cast<NodeKeyValueType*>(m_DistanceVolume->GetScalarPointer());
+  IntensityPixelType* imSrc = static_cast<IntensityPixelType*>(intensityVolume->GetScalarPointer());
+
+  // The same propagation is used for full computation and quick update, as only voxels
+  // that are reached by a shorter path than in the previous computation are queued.
+  while (!queue.IsEmpty())
+  {
+    GrowCutRadixQueue::Entry entry = queue.Pop();
+    NodeIndexType index = entry.Index;
+    NodeKeyValueType currentDistance = distanceVolumePtr[index];
+    if (GrowCutRadixQueue::GetKey(currentDistance) != entry.Key)
+    {
+      // a shorter path to this voxel was found after it was queued
+      continue;
+    }
+    LabelPixelType currentLabel = resultLabelVolumePtr[index];
+
+    // Update neighbors
+    NodeKeyValueType pixCenter = imSrc[index];
+    unsigned char nbSize = m_NumberOfNeighbors[index];
+    for (unsigned char i = 0; i < nbSize; i++)
+    {
+      NodeIndexType indexNgbh = index + m_NeighborIndexOffsets[i];
+      NodeKeyValueType neighborCurrentDistance = distanceVolumePtr[indexNgbh];
+      NodeKeyValueType neighborNewDistance = fabs(pixCenter - imSrc[indexNgbh]) + currentDistance + m_NeighborDistancePenalties[i];
+      if (neighborCurrentDistance > neighborNewDistance)
+      {
+        distanceVolumePtr[indexNgbh] = neighborNewDistance;
+        resultLabelVolumePtr[indexNgbh] = currentLabel;
+        queue.Push(GrowCutRadixQueue::GetKey(neighborNewDistance), indexNgbh);
+      }
+    }
+  }
+
+  m_bSegInitialized = true;
+}
+
 //-----------------------------------------------------------------------------
 template< class IntensityPixelType, class LabelPixelType>
 bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut2(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume,
-  vtkImageData *maskLabelVolume, double distancePenalty)
+  vtkImageData *maskLabelVolume, double distancePenalty, int engine)
 {
   int* imSize = intensityVolume->GetDimensions();
 
@@ -433,6 +668,14 @@ bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut2(vtkImageData *intensit
     return false;
   }
 
+  if (engine == vtkImageGrowCutSegment::ENGINE_RADIX_QUEUE)
+  {
+    GrowCutRadixQueue queue;
+    this->InitializationRadixQueue<LabelPixelType>(seedLabelVolume, maskLabelVolume, distancePenalty, queue);
+    this->RadixQueueClassification<IntensityPixelType, LabelPixelType>(intensityVolume, queue);
+    return true;
+  }
+
   if (!InitializationAHP<IntensityPixelType, LabelPixelType>(intensityVolume, seedLabelVolume, maskLabelVolume, distancePenalty))
   {
     return false;
@@ -445,7 +688,7 @@ bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut2(vtkImageData *intensit
 //----------------------------------------------------------------------------
 template <class SourceVolType>
 bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume,
-  vtkImageData *maskLabelVolume, vtkImageData *resultLabelVolume, double distancePenalty)
+  vtkImageData *maskLabelVolume, vtkImageData *resultLabelVolume, double distancePenalty, int engine)
 {
   int* extent = intensityVolume->GetExtent();
   double* spacing = intensityVolume->GetSpacing();
@@ -521,7 +764,7 @@ bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut(vtkImageData *intensity
   bool success = false;
   switch (seedLabelVolume->GetScalarType())
   {
-    vtkTemplateMacro((success = ExecuteGrowCut2<SourceVolType, VTK_TT>(intensityVolume, seedLabelVolume, maskLabelVolume, distancePenalty)));
+    vtkTemplateMacro((success = ExecuteGrowCut2<SourceVolType, VTK_TT>(intensityVolume, seedLabelVolume, maskLabelVolume, distancePenalty, engine)));
   default:
     vtkGenericWarningMacro("vtkOrientedImageDataResample::MergeImage: Unknown ScalarType");
   }
@@ -544,6 +787,7 @@ vtkImageGrowCutSegment::vtkImageGrowCutSegment()
   this->SetNumberOfInputPorts(3);
   this->SetNumberOfOutputPorts(1);
   this->DistancePenalty = 0.0;
+  this->Engine = ENGINE_RADIX_QUEUE;
 }
 
 //-----------------------------------------------------------------------------
@@ -577,7 +821,7 @@ void vtkImageGrowCutSegment::ExecuteDataWithInformation(
 
   switch (intensityVolume->GetScalarType())
   {
-    vtkTemplateMacro(this->Internal->ExecuteGrowCut<VTK_TT>(intensityVolume, seedLabelVolume, maskLabelVolume, resultLabelVolume, this->DistancePenalty));
+    vtkTemplateMacro(this->Internal->ExecuteGrowCut<VTK_TT>(intensityVolume, seedLabelVolume, maskLabelVolume, resultLabelVolume, this->DistancePenalty, this->Engine));
     break;
   }
   logger->StopTimer();
@@ -608,6 +852,7 @@ void vtkImageGrowCutSegment::Reset()
 //-----------------------------------------------------------------------------
 void vtkImageGrowCutSegment::PrintSelf(ostream &os, vtkIndent indent)
 {
-  // XXX Implement this function
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "DistancePenalty: " << this->DistancePenalty << "\n";
+  os << indent << "Engine: " << (this->Engine == ENGINE_RADIX_QUEUE ? "RadixQueue" : "FibonacciHeap") << "\n";
 }
@@ -14,6 +14,15 @@ public:
   vtkTypeMacro(vtkImageGrowCutSegment, vtkImageAlgorithm);
   void PrintSelf(ostream &os, vtkIndent indent) override;
 
+  enum
+  {
+    /// Fibonacci heap that stores a heap node for each voxel of the image (about 24 bytes per voxel).
+    ENGINE_FIBONACCI_HEAP,
+    /// Monotone radix queue that only stores the voxels that are waiting to be processed
+    /// (8 bytes per queued voxel). Voxels are initialized in parallel.
+    ENGINE_RADIX_QUEUE
+  };
+
   /// Set input grayscale volume (input 0)
   void SetIntensityVolume(vtkImageData* grayscaleImage) { this->SetInputData(0, grayscaleImage); }
 
@@ -36,6 +45,16 @@ public:
   vtkGetMacro(DistancePenalty, double);
   vtkSetMacro(DistancePenalty, double);
 
+  /// Priority queue implementation that is used for region growing.
+  /// Both engines compute the same shortest paths, so results are the same,
+  /// except for voxels that are at exactly the same distance from multiple seeds.
+  /// The state of the previous computation is kept when the engine is changed.
+  /// By default ENGINE_RADIX_QUEUE is used.
+  vtkSetClampMacro(Engine, int, ENGINE_FIBONACCI_HEAP, ENGINE_RADIX_QUEUE);
+  vtkGetMacro(Engine, int);
+  void SetEngineToFibonacciHeap() { this->SetEngine(ENGINE_FIBONACCI_HEAP); }
+  void SetEngineToRadixQueue() { this->SetEngine(ENGINE_RADIX_QUEUE); }
+
 protected:
   vtkImageGrowCutSegment();
   ~vtkImageGrowCutSegment() override;
@@ -52,6 +71,7 @@ private:
   class vtkInternal;
   vtkInternal * Internal;
   double DistancePenalty;
+  int Engine;
 };
 
 #endif
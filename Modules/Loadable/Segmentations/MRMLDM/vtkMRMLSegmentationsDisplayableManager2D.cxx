@@ -30,6 +30,7 @@
 #include <vtkMRMLTransformNode.h>
 
 // MRML logic includes
+#include "vtkImageLabelMapToRGBA.h"
 #include "vtkImageLabelOutline.h"
 
 // SegmentationCore includes
@@ -184,6 +185,9 @@ public:
       this->Reslice = vtkSmartPointer<vtkImageReslice>::New();
       this->SliceToImageTransform = vtkSmartPointer<vtkGeneralTransform>::New();
       this->LabelOutline = vtkSmartPointer<vtkImageLabelOutline>::New();
+      this->OutlineColorMapper = vtkSmartPointer<vtkImageMapToRGBA>::New();
+      this->FillColorMapper = vtkSmartPointer<vtkImageMapToRGBA>::New();
+      this->LabelMapToRGBA = vtkSmartPointer<vtkImageLabelMapToRGBA>::New();
       this->LookupTableOutline = vtkSmartPointer<vtkLookupTable>::New();
       this->LookupTableFill = vtkSmartPointer<vtkLookupTable>::New();
       this->ImageThreshold = vtkSmartPointer<vtkImageThreshold>::New();
@@ -205,28 +209,31 @@ public:
 
       // Image outline
       this->LabelOutline->SetInputConnection(this->Reslice->GetOutputPort());
-      vtkSmartPointer<vtkImageMapToRGBA> outlineColorMapper = vtkSmartPointer<vtkImageMapToRGBA>::New();
-      outlineColorMapper->SetInputConnection(this->LabelOutline->GetOutputPort());
-      outlineColorMapper->SetOutputFormatToRGBA();
-      outlineColorMapper->SetLookupTable(this->LookupTableOutline);
+      this->OutlineColorMapper->SetInputConnection(this->LabelOutline->GetOutputPort());
+      this->OutlineColorMapper->SetOutputFormatToRGBA();
+      this->OutlineColorMapper->SetLookupTable(this->LookupTableOutline);
       vtkSmartPointer<vtkImageMapper> imageOutlineMapper = vtkSmartPointer<vtkImageMapper>::New();
-      imageOutlineMapper->SetInputConnection(outlineColorMapper->GetOutputPort());
+      imageOutlineMapper->SetInputConnection(this->OutlineColorMapper->GetOutputPort());
       imageOutlineMapper->SetColorWindow(255);
       imageOutlineMapper->SetColorLevel(127.5);
       this->ImageOutlineActor->SetMapper(imageOutlineMapper);
       this->ImageOutlineActor->SetVisibility(0);
 
       // Image fill
-      vtkSmartPointer<vtkImageMapToRGBA> fillColorMapper = vtkSmartPointer<vtkImageMapToRGBA>::New();
-      fillColorMapper->SetInputConnection(this->Reslice->GetOutputPort());
-      fillColorMapper->SetOutputFormatToRGBA();
-      fillColorMapper->SetLookupTable(this->LookupTableFill);
+      this->FillColorMapper->SetInputConnection(this->Reslice->GetOutputPort());
+      this->FillColorMapper->SetOutputFormatToRGBA();
+      this->FillColorMapper->SetLookupTable(this->LookupTableFill);
       vtkSmartPointer<vtkImageMapper> imageFillMapper = vtkSmartPointer<vtkImageMapper>::New();
-      imageFillMapper->SetInputConnection(fillColorMapper->GetOutputPort());
+      imageFillMapper->SetInputConnection(this->FillColorMapper->GetOutputPort());
       imageFillMapper->SetColorWindow(255);
       imageFillMapper->SetColorLevel(127.5);
       this->ImageFillActor->SetMapper(imageFillMapper);
       this->ImageFillActor->SetVisibility(0);
+
+      // Image fill and outline of binary labelmaps, computed in a single pass for all segments in the layer
+      this->LabelMapToRGBA->SetInputConnection(this->Reslice->GetOutputPort());
+      this->LabelMapToRGBA->SetFillLookupTable(this->LookupTableFill);
+      this->LabelMapToRGBA->SetOutlineLookupTable(this->LookupTableOutline);
     }
 
     vtkSmartPointer<vtkTransform> WorldToSliceTransform;
@@ -245,6 +252,9 @@ public:
     vtkSmartPointer<vtkImageReslice> Reslice;
     vtkSmartPointer<vtkGeneralTransform> SliceToImageTransform;
     vtkSmartPointer<vtkImageLabelOutline> LabelOutline;
+    vtkSmartPointer<vtkImageMapToRGBA> OutlineColorMapper;
+    vtkSmartPointer<vtkImageMapToRGBA> FillColorMapper;
+    vtkSmartPointer<vtkImageLabelMapToRGBA> LabelMapToRGBA;
     vtkSmartPointer<vtkLookupTable> LookupTableOutline;
     vtkSmartPointer<vtkLookupTable> LookupTableFill;
     vtkSmartPointer<vtkImageThreshold> ImageThreshold;
@@ -913,11 +923,14 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
       if (outlineVisible)
       {
         pipeline->LabelOutline->SetOutline(genericDisplayNode->GetSliceIntersectionThickness());
+        pipeline->LabelMapToRGBA->SetOutline(genericDisplayNode->GetSliceIntersectionThickness());
       }
       else
       {
         pipeline->LabelOutline->SetInputConnection(nullptr);
       }
+      pipeline->LabelMapToRGBA->SetGenerateOutline(outlineVisible);
+      pipeline->LabelMapToRGBA->SetGenerateFill(fillVisible);
 
       // Set the range of the scalars in the image data from the ScalarRange field if it exists
       // Default to the scalar range of 0.0 to 1.0 otherwise
@@ -1090,11 +1103,23 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
       int sliceOutputExtent[6] = { 0, dimensions[0] - 1, 0, dimensions[1] - 1, 0, dimensions[2] - 1 };
       pipeline->Reslice->SetOutputExtent(sliceOutputExtent);
 
-      // Smooth the border of fractional labelmaps
-      pipeline->LabelOutline->SetInputConnection(pipeline->Reslice->GetOutputPort());
-      pipeline->ImageFillActor->GetMapper()->GetInputAlgorithm()->SetInputConnection(pipeline->Reslice->GetOutputPort());
-      if (shownRepresenatationName == vtkSegmentationConverter::GetSegmentationFractionalLabelmapRepresentationName())
+      vtkImageMapper* imageFillMapper = vtkImageMapper::SafeDownCast(pipeline->ImageFillActor->GetMapper());
+      vtkImageMapper* imageOutlineMapper = vtkImageMapper::SafeDownCast(pipeline->ImageOutlineActor->GetMapper());
+      if (shownRepresenatationName != vtkSegmentationConverter::GetSegmentationFractionalLabelmapRepresentationName())
+      {
+        // Fill and outline of all segments in the layer are computed from the resliced labelmap in a single pass
+        pipeline->LabelOutline->SetInputConnection(nullptr);
+        pipeline->FillColorMapper->SetInputConnection(nullptr);
+        imageFillMapper->SetInputConnection(pipeline->LabelMapToRGBA->GetFillOutputPort());
+        imageOutlineMapper->SetInputConnection(pipeline->LabelMapToRGBA->GetOutlineOutputPort());
+      }
+      else
       {
+        // Smooth the border of fractional labelmaps
+        imageFillMapper->SetInputConnection(pipeline->FillColorMapper->GetOutputPort());
+        imageOutlineMapper->SetInputConnection(pipeline->OutlineColorMapper->GetOutputPort());
+        pipeline->LabelOutline->SetInputConnection(pipeline->Reslice->GetOutputPort());
+        pipeline->FillColorMapper->SetInputConnection(pipeline->Reslice->GetOutputPort());
         // If ThresholdValue is not specified, then do not perform thresholding
         vtkDoubleArray* thresholdValue = vtkDoubleArray::SafeDownCast(
           imageData->GetFieldData()->GetAbstractArray(vtkSegmentationConverter::GetThresholdValueFieldName()));
@@ -1102,7 +1127,7 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
         {
           if (!this->SmoothFractionalLabelMapBorder && thresholdValue && thresholdValue->GetNumberOfValues() == 1)
           {
-            pipeline->ImageFillActor->GetMapper()->GetInputAlgorithm()->SetInputConnection(pipeline->ImageThreshold->GetOutputPort());
+            pipeline->FillColorMapper->SetInputConnection(pipeline->ImageThreshold->GetOutputPort());
           }
           pipeline->ImageThreshold->ThresholdByLower(thresholdValue->GetValue(0));
           pipeline->LabelOutline->SetInputConnection(pipeline->ImageThreshold->GetOutputPort());
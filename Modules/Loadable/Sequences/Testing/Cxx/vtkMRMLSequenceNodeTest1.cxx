@@ -148,6 +148,46 @@ int vtkMRMLSequenceNodeTest1( int, char * [] )
   CHECK_INT(scene->GetNumberOfNodes(), 1);
   CHECK_INT(seqNode->GetNumberOfDataNodes(), 1);
 
+  // Check numeric index lookup
+  seqNode->RemoveAllDataNodes();
+  for (int i = 0; i < numberOfDataNodes; ++i)
+  {
+    std::ostringstream valueStr;
+    valueStr << i * 0.5;
+    seqNode->SetDataNodeAtValue(dataNode, valueStr.str());
+  }
+  CHECK_INT(seqNode->GetItemNumberFromNumericIndexValue(10.0), 20);
+  CHECK_INT(seqNode->GetItemNumberFromNumericIndexValue(10.0004), 20);
+  CHECK_INT(seqNode->GetItemNumberFromNumericIndexValue(10.2), -1);
+  CHECK_INT(seqNode->GetItemNumberFromNumericIndexValue(10.2, false), 20);
+  CHECK_INT(seqNode->GetItemNumberFromNumericIndexValue(-3.0), -1);
+  CHECK_INT(seqNode->GetItemNumberFromNumericIndexValue(-3.0, false), 0);
+  CHECK_INT(seqNode->GetItemNumberFromNumericIndexValue(1000.0, false), numberOfDataNodes - 1);
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("10.0"), 20);
+  seqNode->UpdateIndexValue("10", "100");
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("10"), -1);
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("100"), numberOfDataNodes - 1);
+  CHECK_INT(seqNode->GetItemNumberFromNumericIndexValue(10.5), 20);
+
+  // Check text index lookup
+  vtkNew<vtkMRMLSequenceNode> textSeqNode;
+  textSeqNode->SetIndexType(vtkMRMLSequenceNode::TextIndex);
+  CHECK_INT(textSeqNode->GetItemNumberFromNumericIndexValue(0.0), -1);
+  textSeqNode->SetDataNodeAtValue(dataNode, "first");
+  textSeqNode->SetDataNodeAtValue(dataNode, "second");
+  textSeqNode->SetDataNodeAtValue(dataNode, "third");
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("second"), 1);
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("fourth"), -1);
+  textSeqNode->RemoveDataNodeAtValue("first");
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("first"), -1);
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("third"), 1);
+  textSeqNode->UpdateIndexValue("second", "2nd");
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("second"), -1);
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("2nd"), 0);
+  vtkNew<vtkMRMLSequenceNode> copiedSeqNode;
+  copiedSeqNode->CopySequenceIndex(textSeqNode);
+  CHECK_INT(copiedSeqNode->GetItemNumberFromIndexValue("third"), 1);
+
   /*
   bool res = true;
   TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
@@ -0,0 +1,191 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include <vtkMRMLScalarVolumeNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSequenceNode.h>
+#include <vtkMRMLVolumeSequenceLazyLoader.h>
+#include <vtkMRMLVolumeSequenceStorageNode.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+// STD includes
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+
+const int NUMBER_OF_FRAMES = 12;
+const int DIMENSIONS[3] = { 7, 6, 5 };
+
+//-----------------------------------------------------------------------------
+short GetExpectedVoxelValue(int frameIndex, int voxelIndex)
+{
+  return static_cast<short>(frameIndex * 1000 - voxelIndex);
+}
+
+//-----------------------------------------------------------------------------
+bool IsFrameLoaded(vtkMRMLSequenceNode* sequenceNode, int itemNumber)
+{
+  // Find the data node in the sequence scene by name to access it without loading
+  vtkMRMLScene* sequenceScene = sequenceNode->GetSequenceScene();
+  vtkMRMLVolumeNode* frameVolume = nullptr;
+  std::ostringstream baseName;
+  baseName << sequenceNode->GetName() << "_" << std::setw(4) << std::setfill('0') << itemNumber;
+  for (int nodeIndex = 0; nodeIndex < sequenceScene->GetNumberOfNodes(); ++nodeIndex)
+  {
+    vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(sequenceScene->GetNthNode(nodeIndex));
+    if (volumeNode && baseName.str() == volumeNode->GetName())
+    {
+      frameVolume = volumeNode;
+    }
+  }
+  return frameVolume && frameVolume->GetImageData() && frameVolume->GetImageData()->GetPointData()->GetScalars();
+}
+
+//-----------------------------------------------------------------------------
+bool CheckFrame(vtkMRMLSequenceNode* sequenceNode, int itemNumber)
+{
+  vtkMRMLVolumeNode* frameVolume = vtkMRMLVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(itemNumber));
+  vtkImageData* imageData = (frameVolume ? frameVolume->GetImageData() : nullptr);
+  if (!imageData || !imageData->GetPointData()->GetScalars())
+  {
+    std::cerr << "Frame " << itemNumber << " is not loaded" << std::endl;
+    return false;
+  }
+  short* voxels = static_cast<short*>(imageData->GetScalarPointer());
+  for (int voxelIndex = 0; voxelIndex < DIMENSIONS[0] * DIMENSIONS[1] * DIMENSIONS[2]; ++voxelIndex)
+  {
+    if (voxels[voxelIndex] != GetExpectedVoxelValue(itemNumber, voxelIndex))
+    {
+      std::cerr << "Frame " << itemNumber << " voxel " << voxelIndex << " mismatch: expected "
+        << GetExpectedVoxelValue(itemNumber, voxelIndex) << ", actual " << voxels[voxelIndex] << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+int TestLazyLoading(vtkMRMLScene* scene, vtkMRMLSequenceNode* sequenceNode, const std::string& fileName, bool compression)
+{
+  std::cout << "Testing lazy loading of " << fileName << std::endl;
+  vtkNew<vtkMRMLVolumeSequenceStorageNode> storageNode;
+  scene->AddNode(storageNode);
+  storageNode->SetFileName(fileName.c_str());
+  storageNode->SetUseCompression(compression);
+  CHECK_BOOL(storageNode->WriteData(sequenceNode), true);
+
+  vtkMRMLSequenceNode* readSequenceNode = vtkMRMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceNode", "Lazy"));
+  vtkNew<vtkMRMLVolumeSequenceStorageNode> readStorageNode;
+  scene->AddNode(readStorageNode);
+  readStorageNode->SetFileName(fileName.c_str());
+  readStorageNode->LazyLoadingOn();
+  CHECK_BOOL(readStorageNode->ReadData(readSequenceNode), true);
+  CHECK_INT(readSequenceNode->GetNumberOfDataNodes(), NUMBER_OF_FRAMES);
+
+  vtkMRMLVolumeSequenceLazyLoader* loader = vtkMRMLVolumeSequenceLazyLoader::SafeDownCast(readSequenceNode->GetDataNodeLoader());
+  CHECK_NOT_NULL(loader);
+  loader->SetMaximumNumberOfLoadedFrames(4);
+  loader->SetNumberOfReadAheadFrames(2);
+  CHECK_INT(loader->GetNumberOfLoadedFrames(), 0);
+  CHECK_BOOL(IsFrameLoaded(readSequenceNode, 0), false);
+
+  // Checking if the sequence can be written does not load the frames
+  CHECK_BOOL(readStorageNode->CanWriteFromReferenceNode(readSequenceNode), true);
+  CHECK_STD_STRING(readSequenceNode->GetDefaultStorageNodeClassName(), "vtkMRMLVolumeSequenceStorageNode");
+  CHECK_POINTER(readSequenceNode->GetDataNodeLoader(), loader);
+  CHECK_INT(loader->GetNumberOfLoadedFrames(), 0);
+  CHECK_BOOL(IsFrameLoaded(readSequenceNode, 0), false);
+
+  // Access frames forward: the next frames are read ahead
+  CHECK_BOOL(CheckFrame(readSequenceNode, 0), true);
+  CHECK_INT(loader->GetNumberOfLoadedFrames(), 3);
+  CHECK_BOOL(IsFrameLoaded(readSequenceNode, 2), true);
+  CHECK_BOOL(IsFrameLoaded(readSequenceNode, 3), false);
+  for (int itemNumber = 1; itemNumber < NUMBER_OF_FRAMES; ++itemNumber)
+  {
+    CHECK_BOOL(CheckFrame(readSequenceNode, itemNumber), true);
+    CHECK_BOOL(loader->GetNumberOfLoadedFrames() <= 4, true);
+  }
+  CHECK_BOOL(IsFrameLoaded(readSequenceNode, 0), false);
+
+  // Access frames backward: the previous frames are read ahead
+  CHECK_BOOL(CheckFrame(readSequenceNode, 5), true);
+  CHECK_BOOL(IsFrameLoaded(readSequenceNode, 3), true);
+  CHECK_BOOL(IsFrameLoaded(readSequenceNode, 6), false);
+
+  // Modified frames are kept in memory
+  vtkMRMLVolumeNode* modifiedFrameVolume = vtkMRMLVolumeNode::SafeDownCast(readSequenceNode->GetNthDataNode(4));
+  modifiedFrameVolume->GetImageData()->Modified();
+  for (int itemNumber = NUMBER_OF_FRAMES - 1; itemNumber >= 6; --itemNumber)
+  {
+    CHECK_BOOL(CheckFrame(readSequenceNode, itemNumber), true);
+  }
+  CHECK_BOOL(IsFrameLoaded(readSequenceNode, 4), true);
+  CHECK_BOOL(IsFrameLoaded(readSequenceNode, 3), false);
+
+  // Load all frames, for example before writing
+  CHECK_BOOL(readSequenceNode->LoadAllDataNodes(), true);
+  CHECK_NULL(readSequenceNode->GetDataNodeLoader());
+  for (int itemNumber = 0; itemNumber < NUMBER_OF_FRAMES; ++itemNumber)
+  {
+    CHECK_BOOL(IsFrameLoaded(readSequenceNode, itemNumber), true);
+    CHECK_BOOL(CheckFrame(readSequenceNode, itemNumber), true);
+  }
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceLazyLoadingTest1(int argc, char* argv[])
+{
+  std::string tempDir = ".";
+  if (argc > 1)
+  {
+    tempDir = argv[1];
+  }
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLSequenceNode* sequenceNode = vtkMRMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLSequenceNode", "Sequence"));
+  for (int frameIndex = 0; frameIndex < NUMBER_OF_FRAMES; ++frameIndex)
+  {
+    vtkNew<vtkImageData> image;
+    image->SetDimensions(DIMENSIONS[0], DIMENSIONS[1], DIMENSIONS[2]);
+    image->AllocateScalars(VTK_SHORT, 1);
+    short* voxels = static_cast<short*>(image->GetScalarPointer());
+    for (int voxelIndex = 0; voxelIndex < DIMENSIONS[0] * DIMENSIONS[1] * DIMENSIONS[2]; ++voxelIndex)
+    {
+      voxels[voxelIndex] = GetExpectedVoxelValue(frameIndex, voxelIndex);
+    }
+    vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+    volumeNode->SetAndObserveImageData(image);
+    sequenceNode->SetDataNodeAtValue(volumeNode, std::to_string(frameIndex));
+  }
+
+  CHECK_EXIT_SUCCESS(TestLazyLoading(scene, sequenceNode, tempDir + "/LazyLoadingRaw.seq.nrrd", false));
+  CHECK_EXIT_SUCCESS(TestLazyLoading(scene, sequenceNode, tempDir + "/LazyLoadingCompressed.seq.nrrd", true));
+
+  std::cout << "Volume sequence lazy loading test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
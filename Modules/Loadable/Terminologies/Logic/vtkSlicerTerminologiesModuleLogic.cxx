@@ -48,6 +48,7 @@
 
 // STD includes
 #include <algorithm>
+#include <unordered_map>
 
 #include "rapidjson/document.h"     // rapidjson's DOM-style API
 #include "rapidjson/prettywriter.h" // for stringify JSON
@@ -73,6 +74,38 @@ public:
   vtkInternal();
   ~vtkInternal();
 
+  /// Lookup tables of a Json code array (categories, types, modifiers, or regions),
+  /// so that codes can be found without traversing and comparing all the items of the array.
+  struct CodeArrayIndex
+  {
+    /// Position of the codes in the Json array. Key is created by \sa GetCodeKey.
+    std::unordered_map<std::string, rapidjson::SizeType> CodePositions;
+    /// Valid codes in the order they appear in the Json array
+    std::vector<CodeIdentifier> Codes;
+    /// Position of each item of \sa Codes in the Json array
+    std::vector<rapidjson::SizeType> CodeArrayPositions;
+    /// Lowercase code meaning of each item of \sa Codes for case-insensitive search
+    std::vector<std::string> LowerCaseCodeMeanings;
+  };
+
+  /// Get key of a code in \sa CodeArrayIndex::CodePositions
+  static std::string GetCodeKey(const std::string& codingSchemeDesignator, const std::string& codeValue)
+  {
+    // Unit separator character cannot occur in code strings
+    return codingSchemeDesignator + '\x1f' + codeValue;
+  }
+
+  /// Fill lookup tables from the items of a Json code array
+  static void BuildCodeArrayIndex(rapidjson::Value& jsonArray, CodeArrayIndex& codeArrayIndex);
+  /// Create lookup tables for all the code arrays in a loaded terminology or anatomic context document
+  void AddCodeIndex(rapidjson::Document* doc);
+  /// Remove lookup tables of all the code arrays of a document.
+  /// Must be called before the document is modified or deleted.
+  void RemoveCodeIndex(rapidjson::Document* doc);
+  /// Get lookup tables of a Json code array.
+  /// If the array is not part of a loaded document then the lookup tables are built in temporaryIndex.
+  const CodeArrayIndex& GetCodeArrayIndex(rapidjson::Value& jsonArray, CodeArrayIndex& temporaryIndex);
+
   /// Utility function to get code in Json array
   /// \param foundIndex Output parameter for index of found object in input array. -1 if not found
   /// \return Json object if found, otherwise null Json object
@@ -141,21 +174,20 @@ public:
   /// \param code Json object into which the code information is added a members
   void GetJsonCodeFromIdentifier(rapidjson::Value& code, CodeIdentifier identifier, rapidjson::Document::AllocatorType& allocator);
 
-  /// Utility function for safe (memory-leak-free) setting of a document pointer in map
-  static void SetDocumentInTerminologyMap(TerminologyMap& terminologyMap, const std::string& name, rapidjson::Document* doc)
+  /// Utility function for safe (memory-leak-free) setting of a document pointer in map.
+  /// Lookup tables of the document are (re)built, as its content may have changed.
+  void SetDocumentInTerminologyMap(TerminologyMap& terminologyMap, const std::string& name, rapidjson::Document* doc)
   {
-    if (terminologyMap.find(name) != terminologyMap.end())
+    if (terminologyMap.find(name) != terminologyMap.end() && doc != terminologyMap[name])
     {
-      if (doc == terminologyMap[name])
-      {
-        // The two objects are the same, there is nothing to do
-        return;
-      }
       // Make sure the previous document object is deleted
+      this->RemoveCodeIndex(terminologyMap[name]);
       delete terminologyMap[name];
     }
     // Set new document object
     terminologyMap[name] = doc;
+    this->RemoveCodeIndex(doc);
+    this->AddCodeIndex(doc);
   }
 
 public:
@@ -164,6 +196,11 @@ public:
 
   /// Loaded anatomical region contexts. Key is the context name, value is the root item.
   TerminologyMap LoadedAnatomicContexts;
+
+  /// Lookup tables of the code arrays in the loaded documents. Key is the Json array.
+  std::unordered_map<const rapidjson::Value*, CodeArrayIndex> CodeArrayIndices;
+  /// Code arrays of each loaded document that have lookup tables in \sa CodeArrayIndices
+  std::map<const rapidjson::Document*, std::vector<const rapidjson::Value*> > IndexedCodeArrays;
 };
 
 //---------------------------------------------------------------------------
@@ -187,14 +224,165 @@ vtkSlicerTerminologiesModuleLogic::vtkInternal::~vtkInternal()
   }
 }
 
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::BuildCodeArrayIndex(rapidjson::Value& jsonArray, CodeArrayIndex& codeArrayIndex)
+{
+  codeArrayIndex = CodeArrayIndex();
+  if (!jsonArray.IsArray())
+  {
+    return;
+  }
+  codeArrayIndex.CodePositions.reserve(jsonArray.Size());
+  codeArrayIndex.Codes.reserve(jsonArray.Size());
+  codeArrayIndex.CodeArrayPositions.reserve(jsonArray.Size());
+  codeArrayIndex.LowerCaseCodeMeanings.reserve(jsonArray.Size());
+  for (rapidjson::SizeType index = 0; index < jsonArray.Size(); ++index)
+  {
+    rapidjson::Value& currentObject = jsonArray[index];
+    if (!currentObject.IsObject())
+    {
+      continue;
+    }
+    rapidjson::Value::MemberIterator codingSchemeDesignator = currentObject.FindMember("CodingSchemeDesignator");
+    rapidjson::Value::MemberIterator codeValue = currentObject.FindMember("CodeValue");
+    if (codingSchemeDesignator == currentObject.MemberEnd() || !codingSchemeDesignator->value.IsString()
+      || codeValue == currentObject.MemberEnd() || !codeValue->value.IsString())
+    {
+      continue;
+    }
+    // Keep the first occurrence of duplicate codes, as they were found by traversing the array
+    codeArrayIndex.CodePositions.emplace(
+      GetCodeKey(codingSchemeDesignator->value.GetString(), codeValue->value.GetString()), index);
+
+    rapidjson::Value::MemberIterator codeMeaning = currentObject.FindMember("CodeMeaning");
+    if (codeMeaning == currentObject.MemberEnd() || !codeMeaning->value.IsString())
+    {
+      // Codes without meaning cannot be listed or searched
+      vtkGenericWarningMacro("BuildCodeArrayIndex: Invalid code '" << codeValue->value.GetString()
+        << "' without code meaning at index " << index);
+      continue;
+    }
+    std::string codeMeaningStr = codeMeaning->value.GetString();
+    std::string codeMeaningLowerCase(codeMeaningStr);
+    std::transform(codeMeaningLowerCase.begin(), codeMeaningLowerCase.end(), codeMeaningLowerCase.begin(), ::tolower);
+    codeArrayIndex.Codes.emplace_back(codingSchemeDesignator->value.GetString(), codeValue->value.GetString(), codeMeaningStr);
+    codeArrayIndex.CodeArrayPositions.push_back(index);
+    codeArrayIndex.LowerCaseCodeMeanings.push_back(codeMeaningLowerCase);
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::AddCodeIndex(rapidjson::Document* doc)
+{
+  if (!doc || !doc->IsObject())
+  {
+    return;
+  }
+
+  // Collect code arrays: categories, types, and type modifiers in terminologies;
+  // regions and region modifiers in anatomic contexts
+  std::vector<rapidjson::Value*> codeArrays;
+  rapidjson::Value::MemberIterator segmentationCodes = doc->FindMember("SegmentationCodes");
+  if (segmentationCodes != doc->MemberEnd() && segmentationCodes->value.IsObject())
+  {
+    rapidjson::Value::MemberIterator categoryArray = segmentationCodes->value.FindMember("Category");
+    if (categoryArray != segmentationCodes->value.MemberEnd())
+    {
+      codeArrays.push_back(&categoryArray->value);
+    }
+  }
+  rapidjson::Value::MemberIterator anatomicCodes = doc->FindMember("AnatomicCodes");
+  if (anatomicCodes != doc->MemberEnd() && anatomicCodes->value.IsObject())
+  {
+    rapidjson::Value::MemberIterator regionArray = anatomicCodes->value.FindMember("AnatomicRegion");
+    if (regionArray != anatomicCodes->value.MemberEnd())
+    {
+      codeArrays.push_back(&regionArray->value);
+    }
+  }
+
+  std::vector<const rapidjson::Value*>& indexedCodeArrays = this->IndexedCodeArrays[doc];
+  // Nested arrays are appended while traversing, therefore elements are accessed by index
+  for (size_t arrayIndex = 0; arrayIndex < codeArrays.size(); ++arrayIndex)
+  {
+    rapidjson::Value& codeArray = *codeArrays[arrayIndex];
+    if (!codeArray.IsArray())
+    {
+      continue;
+    }
+    BuildCodeArrayIndex(codeArray, this->CodeArrayIndices[&codeArray]);
+    indexedCodeArrays.push_back(&codeArray);
+
+    for (rapidjson::Value::ValueIterator codeIt = codeArray.Begin(); codeIt != codeArray.End(); ++codeIt)
+    {
+      if (!codeIt->IsObject())
+      {
+        continue;
+      }
+      for (const char* nestedArrayName : { "Type", "Modifier" })
+      {
+        rapidjson::Value::MemberIterator nestedArray = codeIt->FindMember(nestedArrayName);
+        if (nestedArray != codeIt->MemberEnd() && nestedArray->value.IsArray())
+        {
+          codeArrays.push_back(&nestedArray->value);
+        }
+      }
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::RemoveCodeIndex(rapidjson::Document* doc)
+{
+  std::map<const rapidjson::Document*, std::vector<const rapidjson::Value*> >::iterator docIt = this->IndexedCodeArrays.find(doc);
+  if (docIt == this->IndexedCodeArrays.end())
+  {
+    return;
+  }
+  for (const rapidjson::Value* codeArray : docIt->second)
+  {
+    this->CodeArrayIndices.erase(codeArray);
+  }
+  this->IndexedCodeArrays.erase(docIt);
+}
+
+//---------------------------------------------------------------------------
+const vtkSlicerTerminologiesModuleLogic::vtkInternal::CodeArrayIndex& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetCodeArrayIndex(
+  rapidjson::Value& jsonArray, CodeArrayIndex& temporaryIndex)
+{
+  std::unordered_map<const rapidjson::Value*, CodeArrayIndex>::iterator indexIt = this->CodeArrayIndices.find(&jsonArray);
+  if (indexIt != this->CodeArrayIndices.end())
+  {
+    return indexIt->second;
+  }
+  BuildCodeArrayIndex(jsonArray, temporaryIndex);
+  return temporaryIndex;
+}
+
 //---------------------------------------------------------------------------
 rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetCodeInArray(CodeIdentifier codeId, rapidjson::Value &jsonArray, int &foundIndex)
 {
+  foundIndex = -1;
   if (!jsonArray.IsArray())
   {
     return JSON_EMPTY_VALUE;
   }
 
+  // Use lookup table if the array is part of a loaded document
+  std::unordered_map<const rapidjson::Value*, CodeArrayIndex>::iterator indexIt = this->CodeArrayIndices.find(&jsonArray);
+  if (indexIt != this->CodeArrayIndices.end())
+  {
+    const std::unordered_map<std::string, rapidjson::SizeType>& codePositions = indexIt->second.CodePositions;
+    std::unordered_map<std::string, rapidjson::SizeType>::const_iterator codeIt =
+      codePositions.find(GetCodeKey(codeId.CodingSchemeDesignator, codeId.CodeValue));
+    if (codeIt == codePositions.end())
+    {
+      return JSON_EMPTY_VALUE;
+    }
+    foundIndex = codeIt->second;
+    return jsonArray[codeIt->second];
+  }
+
   // Traverse array and try to find the object with given identifier
   rapidjson::SizeType index = 0;
   while (index<jsonArray.Size())
@@ -1065,7 +1253,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadContextFromFile(std::string filePath
   {
     // Store terminology
     std::string contextName = (*jsonRoot)["SegmentationCategoryTypeContextName"].GetString();
-    vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+    this->Internal->SetDocumentInTerminologyMap(
       this->Internal->LoadedTerminologies, contextName, jsonRoot);
     vtkDebugMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
   }
@@ -1073,7 +1261,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadContextFromFile(std::string filePath
   {
     // Store anatomic context
     std::string contextName = (*jsonRoot)["AnatomicContextName"].GetString();
-    vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+    this->Internal->SetDocumentInTerminologyMap(
       this->Internal->LoadedAnatomicContexts, contextName, jsonRoot);
     vtkDebugMacro("Anatomic context named '" << contextName << "' successfully loaded from file " << filePath);
   }
@@ -1132,7 +1320,7 @@ std::string vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromFile(std::stri
 
   // Store terminology
   std::string contextName = (*terminologyRoot)["SegmentationCategoryTypeContextName"].GetString();
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+  this->Internal->SetDocumentInTerminologyMap(
     this->Internal->LoadedTerminologies, contextName, terminologyRoot);
 
   vtkDebugMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
@@ -1173,6 +1361,8 @@ bool vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromSegmentDescriptorFile
     convertedDoc = new rapidjson::Document;
   }
 
+  // Conversion rearranges the code arrays of the document, so their lookup tables become invalid
+  this->Internal->RemoveCodeIndex(convertedDoc);
   bool success = this->Internal->ConvertSegmentationDescriptorToTerminologyContext(descriptorDoc, *convertedDoc, contextName);
   if (!success)
   {
@@ -1182,7 +1372,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromSegmentDescriptorFile
   }
 
   // Store terminology
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+  this->Internal->SetDocumentInTerminologyMap(
     this->Internal->LoadedTerminologies, contextName, convertedDoc );
 
   vtkDebugMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
@@ -1250,7 +1440,7 @@ std::string vtkSlicerTerminologiesModuleLogic::LoadAnatomicContextFromFile(std::
 
   // Store anatomic context
   std::string contextName = (*anatomicContextRoot)["AnatomicContextName"].GetString();
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+  this->Internal->SetDocumentInTerminologyMap(
     this->Internal->LoadedAnatomicContexts, contextName, anatomicContextRoot);
 
   vtkDebugMacro("Anatomic context named '" << contextName << "' successfully loaded from file " << filePath);
@@ -1291,6 +1481,8 @@ bool vtkSlicerTerminologiesModuleLogic::LoadAnatomicContextFromSegmentDescriptor
     convertedDoc = new rapidjson::Document;
   }
 
+  // Conversion rearranges the code arrays of the document, so their lookup tables become invalid
+  this->Internal->RemoveCodeIndex(convertedDoc);
   bool success = this->Internal->ConvertSegmentationDescriptorToAnatomicContext(descriptorDoc, *convertedDoc, contextName);
   if (!success)
   {
@@ -1300,7 +1492,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadAnatomicContextFromSegmentDescriptor
   }
 
   // Store anatomic context
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+  this->Internal->SetDocumentInTerminologyMap(
     this->Internal->LoadedAnatomicContexts, contextName, convertedDoc );
 
   vtkDebugMacro("Anatomic context named '" << contextName << "' successfully loaded from file " << filePath);
@@ -1429,37 +1621,24 @@ bool vtkSlicerTerminologiesModuleLogic::FindCategoriesInTerminology(std::string
     return false;
   }
 
+  vtkInternal::CodeArrayIndex temporaryIndex;
+  const vtkInternal::CodeArrayIndex& categoryIndex = this->Internal->GetCodeArrayIndex(categoryArray, temporaryIndex);
+  if (search.empty())
+  {
+    categories = categoryIndex.Codes;
+    return true;
+  }
+
   // Make lowercase for case-insensitive comparison
   std::transform(search.begin(), search.end(), search.begin(), ::tolower);
 
-  // Traverse categories
-  rapidjson::SizeType index = 0;
-  while (index < categoryArray.Size())
+  // Add categories with name containing the search string
+  for (size_t index = 0; index < categoryIndex.Codes.size(); ++index)
   {
-    rapidjson::Value& category = categoryArray[index];
-    if (category.IsObject())
+    if (categoryIndex.LowerCaseCodeMeanings[index].find(search) != std::string::npos)
     {
-      rapidjson::Value& categoryName = category["CodeMeaning"];
-      rapidjson::Value& categoryCodingSchemeDesignator = category["CodingSchemeDesignator"];
-      rapidjson::Value& categoryCodeValue = category["CodeValue"];
-      if (categoryName.IsString() && categoryCodingSchemeDesignator.IsString() && categoryCodeValue.IsString())
-      {
-        // Add category to list if search string is empty or is contained by the current category name
-        std::string categoryNameStr = categoryName.GetString();
-        std::string categoryNameLowerCase(categoryNameStr);
-        std::transform(categoryNameLowerCase.begin(), categoryNameLowerCase.end(), categoryNameLowerCase.begin(), ::tolower);
-        if (search.empty() || categoryNameLowerCase.find(search) != std::string::npos)
-        {
-          CodeIdentifier categoryId(categoryCodingSchemeDesignator.GetString(), categoryCodeValue.GetString(), categoryNameStr);
-          categories.push_back(categoryId);
-        }
-      }
-      else
-      {
-        vtkErrorMacro("FindCategoriesInTerminology: Invalid category '" << categoryName.GetString() << "' in terminology '" << terminologyName << "'");
-      }
+      categories.push_back(categoryIndex.Codes[index]);
     }
-    ++index;
   }
 
   return true;
@@ -1552,41 +1731,22 @@ bool vtkSlicerTerminologiesModuleLogic::FindTypesInTerminologyCategory(
   // Make lowercase for case-insensitive comparison
   std::transform(search.begin(), search.end(), search.begin(), ::tolower);
 
-  // Traverse types
-  rapidjson::SizeType index = 0;
-  while (index < typeArray.Size())
+  // Add types with name containing the search string
+  vtkInternal::CodeArrayIndex temporaryIndex;
+  const vtkInternal::CodeArrayIndex& typeIndex = this->Internal->GetCodeArrayIndex(typeArray, temporaryIndex);
+  for (size_t index = 0; index < typeIndex.Codes.size(); ++index)
   {
-    rapidjson::Value& type = typeArray[index];
-    if (type.IsObject())
+    if (!search.empty() && typeIndex.LowerCaseCodeMeanings[index].find(search) == std::string::npos)
     {
-      rapidjson::Value& typeName = type["CodeMeaning"];
-      rapidjson::Value& typeCodingSchemeDesignator = type["CodingSchemeDesignator"];
-      rapidjson::Value& typeCodeValue = type["CodeValue"];
-      if (typeName.IsString() && typeCodingSchemeDesignator.IsString() && typeCodeValue.IsString())
-      {
-        // Add type to list if search string is empty or is contained by the current type name
-        std::string typeNameStr = typeName.GetString();
-        std::string typeNameLowerCase(typeNameStr);
-        std::transform(typeNameLowerCase.begin(), typeNameLowerCase.end(), typeNameLowerCase.begin(), ::tolower);
-        if (search.empty() || typeNameLowerCase.find(search) != std::string::npos)
-        {
-          CodeIdentifier typeId(typeCodingSchemeDesignator.GetString(), typeCodeValue.GetString(), typeNameStr);
-          types.push_back(typeId);
-          if (typeObjects)
-          {
-            vtkSmartPointer<vtkSlicerTerminologyType> typeObject = vtkSmartPointer<vtkSlicerTerminologyType>::New();
-            this->Internal->PopulateTerminologyTypeFromJson(type, typeObject);
-            typeObjects->push_back(typeObject);
-          }
-        }
-      }
-      else
-      {
-        vtkErrorMacro("FindTypesInTerminologyCategory: Invalid type '" << typeName.GetString() << "in category '"
-          << categoryId.CodeMeaning << "' in terminology '" << terminologyName << "'");
-      }
+      continue;
+    }
+    types.push_back(typeIndex.Codes[index]);
+    if (typeObjects)
+    {
+      vtkSmartPointer<vtkSlicerTerminologyType> typeObject = vtkSmartPointer<vtkSlicerTerminologyType>::New();
+      this->Internal->PopulateTerminologyTypeFromJson(typeArray[typeIndex.CodeArrayPositions[index]], typeObject);
+      typeObjects->push_back(typeObject);
     }
-    ++index;
   }
 
   return true;
@@ -1674,24 +1834,8 @@ bool vtkSlicerTerminologiesModuleLogic::GetTypeModifiersInTerminologyType(
   }
 
   // Collect type modifiers
-  rapidjson::SizeType index = 0;
-  while (index < typeModifierArray.Size())
-  {
-    rapidjson::Value& typeModifier = typeModifierArray[index];
-    if (typeModifier.IsObject())
-    {
-      rapidjson::Value& typeModifierName = typeModifier["CodeMeaning"];
-      rapidjson::Value& typeModifierCodingSchemeDesignator = typeModifier["CodingSchemeDesignator"];
-      rapidjson::Value& typeModifierCodeValue = typeModifier["CodeValue"];
-      if (typeModifierName.IsString() && typeModifierCodingSchemeDesignator.IsString() && typeModifierCodeValue.IsString())
-      {
-        CodeIdentifier typeModifierId(typeModifierCodingSchemeDesignator.GetString(),
-          typeModifierCodeValue.GetString(), typeModifierName.GetString());
-        typeModifiers.push_back(typeModifierId);
-      }
-    }
-    ++index;
-  } // For each type modifier index
+  vtkInternal::CodeArrayIndex temporaryIndex;
+  typeModifiers = this->Internal->GetCodeArrayIndex(typeModifierArray, temporaryIndex).Codes;
 
   return true;
 }
@@ -1822,38 +1966,24 @@ bool vtkSlicerTerminologiesModuleLogic::FindRegionsInAnatomicContext(std::string
     return false;
   }
 
+  vtkInternal::CodeArrayIndex temporaryIndex;
+  const vtkInternal::CodeArrayIndex& regionIndex = this->Internal->GetCodeArrayIndex(regionArray, temporaryIndex);
+  if (search.empty())
+  {
+    regions = regionIndex.Codes;
+    return true;
+  }
+
   // Make lowercase for case-insensitive comparison
   std::transform(search.begin(), search.end(), search.begin(), ::tolower);
 
-  // Traverse regions
-  rapidjson::SizeType index = 0;
-  while (index<regionArray.Size())
+  // Add regions with name containing the search string
+  for (size_t index = 0; index < regionIndex.Codes.size(); ++index)
   {
-    rapidjson::Value& region = regionArray[index];
-    if (region.IsObject())
+    if (regionIndex.LowerCaseCodeMeanings[index].find(search) != std::string::npos)
     {
-      rapidjson::Value& regionName = region["CodeMeaning"];
-      rapidjson::Value& regionCodingSchemeDesignator = region["CodingSchemeDesignator"];
-      rapidjson::Value& regionCodeValue = region["CodeValue"];
-      if (regionName.IsString() && regionCodingSchemeDesignator.IsString() && regionCodeValue.IsString())
-      {
-        // Add region name to list if search string is empty or is contained by the current region name
-        std::string regionNameStr = regionName.GetString();
-        std::string regionNameLowerCase(regionNameStr);
-        std::transform(regionNameLowerCase.begin(), regionNameLowerCase.end(), regionNameLowerCase.begin(), ::tolower);
-        if (search.empty() || regionNameLowerCase.find(search) != std::string::npos)
-        {
-          CodeIdentifier regionId(regionCodingSchemeDesignator.GetString(), regionCodeValue.GetString(), regionNameStr);
-          regions.push_back(regionId);
-        }
-      }
-      else
-      {
-        vtkErrorMacro("FindRegionsInAnatomicContext: Invalid region '" << regionName.GetString()
-          << "' in anatomic context '" << anatomicContextName << "'");
-      }
+      regions.push_back(regionIndex.Codes[index]);
     }
-    ++index;
   }
 
   return true;
@@ -1893,24 +2023,8 @@ bool vtkSlicerTerminologiesModuleLogic::GetRegionModifiersInAnatomicRegion(
   }
 
   // Collect region modifiers
-  rapidjson::SizeType index = 0;
-  while (index<regionModifierArray.Size())
-  {
-    rapidjson::Value& regionModifier = regionModifierArray[index];
-    if (regionModifier.IsObject())
-    {
-      rapidjson::Value& regionModifierName = regionModifier["CodeMeaning"];
-      rapidjson::Value& regionModifierCodingSchemeDesignator = regionModifier["CodingSchemeDesignator"];
-      rapidjson::Value& regionModifierCodeValue = regionModifier["CodeValue"];
-      if (regionModifierName.IsString() && regionModifierCodingSchemeDesignator.IsString() && regionModifierCodeValue.IsString())
-      {
-        CodeIdentifier regionModifierId(regionModifierCodingSchemeDesignator.GetString(),
-          regionModifierCodeValue.GetString(), regionModifierName.GetString());
-          regionModifiers.push_back(regionModifierId);
-      }
-    }
-    ++index;
-  } // For each region index
+  vtkInternal::CodeArrayIndex temporaryIndex;
+  regionModifiers = this->Internal->GetCodeArrayIndex(regionModifierArray, temporaryIndex).Codes;
 
   return true;
 }
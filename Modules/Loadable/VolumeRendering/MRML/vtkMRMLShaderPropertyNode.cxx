@@ -30,6 +30,9 @@
 #include <vtkShaderProperty.h>
 #include <vtkUniforms.h>
 
+// STD includes
+#include <algorithm>
+
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLShaderPropertyNode);
 
@@ -161,3 +164,14 @@ bool vtkMRMLShaderPropertyNode::GetModifiedSinceRead()
     (this->ShaderProperty &&
      this->ShaderProperty->GetMTime() > this->GetStoredTime());
 }
+
+//---------------------------------------------------------------------------
+vtkMTimeType vtkMRMLShaderPropertyNode::GetContentMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetContentMTime();
+  if (this->ShaderProperty)
+  {
+    mTime = std::max(mTime, this->ShaderProperty->GetMTime());
+  }
+  return mTime;
+}
@@ -82,6 +82,9 @@ public:
   /// \sa vtkMRMLStorableNode::GetModifiedSinceRead()
   bool GetModifiedSinceRead() override;
 
+  /// Reimplemented to take into account the modified time of the shader property.
+  vtkMTimeType GetContentMTime() override;
+
 protected:
   vtkMRMLShaderPropertyNode();
   ~vtkMRMLShaderPropertyNode() override;
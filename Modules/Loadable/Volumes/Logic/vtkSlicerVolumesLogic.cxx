@@ -14,6 +14,7 @@
 
 // STD includes
 #include <algorithm>
+#include <cstring>
 #include <memory>
 
 // Volumes includes
@@ -61,6 +62,11 @@
 #include <vtkTransform.h>
 #include <vtksys/RegularExpression.hxx>
 
+// ITK includes
+#include <itkImage.h>
+#include <itkImageFileReader.h>
+#include <itkMetaDataObject.h>
+
 // JSON includes
 #include "rapidjson/document.h"
 #include "rapidjson/filereadstream.h"
@@ -405,25 +411,69 @@ ArchetypeVolumeNodeSet ScalarVolumeNodeSetFactory(std::string& volumeName, vtkMR
   return nodeSet;
 }
 
+//----------------------------------------------------------------------------
+// Probes of the default factories. They only reject files that the storage
+// node of the factory would refuse after reading the header (or the whole file).
+
+//----------------------------------------------------------------------------
+bool DiffusionWeightedVolumeNodeSetProbe(const vtkSlicerVolumesLogic::VolumeHeaderInformation& header)
+{
+  // vtkMRMLNRRDStorageNode requires a NRRD file with "modality: DWMRI"
+  return !header.Valid || (header.NRRD && header.Modality == "DWMRI");
+}
+
+//----------------------------------------------------------------------------
+bool DiffusionTensorVolumeNodeSetProbe(const vtkSlicerVolumesLogic::VolumeHeaderInformation& header)
+{
+  // vtkITKArchetypeDiffusionTensorImageReaderFile requires 6 or 9 components
+  return !header.Valid || header.NumberOfComponents == 6 || header.NumberOfComponents == 9;
+}
+
+//----------------------------------------------------------------------------
+bool NRRDVectorVolumeNodeSetProbe(const vtkSlicerVolumesLogic::VolumeHeaderInformation& header)
+{
+  // vtkMRMLNRRDStorageNode requires a NRRD file with vector or normal kind
+  return !header.Valid || (header.NRRD && header.NumberOfComponents > 1);
+}
+
+//----------------------------------------------------------------------------
+bool ArchetypeVectorVolumeNodeSetProbe(const vtkSlicerVolumesLogic::VolumeHeaderInformation& header)
+{
+  // vtkMRMLVolumeArchetypeStorageNode requires at least 3 components for vector volumes
+  return !header.Valid || header.NumberOfComponents >= 3;
+}
+
+//----------------------------------------------------------------------------
+bool ScalarVolumeNodeSetProbe(const vtkSlicerVolumesLogic::VolumeHeaderInformation& header)
+{
+  // vtkMRMLVolumeArchetypeStorageNode requires a single component for scalar
+  // volumes and label maps, but it only finds out after reading the voxels.
+  return !header.Valid || header.NumberOfComponents == 1;
+}
+
 } // end of anonymous namespace
 
 //----------------------------------------------------------------------------
 vtkSlicerVolumesLogic::vtkSlicerVolumesLogic()
 {
   // register the default factories for nodesets. this is done in a specific order
-  this->RegisterArchetypeVolumeNodeSetFactory( DiffusionWeightedVolumeNodeSetFactory );
-  this->RegisterArchetypeVolumeNodeSetFactory( DiffusionTensorVolumeNodeSetFactory );
-  this->RegisterArchetypeVolumeNodeSetFactory( NRRDVectorVolumeNodeSetFactory );
-  this->RegisterArchetypeVolumeNodeSetFactory( ArchetypeVectorVolumeNodeSetFactory );
-  this->RegisterArchetypeVolumeNodeSetFactory( LabelMapVolumeNodeSetFactory );
-  this->RegisterArchetypeVolumeNodeSetFactory( ScalarVolumeNodeSetFactory );
+  this->RegisterArchetypeVolumeNodeSetFactory( DiffusionWeightedVolumeNodeSetFactory, DiffusionWeightedVolumeNodeSetProbe );
+  this->RegisterArchetypeVolumeNodeSetFactory( DiffusionTensorVolumeNodeSetFactory, DiffusionTensorVolumeNodeSetProbe );
+  this->RegisterArchetypeVolumeNodeSetFactory( NRRDVectorVolumeNodeSetFactory, NRRDVectorVolumeNodeSetProbe );
+  this->RegisterArchetypeVolumeNodeSetFactory( ArchetypeVectorVolumeNodeSetFactory, ArchetypeVectorVolumeNodeSetProbe );
+  this->RegisterArchetypeVolumeNodeSetFactory( LabelMapVolumeNodeSetFactory, ScalarVolumeNodeSetProbe );
+  this->RegisterArchetypeVolumeNodeSetFactory( ScalarVolumeNodeSetFactory, ScalarVolumeNodeSetProbe );
 
   this->CompareVolumeGeometryEpsilon = 0.000001;
   this->CompareVolumeGeometryPrecision = 6;
+  this->DICOMHeaderCacheDirectory = nullptr;
 }
 
 //----------------------------------------------------------------------------
-vtkSlicerVolumesLogic::~vtkSlicerVolumesLogic() = default;
+vtkSlicerVolumesLogic::~vtkSlicerVolumesLogic()
+{
+  this->SetDICOMHeaderCacheDirectory(nullptr);
+}
 
 //----------------------------------------------------------------------------
 void vtkSlicerVolumesLogic::ProcessMRMLNodesEvents(vtkObject *vtkNotUsed(caller),
@@ -473,6 +523,12 @@ void vtkSlicerVolumesLogic::InitializeStorageNode(
     mrmlScene = this->GetMRMLScene();
   }
 
+  vtkMRMLVolumeArchetypeStorageNode* archetypeStorageNode = vtkMRMLVolumeArchetypeStorageNode::SafeDownCast(storageNode);
+  if (archetypeStorageNode)
+  {
+    archetypeStorageNode->SetDICOMHeaderCacheDirectory(this->DICOMHeaderCacheDirectory);
+  }
+
   if (mrmlScene && mrmlScene->GetCacheManager())
   {
     useURI = mrmlScene->GetCacheManager()->IsRemoteReference(filename);
@@ -592,10 +648,28 @@ vtkMRMLVolumeNode* vtkSlicerVolumesLogic::AddArchetypeVolume (
   this->GetApplicationLogic()->SetMRMLSceneDataIO(testScene.GetPointer(),
                                                   remoteIOLogic, dataIOManagerLogic);
 
+  // Read the header once so that factories that cannot read the file are
+  // skipped without instantiating their reader. Remote files are not probed.
+  VolumeHeaderInformation header;
+  bool useURI = this->GetMRMLScene()->GetCacheManager()
+    && this->GetMRMLScene()->GetCacheManager()->IsRemoteReference(filename);
+  if (!useURI)
+  {
+    vtkSlicerVolumesLogic::ReadVolumeHeaderInformation(filename, header);
+  }
+
   // Run through the factory list and test each factory until success
   for (NodeSetFactoryRegistry::const_iterator fit = volumeRegistry.begin();
        fit != volumeRegistry.end(); ++fit)
   {
+    std::map<ArchetypeVolumeNodeSetFactory, ArchetypeVolumeNodeSetProbe>::const_iterator
+      pit = this->VolumeProbes.find(*fit);
+    if (header.Valid && pit != this->VolumeProbes.end() && !(pit->second)(header))
+    {
+      vtkDebugMacro("AddArchetypeVolume: skip node set factory, header does not match [filename = " << filename << "]");
+      continue;
+    }
+
     ArchetypeVolumeNodeSet nodeSet( (*fit)(volumeName, testScene.GetPointer(), loadingOptions) );
 
     // if the labelMap flags for reader and factory are consistent
@@ -1243,6 +1317,8 @@ void vtkSlicerVolumesLogic::PrintSelf(ostream& os, vtkIndent indent)
      << this->CompareVolumeGeometryEpsilon << "\n";
   os << indent << "CompareVolumeGeometryPrecision: "
      << this->CompareVolumeGeometryPrecision << "\n";
+  os << indent << "DICOMHeaderCacheDirectory: "
+     << (this->DICOMHeaderCacheDirectory ? this->DICOMHeaderCacheDirectory : "(none)") << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -1470,6 +1546,66 @@ vtkSlicerVolumesLogic
   }
 }
 
+//----------------------------------------------------------------------------
+void
+vtkSlicerVolumesLogic
+::RegisterArchetypeVolumeNodeSetFactory(ArchetypeVolumeNodeSetFactory factory,
+                                        ArchetypeVolumeNodeSetProbe probe)
+{
+  this->RegisterArchetypeVolumeNodeSetFactory(factory);
+  this->VolumeProbes[factory] = probe;
+}
+
+//----------------------------------------------------------------------------
+void
+vtkSlicerVolumesLogic
+::PreRegisterArchetypeVolumeNodeSetFactory(ArchetypeVolumeNodeSetFactory factory,
+                                           ArchetypeVolumeNodeSetProbe probe)
+{
+  this->PreRegisterArchetypeVolumeNodeSetFactory(factory);
+  this->VolumeProbes[factory] = probe;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerVolumesLogic::ReadVolumeHeaderInformation(const char* filename, VolumeHeaderInformation& header)
+{
+  header = VolumeHeaderInformation();
+  if (filename == nullptr || !vtksys::SystemTools::FileExists(filename, true))
+  {
+    return false;
+  }
+
+  // Use the same image type as vtkITKArchetypeImageSeriesReader so that
+  // the same ImageIO is selected.
+  typedef itk::Image<float, 3> ImageType;
+  itk::ImageFileReader<ImageType>::Pointer reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(filename);
+  try
+  {
+    reader->UpdateOutputInformation();
+  }
+  catch (...)
+  {
+    // itk::ExceptionObject, or std::string thrown by GDCM
+    return false;
+  }
+  itk::ImageIOBase* imageIO = reader->GetImageIO();
+  if (imageIO == nullptr)
+  {
+    return false;
+  }
+
+  header.NumberOfComponents = imageIO->GetNumberOfComponents();
+  header.PixelType = itk::ImageIOBase::GetPixelTypeAsString(imageIO->GetPixelType());
+  header.NRRD = (strcmp(imageIO->GetNameOfClass(), "NrrdImageIO") == 0);
+  if (header.NRRD)
+  {
+    itk::ExposeMetaData<std::string>(imageIO->GetMetaDataDictionary(), "modality", header.Modality);
+  }
+  header.Valid = true;
+  return true;
+}
+
 //----------------------------------------------------------------------------
 vtkMRMLScalarVolumeNode*
 vtkSlicerVolumesLogic
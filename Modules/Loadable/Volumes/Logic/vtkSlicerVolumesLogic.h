@@ -34,6 +34,7 @@
 // STD includes
 #include <cstdlib>
 #include <list>
+#include <map>
 #include <string>
 
 #include "vtkSlicerVolumesModuleLogicExport.h"
@@ -98,6 +99,28 @@ public:
   /// initialize the storage node with the "options".
   typedef ArchetypeVolumeNodeSet (*ArchetypeVolumeNodeSetFactory)(std::string& volumeName, vtkMRMLScene* scene, int options);
 
+  /// Information read from the header of a volume file, without reading
+  /// the voxels. Used to skip node set factories that cannot read the file.
+  /// \sa ReadVolumeHeaderInformation, ArchetypeVolumeNodeSetProbe
+  struct VolumeHeaderInformation
+  {
+    /// Set to true if the header could be read.
+    bool Valid{false};
+    /// Set to true if the file is a NRRD file.
+    bool NRRD{false};
+    unsigned int NumberOfComponents{0};
+    /// ITK pixel type (e.g., "scalar", "vector", "symmetric_second_rank_tensor").
+    std::string PixelType;
+    /// Value of the "modality" field of NRRD files (e.g., "DWMRI").
+    std::string Modality;
+  };
+
+  /// Function that examines the header of a file and returns false if the
+  /// associated factory certainly cannot create a node set that reads the file.
+  /// It must return true if the header is not valid, as the storage node
+  /// may still be able to read the file.
+  typedef bool (*ArchetypeVolumeNodeSetProbe)(const VolumeHeaderInformation& header);
+
   /// Examine the file name to see if the extension is one of the supported
   /// freesurfer volume formats. Used to assign the proper color node to label maps.
   int IsFreeSurferVolume(const char* filename);
@@ -111,6 +134,12 @@ public:
   /// called. Factories are tested in the order they are registered.
   void RegisterArchetypeVolumeNodeSetFactory(ArchetypeVolumeNodeSetFactory factory);
 
+  /// Register a factory method along with a probe function that is called
+  /// before the factory to skip reading of files that the factory cannot load.
+  /// \sa RegisterArchetypeVolumeNodeSetFactory(ArchetypeVolumeNodeSetFactory)
+  void RegisterArchetypeVolumeNodeSetFactory(ArchetypeVolumeNodeSetFactory factory,
+                                             ArchetypeVolumeNodeSetProbe probe);
+
   /// Register a factory method that can create and configure a node
   /// set (ArchetypeVolumeNodeSet) containing a volume node, display
   /// node, and storage node. The nodes are configured within the
@@ -122,6 +151,17 @@ public:
   /// the back of the list of factories.
   void PreRegisterArchetypeVolumeNodeSetFactory(ArchetypeVolumeNodeSetFactory factory);
 
+  /// Pre-register a factory method along with a probe function.
+  /// \sa PreRegisterArchetypeVolumeNodeSetFactory(ArchetypeVolumeNodeSetFactory)
+  /// \sa RegisterArchetypeVolumeNodeSetFactory(ArchetypeVolumeNodeSetFactory, ArchetypeVolumeNodeSetProbe)
+  void PreRegisterArchetypeVolumeNodeSetFactory(ArchetypeVolumeNodeSetFactory factory,
+                                                ArchetypeVolumeNodeSetProbe probe);
+
+  /// Read number of components, pixel type, and NRRD fields from the header of
+  /// a local volume file. Voxels are not read.
+  /// Returns false (and header.Valid is set to false) if the header could not be read.
+  static bool ReadVolumeHeaderInformation(const char* filename, VolumeHeaderInformation& header);
+
   /// Overloaded function of AddArchetypeVolume to provide more
   /// loading options, where variable loadingOptions is bit-coded as following:
   /// bit 0: label map
@@ -293,6 +333,13 @@ public:
   /// \sa SetCompareVolumeGeometryEpsilon
   vtkGetMacro(CompareVolumeGeometryPrecision, int);
 
+  /// Directory where DICOM header information is cached when loading DICOM series.
+  /// It is set on the storage nodes of volumes loaded by AddArchetypeVolume.
+  /// The cache is disabled if no directory is set (default).
+  /// \sa vtkMRMLVolumeArchetypeStorageNode::SetDICOMHeaderCacheDirectory
+  vtkSetStringMacro(DICOMHeaderCacheDirectory);
+  vtkGetStringMacro(DICOMHeaderCacheDirectory);
+
   /// Method to set volume window/level based on a volume display preset.
   /// Returns true on success.
   bool ApplyVolumeDisplayPreset(vtkMRMLVolumeDisplayNode* displayNode, std::string presetId);
@@ -343,6 +390,10 @@ protected:
 
   NodeSetFactoryRegistry VolumeRegistry;
 
+  /// Probe functions of the registered factories.
+  /// Factories without a probe function are always tested.
+  std::map<ArchetypeVolumeNodeSetFactory, ArchetypeVolumeNodeSetProbe> VolumeProbes;
+
   /// Allowable difference in comparing volume geometry double values.
   /// Defaults to 1 to the power of 10 to the minus 6
   double CompareVolumeGeometryEpsilon;
@@ -350,6 +401,9 @@ protected:
   /// Error print out precision, paired with CompareVolumeGeometryEpsilon.
   /// defaults to 6
   int CompareVolumeGeometryPrecision;
+
+  /// Directory where DICOM header information is cached.
+  char* DICOMHeaderCacheDirectory;
 };
 
 #endif
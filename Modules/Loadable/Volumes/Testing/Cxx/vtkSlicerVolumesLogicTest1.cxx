@@ -88,6 +88,15 @@ int vtkSlicerVolumesLogicTest1( int argc, char * argv[] )
   logic->SetMRMLScene(scene.GetPointer());
   const char* volumeName = argv[1];
 
+  // Header of the test volumes is read without reading the voxels
+  vtkSlicerVolumesLogic::VolumeHeaderInformation header;
+  CHECK_BOOL(vtkSlicerVolumesLogic::ReadVolumeHeaderInformation(volumeName, header), true);
+  CHECK_BOOL(header.Valid, true);
+  CHECK_BOOL(header.NRRD, true);
+  CHECK_INT(header.NumberOfComponents, 1);
+  CHECK_BOOL(vtkSlicerVolumesLogic::ReadVolumeHeaderInformation("nonexistent.nrrd", header), false);
+  CHECK_BOOL(header.Valid, false);
+
   vtkMRMLScalarVolumeNode * scalarVolume = TestScalarVolumeLoading(volumeName, logic.GetPointer());
   CHECK_NOT_NULL(scalarVolume);
 
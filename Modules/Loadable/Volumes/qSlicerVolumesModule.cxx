@@ -18,6 +18,7 @@
 
 ==============================================================================*/
 #include <QDebug>
+#include <QDir>
 
 // Slicer includes
 #include <qSlicerCoreApplication.h>
@@ -132,6 +133,9 @@ void qSlicerVolumesModule::setup()
 
   vtkSlicerVolumesLogic* volumesLogic =
     vtkSlicerVolumesLogic::SafeDownCast(this->logic());
+  // DICOM header information is cached in a dedicated folder of the application cache
+  volumesLogic->SetDICOMHeaderCacheDirectory(
+    QDir(qSlicerCoreApplication::application()->cachePath()).filePath("DICOMHeaderCache").toUtf8());
 
   qSlicerCoreIOManager* ioManager =
     qSlicerCoreApplication::application()->coreIOManager();
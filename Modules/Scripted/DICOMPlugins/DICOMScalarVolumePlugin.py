@@ -436,6 +436,7 @@ class DICOMScalarVolumePluginClass(DICOMPlugin):
         reader.SetOutputScalarTypeToNative()
         reader.SetDesiredCoordinateOrientationToNative()
         reader.SetUseNativeOriginOn()
+        reader.SetDICOMHeaderCacheDirectory(slicer.modules.volumes.logic().GetDICOMHeaderCacheDirectory())
         if imageIOName == "GDCM":
             reader.SetDICOMImageIOApproachToGDCM()
         elif imageIOName == "DCMTK":